@@ -40,6 +40,10 @@ struct Stat
   int64_t scan_open_failed_count = 0;
   int64_t mismatch_count         = 0;
   int64_t scan_other_count       = 0;
+
+  int64_t lookup_success_count  = 0;
+  int64_t lookup_mismatch_count = 0;
+  int64_t lookup_other_count    = 0;
 };
 
 class BenchmarkBase : public Fixture
@@ -70,8 +74,10 @@ public:
 
     const char *filename = btree_filename.c_str();
 
-    RC rc = handler_.create(
-        log_handler_, bpm_, filename, AttrType::INTS, sizeof(int32_t) /*attr_len*/, internal_max_size, leaf_max_size);
+    // 索引只有一个整数字段，键就是记录本身
+    FieldMeta field_meta("key", AttrType::INTS, 0 /*attr_offset*/, sizeof(int32_t) /*attr_len*/, true /*visible*/, 0 /*field_id*/);
+    RC        rc = handler_.create(
+        false /*unique*/, log_handler_, bpm_, filename, {&field_meta}, internal_max_size, leaf_max_size);
     if (rc != RC::SUCCESS) {
       throw runtime_error("failed to create btree handler");
     }
@@ -92,9 +98,9 @@ public:
         state.thread_index());
   }
 
-  void FillUp(uint32_t min, uint32_t max)
+  void FillUp(uint32_t min, uint32_t max, uint32_t step = 1)
   {
-    for (uint32_t value = min; value < max; ++value) {
+    for (uint32_t value = min; value < max; value += step) {
       const char *key = reinterpret_cast<const char *>(&value);
       RID         rid(value, value);
 
@@ -180,8 +186,51 @@ public:
     }
   }
 
+  void Lookup(uint32_t value, Stat &stat)
+  {
+    const char *key = reinterpret_cast<const char *>(&value);
+
+    list<RID> rids;
+    RC        rc = handler_.get_entry(key, sizeof(value), rids);
+    if (rc != RC::SUCCESS) {
+      stat.lookup_other_count++;
+    } else if (rids.size() != 1) {
+      stat.lookup_mismatch_count++;
+    } else {
+      stat.lookup_success_count++;
+    }
+  }
+
+  /// 批量查找从 first 开始、间隔为 step 的 num 个键值，每个键值都应该只有一条记录
+  void BatchLookup(uint32_t first, int num, uint32_t step, Stat &stat)
+  {
+    vector<uint32_t>     values(num);
+    vector<const char *> keys(num);
+    for (int i = 0; i < num; i++) {
+      values[i] = first + i * step;
+      keys[i]   = reinterpret_cast<const char *>(&values[i]);
+    }
+
+    vector<RID> rids;
+    vector<int> offsets;
+    RC          rc = handler_.get_entries(keys, rids, &offsets);
+    if (rc != RC::SUCCESS) {
+      stat.lookup_other_count += num;
+      return;
+    }
+
+    for (int i = 0; i < num; i++) {
+      if (offsets[i + 1] - offsets[i] != 1) {
+        stat.lookup_mismatch_count++;
+      } else {
+        stat.lookup_success_count++;
+      }
+    }
+  }
+
 protected:
-  BufferPoolManager bpm_{512};
+  // 64个线程同时访问时，需要足够的页帧让每个线程都能pin住自己的页面
+  BufferPoolManager bpm_{BufferPoolOptions{.memory_size = 64 * 1024 * 1024}};
   BplusTreeHandler  handler_;
   VacuousLogHandler log_handler_;
 };
@@ -208,7 +257,7 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]     = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, 64);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -247,7 +296,7 @@ BENCHMARK_DEFINE_F(DeletionBenchmark, Deletion)(State &state)
   state.counters["other"]     = Counter(stat.delete_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->ThreadRange(1, 64)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -290,7 +339,140 @@ BENCHMARK_DEFINE_F(ScanBenchmark, Scan)(State &state)
   state.counters["other"]                 = Counter(stat.scan_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->ThreadRange(1, 64)->Arg(4 * 10000);
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 并发点查询，观察读操作随线程数的扩展性
+ * @details range(0) 决定数据量，range(1) 为1时使用乐观的方式查找叶子节点，为0时一路加读锁，作为对照
+ */
+class LookupBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "lookup"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = GetRangeMax(state);
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    FillUp(0, max);
+    handler_.set_optimistic_read(state.range(1) != 0);
+  }
+};
+
+BENCHMARK_DEFINE_F(LookupBenchmark, Lookup)(State &state)
+{
+  IntegerGenerator generator(0, GetRangeMax(state) - 1);
+  Stat             stat;
+
+  for (auto _ : state) {
+    uint32_t value = static_cast<uint32_t>(generator.next());
+    Lookup(value, stat);
+  }
+
+  state.counters["success"]  = Counter(stat.lookup_success_count, Counter::kIsRate);
+  state.counters["mismatch"] = Counter(stat.lookup_mismatch_count, Counter::kIsRate);
+  state.counters["other"]    = Counter(stat.lookup_other_count, Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(LookupBenchmark, Lookup)->ThreadRange(1, 64)->ArgsProduct({{4 * 10000}, {0, 1}});
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 一个线程不停地插入删除奇数，其它线程查询偶数
+ * @details 写线程会让页面分裂、合并，读线程查询的偶数一直都在，查不到就是错误。参数与 LookupBenchmark 相同
+ */
+class ReadWriteBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "read_write"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = GetRangeMax(state);
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    FillUp(0, max, 2 /*step*/);
+    handler_.set_optimistic_read(state.range(1) != 0);
+  }
+};
+
+BENCHMARK_DEFINE_F(ReadWriteBenchmark, ReadWrite)(State &state)
+{
+  IntegerGenerator generator(0, GetRangeMax(state) / 2 - 1);
+  IntegerGenerator operation_generator(0, 1);
+  Stat             stat;
+
+  const bool writer = (0 == state.thread_index());
+  for (auto _ : state) {
+    uint32_t value = static_cast<uint32_t>(generator.next()) * 2;
+    if (!writer) {
+      Lookup(value, stat);
+    } else if (operation_generator.next() == 0) {
+      Insert(value + 1, stat);
+    } else {
+      Delete(value + 1, stat);
+    }
+  }
+
+  if (writer) {
+    state.counters["insert_success"] = Counter(stat.insert_success_count, Counter::kIsRate);
+    state.counters["delete_success"] = Counter(stat.delete_success_count, Counter::kIsRate);
+  } else {
+    state.counters["lookup_success"]  = Counter(stat.lookup_success_count, Counter::kIsRate);
+    state.counters["lookup_mismatch"] = Counter(stat.lookup_mismatch_count, Counter::kIsRate);
+    state.counters["lookup_other"]    = Counter(stat.lookup_other_count, Counter::kIsRate);
+  }
+}
+
+BENCHMARK_REGISTER_F(ReadWriteBenchmark, ReadWrite)->ThreadRange(2, 64)->ArgsProduct({{4 * 10000}, {0, 1}});
+
+/**
+ * @brief 与 ReadWrite 相同，但是读线程每次用 get_entries 批量查找一段连续的偶数
+ */
+BENCHMARK_DEFINE_F(ReadWriteBenchmark, BatchReadWrite)(State &state)
+{
+  const int        batch_size = 64;
+  IntegerGenerator generator(0, GetRangeMax(state) / 2 - batch_size);
+  IntegerGenerator operation_generator(0, 1);
+  Stat             stat;
+
+  const bool writer = (0 == state.thread_index());
+  for (auto _ : state) {
+    uint32_t value = static_cast<uint32_t>(generator.next()) * 2;
+    if (!writer) {
+      BatchLookup(value, batch_size, 2 /*step*/, stat);
+    } else if (operation_generator.next() == 0) {
+      Insert(value + 1, stat);
+    } else {
+      Delete(value + 1, stat);
+    }
+  }
+
+  if (writer) {
+    state.counters["insert_success"] = Counter(stat.insert_success_count, Counter::kIsRate);
+    state.counters["delete_success"] = Counter(stat.delete_success_count, Counter::kIsRate);
+  } else {
+    state.counters["lookup_success"]  = Counter(stat.lookup_success_count, Counter::kIsRate);
+    state.counters["lookup_mismatch"] = Counter(stat.lookup_mismatch_count, Counter::kIsRate);
+    state.counters["lookup_other"]    = Counter(stat.lookup_other_count, Counter::kIsRate);
+  }
+}
+
+BENCHMARK_REGISTER_F(ReadWriteBenchmark, BatchReadWrite)->ThreadRange(2, 64)->ArgsProduct({{4 * 10000}, {1}});
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -344,7 +526,7 @@ BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
       {"scan_open_failed", Counter(stat.scan_open_failed_count, Counter::kIsRate)}});
 }
 
-BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->ThreadRange(1, 64)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,223 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/algorithm.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "common/math/integer_generator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+/// 字符串键值的长度
+static constexpr int CHARS_KEY_LENGTH = 16;
+
+/// 把整数转换成对应类型的键值，字符串按照数字的顺序补齐前导0
+static void make_user_key(AttrType type, int value, char *key)
+{
+  if (type == AttrType::CHARS) {
+    snprintf(key, CHARS_KEY_LENGTH, "%015d", value);
+  } else {
+    memcpy(key, &value, sizeof(value));
+  }
+}
+
+static int key_length(AttrType type) { return type == AttrType::CHARS ? CHARS_KEY_LENGTH : sizeof(int32_t); }
+
+/**
+ * @brief 旧的比较方式，每次比较构造两个 Value，再通过 DataType 比较，作为对照
+ */
+static int compare_by_value(AttrType type, int length, const char *v1, const char *v2)
+{
+  Value left;
+  left.set_type(type);
+  left.set_data(v1, length);
+  Value right;
+  right.set_type(type);
+  right.set_data(v2, length);
+  return DataType::type_instance(type)->compare(left, right);
+}
+
+/**
+ * @brief 比较两个键值的开销。range(0) 是属性类型，range(1) 为1时使用 AttrComparator，否则使用 Value 比较
+ */
+static void BM_AttrCompare(State &state)
+{
+  const AttrType type           = static_cast<AttrType>(state.range(0));
+  const bool     use_comparator = state.range(1) != 0;
+  int            length         = key_length(type);
+
+  AttrComparator comparator;
+  AttrType       types[] = {type};
+  comparator.init(1, types, &length);
+
+  const int        key_num = 1024;
+  vector<char>     keys(key_num * length);
+  IntegerGenerator generator(0, INT32_MAX);
+  for (int i = 0; i < key_num; i++) {
+    make_user_key(type, generator.next() % 1000000, keys.data() + i * length);
+  }
+
+  int64_t sum = 0;
+  int     i   = 0;
+  for (auto _ : state) {
+    const char *v1 = keys.data() + (i % key_num) * length;
+    const char *v2 = keys.data() + ((i + 1) % key_num) * length;
+    sum += use_comparator ? comparator(v1, v2) : compare_by_value(type, length, v1, v2);
+    i++;
+  }
+  DoNotOptimize(sum);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_AttrCompare)
+    ->ArgsProduct({{static_cast<int64_t>(AttrType::INTS), static_cast<int64_t>(AttrType::CHARS)}, {0, 1}});
+
+/**
+ * @brief B+树点查询的吞吐量
+ * @details range(0) 是树中键值的个数，range(1) 是属性类型，range(2) 是节点的存储格式。每次查询一个随机的、存在的键值
+ */
+class BplusTreeLookupBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    type_       = static_cast<AttrType>(state.range(1));
+    key_num_    = static_cast<int>(state.range(0));
+    key_length_ = key_length(type_);
+
+    const BplusTreeNodeFormat node_format = static_cast<BplusTreeNodeFormat>(state.range(2));
+
+    LoggerFactory::init_default("bplus_tree_lookup_performance_test.log", LOG_LEVEL_WARN);
+    bpm_ = make_unique<BufferPoolManager>();
+    bpm_->init(make_unique<VacuousDoubleWriteBuffer>());
+
+    const char *filename = "bplus_tree_lookup_performance_test.btree";
+    ::remove(filename);
+
+    FieldMeta field_meta("key", type_, 0 /*attr_offset*/, key_length_, true /*visible*/, 0 /*field_id*/);
+    handler_ = make_unique<BplusTreeHandler>();
+    RC rc    = handler_->create(true /*unique*/, log_handler_, *bpm_, filename, {&field_meta}, -1, -1, node_format);
+    if (rc != RC::SUCCESS) {
+      throw runtime_error("failed to create btree handler");
+    }
+
+    vector<char> key(key_length_);
+    for (int value = 0; value < key_num_; value++) {
+      make_user_key(type_, value, key.data());
+      RID rid(value, value);
+      rc = handler_->insert_entry(key.data(), &rid);
+      if (rc != RC::SUCCESS) {
+        throw runtime_error("failed to insert entry into btree");
+      }
+    }
+  }
+
+  void TearDown(const State &state) override
+  {
+    handler_.reset();
+    bpm_.reset();
+    ::remove("bplus_tree_lookup_performance_test.btree");
+  }
+
+protected:
+  AttrType                      type_       = AttrType::INTS;
+  int                           key_num_    = 0;
+  int                           key_length_ = 0;
+  VacuousLogHandler             log_handler_;
+  unique_ptr<BufferPoolManager> bpm_;
+  unique_ptr<BplusTreeHandler>  handler_;
+};
+
+BENCHMARK_DEFINE_F(BplusTreeLookupBenchmark, PointLookup)(State &state)
+{
+  // 提前生成要查询的键值，不把生成随机数的开销计算在内
+  const int        lookup_key_num = 4096;
+  IntegerGenerator generator(0, key_num_ - 1);
+  vector<char>     lookup_keys(lookup_key_num * key_length_);
+  for (int i = 0; i < lookup_key_num; i++) {
+    make_user_key(type_, generator.next(), lookup_keys.data() + i * key_length_);
+  }
+
+  list<RID> rids;
+  int64_t   found = 0;
+  int       i     = 0;
+  for (auto _ : state) {
+    rids.clear();
+    handler_->get_entry(lookup_keys.data() + (i++ % lookup_key_num) * key_length_, key_length_, rids);
+    found += rids.size();
+  }
+
+  if (found != state.iterations()) {
+    state.SkipWithError("some keys are not found");
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(BplusTreeLookupBenchmark, PointLookup)
+    ->ArgsProduct({{10000, 200000},
+        {static_cast<int64_t>(AttrType::INTS), static_cast<int64_t>(AttrType::CHARS)},
+        {static_cast<int64_t>(BplusTreeNodeFormat::PLAIN), static_cast<int64_t>(BplusTreeNodeFormat::COMPRESSED)}});
+
+/**
+ * @brief 批量查找的吞吐量，与 PointLookup 对比
+ * @details range(3) 是每批查找的键值个数。每批键值都是排好序的随机键值，用 get_entries 一次查完
+ */
+BENCHMARK_DEFINE_F(BplusTreeLookupBenchmark, BatchLookup)(State &state)
+{
+  const int        batch_size = static_cast<int>(state.range(3));
+  const int        batch_num  = 64;
+  IntegerGenerator generator(0, key_num_ - 1);
+
+  vector<char>                 lookup_keys(static_cast<size_t>(batch_num) * batch_size * key_length_);
+  vector<vector<const char *>> batches(batch_num);
+  for (int i = 0; i < batch_num; i++) {
+    vector<int> values(batch_size);
+    for (int &value : values) {
+      value = generator.next();
+    }
+    sort(values.begin(), values.end());
+
+    for (int j = 0; j < batch_size; j++) {
+      char *key = lookup_keys.data() + (static_cast<size_t>(i) * batch_size + j) * key_length_;
+      make_user_key(type_, values[j], key);
+      batches[i].push_back(key);
+    }
+  }
+
+  vector<RID> rids;
+  int64_t     found = 0;
+  int         i     = 0;
+  for (auto _ : state) {
+    rids.clear();
+    handler_->get_entries(batches[i++ % batch_num], rids);
+    found += rids.size();
+  }
+
+  if (found != state.iterations() * batch_size) {
+    state.SkipWithError("some keys are not found");
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+BENCHMARK_REGISTER_F(BplusTreeLookupBenchmark, BatchLookup)
+    ->ArgsProduct({{200000},
+        {static_cast<int64_t>(AttrType::INTS), static_cast<int64_t>(AttrType::CHARS)},
+        {static_cast<int64_t>(BplusTreeNodeFormat::PLAIN), static_cast<int64_t>(BplusTreeNodeFormat::COMPRESSED)},
+        {16, 1024}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/filesystem.h"
+#include "common/lang/stdexcept.h"
+#include "common/log/log.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/log_replayer.h"
+
+using namespace std;
+using namespace common;
+using namespace benchmark;
+
+class EmptyLogReplayer : public LogReplayer
+{
+public:
+  RC replay(const LogEntry &) override { return RC::SUCCESS; }
+};
+
+/**
+ * @brief 测试组提交的性能
+ * @details 每个线程模拟一个会话，不停的提交事务：写一条日志，然后等待日志落盘。
+ * 第一个参数是组提交的等待时间（微秒），结果中的 commits 是每秒提交的事务数，
+ * fsyncs 是每秒做的fsync次数，两者的比值就是平均一次fsync提交了多少个事务。
+ */
+class GroupCommitBenchmark : public Fixture
+{
+public:
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    LoggerFactory::init_default("clog_group_commit_performance_test.log", LOG_LEVEL_INFO);
+
+    filesystem::remove_all(directory_);
+
+    LogHandlerOptions options;
+    options.group_commit_window_us = static_cast<int>(state.range(0));
+    handler_                       = make_unique<DiskLogHandler>(options);
+
+    EmptyLogReplayer replayer;
+    if (OB_FAIL(handler_->init(directory_)) || OB_FAIL(handler_->replay(replayer, 0)) || OB_FAIL(handler_->start())) {
+      throw runtime_error("failed to start log handler");
+    }
+    start_groups_ = handler_->flush_group_count();
+  }
+
+  void TearDown(State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    state.counters["fsyncs"] = Counter(handler_->flush_group_count() - start_groups_, Counter::kIsRate);
+    handler_->stop();
+    handler_->await_termination();
+    handler_.reset();
+    filesystem::remove_all(directory_);
+  }
+
+  void commit(State &state)
+  {
+    LSN          lsn = 0;
+    vector<char> data(64);
+    RC           rc = handler_->append(lsn, LogModule::Id::TRANSACTION, std::move(data));
+    if (OB_SUCC(rc)) {
+      rc = handler_->wait_lsn(lsn);
+    }
+    if (OB_FAIL(rc)) {
+      state.SkipWithError(strrc(rc));
+    }
+  }
+
+protected:
+  const char                *directory_ = "clog_group_commit_performance_test";
+  unique_ptr<DiskLogHandler> handler_;
+  int64_t                    start_groups_ = 0;
+};
+
+BENCHMARK_DEFINE_F(GroupCommitBenchmark, Commit)(State &state)
+{
+  for (auto _ : state) {
+    commit(state);
+  }
+
+  state.counters["commits"] = Counter(state.iterations(), Counter::kIsRate);
+}
+
+BENCHMARK_REGISTER_F(GroupCommitBenchmark, Commit)
+    ->Arg(0)
+    ->Arg(1000)
+    ->ThreadRange(1, 256)
+    ->UseRealTime()
+    ->MinTime(1.0);
+
+BENCHMARK_MAIN();
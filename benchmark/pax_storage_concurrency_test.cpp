@@ -271,7 +271,7 @@ public:
   }
 
 protected:
-  BufferPoolManager  bpm_{512};
+  BufferPoolManager  bpm_{BufferPoolOptions{.memory_size = 512}};
   DiskBufferPool    *buffer_pool_ = nullptr;
   RecordFileHandler *handler_     = nullptr;
   VacuousLogHandler  log_handler_;
@@ -229,7 +229,8 @@ public:
   }
 
 protected:
-  BufferPoolManager  bpm_{512};
+  // 64个线程同时访问时，需要足够的页帧让每个线程都能pin住自己的页面
+  BufferPoolManager  bpm_{BufferPoolOptions{.memory_size = 64 * 1024 * 1024}};
   DiskBufferPool    *buffer_pool_ = nullptr;
   RecordFileHandler *handler_;
   VacuousLogHandler  log_handler_;
@@ -256,7 +257,7 @@ BENCHMARK_DEFINE_F(InsertionBenchmark, Insertion)(State &state)
   state.counters["other"]   = Counter(stat.insert_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->Threads(10);
+BENCHMARK_REGISTER_F(InsertionBenchmark, Insertion)->ThreadRange(1, 64);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -307,7 +308,7 @@ BENCHMARK_DEFINE_F(DeletionBenchmark, Deletion)(State &state)
   state.counters["other"]     = Counter(stat.delete_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(DeletionBenchmark, Deletion)->ThreadRange(1, 64)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -351,7 +352,7 @@ BENCHMARK_DEFINE_F(ScanBenchmark, Scan)(State &state)
   state.counters["other"]                 = Counter(stat.scan_other_count, Counter::kIsRate);
 }
 
-BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(ScanBenchmark, Scan)->ThreadRange(1, 64)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -414,7 +415,7 @@ BENCHMARK_DEFINE_F(MixtureBenchmark, Mixture)(State &state)
       {"scan_open_failed", Counter(stat.scan_open_failed_count, Counter::kIsRate)}});
 }
 
-BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
+BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->ThreadRange(1, 64)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
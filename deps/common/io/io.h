@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <vector>
+#include <sys/types.h>
 
 #include "common/defs.h"
 #include "common/lang/string.h"
@@ -67,6 +68,18 @@ int getFileSize(const char *filePath, uint64_t &fileLen);
  */
 int writen(int fd, const void *buf, int size);
 
+/**
+ * @brief 在指定的偏移位置一次性写入所有指定数据
+ * @details 不会修改文件的读写位置
+ *
+ * @param fd  写入的描述符
+ * @param buf 写入的数据
+ * @param size 写入多少数据
+ * @param offset 从文件的这个位置开始写入
+ * @return int 0 表示成功，否则返回errno
+ */
+int pwriten(int fd, const void *buf, int size, off_t offset);
+
 /**
  * @brief 一次性读取指定长度的数据
  *
@@ -77,4 +90,16 @@ int writen(int fd, const void *buf, int size);
  */
 int readn(int fd, void *buf, int size);
 
+/**
+ * @brief 从指定的偏移位置一次性读取指定长度的数据
+ * @details 不会修改文件的读写位置，多个线程可以同时读取同一个文件
+ *
+ * @param fd  读取的描述符
+ * @param buf 读取到这里
+ * @param size 读取的数据长度
+ * @param offset 从文件的这个位置开始读取
+ * @return int 返回0表示成功。-1 表示读取到文件尾，并且没有读到size大小数据，其它表示errno
+ */
+int preadn(int fd, void *buf, int size, off_t offset);
+
 }  // namespace common
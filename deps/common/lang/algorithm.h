@@ -14,4 +14,5 @@ See the Mulan PSL v2 for more details. */
 
 using std::max;
 using std::min;
-using std::transform;
\ No newline at end of file
+using std::transform;
+using std::clamp;
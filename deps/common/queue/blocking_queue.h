@@ -0,0 +1,61 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#pragma once
+
+#include "common/queue/queue.h"
+#include "common/lang/chrono.h"
+#include "common/lang/mutex.h"
+#include "common/lang/queue.h"
+
+namespace common {
+
+/**
+ * @brief 取任务时会等待的任务队列
+ * @details 与 SimpleQueue 一样用一个锁保护所有的接口，但是队列为空时，pop 会等待一段时间，
+ * 直到有新的任务或者超时。线程池的线程空闲时就不会一直占用CPU。
+ * 由于线程池需要定期检查自己的状态，所以 pop 不会无限等待。
+ * @tparam T 任务数据类型。
+ * @ingroup Queue
+ */
+template <typename T>
+class BlockingQueue : public Queue<T>
+{
+public:
+  using value_type = T;
+
+public:
+  /**
+   * @param wait_timeout 队列为空时 pop 最多等待的时间
+   */
+  explicit BlockingQueue(chrono::milliseconds wait_timeout = chrono::milliseconds(100))
+      : Queue<T>(), wait_timeout_(wait_timeout)
+  {}
+  virtual ~BlockingQueue() {}
+
+  //! @copydoc Queue::emplace
+  int push(value_type &&value) override;
+  //! @copydoc Queue::pop
+  int pop(value_type &value) override;
+  //! @copydoc Queue::size
+  int size() const override;
+
+private:
+  const chrono::milliseconds wait_timeout_;
+
+  mutable mutex      mutex_;
+  condition_variable cond_;
+  queue<value_type>  queue_;
+};
+
+}  // namespace common
+
+#include "common/queue/blocking_queue.ipp"
@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 
 class BufferPoolManager;
 class DefaultHandler;
+class PlanCache;
+class QueryCache;
 class TrxKit;
 
 /**
@@ -26,6 +28,8 @@ struct GlobalContext
 {
   // BufferPoolManager *buffer_pool_manager_ = nullptr;
   DefaultHandler *handler_ = nullptr;
+  PlanCache      *plan_cache_ = nullptr;
+  QueryCache     *query_cache_ = nullptr;
   // TrxKit            *trx_kit_             = nullptr;
 
   static GlobalContext &instance();
@@ -25,7 +25,9 @@ See the Mulan PSL v2 for more details. */
 #include "global_context.h"
 #include "session/session.h"
 #include "session/session_stage.h"
+#include "sql/plan_cache/plan_cache.h"
 #include "sql/plan_cache/plan_cache_stage.h"
+#include "sql/query_cache/query_cache.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/default/default_handler.h"
 #include "storage/trx/trx.h"
@@ -147,11 +149,20 @@ int init_global_objects(ProcessParam *process_param, Ini &properties)
     LOG_ERROR("failed to init handler. rc=%s", strrc(rc));
     return -1;
   }
+
+  GCTX.plan_cache_ = new PlanCache(PlanCache::DEFAULT_CAPACITY, PlanCache::DEFAULT_MAX_IDLE_PLANS);
+  GCTX.query_cache_ = new QueryCache(QueryCache::DEFAULT_CAPACITY, QueryCache::DEFAULT_MAX_RESULT_SIZE);
   return ret;
 }
 
 int uninit_global_objects()
 {
+  delete GCTX.query_cache_;
+  GCTX.query_cache_ = nullptr;
+
+  delete GCTX.plan_cache_;
+  GCTX.plan_cache_ = nullptr;
+
   delete GCTX.handler_;
   GCTX.handler_ = nullptr;
 
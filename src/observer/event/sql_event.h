@@ -16,10 +16,13 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/string.h"
 #include "common/lang/memory.h"
+#include "sql/operator/logical_operator.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/plan_cache/parameterized_sql.h"
 
 class SessionEvent;
 class Stmt;
+class Table;
 class ParsedSqlNode;
 
 /**
@@ -36,12 +39,16 @@ public:
   const string                       &sql() const { return sql_; }
   const unique_ptr<ParsedSqlNode>    &sql_node() const { return sql_node_; }
   Stmt                               *stmt() const { return stmt_; }
+  unique_ptr<LogicalOperator>        &logical_operator() { return logical_operator_; }
+  vector<PlanValue>                  &plan_values() { return plan_values_; }
+  vector<Table *>                    &tables() { return tables_; }
   unique_ptr<PhysicalOperator>       &physical_operator() { return operator_; }
   const unique_ptr<PhysicalOperator> &physical_operator() const { return operator_; }
 
   void set_sql(const char *sql) { sql_ = sql; }
   void set_sql_node(unique_ptr<ParsedSqlNode> sql_node) { sql_node_ = std::move(sql_node); }
   void set_stmt(Stmt *stmt) { stmt_ = stmt; }
+  void set_logical_operator(unique_ptr<LogicalOperator> oper) { logical_operator_ = std::move(oper); }
   void set_operator(unique_ptr<PhysicalOperator> oper) { operator_ = std::move(oper); }
 
 private:
@@ -49,5 +56,8 @@ private:
   string                       sql_;             ///< 处理的SQL语句
   unique_ptr<ParsedSqlNode>    sql_node_;        ///< 语法解析后的SQL命令
   Stmt                        *stmt_ = nullptr;  ///< Resolver之后生成的数据结构
-  unique_ptr<PhysicalOperator> operator_;        ///< 生成的执行计划，也可能没有
+  unique_ptr<LogicalOperator>  logical_operator_;  ///< 优化之后的逻辑计划，物理计划中的部分表达式仍然属于它
+  vector<PlanValue>            plan_values_;       ///< 执行计划中的常量，用于计划缓存
+  vector<Table *>              tables_;            ///< 命中计划缓存时没有stmt，由计划缓存给出查询用到的表
+  unique_ptr<PhysicalOperator> operator_;          ///< 生成的执行计划，也可能没有
 };
@@ -57,27 +57,55 @@ RC SqlTaskHandler::handle_event(Communicator *communicator)
 
 RC SqlTaskHandler::handle_sql(SQLStageEvent *sql_event)
 {
-  RC rc = query_cache_stage_.handle_request(sql_event);
+  bool query_cache_hit = false;
+  RC   rc              = query_cache_stage_.handle_request(sql_event, query_cache_hit);
   if (OB_FAIL(rc)) {
     LOG_TRACE("failed to do query cache. rc=%s", strrc(rc));
     return rc;
   }
 
-  rc = parse_stage_.handle_request(sql_event);
-  if (OB_FAIL(rc)) {
-    LOG_TRACE("failed to do parse. rc=%s", strrc(rc));
-    return rc;
+  if (query_cache_hit) {
+    return execute_stage_.handle_request(sql_event);
   }
 
-  rc = resolve_stage_.handle_request(sql_event);
+  bool plan_cache_hit = false;
+  rc = plan_cache_stage_.handle_request(sql_event, plan_cache_hit);
   if (OB_FAIL(rc)) {
-    LOG_TRACE("failed to do resolve. rc=%s", strrc(rc));
+    LOG_TRACE("failed to do plan cache. rc=%s", strrc(rc));
     return rc;
   }
 
-  rc = optimize_stage_.handle_request(sql_event);
-  if (rc != RC::UNIMPLEMENTED && rc != RC::SUCCESS) {
-    LOG_TRACE("failed to do optimize. rc=%s", strrc(rc));
+  if (!plan_cache_hit) {
+    rc = parse_stage_.handle_request(sql_event);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to do parse. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = resolve_stage_.handle_request(sql_event);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("failed to do resolve. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = optimize_stage_.handle_request(sql_event);
+    if (rc != RC::UNIMPLEMENTED && rc != RC::SUCCESS) {
+      LOG_TRACE("failed to do optimize. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (OB_SUCC(rc)) {
+      rc = plan_cache_stage_.add_plan(sql_event);
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("failed to add plan to cache. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+  }
+
+  rc = query_cache_stage_.cache_result(sql_event);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to cache query result. rc=%s", strrc(rc));
     return rc;
   }
 
@@ -83,6 +83,9 @@ public:
   void          set_execution_mode(const ExecutionMode mode) { execution_mode_ = mode; }
   ExecutionMode get_execution_mode() const { return execution_mode_; }
 
+  void    set_hash_join_memory_limit(int64_t limit) { hash_join_memory_limit_ = limit; }
+  int64_t hash_join_memory_limit() const { return hash_join_memory_limit_; }
+
   bool used_chunk_mode() { return used_chunk_mode_; }
 
   void set_used_chunk_mode(bool used_chunk_mode) { used_chunk_mode_ = used_chunk_mode; }
@@ -113,4 +116,7 @@ private:
   bool used_chunk_mode_ = false;
 
   ExecutionMode execution_mode_ = ExecutionMode::TUPLE_ITERATOR;
+
+  ///< hash join build端可以使用的内存（字节），超过后会把数据分区写到临时文件中
+  int64_t hash_join_memory_limit_ = 64 * 1024 * 1024;
 };
@@ -80,12 +80,17 @@ void SessionStage::handle_request2(SessionEvent *event)
  */
 RC SessionStage::handle_sql(SQLStageEvent *sql_event)
 {
-  RC rc = query_cache_stage_.handle_request(sql_event);
+  bool query_cache_hit = false;
+  RC   rc              = query_cache_stage_.handle_request(sql_event, query_cache_hit);
   if (OB_FAIL(rc)) {
     LOG_TRACE("failed to do query cache. rc=%s", strrc(rc));
     return rc;
   }
 
+  if (query_cache_hit) {
+    return execute_stage_.handle_request(sql_event);
+  }
+
   rc = parse_stage_.handle_request(sql_event);
   if (OB_FAIL(rc)) {
     LOG_TRACE("failed to do parse. rc=%s", strrc(rc));
@@ -104,6 +109,12 @@ RC SessionStage::handle_sql(SQLStageEvent *sql_event)
     return rc;
   }
 
+  rc = query_cache_stage_.cache_result(sql_event);
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to cache query result. rc=%s", strrc(rc));
+    return rc;
+  }
+
   rc = execute_stage_.handle_request(sql_event);
   if (OB_FAIL(rc)) {
     LOG_TRACE("failed to do execute. rc=%s", strrc(rc));
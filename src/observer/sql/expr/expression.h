@@ -238,6 +238,9 @@ public:
   void         get_value(Value &value) const { value = value_; }
   const Value &get_value() const { return value_; }
 
+  /// @brief 替换常量值。执行计划缓存命中时，用新的参数值覆盖计划中的常量
+  void set_value(const Value &value) { value_ = value; }
+
 private:
   Value value_;
 };
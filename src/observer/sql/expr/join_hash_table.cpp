@@ -0,0 +1,238 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <string_view>
+
+#include "common/log/log.h"
+#include "sql/expr/join_hash_table.h"
+
+using namespace std;
+
+namespace {
+
+/// 常量列只有一个值，所有行都使用这个值
+const char *column_value_at(const Column &column, int row)
+{
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    return column.data();
+  }
+  return column.data() + static_cast<size_t>(row) * column.attr_len();
+}
+
+uint64_t mix_hash(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+uint64_t hash_one(AttrType attr_type, const char *data, int attr_len)
+{
+  switch (attr_type) {
+    case AttrType::CHARS: {
+      // 字符串在记录中以'\0'结尾，之后的字节内容是不确定的
+      return hash<string_view>()(string_view(data, strnlen(data, attr_len)));
+    }
+    case AttrType::FLOATS: {
+      float f = *reinterpret_cast<const float *>(data);
+      if (f == 0) {
+        f = 0;  // -0.0 与 0.0 要得到相同的hash值
+      }
+      uint32_t bits = 0;
+      memcpy(&bits, &f, sizeof(bits));
+      return bits;
+    }
+    default: {
+      uint32_t bits = 0;
+      memcpy(&bits, data, sizeof(bits));
+      return bits;
+    }
+  }
+}
+
+bool value_equal(AttrType attr_type, const char *left, const char *right, int attr_len)
+{
+  switch (attr_type) {
+    case AttrType::CHARS: return strncmp(left, right, attr_len) == 0;
+    case AttrType::FLOATS: return *reinterpret_cast<const float *>(left) == *reinterpret_cast<const float *>(right);
+    default: return memcmp(left, right, attr_len) == 0;
+  }
+}
+
+}  // namespace
+
+RC JoinHashTable::append_column(const Column &column, int rows, ColumnData &column_data)
+{
+  if (column_data.attr_type == AttrType::UNDEFINED) {
+    column_data.attr_type = column.attr_type();
+    column_data.attr_len  = column.attr_len();
+  } else if (column_data.attr_type != column.attr_type() || column_data.attr_len != column.attr_len()) {
+    LOG_WARN("column schema changed. type=%d, len=%d, expect type=%d, len=%d",
+        column.attr_type(), column.attr_len(), column_data.attr_type, column_data.attr_len);
+    return RC::INTERNAL;
+  }
+
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    // 常量列展开成普通列，保证每一行都有自己的值
+    for (int row = 0; row < rows; row++) {
+      column_data.data.insert(column_data.data.end(), column.data(), column.data() + column.attr_len());
+    }
+  } else {
+    column_data.data.insert(column_data.data.end(), column.data(), column.data() + column.data_len());
+  }
+  return RC::SUCCESS;
+}
+
+RC JoinHashTable::add_chunk(Chunk &keys_chunk, Chunk &payload_chunk)
+{
+  const int rows = payload_chunk.rows();
+  if (rows == 0) {
+    return RC::SUCCESS;
+  }
+
+  if (key_columns_.empty()) {
+    key_columns_.resize(keys_chunk.column_num());
+    payload_columns_.resize(payload_chunk.column_num());
+  }
+
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < keys_chunk.column_num(); i++) {
+    if (OB_FAIL(rc = append_column(keys_chunk.column(i), rows, key_columns_[i]))) {
+      return rc;
+    }
+  }
+
+  for (int i = 0; i < payload_chunk.column_num(); i++) {
+    if (OB_FAIL(rc = append_column(payload_chunk.column(i), rows, payload_columns_[i]))) {
+      return rc;
+    }
+  }
+
+  vector<uint64_t> hashes;
+  hash_chunk(keys_chunk, hashes);
+  hashes_.insert(hashes_.end(), hashes.begin(), hashes.end());
+  rows_ += rows;
+  return rc;
+}
+
+void JoinHashTable::build()
+{
+  capacity_ = 16;
+  while (capacity_ < rows_ * 2) {
+    capacity_ *= 2;
+  }
+
+  slot_hashes_.assign(capacity_, 0);
+  slot_heads_.assign(capacity_, NO_MATCH);
+  next_.assign(rows_, NO_MATCH);
+
+  const uint64_t mask = capacity_ - 1;
+  // 倒序插入，这样链表中的行是按照写入顺序排列的
+  for (int row = rows_ - 1; row >= 0; row--) {
+    const uint64_t hash  = hashes_[row];
+    uint64_t       index = hash & mask;
+    while (slot_heads_[index] != NO_MATCH && slot_hashes_[index] != hash) {
+      index = (index + 1) & mask;
+    }
+
+    next_[row]          = slot_heads_[index];
+    slot_hashes_[index] = hash;
+    slot_heads_[index]  = row;
+  }
+}
+
+void JoinHashTable::hash_chunk(Chunk &keys_chunk, vector<uint64_t> &hashes)
+{
+  const int rows = keys_chunk.column_num() > 0 ? keys_chunk.rows() : 0;
+  hashes.assign(rows, 0);
+
+  // 按列计算，每次只处理一列数据
+  for (int col = 0; col < keys_chunk.column_num(); col++) {
+    const Column &column = keys_chunk.column(col);
+    for (int row = 0; row < rows; row++) {
+      uint64_t h = hash_one(column.attr_type(), column_value_at(column, row), column.attr_len());
+      hashes[row] ^= h + 0x9e3779b97f4a7c15ULL + (hashes[row] << 6) + (hashes[row] >> 2);
+    }
+  }
+
+  for (uint64_t &hash : hashes) {
+    hash = mix_hash(hash);
+  }
+}
+
+bool JoinHashTable::keys_equal(int build_row, Chunk &keys_chunk, int probe_row) const
+{
+  for (size_t col = 0; col < key_columns_.size(); col++) {
+    const ColumnData &build_column = key_columns_[col];
+    const Column     &probe_column = keys_chunk.column(col);
+    if (!value_equal(build_column.attr_type,
+            build_column.at(build_row),
+            column_value_at(probe_column, probe_row),
+            build_column.attr_len)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int JoinHashTable::find_chain(uint64_t hash, Chunk &keys_chunk, int probe_row) const
+{
+  if (capacity_ == 0) {
+    return NO_MATCH;
+  }
+
+  const uint64_t mask  = capacity_ - 1;
+  uint64_t       index = hash & mask;
+  while (slot_heads_[index] != NO_MATCH) {
+    if (slot_hashes_[index] == hash) {
+      int row = slot_heads_[index];
+      if (keys_equal(row, keys_chunk, probe_row)) {
+        return row;
+      }
+      return next_match(row, keys_chunk, probe_row);
+    }
+    index = (index + 1) & mask;
+  }
+  return NO_MATCH;
+}
+
+void JoinHashTable::probe(Chunk &keys_chunk, const vector<uint64_t> &hashes, vector<int> &matches) const
+{
+  matches.resize(hashes.size());
+  for (size_t row = 0; row < hashes.size(); row++) {
+    matches[row] = find_chain(hashes[row], keys_chunk, static_cast<int>(row));
+  }
+}
+
+int JoinHashTable::next_match(int build_row, Chunk &keys_chunk, int probe_row) const
+{
+  for (int row = next_[build_row]; row != NO_MATCH; row = next_[row]) {
+    if (keys_equal(row, keys_chunk, probe_row)) {
+      return row;
+    }
+  }
+  return NO_MATCH;
+}
+
+RC JoinHashTable::gather(int col, const vector<int> &build_rows, Column &column) const
+{
+  const ColumnData &column_data = payload_columns_[col];
+  RC                rc          = RC::SUCCESS;
+  for (int row : build_rows) {
+    if (OB_FAIL(rc = column.append_one(const_cast<char *>(column_data.at(row))))) {
+      return rc;
+    }
+  }
+  return rc;
+}
@@ -0,0 +1,102 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/common/chunk.h"
+
+/**
+ * @brief 用于向量化 hash join 的列式哈希表，不支持并发访问。
+ * @details build 端的连接键和输出列都按列保存在连续内存中。
+ * 哈希表本身参考 LinearProbingAggregateHashTable 使用开放寻址 + 线性探测，
+ * 每个槽位保存一个hash值和该hash值对应的第一行，hash值相同的行通过 next_ 数组串起来。
+ * 使用方式：先多次调用 add_chunk 写入 build 端数据，再调用 build 建立探测目录，然后就可以探测了。
+ */
+class JoinHashTable
+{
+public:
+  /// 没有匹配行时返回的行号
+  static constexpr int NO_MATCH = -1;
+
+public:
+  JoinHashTable()  = default;
+  ~JoinHashTable() = default;
+
+  /**
+   * @brief 写入一批 build 端数据
+   * @param keys_chunk 连接键，每列一个连接键
+   * @param payload_chunk 需要输出的列
+   */
+  RC add_chunk(Chunk &keys_chunk, Chunk &payload_chunk);
+
+  /**
+   * @brief 根据已经写入的数据建立探测目录，调用之后不能再 add_chunk
+   */
+  void build();
+
+  /**
+   * @brief 批量计算一个 chunk 中每一行连接键的hash值，build 和 probe 两端必须使用同一个函数
+   */
+  static void hash_chunk(Chunk &keys_chunk, std::vector<uint64_t> &hashes);
+
+  /**
+   * @brief 批量探测，matches[i] 为第i行的第一个匹配行，没有匹配时为 NO_MATCH
+   */
+  void probe(Chunk &keys_chunk, const std::vector<uint64_t> &hashes, std::vector<int> &matches) const;
+
+  /**
+   * @brief 获取 probe 端第 probe_row 行在 build_row 之后的下一个匹配行
+   */
+  int next_match(int build_row, Chunk &keys_chunk, int probe_row) const;
+
+  int rows() const { return rows_; }
+  int payload_column_num() const { return static_cast<int>(payload_columns_.size()); }
+
+  AttrType payload_type(int col) const { return payload_columns_[col].attr_type; }
+  int      payload_len(int col) const { return payload_columns_[col].attr_len; }
+
+  /**
+   * @brief 按照行号把 build 端的输出列追加到 column 中
+   */
+  RC gather(int col, const std::vector<int> &build_rows, Column &column) const;
+
+private:
+  /// 连续存储的一列数据
+  struct ColumnData
+  {
+    AttrType          attr_type = AttrType::UNDEFINED;
+    int               attr_len  = 0;
+    std::vector<char> data;
+
+    const char *at(int row) const { return data.data() + static_cast<size_t>(row) * attr_len; }
+  };
+
+  static RC append_column(const Column &column, int rows, ColumnData &column_data);
+
+  /// build 端第 build_row 行的连接键与 probe 端第 probe_row 行的连接键是否相等
+  bool keys_equal(int build_row, Chunk &keys_chunk, int probe_row) const;
+
+  int find_chain(uint64_t hash, Chunk &keys_chunk, int probe_row) const;
+
+private:
+  std::vector<ColumnData> key_columns_;
+  std::vector<ColumnData> payload_columns_;
+  std::vector<uint64_t>   hashes_;  ///< 每行连接键的hash值
+  std::vector<int>        next_;    ///< hash值相同的下一行
+  int                     rows_ = 0;
+
+  /// 探测目录，capacity_ 为2的幂
+  std::vector<uint64_t> slot_hashes_;
+  std::vector<int>      slot_heads_;
+  int                   capacity_ = 0;
+};
@@ -113,6 +113,9 @@ RC HashGroupByPhysicalOperator::next()
 RC HashGroupByPhysicalOperator::close()
 {
   children_[0]->close();
+  // 清理分组结果，算子可以重新打开（比如缓存的执行计划）
+  groups_.clear();
+  current_group_ = groups_.end();
   LOG_INFO("close group by operator");
   return RC::SUCCESS;
 }
@@ -0,0 +1,526 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string_view>
+
+#include "common/lang/serializer.h"
+#include "common/log/log.h"
+#include "sql/operator/hash_join_physical_operator.h"
+
+using namespace std;
+using namespace common;
+
+namespace {
+
+size_t hash_value(const Value &value)
+{
+  switch (value.attr_type()) {
+    case AttrType::CHARS: {
+      return std::hash<string_view>()(string_view(value.data(), value.length()));
+    }
+    case AttrType::FLOATS: {
+      float f = value.get_float();
+      if (f == 0) {
+        f = 0;  // -0.0 与 0.0 要得到相同的hash值
+      }
+      return std::hash<float>()(f);
+    }
+    default: {
+      return std::hash<int>()(value.get_int());
+    }
+  }
+}
+
+/// 连接键中的整数hash值往往就是它本身，需要打散一下，否则分区和hash桶都会很不均匀
+size_t mix_hash(size_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+int partition_of(size_t hash) { return static_cast<int>((hash >> 32) % HashJoinPhysicalOperator::SPILL_PARTITION_NUM); }
+
+string key_name(const Expression &expr)
+{
+  if (expr.type() == ExprType::FIELD) {
+    const auto &field_expr = static_cast<const FieldExpr &>(expr);
+    return string(field_expr.table_name()) + "." + field_expr.field_name();
+  }
+  return expr.name();
+}
+
+bool keys_equal(const vector<Value> &left, const vector<Value> &right)
+{
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < left.size(); i++) {
+    if (left[i].compare(right[i]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// 估算一行数据在hash表中占用的内存
+int64_t row_memory(const vector<Value> &row, const vector<Value> &keys)
+{
+  int64_t size = 2 * sizeof(vector<Value>) + (row.size() + keys.size()) * sizeof(Value) + 4 * sizeof(void *);
+  for (const Value &value : row) {
+    if (value.attr_type() == AttrType::CHARS) {
+      size += value.length() + 1;
+    }
+  }
+  return size;
+}
+
+/**
+ * @brief 把一行数据写到分区文件中
+ * @details 格式为：数据长度 + 数据。数据为列数 + 每列的(类型，长度，数据)
+ */
+RC write_row(FILE *file, const vector<Value> &row)
+{
+  Serializer serializer;
+  serializer.write_int32(static_cast<int32_t>(row.size()));
+  for (const Value &value : row) {
+    serializer.write_int32(static_cast<int32_t>(value.attr_type()));
+    serializer.write_int32(value.length());
+    if (value.length() > 0) {
+      serializer.write(value.data(), value.length());
+    }
+  }
+
+  const int32_t size = static_cast<int32_t>(serializer.size());
+  if (fwrite(&size, sizeof(size), 1, file) != 1 || fwrite(serializer.data().data(), size, 1, file) != 1) {
+    LOG_WARN("failed to write spill file. errno=%d:%s", errno, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC read_row(FILE *file, vector<Value> &row)
+{
+  int32_t size = 0;
+  if (fread(&size, sizeof(size), 1, file) != 1) {
+    if (feof(file)) {
+      return RC::RECORD_EOF;
+    }
+    LOG_WARN("failed to read spill file. errno=%d:%s", errno, strerror(errno));
+    return RC::IOERR_READ;
+  }
+
+  vector<char> buffer(size);
+  if (fread(buffer.data(), size, 1, file) != 1) {
+    LOG_WARN("failed to read spill file. size=%d, errno=%d:%s", size, errno, strerror(errno));
+    return RC::IOERR_READ;
+  }
+
+  Deserializer deserializer(buffer.data(), size);
+  int32_t      cell_num = 0;
+  if (deserializer.read_int32(cell_num) != 0) {
+    return RC::IOERR_READ;
+  }
+
+  row.clear();
+  row.resize(cell_num);
+  for (int32_t i = 0; i < cell_num; i++) {
+    int32_t type   = 0;
+    int32_t length = 0;
+    if (deserializer.read_int32(type) != 0 || deserializer.read_int32(length) != 0) {
+      return RC::IOERR_READ;
+    }
+
+    if (static_cast<AttrType>(type) == AttrType::CHARS) {
+      string str(length, '\0');
+      if (length > 0 && deserializer.read(str.data(), length) != 0) {
+        return RC::IOERR_READ;
+      }
+      row[i].set_type(AttrType::CHARS);
+      row[i].set_data(str.c_str(), length);
+    } else {
+      char data[sizeof(int64_t)] = {0};
+      if (length > static_cast<int32_t>(sizeof(data)) || deserializer.read(data, length) != 0) {
+        return RC::IOERR_READ;
+      }
+      row[i].set_type(static_cast<AttrType>(type));
+      row[i].set_data(data, length);
+    }
+  }
+  return RC::SUCCESS;
+}
+
+}  // namespace
+
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(
+    vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys, int64_t memory_limit)
+    : left_keys_(std::move(left_keys)), right_keys_(std::move(right_keys)), memory_limit_(memory_limit)
+{
+  ASSERT(left_keys_.size() == right_keys_.size(), "join keys size mismatch. left=%d, right=%d",
+         left_keys_.size(), right_keys_.size());
+}
+
+HashJoinPhysicalOperator::~HashJoinPhysicalOperator() { close_spill_files(); }
+
+string HashJoinPhysicalOperator::param() const
+{
+  string result;
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    if (i > 0) {
+      result += " AND ";
+    }
+    result += key_name(*left_keys_[i]) + "=" + key_name(*right_keys_[i]);
+  }
+  return result;
+}
+
+RC HashJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  trx_   = trx;
+  left_  = children_[0].get();
+  right_ = children_[1].get();
+
+  spilled_           = false;
+  probe_valid_       = false;
+  current_partition_ = -1;
+  left_specs_.clear();
+  right_specs_.clear();
+  clear_hash_table();
+
+  RC rc = build();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build hash table. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (spilled_) {
+    rc = partition_probe_side();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to partition probe side. rc=%s", strrc(rc));
+    }
+    return rc;
+  }
+
+  rc = left_->open(trx_);
+  if (OB_SUCC(rc)) {
+    left_opened_ = true;
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::build()
+{
+  RC rc = right_->open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open right child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  while (OB_SUCC(rc = right_->next())) {
+    Tuple *tuple = right_->current_tuple();
+    if (right_specs_.empty()) {
+      right_specs_.resize(tuple->cell_num());
+      for (int i = 0; i < tuple->cell_num(); i++) {
+        tuple->spec_at(i, right_specs_[i]);
+      }
+    }
+
+    Row row(tuple->cell_num());
+    for (int i = 0; i < tuple->cell_num(); i++) {
+      tuple->cell_at(i, row[i]);
+    }
+
+    Row    keys;
+    size_t hash = 0;
+    rc          = compute_keys(right_keys_, *tuple, keys, hash);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
+    if (spilled_) {
+      rc = write_row(build_partitions_[partition_of(hash)], row);
+    } else {
+      build_rows_.emplace_back(std::move(row));
+      build_keys_.emplace_back(std::move(keys));
+      hash_table_.emplace(hash, build_rows_.size() - 1);
+      memory_used_ += row_memory(build_rows_.back(), build_keys_.back());
+      if (memory_used_ > memory_limit_) {
+        rc = spill_build_rows();
+      }
+    }
+
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+
+  RC close_rc = right_->close();
+  if (rc == RC::RECORD_EOF) {
+    rc = close_rc;
+  }
+
+  right_tuple_.set_names(right_specs_);
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::spill_build_rows()
+{
+  LOG_INFO("hash join build side exceeds memory limit, switch to partition mode. memory used=%ld, limit=%ld",
+           memory_used_, memory_limit_);
+
+  for (int i = 0; i < SPILL_PARTITION_NUM; i++) {
+    FILE *build_file = tmpfile();
+    FILE *probe_file = tmpfile();
+    if (build_file != nullptr) {
+      build_partitions_.push_back(build_file);
+    }
+    if (probe_file != nullptr) {
+      probe_partitions_.push_back(probe_file);
+    }
+    if (build_file == nullptr || probe_file == nullptr) {
+      LOG_WARN("failed to create spill file. errno=%d:%s", errno, strerror(errno));
+      return RC::IOERR_OPEN;
+    }
+  }
+
+  spilled_ = true;
+  for (auto &[hash, index] : hash_table_) {
+    RC rc = write_row(build_partitions_[partition_of(hash)], build_rows_[index]);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  clear_hash_table();
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::partition_probe_side()
+{
+  RC rc = left_->open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open left child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  while (OB_SUCC(rc = left_->next())) {
+    Tuple *tuple = left_->current_tuple();
+    if (left_specs_.empty()) {
+      left_specs_.resize(tuple->cell_num());
+      for (int i = 0; i < tuple->cell_num(); i++) {
+        tuple->spec_at(i, left_specs_[i]);
+      }
+    }
+
+    Row    keys;
+    size_t hash = 0;
+    rc          = compute_keys(left_keys_, *tuple, keys, hash);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
+    Row row(tuple->cell_num());
+    for (int i = 0; i < tuple->cell_num(); i++) {
+      tuple->cell_at(i, row[i]);
+    }
+
+    rc = write_row(probe_partitions_[partition_of(hash)], row);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+
+  RC close_rc = left_->close();
+  if (rc == RC::RECORD_EOF) {
+    rc = close_rc;
+  }
+
+  spilled_left_tuple_.set_names(left_specs_);
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::load_partition(int partition)
+{
+  clear_hash_table();
+
+  FILE *build_file = build_partitions_[partition];
+  FILE *probe_file = probe_partitions_[partition];
+  rewind(build_file);
+  rewind(probe_file);
+
+  ValueListTuple tuple;
+  tuple.set_names(right_specs_);
+
+  RC  rc = RC::SUCCESS;
+  Row row;
+  while (OB_SUCC(rc = read_row(build_file, row))) {
+    tuple.set_cells(row);
+
+    Row    keys;
+    size_t hash = 0;
+    rc          = compute_keys(right_keys_, tuple, keys, hash);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    build_rows_.emplace_back(std::move(row));
+    build_keys_.emplace_back(std::move(keys));
+    hash_table_.emplace(hash, build_rows_.size() - 1);
+    memory_used_ += row_memory(build_rows_.back(), build_keys_.back());
+  }
+
+  if (rc == RC::RECORD_EOF) {
+    rc = RC::SUCCESS;
+  }
+
+  LOG_TRACE("load hash join partition %d. rows=%d, memory used=%ld", partition, build_rows_.size(), memory_used_);
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::probe_next()
+{
+  if (!spilled_) {
+    RC rc = left_->next();
+    if (OB_SUCC(rc)) {
+      left_tuple_ = left_->current_tuple();
+    }
+    return rc;
+  }
+
+  while (true) {
+    if (current_partition_ >= 0) {
+      Row row;
+      RC  rc = read_row(probe_partitions_[current_partition_], row);
+      if (OB_SUCC(rc)) {
+        spilled_left_tuple_.set_cells(row);
+        left_tuple_ = &spilled_left_tuple_;
+        return rc;
+      }
+
+      if (rc != RC::RECORD_EOF) {
+        return rc;
+      }
+    }
+
+    // 跳过build端为空的分区，这些分区中的probe数据不可能有匹配
+    do {
+      if (current_partition_ + 1 >= SPILL_PARTITION_NUM) {
+        clear_hash_table();
+        return RC::RECORD_EOF;
+      }
+
+      RC rc = load_partition(++current_partition_);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to load partition. partition=%d, rc=%s", current_partition_, strrc(rc));
+        return rc;
+      }
+    } while (build_rows_.empty());
+  }
+}
+
+RC HashJoinPhysicalOperator::next()
+{
+  while (true) {
+    if (probe_valid_) {
+      while (match_iter_ != match_end_) {
+        size_t index = match_iter_->second;
+        ++match_iter_;
+        if (keys_equal(probe_keys_, build_keys_[index])) {
+          right_tuple_.set_cells(build_rows_[index]);
+          joined_tuple_.set_left(left_tuple_);
+          joined_tuple_.set_right(&right_tuple_);
+          return RC::SUCCESS;
+        }
+      }
+      probe_valid_ = false;
+    }
+
+    RC rc = probe_next();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    size_t hash = 0;
+    rc          = compute_keys(left_keys_, *left_tuple_, probe_keys_, hash);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    auto range   = hash_table_.equal_range(hash);
+    match_iter_  = range.first;
+    match_end_   = range.second;
+    probe_valid_ = true;
+  }
+}
+
+RC HashJoinPhysicalOperator::close()
+{
+  RC rc = RC::SUCCESS;
+  if (left_opened_) {
+    rc = left_->close();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to close left oper. rc=%s", strrc(rc));
+    }
+    left_opened_ = false;
+  }
+
+  probe_valid_ = false;
+  clear_hash_table();
+  close_spill_files();
+  return rc;
+}
+
+Tuple *HashJoinPhysicalOperator::current_tuple() { return &joined_tuple_; }
+
+RC HashJoinPhysicalOperator::compute_keys(
+    vector<unique_ptr<Expression>> &key_exprs, const Tuple &tuple, Row &keys, size_t &hash)
+{
+  keys.resize(key_exprs.size());
+  hash = 0;
+  for (size_t i = 0; i < key_exprs.size(); i++) {
+    RC rc = key_exprs[i]->get_value(tuple, keys[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get join key value. rc=%s", strrc(rc));
+      return rc;
+    }
+    hash ^= hash_value(keys[i]) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  hash = mix_hash(hash);
+  return RC::SUCCESS;
+}
+
+void HashJoinPhysicalOperator::clear_hash_table()
+{
+  build_rows_.clear();
+  build_keys_.clear();
+  hash_table_.clear();
+  memory_used_ = 0;
+}
+
+void HashJoinPhysicalOperator::close_spill_files()
+{
+  // tmpfile 创建的文件在关闭后会自动删除
+  for (FILE *file : build_partitions_) {
+    fclose(file);
+  }
+  for (FILE *file : probe_partitions_) {
+    fclose(file);
+  }
+  build_partitions_.clear();
+  probe_partitions_.clear();
+}
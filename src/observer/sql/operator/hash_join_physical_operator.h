@@ -0,0 +1,103 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdio>
+#include <unordered_map>
+
+#include "sql/expr/expression.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 等值连接的 hash join 算子
+ * @ingroup PhysicalOperator
+ * @details 右孩子作为build端，先全部读出来建立hash表；左孩子作为probe端，逐行到hash表中查找匹配的数据。
+ * 输出的tuple与NestedLoopJoin一样，左边是左孩子的数据，右边是右孩子的数据。
+ * 如果build端占用的内存超过了 memory_limit，就切换到分区模式（grace hash join）：
+ * 把build端和probe端都按照连接键的hash值写到若干个临时文件中，然后逐个分区做内存中的hash join。
+ * NOTE: 分区只做一次，如果某个分区仍然超过内存限制，也会整体加载到内存中。
+ */
+class HashJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  /// 分区模式下的分区个数
+  static constexpr int SPILL_PARTITION_NUM = 16;
+
+public:
+  HashJoinPhysicalOperator(std::vector<std::unique_ptr<Expression>> &&left_keys,
+      std::vector<std::unique_ptr<Expression>> &&right_keys, int64_t memory_limit);
+  virtual ~HashJoinPhysicalOperator();
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; }
+
+  std::string param() const override;
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override;
+
+  /// 是否使用了分区（落盘）模式，测试使用
+  bool spilled() const { return spilled_; }
+
+private:
+  using Row = std::vector<Value>;
+
+  RC build();
+  RC spill_build_rows();
+  RC partition_probe_side();
+  RC load_partition(int partition);
+
+  /// 获取probe端的下一行，内存模式下直接从左孩子读取，分区模式下从分区文件中读取
+  RC probe_next();
+
+  RC compute_keys(std::vector<std::unique_ptr<Expression>> &key_exprs, const Tuple &tuple, Row &keys, size_t &hash);
+
+  void clear_hash_table();
+  void close_spill_files();
+
+private:
+  Trx *trx_ = nullptr;
+
+  std::vector<std::unique_ptr<Expression>> left_keys_;
+  std::vector<std::unique_ptr<Expression>> right_keys_;
+  int64_t                                  memory_limit_ = 0;  ///< build端可以使用的内存，单位字节
+
+  PhysicalOperator *left_  = nullptr;
+  PhysicalOperator *right_ = nullptr;
+
+  std::vector<TupleCellSpec> left_specs_;   ///< 左孩子的tuple schema，分区模式下还原左边tuple使用
+  std::vector<TupleCellSpec> right_specs_;  ///< 右孩子的tuple schema
+
+  /// build端数据，hash表中保存的是连接键的hash值到build_rows_下标的映射
+  std::vector<Row>                        build_rows_;
+  std::vector<Row>                        build_keys_;
+  std::unordered_multimap<size_t, size_t> hash_table_;
+  int64_t                                 memory_used_ = 0;
+
+  /// 当前probe行对应的匹配范围
+  using MatchIterator = std::unordered_multimap<size_t, size_t>::iterator;
+  MatchIterator match_iter_;
+  MatchIterator match_end_;
+  Row           probe_keys_;
+  bool          probe_valid_ = false;
+
+  Tuple         *left_tuple_ = nullptr;
+  ValueListTuple spilled_left_tuple_;
+  ValueListTuple right_tuple_;
+  JoinedTuple    joined_tuple_;
+
+  bool                spilled_           = false;
+  bool                left_opened_       = false;
+  int                 current_partition_ = -1;
+  std::vector<FILE *> build_partitions_;
+  std::vector<FILE *> probe_partitions_;
+};
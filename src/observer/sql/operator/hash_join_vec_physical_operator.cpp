@@ -0,0 +1,248 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/hash_join_vec_physical_operator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+namespace {
+
+string key_name(const Expression &expr)
+{
+  if (expr.type() == ExprType::FIELD) {
+    const auto &field_expr = static_cast<const FieldExpr &>(expr);
+    return string(field_expr.table_name()) + "." + field_expr.field_name();
+  }
+  return expr.name();
+}
+
+const char *column_value_at(const Column &column, int row)
+{
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    return column.data();
+  }
+  return column.data() + static_cast<size_t>(row) * column.attr_len();
+}
+
+}  // namespace
+
+HashJoinVecPhysicalOperator::HashJoinVecPhysicalOperator(
+    vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys)
+    : left_keys_(std::move(left_keys)), right_keys_(std::move(right_keys))
+{
+  ASSERT(left_keys_.size() == right_keys_.size(), "join keys of both sides should have the same size");
+}
+
+string HashJoinVecPhysicalOperator::param() const
+{
+  string result;
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    if (i > 0) {
+      result += " AND ";
+    }
+    result += key_name(*left_keys_[i]) + "=" + key_name(*right_keys_[i]);
+  }
+  return result;
+}
+
+RC HashJoinVecPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  hash_table_ = JoinHashTable();
+  probe_chunk_.reset();
+  output_chunk_.reset();
+  probe_row_ = 0;
+  match_row_ = JoinHashTable::NO_MATCH;
+  probe_eof_ = false;
+
+  RC rc = children_[1]->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open right child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = build();
+  children_[1]->close();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build hash table. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rc = children_[0]->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open left child operator. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC HashJoinVecPhysicalOperator::build()
+{
+  RC    rc = RC::SUCCESS;
+  Chunk build_chunk;
+  Chunk build_keys;
+  while (OB_SUCC(rc = children_[1]->next(build_chunk))) {
+    if (OB_FAIL(rc = eval_keys(right_keys_, build_chunk, build_keys))) {
+      return rc;
+    }
+    if (OB_FAIL(rc = hash_table_.add_chunk(build_keys, build_chunk))) {
+      LOG_WARN("failed to add chunk to hash table. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to fetch chunk from right child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  hash_table_.build();
+  LOG_TRACE("hash join build side finished. rows=%d", hash_table_.rows());
+  return RC::SUCCESS;
+}
+
+RC HashJoinVecPhysicalOperator::eval_keys(vector<unique_ptr<Expression>> &key_exprs, Chunk &chunk, Chunk &keys_chunk)
+{
+  keys_chunk.reset();
+  for (size_t i = 0; i < key_exprs.size(); i++) {
+    auto column = make_unique<Column>();
+    RC   rc     = key_exprs[i]->get_column(chunk, *column);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get column of join key. rc=%s", strrc(rc));
+      return rc;
+    }
+    keys_chunk.add_column(std::move(column), i);
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinVecPhysicalOperator::fetch_probe_chunk()
+{
+  if (probe_eof_) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = children_[0]->next(probe_chunk_);
+  if (rc == RC::RECORD_EOF) {
+    probe_eof_ = true;
+    probe_chunk_.reset();
+    return rc;
+  } else if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch chunk from left child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (OB_FAIL(rc = eval_keys(left_keys_, probe_chunk_, probe_keys_))) {
+    return rc;
+  }
+
+  JoinHashTable::hash_chunk(probe_keys_, probe_hashes_);
+  hash_table_.probe(probe_keys_, probe_hashes_, probe_matches_);
+
+  probe_row_ = 0;
+  match_row_ = probe_chunk_.rows() > 0 ? probe_matches_[0] : JoinHashTable::NO_MATCH;
+
+  if (output_chunk_.column_num() == 0 && probe_chunk_.rows() > 0) {
+    int col_id = 0;
+    for (int i = 0; i < probe_chunk_.column_num(); i++) {
+      Column &column = probe_chunk_.column(i);
+      output_chunk_.add_column(make_unique<Column>(column.attr_type(), column.attr_len()), col_id++);
+    }
+    for (int i = 0; i < hash_table_.payload_column_num(); i++) {
+      output_chunk_.add_column(
+          make_unique<Column>(hash_table_.payload_type(i), hash_table_.payload_len(i)), col_id++);
+    }
+  }
+  return rc;
+}
+
+RC HashJoinVecPhysicalOperator::next(Chunk &chunk)
+{
+  // 内连接，build端为空时不会有任何输出
+  if (hash_table_.rows() == 0) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = RC::SUCCESS;
+  selected_probe_rows_.clear();
+  selected_build_rows_.clear();
+  while (true) {
+    if (probe_row_ >= probe_chunk_.rows()) {
+      // 已经选中的行引用了当前的 probe_chunk_，需要先输出
+      if (!selected_probe_rows_.empty()) {
+        break;
+      }
+
+      rc = fetch_probe_chunk();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      continue;
+    }
+
+    if (match_row_ == JoinHashTable::NO_MATCH) {
+      probe_row_++;
+      if (probe_row_ < probe_chunk_.rows()) {
+        match_row_ = probe_matches_[probe_row_];
+      }
+      continue;
+    }
+
+    selected_probe_rows_.push_back(probe_row_);
+    selected_build_rows_.push_back(match_row_);
+    match_row_ = hash_table_.next_match(match_row_, probe_keys_, probe_row_);
+    if (static_cast<int>(selected_probe_rows_.size()) >= output_chunk_.capacity()) {
+      break;
+    }
+  }
+
+  if (OB_FAIL(rc = materialize())) {
+    return rc;
+  }
+  return chunk.reference(output_chunk_);
+}
+
+RC HashJoinVecPhysicalOperator::materialize()
+{
+  RC rc = RC::SUCCESS;
+  output_chunk_.reset_data();
+
+  const int left_column_num = probe_chunk_.column_num();
+  for (int col = 0; col < left_column_num; col++) {
+    const Column &probe_column  = probe_chunk_.column(col);
+    Column       &output_column = output_chunk_.column(col);
+    for (int row : selected_probe_rows_) {
+      if (OB_FAIL(rc = output_column.append_one(const_cast<char *>(column_value_at(probe_column, row))))) {
+        return rc;
+      }
+    }
+  }
+
+  for (int col = 0; col < hash_table_.payload_column_num(); col++) {
+    rc = hash_table_.gather(col, selected_build_rows_, output_chunk_.column(left_column_num + col));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC HashJoinVecPhysicalOperator::close()
+{
+  hash_table_ = JoinHashTable();
+  probe_chunk_.reset();
+  probe_keys_.reset();
+  output_chunk_.reset();
+  return children_[0]->close();
+}
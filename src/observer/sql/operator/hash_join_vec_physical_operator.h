@@ -0,0 +1,66 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/expr/join_hash_table.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 等值连接的 hash join 算子(Vectorized)
+ * @ingroup PhysicalOperator
+ * @details 右孩子作为build端，open时把所有chunk写入 JoinHashTable；左孩子作为probe端，每次取一个chunk批量探测。
+ * 输出的chunk中，前面是左孩子的所有列，后面是右孩子的所有列，上层算子中的 FieldExpr 需要通过 pos 定位到对应的列。
+ * NOTE: 与 HashJoinPhysicalOperator 不同，这里没有实现落盘，build端需要全部放在内存中。
+ */
+class HashJoinVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  HashJoinVecPhysicalOperator(
+      std::vector<std::unique_ptr<Expression>> &&left_keys, std::vector<std::unique_ptr<Expression>> &&right_keys);
+  virtual ~HashJoinVecPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN_VEC; }
+
+  std::string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+private:
+  RC build();
+
+  /// 从左孩子获取下一个chunk，并批量计算hash值、探测哈希表
+  RC fetch_probe_chunk();
+
+  static RC eval_keys(std::vector<std::unique_ptr<Expression>> &key_exprs, Chunk &chunk, Chunk &keys_chunk);
+
+  /// 根据匹配的行号，按列把输出数据写到 output_chunk_ 中
+  RC materialize();
+
+private:
+  std::vector<std::unique_ptr<Expression>> left_keys_;
+  std::vector<std::unique_ptr<Expression>> right_keys_;
+
+  JoinHashTable hash_table_;
+
+  Chunk            probe_chunk_;
+  Chunk            probe_keys_;
+  std::vector<uint64_t> probe_hashes_;
+  std::vector<int> probe_matches_;   ///< probe_chunk_ 中每一行的第一个匹配行
+  int              probe_row_ = 0;   ///< 当前正在处理的probe行
+  int              match_row_ = JoinHashTable::NO_MATCH;  ///< 当前probe行正在输出的build行
+  bool             probe_eof_ = false;
+
+  std::vector<int> selected_probe_rows_;
+  std::vector<int> selected_build_rows_;
+  Chunk            output_chunk_;
+};
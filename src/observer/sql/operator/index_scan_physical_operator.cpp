@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/index_scan_physical_operator.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/limits.h"
 #include "common/log/log.h"
 #include "common/rc.h"
 #include "common/type/attr_type.h"
@@ -20,92 +22,393 @@ See the Mulan PSL v2 for more details. */
 #include "storage/trx/trx.h"
 #include <cstring>
 
-RC IndexScanPhysicalOperator::make_data(
-    const std::vector<Value> &values, std::vector<FieldMeta> &meta, Table *table, Record &out)
-{
-  int offset = 0;
-  for (int i = 0; i < values.size(); i++) {
-    Value       &value      = const_cast<Value &>(values[i]);
-    FieldMeta   &field_meta = meta[i];
-    size_t       copy_len   = field_meta.len();
-    const size_t data_len   = value.length();
-    if (field_meta.type() == AttrType::CHARS) {
-      if (copy_len > data_len) {
-        copy_len = data_len + 1;
+namespace {
+
+/// 一个字段上范围的一边，没有边界时 value 无意义
+struct ValueBound
+{
+  bool  bounded   = false;
+  bool  inclusive = true;
+  Value value;
+};
+
+/// 一个字段上的值的范围
+struct ValueRange
+{
+  ValueBound left;
+  ValueBound right;
+
+  bool is_point() const
+  {
+    return left.bounded && right.bounded && left.inclusive && right.inclusive && left.value.compare(right.value) == 0;
+  }
+};
+
+/// 比较两个左边界。没有边界的最小，值相同时包含边界的更小
+int compare_left(const ValueBound &a, const ValueBound &b)
+{
+  if (!a.bounded || !b.bounded) {
+    return static_cast<int>(a.bounded) - static_cast<int>(b.bounded);
+  }
+  int result = a.value.compare(b.value);
+  if (result == 0) {
+    result = static_cast<int>(b.inclusive) - static_cast<int>(a.inclusive);
+  }
+  return result;
+}
+
+/// 比较两个右边界。没有边界的最大，值相同时包含边界的更大
+int compare_right(const ValueBound &a, const ValueBound &b)
+{
+  if (!a.bounded || !b.bounded) {
+    return static_cast<int>(b.bounded) - static_cast<int>(a.bounded);
+  }
+  int result = a.value.compare(b.value);
+  if (result == 0) {
+    result = static_cast<int>(a.inclusive) - static_cast<int>(b.inclusive);
+  }
+  return result;
+}
+
+bool is_empty(const ValueRange &range)
+{
+  if (!range.left.bounded || !range.right.bounded) {
+    return false;
+  }
+  const int result = range.left.value.compare(range.right.value);
+  return result > 0 || (result == 0 && !(range.left.inclusive && range.right.inclusive));
+}
+
+/// 左边的范围与右边的范围相交或者相邻，可以合并成一个
+bool can_merge(const ValueRange &left, const ValueRange &right)
+{
+  if (!left.right.bounded || !right.left.bounded) {
+    return true;
+  }
+  const int result = left.right.value.compare(right.left.value);
+  return result > 0 || (result == 0 && (left.right.inclusive || right.left.inclusive));
+}
+
+/// 排序并合并重叠的范围，结果按照从小到大排列并且互不重叠
+void normalize(std::vector<ValueRange> &ranges)
+{
+  ranges.erase(std::remove_if(ranges.begin(), ranges.end(), is_empty), ranges.end());
+  std::sort(ranges.begin(), ranges.end(), [](const ValueRange &a, const ValueRange &b) {
+    return compare_left(a.left, b.left) < 0;
+  });
+
+  size_t merged_num = 0;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    if (merged_num > 0 && can_merge(ranges[merged_num - 1], ranges[i])) {
+      ValueRange &last = ranges[merged_num - 1];
+      if (compare_right(ranges[i].right, last.right) > 0) {
+        last.right = ranges[i].right;
       }
+    } else {
+      ranges[merged_num++] = ranges[i];
     }
-    memcpy(out.data() + offset, value.data(), copy_len);
-    offset += field_meta.offset();
   }
-  return RC::SUCCESS;
+  ranges.resize(merged_num);
 }
 
-IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode,
-    const std::vector<Value> &left_value, bool left_inclusive, const std::vector<Value> &right_value,
-    bool right_inclusive)
-    : table_(table), index_(index), mode_(mode), left_inclusive_(left_inclusive), right_inclusive_(right_inclusive)
+/// 两组范围的交集，两组范围都已经 normalize 过
+std::vector<ValueRange> intersect(const std::vector<ValueRange> &a, const std::vector<ValueRange> &b)
 {
-  std::vector<FieldMeta> fields = index_->field_metas();
+  std::vector<ValueRange> result;
+  for (const ValueRange &x : a) {
+    for (const ValueRange &y : b) {
+      ValueRange range;
+      range.left  = compare_left(x.left, y.left) >= 0 ? x.left : y.left;
+      range.right = compare_right(x.right, y.right) <= 0 ? x.right : y.right;
+      if (!is_empty(range)) {
+        result.push_back(range);
+      }
+    }
+  }
+  normalize(result);
+  return result;
+}
 
-  RC  rc   = RC::SUCCESS;
-  int size = index->size();
-  // for (auto &field : fields) {
-  //   size += field.len();
-  // }
+/**
+ * @brief 把一个条件转换成字段上的范围
+ * @details 常量会转换成字段的类型。转换有损失时（比如浮点数转换成整数）不能保证范围正确，就不限制范围，
+ * 由谓词过滤。字符串超过字段长度时截断，截断后的边界需要包含边界值
+ */
+ValueRange make_value_range(const FieldMeta &field_meta, const IndexKeyCondition &condition)
+{
+  ValueRange   range;
+  const Value &origin = condition.value->get_value();
 
-  Record lrecord;
-  Record rrecord;
-  rc = lrecord.new_record(size);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("Failed to make record");
+  Value value = origin;
+  bool  exact = true;
+  if (origin.attr_type() != field_meta.type()) {
+    Value restored;
+    if (OB_FAIL(Value::cast_to(origin, field_meta.type(), value)) ||
+        OB_FAIL(Value::cast_to(value, origin.attr_type(), restored)) || restored.compare(origin) != 0) {
+      return range;
+    }
   }
-  rc = rrecord.new_record(size);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("Failed to make record");
+  if (field_meta.type() == AttrType::CHARS && value.length() > field_meta.len()) {
+    value = Value(value.data(), field_meta.len());
+    exact = false;
   }
 
-  rc = make_data(left_value, fields, table, lrecord); 
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("fail to make data");
+  ValueBound bound;
+  bound.bounded   = true;
+  bound.value     = value;
+  bound.inclusive = true;
+  switch (condition.comp) {
+    case EQUAL_TO: {
+      range.left  = bound;
+      range.right = bound;
+    } break;
+    case LESS_THAN:
+    case LESS_EQUAL: {
+      bound.inclusive = condition.comp == LESS_EQUAL || !exact;
+      range.right     = bound;
+    } break;
+    case GREAT_THAN:
+    case GREAT_EQUAL: {
+      bound.inclusive = condition.comp == GREAT_EQUAL || !exact;
+      range.left      = bound;
+    } break;
+    default: break;
   }
-  left_value_.resize(size);
-  memcpy(left_value_.data(), lrecord.data(), size);
+  return range;
+}
+
+/// 能否用类型的最小值和最大值填充没有条件的字段
+bool has_extreme(AttrType type)
+{
+  return type == AttrType::INTS || type == AttrType::DATES || type == AttrType::FLOATS || type == AttrType::CHARS;
+}
 
-  rc = make_data(right_value, fields, table, rrecord); 
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("fail to make data");
+/// 字段类型的最小值或者最大值，用于填充没有条件的字段
+void fill_extreme(const FieldMeta &field_meta, bool max, char *data)
+{
+  switch (field_meta.type()) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      const int32_t value = max ? std::numeric_limits<int32_t>::max() : std::numeric_limits<int32_t>::min();
+      memcpy(data, &value, sizeof(value));
+    } break;
+    case AttrType::FLOATS: {
+      const float value = max ? std::numeric_limits<float>::infinity() : -std::numeric_limits<float>::infinity();
+      memcpy(data, &value, sizeof(value));
+    } break;
+    case AttrType::CHARS: {
+      memset(data, max ? 0xFF : 0, field_meta.len());
+    } break;
+    default: {
+      ASSERT(false, "unsupported type to fill extreme value. type=%s", attr_type_to_string(field_meta.type()));
+    } break;
   }
-  right_value_.resize(size);
-  memcpy(right_value_.data(), lrecord.data(), size);
+}
 
-  left_len_  = size;
-  right_len_ = size;
-  // LOG_INFO("left value:%s right value:%s", left_value_.data(), right_value_.data());
+void fill_value(const FieldMeta &field_meta, const Value &value, char *data)
+{
+  size_t copy_len = field_meta.len();
+  if (field_meta.type() == AttrType::CHARS) {
+    copy_len = std::min(copy_len, static_cast<size_t>(value.length()));
+    memset(data, 0, field_meta.len());
+  }
+  memcpy(data, value.data(), copy_len);
 }
 
-RC IndexScanPhysicalOperator::open(Trx *trx)
+}  // namespace
+
+IndexScanPhysicalOperator::IndexScanPhysicalOperator(
+    Table *table, Index *index, ReadWriteMode mode, std::vector<IndexColumnConditions> column_conditions)
+    : table_(table), index_(index), mode_(mode), column_conditions_(std::move(column_conditions))
+{}
+
+RC IndexScanPhysicalOperator::make_key_ranges(bool &point_lookup)
 {
-  if (nullptr == table_ || nullptr == index_) {
-    return RC::INTERNAL;
+  const std::vector<FieldMeta> &field_metas = index_->field_metas();
+  const int                     record_size = table_->table_meta().record_size();
+
+  point_lookup = false;
+  key_buffer_.clear();
+  key_ranges_.clear();
+
+  // 每个字段上的范围：AND 起来的条件取交集，OR 起来的条件取并集
+  std::vector<std::vector<ValueRange>> column_ranges;
+  for (size_t i = 0; i < column_conditions_.size() && i < field_metas.size(); i++) {
+    std::vector<ValueRange> ranges(1);
+    for (const std::vector<IndexKeyCondition> &group : column_conditions_[i]) {
+      std::vector<ValueRange> group_ranges;
+      for (const IndexKeyCondition &condition : group) {
+        group_ranges.push_back(make_value_range(field_metas[i], condition));
+      }
+      normalize(group_ranges);
+      ranges = intersect(ranges, group_ranges);
+    }
+
+    if (ranges.empty()) {
+      // 条件互相矛盾，不会有数据
+      return RC::SUCCESS;
+    }
+    column_ranges.push_back(std::move(ranges));
+  }
+
+  // 前面都是等值条件的字段组合成前缀，最多再加上一个字段的范围。组合太多时后面的字段就不再使用
+  std::vector<std::vector<Value>> prefixes(1);
+  const std::vector<ValueRange>  *last_ranges = nullptr;
+  for (const std::vector<ValueRange> &ranges : column_ranges) {
+    if (!prefixes.front().empty() && prefixes.size() * ranges.size() > MAX_SCAN_RANGES) {
+      break;
+    }
+
+    bool all_points = std::all_of(ranges.begin(), ranges.end(), [](const ValueRange &r) { return r.is_point(); });
+    if (!all_points) {
+      last_ranges = &ranges;
+      break;
+    }
+
+    std::vector<std::vector<Value>> new_prefixes;
+    new_prefixes.reserve(prefixes.size() * ranges.size());
+    for (const std::vector<Value> &prefix : prefixes) {
+      for (const ValueRange &range : ranges) {
+        new_prefixes.push_back(prefix);
+        new_prefixes.back().push_back(range.left.value);
+      }
+    }
+    prefixes.swap(new_prefixes);
+  }
+
+  const size_t prefix_len = prefixes.front().size();
+  if (last_ranges == nullptr && prefix_len == field_metas.size()) {
+    // 所有字段都是确定的值，可以批量查找
+    point_lookup = true;
+    key_buffer_.assign(prefixes.size() * record_size, 0);
+    for (size_t i = 0; i < prefixes.size(); i++) {
+      char *key = key_buffer_.data() + i * record_size;
+      for (size_t j = 0; j < prefix_len; j++) {
+        fill_value(field_metas[j], prefixes[i][j], key + field_metas[j].offset());
+      }
+      key_ranges_.push_back(IndexKeyRange{key, true, key, true});
+    }
+    return RC::SUCCESS;
+  }
+
+  static const std::vector<ValueRange> unbounded_ranges(1);
+  if (last_ranges == nullptr) {
+    last_ranges = &unbounded_ranges;
+  }
+
+  // 边界之后的字段用最小值或者最大值填充，使得同一个前缀的所有键值都在范围内
+  const size_t bound_column = prefix_len;
+  for (size_t i = bound_column; i < field_metas.size(); i++) {
+    if (!has_extreme(field_metas[i].type())) {
+      LOG_TRACE("cannot fill key with extreme values, scan the whole index. field=%s", field_metas[i].name());
+      key_ranges_.push_back(IndexKeyRange{});
+      return RC::SUCCESS;
+    }
+  }
+
+  auto fill_key = [&](const std::vector<Value> &prefix, const ValueBound &bound, bool max, char *key) {
+    for (size_t j = 0; j < prefix_len; j++) {
+      fill_value(field_metas[j], prefix[j], key + field_metas[j].offset());
+    }
+    size_t next_column = bound_column;
+    if (bound.bounded) {
+      fill_value(field_metas[bound_column], bound.value, key + field_metas[bound_column].offset());
+      next_column++;
+    }
+    for (size_t j = next_column; j < field_metas.size(); j++) {
+      fill_extreme(field_metas[j], max, key + field_metas[j].offset());
+    }
+  };
+
+  const size_t range_num = prefixes.size() * last_ranges->size();
+  key_buffer_.assign(range_num * 2 * record_size, 0);
+  key_ranges_.reserve(range_num);
+  for (const std::vector<Value> &prefix : prefixes) {
+    for (const ValueRange &range : *last_ranges) {
+      char *left_key  = key_buffer_.data() + key_ranges_.size() * 2 * record_size;
+      char *right_key = left_key + record_size;
+
+      IndexKeyRange key_range;
+      if (range.left.bounded || prefix_len > 0) {
+        // 不包含左边界时，左边界之后的字段填充最大值，跳过所有等于边界值的键
+        fill_key(prefix, range.left, range.left.bounded && !range.left.inclusive, left_key);
+        key_range.left_key       = left_key;
+        key_range.left_inclusive = !range.left.bounded || range.left.inclusive;
+      }
+      if (range.right.bounded || prefix_len > 0) {
+        fill_key(prefix, range.right, !range.right.bounded || range.right.inclusive, right_key);
+        key_range.right_key       = right_key;
+        key_range.right_inclusive = !range.right.bounded || range.right.inclusive;
+      }
+      key_ranges_.push_back(key_range);
+    }
   }
+  return RC::SUCCESS;
+}
 
-  IndexScanner *index_scanner = index_->create_scanner(
-      left_value_.data(), left_len_, left_inclusive_, right_value_.data(), right_len_, right_inclusive_);
-  if (nullptr == index_scanner) {
-    LOG_WARN("failed to create index scanner");
+RC IndexScanPhysicalOperator::open(Trx *trx)
+{
+  if (nullptr == table_ || nullptr == index_) {
     return RC::INTERNAL;
   }
 
   record_handler_ = table_->record_handler();
   if (nullptr == record_handler_) {
     LOG_WARN("invalid record handler");
-    index_scanner->destroy();
     return RC::INTERNAL;
   }
-  index_scanner_ = index_scanner;
+
+  // 常量可能已经被替换过（比如缓存的执行计划），每次都重新生成扫描范围
+  bool point_lookup = false;
+  RC   rc           = make_key_ranges(point_lookup);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to make index key ranges. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  rids_.clear();
+  rid_offsets_.clear();
+  rid_index_ = 0;
+  key_index_ = 0;
+  if (point_lookup) {
+    // 等值查询一次取出所有的 RID，不需要创建扫描器
+    std::vector<const char *> keys;
+    keys.reserve(key_ranges_.size());
+    for (const IndexKeyRange &range : key_ranges_) {
+      keys.push_back(range.left_key);
+    }
+    rc = index_->get_entries(keys, rids_, &rid_offsets_);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get index entries. rc=%s", strrc(rc));
+      return rc;
+    }
+  } else if (!key_ranges_.empty()) {
+    IndexScanner *index_scanner = index_->create_scanner(key_ranges_);
+    if (nullptr == index_scanner) {
+      LOG_WARN("failed to create index scanner");
+      return RC::INTERNAL;
+    }
+    index_scanner_ = index_scanner;
+  }
+
+  sorted_fetch_ = false;
+  if (bitmap_fetch_) {
+    rc = prepare_bitmap_fetch();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to prepare bitmap fetch. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
 
   tuple_.set_schema(table_, table_->table_meta().field_metas());
 
+  if (index_only_) {
+    // 不在索引中的字段不会被用到，保持为0
+    index_record_data_.assign(table_->table_meta().record_size(), 0);
+    index_record_.set_data(index_record_data_.data(), static_cast<int>(index_record_data_.size()));
+    not_all_visible_pages_.clear();
+  }
+
   trx_ = trx;
   return RC::SUCCESS;
 }
@@ -116,8 +419,25 @@ RC IndexScanPhysicalOperator::next()
   RC  rc = RC::SUCCESS;
 
   bool filter_result = false;
-  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
-    rc = record_handler_->get_record(rid, current_record_);
+  while (RC::SUCCESS == (rc = next_rid(rid))) {
+    if (index_only_ && is_page_all_visible(rid.page_num)) {
+      fill_index_record();
+      index_record_.set_rid(rid);
+      tuple_.set_record(&index_record_);
+      rc = filter(tuple_, filter_result);
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("failed to filter record. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      if (filter_result) {
+        return rc;
+      }
+      continue;
+    }
+
+    Record *record = nullptr;
+    rc             = fetch_record(rid, record);
     if (OB_FAIL(rc)) {
       LOG_TRACE("failed to get record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
       return rc;
@@ -125,7 +445,7 @@ RC IndexScanPhysicalOperator::next()
 
     LOG_TRACE("got a record. rid=%s", rid.to_string().c_str());
 
-    tuple_.set_record(&current_record_);
+    tuple_.set_record(record);
     rc = filter(tuple_, filter_result);
     if (OB_FAIL(rc)) {
       LOG_TRACE("failed to filter record. rc=%s", strrc(rc));
@@ -137,7 +457,7 @@ RC IndexScanPhysicalOperator::next()
       continue;
     }
 
-    rc = trx_->visit_record(table_, current_record_, mode_);
+    rc = trx_->visit_record(table_, *record, mode_);
     if (rc == RC::RECORD_INVISIBLE) {
       LOG_TRACE("record invisible");
       continue;
@@ -151,14 +471,134 @@ RC IndexScanPhysicalOperator::next()
 
 RC IndexScanPhysicalOperator::close()
 {
-  index_scanner_->destroy();
-  index_scanner_ = nullptr;
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+  rids_.clear();
+  rid_offsets_.clear();
+  rid_index_ = 0;
+  not_all_visible_pages_.clear();
+  page_records_.clear();
+  return RC::SUCCESS;
+}
+
+RC IndexScanPhysicalOperator::next_rid(RID &rid)
+{
+  if (index_scanner_ != nullptr) {
+    return index_scanner_->next_entry(&rid);
+  }
+
+  if (rid_index_ >= rids_.size()) {
+    return RC::RECORD_EOF;
+  }
+  while (key_index_ + 1 < rid_offsets_.size() && rid_offsets_[key_index_ + 1] <= static_cast<int>(rid_index_)) {
+    key_index_++;
+  }
+  rid = rids_[rid_index_++];
+  return RC::SUCCESS;
+}
+
+RC IndexScanPhysicalOperator::prepare_bitmap_fetch()
+{
+  RC rc = RC::SUCCESS;
+  if (index_scanner_ != nullptr) {
+    RID rid;
+    while (OB_SUCC(rc = index_scanner_->next_entry(&rid))) {
+      rids_.push_back(rid);
+    }
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to get next index entry. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+
+  // 按照每个页面都放满记录来估计表中的记录数
+  const int    record_size    = table_->table_meta().record_size();
+  const double estimated_rows = static_cast<double>(record_handler_->page_count()) * (BP_PAGE_DATA_SIZE / record_size);
+  const size_t rid_num        = rids_.size();
+  if (rid_num < BITMAP_FETCH_MIN_RIDS || rid_num < estimated_rows * BITMAP_FETCH_SELECTIVITY) {
+    return RC::SUCCESS;
+  }
+
+  LOG_TRACE("fetch records sorted by rid. rid num=%d, estimated rows=%.0f", static_cast<int>(rid_num), estimated_rows);
+  sort(rids_.begin(), rids_.end(), [](const RID &rid1, const RID &rid2) { return RID::compare(&rid1, &rid2) < 0; });
+  rid_offsets_.clear();
+  sorted_fetch_ = true;
+  page_begin_   = 0;
+  page_end_     = 0;
   return RC::SUCCESS;
 }
 
+RC IndexScanPhysicalOperator::fetch_record(const RID &rid, Record *&record)
+{
+  if (!sorted_fetch_) {
+    record = &current_record_;
+    return record_handler_->get_record(rid, current_record_);
+  }
+
+  const int    record_size = table_->table_meta().record_size();
+  const size_t index       = rid_index_ - 1;
+  if (index >= page_end_) {
+    page_begin_ = index;
+    page_end_   = index + 1;
+    while (page_end_ < rids_.size() && rids_[page_end_].page_num == rid.page_num) {
+      page_end_++;
+    }
+
+    RC rc = record_handler_->get_records(
+        span<const RID>(rids_.data() + page_begin_, page_end_ - page_begin_), record_size, page_records_);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  page_record_.set_data(page_records_.data() + (index - page_begin_) * record_size, record_size);
+  page_record_.set_rid(rid);
+  record = &page_record_;
+  return RC::SUCCESS;
+}
+
+bool IndexScanPhysicalOperator::is_page_all_visible(PageNum page_num)
+{
+  // 只记住不是全部可见的页面。全部可见的页面上的记录随时可能被修改，每次都要再问一下事务
+  if (not_all_visible_pages_.count(page_num) > 0) {
+    return false;
+  }
+
+  if (trx_->is_page_all_visible(table_, page_num)) {
+    return true;
+  }
+  not_all_visible_pages_.insert(page_num);
+  return false;
+}
+
+void IndexScanPhysicalOperator::fill_index_record()
+{
+  char *data = index_record_data_.data();
+  if (index_scanner_ != nullptr) {
+    // 扫描器返回的键值中，各个字段的值依次存放
+    const char *key    = index_scanner_->current_key();
+    int         offset = 0;
+    for (const FieldMeta &field_meta : index_->field_metas()) {
+      memcpy(data + field_meta.offset(), key + offset, field_meta.len());
+      offset += field_meta.len();
+    }
+  } else {
+    // 等值查询的键值就是记录的格式
+    const char *key = key_ranges_[key_index_].left_key;
+    for (const FieldMeta &field_meta : index_->field_metas()) {
+      memcpy(data + field_meta.offset(), key + field_meta.offset(), field_meta.len());
+    }
+  }
+}
+
 Tuple *IndexScanPhysicalOperator::current_tuple()
 {
-  tuple_.set_record(&current_record_);
+  // next 中已经设置好了 tuple_ 对应的记录，可能是读取的记录，也可能是用键值构造的记录
   return &tuple_;
 }
 
@@ -190,5 +630,9 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 
 std::string IndexScanPhysicalOperator::param() const
 {
-  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+  std::string param = std::string(index_->index_meta().name()) + " ON " + table_->name();
+  if (index_only_) {
+    param += ", INDEX ONLY";
+  }
+  return param;
 }
@@ -14,21 +14,46 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/unordered_set.h"
 #include "sql/expr/tuple.h"
 #include "sql/operator/physical_operator.h"
+#include "storage/index/index.h"
 #include "storage/record/record_manager.h"
 
+/**
+ * @brief 索引字段上的一个比较条件
+ * @ingroup PhysicalOperator
+ * @details 比较的值来自谓词中的常量表达式。执行计划被缓存复用时常量会被替换，所以每次 open 时才计算扫描范围
+ */
+struct IndexKeyCondition
+{
+  CompOp           comp  = NO_OP;    ///< 字段在左边、常量在右边时的比较操作
+  const ValueExpr *value = nullptr;  ///< 常量，属于谓词表达式
+};
+
+/**
+ * @brief 索引一个字段上的所有条件
+ * @ingroup PhysicalOperator
+ * @details 每个元素是一组 OR 起来的条件，元素之间是 AND 关系。比如 a in (1, 5) and a < 3 表示为 {{a=1, a=5}, {a<3}}
+ */
+using IndexColumnConditions = std::vector<std::vector<IndexKeyCondition>>;
+
 /**
  * @brief 索引扫描物理算子
  * @ingroup PhysicalOperator
+ * @details 根据索引前几个字段上的条件计算出一组有序、互不重叠的键值范围，用一个扫描器依次扫描。
+ * 所有字段都是等值条件时，使用索引的批量查找接口。
+ * 查询用到的字段都在索引中时可以只扫描索引，记录所在的页面对当前事务全部可见时直接用键值构造记录，不再读取记录。
+ * 扫描到的记录很多时，可以先取出所有的 RID，按照 RID 排序以后逐页读取记录，每个页面只访问一次
  */
 class IndexScanPhysicalOperator : public PhysicalOperator
 {
 public:
-  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const std::vector<Value> &left_value,
-      bool left_inclusive, const std::vector<Value> &right_value, bool right_inclusive);
-  IndexScanPhysicalOperator(Table *table, Index *index, ReadWriteMode mode, const Value *left_value,
-      bool left_inclusive, const Value *right_value, bool right_inclusive);
+  /**
+   * @param column_conditions 索引前几个字段上的条件。除了最后一个字段，其它字段上都需要有等值条件
+   */
+  IndexScanPhysicalOperator(
+      Table *table, Index *index, ReadWriteMode mode, std::vector<IndexColumnConditions> column_conditions);
   virtual ~IndexScanPhysicalOperator() = default;
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_SCAN; }
@@ -40,11 +65,56 @@ public:
   RC close() override;
 
   Tuple *current_tuple() override;
-  RC make_data(const std::vector<Value> &values, std::vector<FieldMeta> &meta, Table *table, Record &out);
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 只扫描索引
+   * @details 只有查询用到的字段都在索引中，并且是只读的查询时才可以设置。构造的记录中不在索引中的字段都是0
+   */
+  void set_index_only(bool index_only) { index_only_ = index_only; }
+  bool index_only() const { return index_only_; }
+
+  /**
+   * @brief 允许按照 RID 排序以后逐页读取记录
+   * @details 是否真的排序在 open 时根据找到的 RID 个数决定。排序后返回记录的顺序不再是索引的顺序
+   */
+  void set_bitmap_fetch(bool bitmap_fetch) { bitmap_fetch_ = bitmap_fetch; }
+
+  /// 多个字段的 IN 列表组合起来的范围超过这个数量时，后面的字段就不再用来缩小扫描范围
+  static constexpr size_t MAX_SCAN_RANGES = 4096;
+
+  /// RID 至少有这么多，并且估计的选择率不低于 BITMAP_FETCH_SELECTIVITY 时，才按照 RID 排序后逐页读取记录
+  static constexpr size_t BITMAP_FETCH_MIN_RIDS    = 256;
+  static constexpr double BITMAP_FETCH_SELECTIVITY = 0.01;
+
 private:
+  /**
+   * @brief 根据条件中常量当前的值生成扫描范围
+   * @param[out] point_lookup 是否每个范围都是索引所有字段上的一个确定的值
+   */
+  RC make_key_ranges(bool &point_lookup);
+
+  /// 从扫描器或者批量查找的结果中取下一个 RID
+  RC next_rid(RID &rid);
+
+  /// 只扫描索引时，记录所在的页面是否对当前事务全部可见，不可见的页面在一次扫描中只检查一次
+  bool is_page_all_visible(PageNum page_num);
+
+  /// 把当前 RID 对应的键值复制到 index_record_ 中
+  void fill_index_record();
+
+  /**
+   * @brief 取出扫描器中所有的 RID，找到的记录足够多时按照 RID 排序
+   */
+  RC prepare_bitmap_fetch();
+
+  /**
+   * @brief 读取 next_rid 刚返回的 RID 对应的记录
+   * @details 排过序时，一次读取同一个页面上所有要读取的记录
+   */
+  RC fetch_record(const RID &rid, Record *&record);
+
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
@@ -59,12 +129,26 @@ private:
   Record   current_record_;
   RowTuple tuple_;
 
-  std::vector<char> left_value_;
-  std::vector<char> right_value_;
-  int               left_len_;
-  int               right_len_;
-  bool              left_inclusive_  = false;
-  bool              right_inclusive_ = false;
+  std::vector<IndexColumnConditions> column_conditions_;
+  std::vector<char>                  key_buffer_;  ///< 所有范围边界的键值，每个键值是一条记录的大小
+  std::vector<IndexKeyRange>         key_ranges_;  ///< 指向 key_buffer_ 中的键值
+
+  std::vector<RID> rids_;           ///< 等值查询时一次取出的 RID
+  std::vector<int> rid_offsets_;    ///< 第i个键值找到的是 rids_[rid_offsets_[i], rid_offsets_[i+1])
+  size_t           rid_index_ = 0;  ///< 下一个要返回的 rids_ 的下标
+  size_t           key_index_ = 0;  ///< 上一个返回的 RID 对应的键值
+
+  bool                        index_only_ = false;
+  std::vector<char>           index_record_data_;      ///< 用键值构造的记录
+  Record                      index_record_;           ///< 指向 index_record_data_
+  std::unordered_set<PageNum> not_all_visible_pages_;  ///< 本次扫描中已经检查过，不是全部可见的页面
+
+  bool              bitmap_fetch_ = false;  ///< 是否允许按照 RID 排序后逐页读取记录
+  bool              sorted_fetch_ = false;  ///< 本次扫描的 rids_ 是否已经按照 RID 排序
+  size_t            page_begin_   = 0;      ///< 当前页面的记录在 rids_ 中的范围 [page_begin_, page_end_)
+  size_t            page_end_     = 0;
+  std::vector<char> page_records_;          ///< 从当前页面中读取的记录
+  Record            page_record_;           ///< 指向 page_records_ 中的一条记录
 
   std::vector<std::unique_ptr<Expression>> predicates_;
 };
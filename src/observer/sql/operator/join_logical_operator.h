@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
  * @brief 连接算子
  * @ingroup LogicalOperator
  * @details 连接算子，用于连接两个表。对应的物理算子或者实现，可能有NestedLoopJoin，HashJoin等等。
+ * expressions_ 中存放的是等值连接条件（由 JoinPredicatePushdownRewriter 下推），每个都是 EQUAL_TO 的
+ * ComparisonExpr，左边的表达式从左孩子中取值，右边的表达式从右孩子中取值。有等值条件时会生成HashJoin。
  */
 class JoinLogicalOperator : public LogicalOperator
 {
@@ -25,6 +25,8 @@ bool LogicalOperator::can_generate_vectorized_operator(const LogicalOperatorType
     case LogicalOperatorType::CALC:
     case LogicalOperatorType::DELETE:
     case LogicalOperatorType::INSERT:
+    case LogicalOperatorType::PREDICATE:
+    case LogicalOperatorType::UPDATE:
         bool_ret = false;
         break;
     
@@ -35,3 +37,34 @@ bool LogicalOperator::can_generate_vectorized_operator(const LogicalOperatorType
     return bool_ret;
 }
 
+
+bool LogicalOperator::can_generate_vectorized_operator(LogicalOperator &oper)
+{
+  if (!can_generate_vectorized_operator(oper.type())) {
+    return false;
+  }
+
+  // 只有等值连接可以使用向量化的 hash join，连接键两边的类型和长度需要一致，才能按照内存直接比较
+  if (oper.type() == LogicalOperatorType::JOIN) {
+    if (oper.expressions().empty()) {
+      return false;
+    }
+    for (std::unique_ptr<Expression> &expr : oper.expressions()) {
+      if (expr->type() != ExprType::COMPARISON) {
+        return false;
+      }
+      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+      if (comparison_expr->left()->value_type() != comparison_expr->right()->value_type() ||
+          comparison_expr->left()->value_length() != comparison_expr->right()->value_length()) {
+        return false;
+      }
+    }
+  }
+
+  for (std::unique_ptr<LogicalOperator> &child : oper.children()) {
+    if (!can_generate_vectorized_operator(*child)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -61,6 +61,12 @@ public:
   std::vector<std::unique_ptr<Expression>>      &expressions() { return expressions_; }
   static bool                                    can_generate_vectorized_operator(const LogicalOperatorType &type);
 
+  /**
+   * @brief 检查整棵逻辑计划树是否都可以生成向量化算子
+   * @details 只要有一个算子不支持，整个计划就只能使用火山模型执行
+   */
+  static bool can_generate_vectorized_operator(LogicalOperator &oper);
+
 protected:
   std::vector<std::unique_ptr<LogicalOperator>> children_;  ///< 子算子
 
@@ -20,6 +20,8 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
     case PhysicalOperatorType::TABLE_SCAN: return "TABLE_SCAN";
     case PhysicalOperatorType::INDEX_SCAN: return "INDEX_SCAN";
     case PhysicalOperatorType::NESTED_LOOP_JOIN: return "NESTED_LOOP_JOIN";
+    case PhysicalOperatorType::HASH_JOIN: return "HASH_JOIN";
+    case PhysicalOperatorType::HASH_JOIN_VEC: return "HASH_JOIN_VEC";
     case PhysicalOperatorType::EXPLAIN: return "EXPLAIN";
     case PhysicalOperatorType::PREDICATE: return "PREDICATE";
     case PhysicalOperatorType::INSERT: return "INSERT";
@@ -27,6 +29,7 @@ std::string physical_operator_type_name(PhysicalOperatorType type)
     case PhysicalOperatorType::UPDATE: return "UPDATE";
     case PhysicalOperatorType::PROJECT: return "PROJECT";
     case PhysicalOperatorType::STRING_LIST: return "STRING_LIST";
+    case PhysicalOperatorType::CACHED_RESULT: return "CACHED_RESULT";
     case PhysicalOperatorType::HASH_GROUP_BY: return "HASH_GROUP_BY";
     case PhysicalOperatorType::SCALAR_GROUP_BY: return "SCALAR_GROUP_BY";
     case PhysicalOperatorType::AGGREGATE_VEC: return "AGGREGATE_VEC";
@@ -41,6 +41,8 @@ enum class PhysicalOperatorType
   TABLE_SCAN_VEC,
   INDEX_SCAN,
   NESTED_LOOP_JOIN,
+  HASH_JOIN,
+  HASH_JOIN_VEC,
   EXPLAIN,
   PREDICATE,
   PREDICATE_VEC,
@@ -48,6 +50,7 @@ enum class PhysicalOperatorType
   PROJECT_VEC,
   CALC,
   STRING_LIST,
+  CACHED_RESULT,
   DELETE,
   INSERT,
   UPDATE,
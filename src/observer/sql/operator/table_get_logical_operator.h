@@ -37,11 +37,22 @@ public:
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
   auto predicates() -> std::vector<std::unique_ptr<Expression>> & { return predicates_; }
 
+  /**
+   * @brief 设置查询中用到的这张表的所有字段
+   * @details 由优化阶段收集，生成物理计划时用来判断能不能只扫描索引。没有设置过表示不知道用到了哪些字段
+   */
+  void set_referenced_fields(std::vector<const FieldMeta *> fields);
+  bool referenced_fields_known() const { return referenced_fields_known_; }
+  const std::vector<const FieldMeta *> &referenced_fields() const { return referenced_fields_; }
+
 private:
   Table        *table_ = nullptr;
   ReadWriteMode mode_  = ReadWriteMode::READ_WRITE;
   std::vector<Field> fields_;
 
+  bool                           referenced_fields_known_ = false;
+  std::vector<const FieldMeta *> referenced_fields_;
+
   // 与当前表相关的过滤操作，可以尝试在遍历数据时执行
   // 这里的表达式都是比较简单的比较运算，并且左右两边都是取字段表达式或值表达式
   // 不包含复杂的表达式运算，比如加减乘除、或者conjunction expression
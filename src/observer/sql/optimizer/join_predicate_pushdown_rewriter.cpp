@@ -0,0 +1,146 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/join_predicate_pushdown_rewriter.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+
+using namespace std;
+
+RC JoinPredicatePushdownRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  RC rc = RC::SUCCESS;
+  if (oper->type() != LogicalOperatorType::PREDICATE) {
+    return rc;
+  }
+
+  if (oper->children().size() != 1) {
+    return rc;
+  }
+
+  unique_ptr<LogicalOperator> &child_oper = oper->children().front();
+  if (child_oper->type() != LogicalOperatorType::JOIN) {
+    return rc;
+  }
+
+  vector<unique_ptr<Expression>> &predicate_oper_exprs = oper->expressions();
+  if (predicate_oper_exprs.size() != 1) {
+    return rc;
+  }
+
+  unique_ptr<Expression> &predicate_expr = predicate_oper_exprs.front();
+  if (predicate_expr->type() == ExprType::COMPARISON) {
+    change_made = try_pushdown(predicate_expr, *child_oper);
+  } else if (predicate_expr->type() == ExprType::CONJUNCTION) {
+    auto conjunction_expr = static_cast<ConjunctionExpr *>(predicate_expr.get());
+    if (conjunction_expr->conjunction_type() != ConjunctionExpr::Type::AND) {
+      return rc;
+    }
+
+    vector<unique_ptr<Expression>> &child_exprs = conjunction_expr->children();
+    for (auto iter = child_exprs.begin(); iter != child_exprs.end();) {
+      if (try_pushdown(*iter, *child_oper)) {
+        change_made = true;
+        iter        = child_exprs.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+
+    if (child_exprs.empty()) {
+      predicate_expr.reset();
+    }
+  }
+
+  if (!predicate_expr) {
+    LOG_TRACE("all expressions of predicate operator were pushdown to join operator, then make a fake one");
+    Value value((bool)true);
+    predicate_expr = unique_ptr<Expression>(new ValueExpr(value));
+  }
+  return rc;
+}
+
+bool JoinPredicatePushdownRewriter::try_pushdown(unique_ptr<Expression> &expr, LogicalOperator &join_oper)
+{
+  if (expr->type() != ExprType::COMPARISON) {
+    return false;
+  }
+
+  auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+  if (comparison_expr->comp() != EQUAL_TO) {
+    return false;
+  }
+
+  unique_ptr<Expression> &left_expr  = comparison_expr->left();
+  unique_ptr<Expression> &right_expr = comparison_expr->right();
+  if (left_expr->type() != ExprType::FIELD || right_expr->type() != ExprType::FIELD) {
+    return false;
+  }
+
+  // 类型不同时计划生成阶段会加上cast表达式，这里只处理两边类型一致的情况，避免hash值不一致
+  if (left_expr->value_type() != right_expr->value_type()) {
+    return false;
+  }
+
+  const Table *left_table  = static_cast<FieldExpr *>(left_expr.get())->field().table();
+  const Table *right_table = static_cast<FieldExpr *>(right_expr.get())->field().table();
+
+  LogicalOperator *current = &join_oper;
+  while (current->type() == LogicalOperatorType::JOIN && current->children().size() == 2) {
+    unordered_set<const Table *> left_tables;
+    unordered_set<const Table *> right_tables;
+    collect_tables(*current->children()[0], left_tables);
+    collect_tables(*current->children()[1], right_tables);
+
+    const bool left_in_left   = left_tables.count(left_table) > 0;
+    const bool left_in_right  = right_tables.count(left_table) > 0;
+    const bool right_in_left  = left_tables.count(right_table) > 0;
+    const bool right_in_right = right_tables.count(right_table) > 0;
+
+    // 同一张表出现在两边（自连接）时无法区分字段来自哪一边
+    if ((left_in_left && left_in_right) || (right_in_left && right_in_right)) {
+      return false;
+    }
+
+    if (left_in_left && right_in_right) {
+      current->expressions().emplace_back(std::move(expr));
+      return true;
+    }
+
+    if (left_in_right && right_in_left) {
+      std::swap(left_expr, right_expr);
+      current->expressions().emplace_back(std::move(expr));
+      return true;
+    }
+
+    if (left_in_left && right_in_left) {
+      current = current->children()[0].get();
+    } else if (left_in_right && right_in_right) {
+      current = current->children()[1].get();
+    } else {
+      return false;
+    }
+  }
+  return false;
+}
+
+void JoinPredicatePushdownRewriter::collect_tables(LogicalOperator &oper, unordered_set<const Table *> &tables)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    tables.insert(static_cast<TableGetLogicalOperator &>(oper).table());
+    return;
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    collect_tables(*child, tables);
+  }
+}
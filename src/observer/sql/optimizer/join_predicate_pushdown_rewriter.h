@@ -0,0 +1,43 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+#include "sql/optimizer/rewrite_rule.h"
+
+class Table;
+
+/**
+ * @brief 将连接条件下推到连接算子中
+ * @ingroup Rewriter
+ * @details 把predicate算子中形如 t1.a = t2.b 的等值条件，下推到能够区分t1和t2的最低一层join算子上，
+ * 这样物理计划生成时就可以根据这些等值条件选择HashJoin，而不是嵌套循环连接。
+ * 下推后的比较表达式，左边一定来自join的左孩子，右边一定来自join的右孩子。
+ */
+class JoinPredicatePushdownRewriter : public RewriteRule
+{
+public:
+  JoinPredicatePushdownRewriter()          = default;
+  virtual ~JoinPredicatePushdownRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  /**
+   * @brief 尝试把一个等值比较表达式下推到join树中
+   * @return 下推成功时返回true，此时expr已经被移走
+   */
+  bool try_pushdown(std::unique_ptr<Expression> &expr, LogicalOperator &join_oper);
+
+  void collect_tables(LogicalOperator &oper, std::unordered_set<const Table *> &tables);
+};
@@ -211,6 +211,22 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
     const FilterObj &filter_obj_left  = filter_unit->left();
     const FilterObj &filter_obj_right = filter_unit->right();
 
+    if (filter_unit->comp() == IN_OP) {
+      // a IN (x, y) 展开成 a = x OR a = y，IN 的左边只能是字段
+      std::vector<unique_ptr<Expression>> eq_exprs;
+      for (const Value &value : filter_obj_right.values) {
+        unique_ptr<Expression> eq_expr;
+        rc = create_comparison_expr(
+            EQUAL_TO, make_unique<FieldExpr>(filter_obj_left.field), make_unique<ValueExpr>(value), eq_expr);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        eq_exprs.emplace_back(std::move(eq_expr));
+      }
+      cmp_exprs.emplace_back(new ConjunctionExpr(ConjunctionExpr::Type::OR, eq_exprs));
+      continue;
+    }
+
     unique_ptr<Expression> left(filter_obj_left.is_attr
                                     ? static_cast<Expression *>(new FieldExpr(filter_obj_left.field))
                                     : static_cast<Expression *>(new ValueExpr(filter_obj_left.value)));
@@ -219,45 +235,12 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
                                      ? static_cast<Expression *>(new FieldExpr(filter_obj_right.field))
                                      : static_cast<Expression *>(new ValueExpr(filter_obj_right.value)));
 
-    if (left->value_type() != right->value_type()) {
-      auto left_to_right_cost = implicit_cast_cost(left->value_type(), right->value_type());
-      auto right_to_left_cost = implicit_cast_cost(right->value_type(), left->value_type());
-      if (left_to_right_cost <= right_to_left_cost && left_to_right_cost != INT32_MAX) {
-        ExprType left_type = left->type();
-        auto     cast_expr = make_unique<CastExpr>(std::move(left), right->value_type());
-        if (left_type == ExprType::VALUE) {
-          Value left_val;
-          if (OB_FAIL(rc = cast_expr->try_get_value(left_val))) {
-            LOG_WARN("failed to get value from left child", strrc(rc));
-            return rc;
-          }
-          left = make_unique<ValueExpr>(left_val);
-        } else {
-          left = std::move(cast_expr);
-        }
-      } else if (right_to_left_cost < left_to_right_cost && right_to_left_cost != INT32_MAX) {
-        ExprType right_type = right->type();
-        auto     cast_expr  = make_unique<CastExpr>(std::move(right), left->value_type());
-        if (right_type == ExprType::VALUE) {
-          Value right_val;
-          if (OB_FAIL(rc = cast_expr->try_get_value(right_val))) {
-            LOG_WARN("failed to get value from right child", strrc(rc));
-            return rc;
-          }
-          right = make_unique<ValueExpr>(right_val);
-        } else {
-          right = std::move(cast_expr);
-        }
-
-      } else {
-        rc = RC::UNSUPPORTED;
-        LOG_WARN("unsupported cast from %s to %s", attr_type_to_string(left->value_type()), attr_type_to_string(right->value_type()));
-        return rc;
-      }
+    unique_ptr<Expression> cmp_expr;
+    rc = create_comparison_expr(filter_unit->comp(), std::move(left), std::move(right), cmp_expr);
+    if (OB_FAIL(rc)) {
+      return rc;
     }
-
-    ComparisonExpr *cmp_expr = new ComparisonExpr(filter_unit->comp(), std::move(left), std::move(right));
-    cmp_exprs.emplace_back(cmp_expr);
+    cmp_exprs.emplace_back(std::move(cmp_expr));
   }
 
   unique_ptr<PredicateLogicalOperator> predicate_oper;
@@ -270,6 +253,51 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
   return rc;
 }
 
+RC LogicalPlanGenerator::create_comparison_expr(
+    CompOp comp, unique_ptr<Expression> left, unique_ptr<Expression> right, unique_ptr<Expression> &comparison_expr)
+{
+  RC rc = RC::SUCCESS;
+  if (left->value_type() != right->value_type()) {
+    auto left_to_right_cost = implicit_cast_cost(left->value_type(), right->value_type());
+    auto right_to_left_cost = implicit_cast_cost(right->value_type(), left->value_type());
+    if (left_to_right_cost <= right_to_left_cost && left_to_right_cost != INT32_MAX) {
+      ExprType left_type = left->type();
+      auto     cast_expr = make_unique<CastExpr>(std::move(left), right->value_type());
+      if (left_type == ExprType::VALUE) {
+        Value left_val;
+        if (OB_FAIL(rc = cast_expr->try_get_value(left_val))) {
+          LOG_WARN("failed to get value from left child", strrc(rc));
+          return rc;
+        }
+        left = make_unique<ValueExpr>(left_val);
+      } else {
+        left = std::move(cast_expr);
+      }
+    } else if (right_to_left_cost < left_to_right_cost && right_to_left_cost != INT32_MAX) {
+      ExprType right_type = right->type();
+      auto     cast_expr  = make_unique<CastExpr>(std::move(right), left->value_type());
+      if (right_type == ExprType::VALUE) {
+        Value right_val;
+        if (OB_FAIL(rc = cast_expr->try_get_value(right_val))) {
+          LOG_WARN("failed to get value from right child", strrc(rc));
+          return rc;
+        }
+        right = make_unique<ValueExpr>(right_val);
+      } else {
+        right = std::move(cast_expr);
+      }
+
+    } else {
+      rc = RC::UNSUPPORTED;
+      LOG_WARN("unsupported cast from %s to %s", attr_type_to_string(left->value_type()), attr_type_to_string(right->value_type()));
+      return rc;
+    }
+  }
+
+  comparison_expr = make_unique<ComparisonExpr>(comp, std::move(left), std::move(right));
+  return rc;
+}
+
 int LogicalPlanGenerator::implicit_cast_cost(AttrType from, AttrType to)
 {
   if (from == to) {
@@ -29,6 +29,7 @@ class DeleteStmt;
 class UpdateStmt;
 class ExplainStmt;
 class LogicalOperator;
+class Expression;
 
 class LogicalPlanGenerator
 {
@@ -49,5 +50,11 @@ private:
 
   RC create_group_by_plan(SelectStmt *select_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
 
+  /**
+   * @brief 创建比较表达式，两边类型不同时按照代价较小的方向做隐式类型转换
+   */
+  RC create_comparison_expr(CompOp comp, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right,
+      std::unique_ptr<Expression> &comparison_expr);
+
   int implicit_cast_cost(AttrType from, AttrType to);
 };
\ No newline at end of file
@@ -19,16 +19,89 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/conf/ini.h"
 #include "common/io/io.h"
+#include "common/lang/map.h"
+#include "common/lang/set.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "event/session_event.h"
 #include "event/sql_event.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/operator/group_by_logical_operator.h"
 #include "sql/operator/logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "sql/plan_cache/plan_cache_stage.h"
 #include "sql/stmt/stmt.h"
 
 using namespace std;
 using namespace common;
 
+namespace {
+
+using TableFields = map<const Table *, set<const FieldMeta *>>;
+
+/**
+ * @brief 收集表达式中用到的字段
+ * @return 遇到没有绑定的字段或者星号时返回 false，表示不能确定用到了哪些字段
+ */
+bool collect_expression_fields(Expression &expr, TableFields &table_fields)
+{
+  switch (expr.type()) {
+    case ExprType::FIELD: {
+      const Field &field = static_cast<FieldExpr &>(expr).field();
+      table_fields[field.table()].insert(field.meta());
+      return true;
+    }
+    case ExprType::STAR:
+    case ExprType::UNBOUND_FIELD:
+    case ExprType::UNBOUND_AGGREGATION: {
+      return false;
+    }
+    default: break;
+  }
+
+  bool known = true;
+  ExpressionIterator::iterate_child_expr(expr, [&table_fields, &known](unique_ptr<Expression> &child) {
+    known = known && collect_expression_fields(*child, table_fields);
+    return RC::SUCCESS;
+  });
+  return known;
+}
+
+/**
+ * @brief 收集整个逻辑计划中用到的字段，同时记下所有取表数据的算子
+ */
+bool collect_plan_fields(
+    LogicalOperator &oper, TableFields &table_fields, vector<TableGetLogicalOperator *> &table_get_opers)
+{
+  bool known = true;
+  for (unique_ptr<Expression> &expr : oper.expressions()) {
+    known = known && collect_expression_fields(*expr, table_fields);
+  }
+
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    auto &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+    table_get_opers.push_back(&table_get_oper);
+    for (unique_ptr<Expression> &expr : table_get_oper.predicates()) {
+      known = known && collect_expression_fields(*expr, table_fields);
+    }
+  } else if (oper.type() == LogicalOperatorType::GROUP_BY) {
+    auto &group_by_oper = static_cast<GroupByLogicalOperator &>(oper);
+    for (unique_ptr<Expression> &expr : group_by_oper.group_by_expressions()) {
+      known = known && collect_expression_fields(*expr, table_fields);
+    }
+    for (Expression *expr : group_by_oper.aggregate_expressions()) {
+      known = known && collect_expression_fields(*expr, table_fields);
+    }
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    known = known && collect_plan_fields(*child, table_fields, table_get_opers);
+  }
+  return known;
+}
+
+}  // namespace
+
 RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
 {
   unique_ptr<LogicalOperator> logical_operator;
@@ -55,6 +128,13 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
     return rc;
   }
 
+  // 物理计划会接管逻辑计划中的表达式，先记录下常量的位置，计划缓存时用来替换参数
+  rc = PlanCacheStage::collect_plan_values(*logical_operator, sql_event->plan_values());
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to collect values in plan. rc=%s", strrc(rc));
+    return rc;
+  }
+
   unique_ptr<PhysicalOperator> physical_operator;
   rc = generate_physical_plan(logical_operator, physical_operator, sql_event->session_event()->session());
   if (rc != RC::SUCCESS) {
@@ -62,6 +142,7 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
     return rc;
   }
 
+  sql_event->set_logical_operator(std::move(logical_operator));
   sql_event->set_operator(std::move(physical_operator));
 
   return rc;
@@ -69,7 +150,17 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
 
 RC OptimizeStage::optimize(unique_ptr<LogicalOperator> &oper)
 {
-  // do nothing
+  // 记下每张表用到的字段，用到的字段都在索引中时，生成物理计划时可以只扫描索引
+  TableFields                       table_fields;
+  vector<TableGetLogicalOperator *> table_get_opers;
+  if (!collect_plan_fields(*oper, table_fields, table_get_opers)) {
+    return RC::SUCCESS;
+  }
+
+  for (TableGetLogicalOperator *table_get_oper : table_get_opers) {
+    const set<const FieldMeta *> &fields = table_fields[table_get_oper->table()];
+    table_get_oper->set_referenced_fields(vector<const FieldMeta *>(fields.begin(), fields.end()));
+  }
   return RC::SUCCESS;
 }
 
@@ -78,7 +169,7 @@ RC OptimizeStage::generate_physical_plan(
 {
   RC rc = RC::SUCCESS;
   if (session->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR &&
-      LogicalOperator::can_generate_vectorized_operator(logical_operator->type())) {
+      LogicalOperator::can_generate_vectorized_operator(*logical_operator)) {
     LOG_INFO("use chunk iterator");
     session->set_used_chunk_mode(true);
     rc = physical_plan_generator_.create_vec(*logical_operator, physical_operator);
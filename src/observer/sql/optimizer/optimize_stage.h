@@ -59,7 +59,7 @@ private:
 
   /**
    * @brief 优化逻辑计划
-   * @details 当前什么都没做。可以增加每个逻辑计划的代价模型，然后根据代价模型进行优化。
+   * @details 当前只收集每张表用到的字段，供生成物理计划时选择只扫描索引。可以增加每个逻辑计划的代价模型，然后根据代价模型进行优化。
    * @param logical_operator 需要优化的逻辑计划
    */
   RC optimize(std::unique_ptr<LogicalOperator> &logical_operator);
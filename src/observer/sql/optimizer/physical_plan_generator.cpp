@@ -14,9 +14,12 @@ See the Mulan PSL v2 for more details. */
 
 #include <utility>
 
+#include "common/lang/algorithm.h"
+#include "common/lang/map.h"
 #include "common/log/log.h"
 #include "common/rc.h"
 #include "sql/expr/expression.h"
+#include "sql/expr/expression_iterator.h"
 #include "sql/operator/aggregate_vec_physical_operator.h"
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/calc_physical_operator.h"
@@ -26,6 +29,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/explain_physical_operator.h"
 #include "sql/operator/expr_vec_physical_operator.h"
 #include "sql/operator/group_by_vec_physical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
+#include "sql/operator/hash_join_vec_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/insert_physical_operator.h"
@@ -45,12 +50,201 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/table_scan_vec_physical_operator.h"
 #include "sql/operator/update_logical_operator.h"
 #include "sql/operator/update_physical_operator.h"
+#include "session/session.h"
 #include "storage/index/index.h"
+#include "storage/table/table.h"
 #include "sql/optimizer/physical_plan_generator.h"
 
 using namespace std;
 class Index;
 
+namespace {
+
+/// 向量化算子输出的一列，由所属的表和字段id确定
+using VecColumnLayout = vector<pair<const Table *, int>>;
+
+/**
+ * @brief 计算向量化算子输出chunk中每一列对应的字段
+ * @details 表扫描输出表中的所有字段（包括系统字段），join输出左孩子的所有列再加上右孩子的所有列
+ */
+bool collect_vec_output_layout(LogicalOperator &oper, VecColumnLayout &layout)
+{
+  switch (oper.type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      const Table     *table      = static_cast<TableGetLogicalOperator &>(oper).table();
+      const TableMeta &table_meta = table->table_meta();
+      for (int i = 0; i < table_meta.field_num(); i++) {
+        layout.emplace_back(table, table_meta.field(i)->field_id());
+      }
+      return true;
+    }
+    case LogicalOperatorType::JOIN: {
+      for (unique_ptr<LogicalOperator> &child : oper.children()) {
+        if (!collect_vec_output_layout(*child, layout)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+/**
+ * @brief 把表达式中的字段绑定到下层算子输出chunk中的列上
+ * @details 聚合表达式的 pos 表示聚合结果的位置，所以只绑定它的孩子
+ */
+RC bind_vec_field_positions(Expression &expr, const VecColumnLayout &layout)
+{
+  if (expr.type() == ExprType::FIELD) {
+    auto &field_expr = static_cast<FieldExpr &>(expr);
+    for (size_t i = 0; i < layout.size(); i++) {
+      if (layout[i].first == field_expr.field().table() && layout[i].second == field_expr.field().meta()->field_id()) {
+        field_expr.set_pos(static_cast<int>(i));
+        return RC::SUCCESS;
+      }
+    }
+    LOG_WARN("cannot find field in child chunk. field=%s.%s", field_expr.table_name(), field_expr.field_name());
+    return RC::SCHEMA_FIELD_MISSING;
+  }
+
+  return ExpressionIterator::iterate_child_expr(
+      expr, [&layout](unique_ptr<Expression> &child) { return bind_vec_field_positions(*child, layout); });
+}
+
+/**
+ * @brief 下层是join时，输出chunk中列的位置与字段id不再一致，需要为上层表达式绑定列的位置
+ */
+RC bind_vec_field_positions(LogicalOperator &child_oper, const vector<Expression *> &expressions)
+{
+  if (child_oper.type() != LogicalOperatorType::JOIN) {
+    return RC::SUCCESS;
+  }
+
+  VecColumnLayout layout;
+  if (!collect_vec_output_layout(child_oper, layout)) {
+    return RC::UNSUPPORTED;
+  }
+
+  RC rc = RC::SUCCESS;
+  for (Expression *expr : expressions) {
+    if (OB_FAIL(rc = bind_vec_field_positions(*expr, layout))) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+
+/// 比较的两边交换以后对应的比较操作
+CompOp reverse_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_THAN: return GREAT_THAN;
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    default: return comp;
+  }
+}
+
+/**
+ * @brief 从字段与常量的比较中取出可以用于索引扫描的条件
+ * @param[out] field_name 比较的字段
+ */
+bool get_index_key_condition(Expression &expr, const char *&field_name, IndexKeyCondition &condition)
+{
+  if (expr.type() != ExprType::COMPARISON) {
+    return false;
+  }
+
+  auto         &comparison_expr = static_cast<ComparisonExpr &>(expr);
+  const CompOp  comp            = comparison_expr.comp();
+  if (comp != EQUAL_TO && comp != LESS_THAN && comp != LESS_EQUAL && comp != GREAT_THAN && comp != GREAT_EQUAL) {
+    return false;
+  }
+
+  Expression &left_expr  = *comparison_expr.left();
+  Expression &right_expr = *comparison_expr.right();
+  if (left_expr.type() == ExprType::FIELD && right_expr.type() == ExprType::VALUE) {
+    field_name      = static_cast<FieldExpr &>(left_expr).field_name();
+    condition.comp  = comp;
+    condition.value = static_cast<ValueExpr *>(&right_expr);
+    return true;
+  }
+  if (left_expr.type() == ExprType::VALUE && right_expr.type() == ExprType::FIELD) {
+    field_name      = static_cast<FieldExpr &>(right_expr).field_name();
+    condition.comp  = reverse_comp(comp);
+    condition.value = static_cast<ValueExpr *>(&left_expr);
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief 收集谓词中每个字段上可以用于索引扫描的条件
+ * @details 每个谓词是一组 AND 起来的条件。比较是一组条件；OR 的所有孩子都是同一个字段上的比较时（比如 IN 列表），
+ * 也是一组条件
+ */
+map<string, IndexColumnConditions> collect_index_key_conditions(vector<unique_ptr<Expression>> &predicates)
+{
+  map<string, IndexColumnConditions> field_conditions;
+  for (unique_ptr<Expression> &expr : predicates) {
+    const char       *field_name = nullptr;
+    IndexKeyCondition condition;
+    if (get_index_key_condition(*expr, field_name, condition)) {
+      field_conditions[field_name].push_back({condition});
+      continue;
+    }
+
+    if (expr->type() != ExprType::CONJUNCTION ||
+        static_cast<ConjunctionExpr &>(*expr).conjunction_type() != ConjunctionExpr::Type::OR) {
+      continue;
+    }
+
+    vector<IndexKeyCondition> group;
+    const char               *group_field = nullptr;
+    for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(*expr).children()) {
+      if (!get_index_key_condition(*child, field_name, condition) ||
+          (group_field != nullptr && strcmp(group_field, field_name) != 0)) {
+        group.clear();
+        break;
+      }
+      group_field = field_name;
+      group.push_back(condition);
+    }
+    if (!group.empty()) {
+      field_conditions[group_field].push_back(std::move(group));
+    }
+  }
+  return field_conditions;
+}
+
+/// 一组条件是否都是等值比较，比如 IN 列表
+bool is_equality_group(const vector<IndexKeyCondition> &group)
+{
+  return all_of(group.begin(), group.end(), [](const IndexKeyCondition &c) { return c.comp == EQUAL_TO; });
+}
+
+/// 只读的查询用到的这张表的字段是否都在索引中，是的话可以只扫描索引
+bool is_covering_index(const TableGetLogicalOperator &table_get_oper, const IndexMeta &index_meta)
+{
+  if (table_get_oper.read_write_mode() != ReadWriteMode::READ_ONLY || !table_get_oper.referenced_fields_known()) {
+    return false;
+  }
+
+  const vector<string> &index_fields = index_meta.fields();
+  return all_of(table_get_oper.referenced_fields().begin(),
+      table_get_oper.referenced_fields().end(),
+      [&index_fields](const FieldMeta *field) {
+        return find(index_fields.begin(), index_fields.end(), field->name()) != index_fields.end();
+      });
+}
+
+}  // namespace
+
 RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<PhysicalOperator> &oper)
 {
   RC rc = RC::SUCCESS;
@@ -121,6 +315,9 @@ RC PhysicalPlanGenerator::create_vec(LogicalOperator &logical_operator, unique_p
     case LogicalOperatorType::EXPLAIN: {
       return create_vec_plan(static_cast<ExplainLogicalOperator &>(logical_operator), oper);
     } break;
+    case LogicalOperatorType::JOIN: {
+      return create_vec_plan(static_cast<JoinLogicalOperator &>(logical_operator), oper);
+    } break;
     default: {
       return RC::INVALID_ARGUMENT;
     }
@@ -136,90 +333,61 @@ RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, u
   Table *table = table_get_oper.table();
   Index *index = nullptr;
 
-  std::vector<std::pair<Field, Value>> field_values;
-  for (auto &expr : predicates) {
-    if (expr->type() == ExprType::COMPARISON) {
-      ValueExpr *value_expr      = nullptr;
-      auto       comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-      // 简单处理，就找等值查询
-      if (comparison_expr->comp() != EQUAL_TO) {
-        continue;
-      }
-
-      unique_ptr<Expression> &left_expr  = comparison_expr->left();
-      unique_ptr<Expression> &right_expr = comparison_expr->right();
-      // 左右比较的一边最少是一个值
-      if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-        continue;
-      }
-
-      FieldExpr *field_expr = nullptr;
-      if (left_expr->type() == ExprType::FIELD) {
-        ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-        field_expr = static_cast<FieldExpr *>(left_expr.get());
-        value_expr = static_cast<ValueExpr *>(right_expr.get());
-      } else if (right_expr->type() == ExprType::FIELD) {
-        ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-        field_expr = static_cast<FieldExpr *>(right_expr.get());
-        value_expr = static_cast<ValueExpr *>(left_expr.get());
-      }
-
-      if (field_expr == nullptr) {
-        continue;
+  map<string, IndexColumnConditions> field_conditions = collect_index_key_conditions(predicates);
+
+  // 索引字段从前往后，等值条件（包括 IN 列表）的字段可以继续使用下一个字段，遇到范围条件就停止。
+  // 用到的字段越多越好，字段数相同时优先所有字段都是等值条件的索引，再优先可以只扫描索引的索引，最后优先哈希索引。
+  // 哈希索引只能做等值查找，所有字段都有等值条件时才使用
+  vector<IndexColumnConditions> index_conditions;
+  int                           best_score = 0;
+  bool                          index_only = false;
+  const TableMeta              &table_meta = table->table_meta();
+  for (int i = 0; !field_conditions.empty() && i < table_meta.index_num(); i++) {
+    const IndexMeta              *index_meta = table_meta.index(i);
+    vector<IndexColumnConditions> column_conditions;
+    bool                          all_equality = true;
+    for (const string &field_name : index_meta->fields()) {
+      auto iter = field_conditions.find(field_name);
+      if (iter == field_conditions.end()) {
+        all_equality = false;
+        break;
       }
 
-      const Field &field = field_expr->field();
-      Value        value;
-      ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
-      if (value_expr->try_get_value(value) != RC::SUCCESS) {
-        continue;
+      column_conditions.push_back(iter->second);
+      if (none_of(iter->second.begin(), iter->second.end(), is_equality_group)) {
+        all_equality = false;
+        break;
       }
-
-      field_values.push_back({field, value});
     }
-  }
 
-  std::vector<const char *> fields;
-  for (auto &[f, value] : field_values) {
-    fields.push_back(f.field_name());
-  }
-
-  // LOG_INFO("field size:%d", fields.size());
+    const bool hash = index_meta->type() == IndexType::HASH;
+    if (hash && !all_equality) {
+      continue;
+    }
 
-  if (fields.size() > 1) {
-    index = table->find_index_by_fields(fields);
+    const bool covering = is_covering_index(table_get_oper, *index_meta);
+    const int  score    = static_cast<int>(column_conditions.size()) * 8 + (all_equality ? 4 : 0) + (covering ? 2 : 0) +
+                      (hash ? 1 : 0);
+    if (!column_conditions.empty() && score > best_score) {
+      best_score       = score;
+      index            = table->find_index(index_meta->name());
+      index_conditions = std::move(column_conditions);
+      index_only       = covering;
+    }
   }
-  
 
   if (index != nullptr) {
-    LOG_INFO("index name:%s", index->index_meta().name());
-    std::vector<Value> values;
-    const IndexMeta   &index_meta = index->index_meta();
-    for (auto &field : index_meta.fields()) {
-      bool found = false;
-      for (auto &[f, value] : field_values) {
-        if (strcmp(f.field_name(), field.c_str()) == 0) {
-          found = true;
-          values.push_back(value);
-          break;
-        }
-      }
-      if (!found) {
-        break;
-      }
-    }
-
-    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table,
-        index,
-        table_get_oper.read_write_mode(),
-        values,
-        true /*left_inclusive*/,
-        values,
-        true /*right_inclusive*/);
+    LOG_TRACE("index name:%s, columns:%d", index->index_meta().name(), static_cast<int>(index_conditions.size()));
 
+    // 索引条件中的常量属于谓词，计划被缓存复用时这些常量可能被替换，所以由算子在 open 时计算扫描范围
+    IndexScanPhysicalOperator *index_scan_oper =
+        new IndexScanPhysicalOperator(table, index, table_get_oper.read_write_mode(), std::move(index_conditions));
     index_scan_oper->set_predicates(std::move(predicates));
+    index_scan_oper->set_index_only(index_only);
+    // 只扫描索引时大部分记录不需要读取，按照 RID 排序反而打乱了索引的顺序
+    index_scan_oper->set_bitmap_fetch(!index_only);
     oper = unique_ptr<PhysicalOperator>(index_scan_oper);
-    LOG_TRACE("use index scan");
+    LOG_TRACE("use index scan. index only=%d", index_only);
   } else {
     auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.read_write_mode());
     table_scan_oper->set_predicates(std::move(predicates));
@@ -347,7 +515,29 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     return RC::INTERNAL;
   }
 
-  unique_ptr<PhysicalOperator> join_physical_oper(new NestedLoopJoinPhysicalOperator);
+  // 有等值连接条件时使用hash join，否则只能使用嵌套循环连接
+  unique_ptr<PhysicalOperator>    join_physical_oper;
+  vector<unique_ptr<Expression>> &join_conditions = join_oper.expressions();
+  if (!join_conditions.empty()) {
+    vector<unique_ptr<Expression>> left_keys;
+    vector<unique_ptr<Expression>> right_keys;
+    for (unique_ptr<Expression> &condition : join_conditions) {
+      ASSERT(condition->type() == ExprType::COMPARISON, "join condition should be a comparison expression");
+      auto comparison_expr = static_cast<ComparisonExpr *>(condition.get());
+      left_keys.emplace_back(std::move(comparison_expr->left()));
+      right_keys.emplace_back(std::move(comparison_expr->right()));
+    }
+
+    Session *session      = Session::current_session();
+    int64_t  memory_limit = (session != nullptr) ? session->hash_join_memory_limit()
+                                                 : Session::default_session().hash_join_memory_limit();
+    join_physical_oper =
+        make_unique<HashJoinPhysicalOperator>(std::move(left_keys), std::move(right_keys), memory_limit);
+    LOG_TRACE("use hash join");
+  } else {
+    join_physical_oper = make_unique<NestedLoopJoinPhysicalOperator>();
+  }
+
   for (auto &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create(*child_oper, child_physical_oper);
@@ -439,7 +629,24 @@ RC PhysicalPlanGenerator::create_vec_plan(TableGetLogicalOperator &table_get_ope
 
 RC PhysicalPlanGenerator::create_vec_plan(GroupByLogicalOperator &logical_oper, unique_ptr<PhysicalOperator> &oper)
 {
-  RC                           rc            = RC::SUCCESS;
+  RC rc = RC::SUCCESS;
+  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
+
+  LogicalOperator &child_oper = *logical_oper.children().front();
+
+  vector<Expression *> input_expressions;
+  for (Expression *expr : logical_oper.aggregate_expressions()) {
+    input_expressions.push_back(static_cast<AggregateExpr *>(expr)->child().get());
+  }
+  for (unique_ptr<Expression> &expr : logical_oper.group_by_expressions()) {
+    input_expressions.push_back(expr.get());
+  }
+  rc = bind_vec_field_positions(child_oper, input_expressions);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to bind field positions of group by(vec) operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
   unique_ptr<PhysicalOperator> physical_oper = nullptr;
   if (logical_oper.group_by_expressions().empty()) {
     physical_oper = make_unique<AggregateVecPhysicalOperator>(std::move(logical_oper.aggregate_expressions()));
@@ -448,9 +655,6 @@ RC PhysicalPlanGenerator::create_vec_plan(GroupByLogicalOperator &logical_oper,
         std::move(logical_oper.group_by_expressions()), std::move(logical_oper.aggregate_expressions()));
   }
 
-  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
-
-  LogicalOperator             &child_oper = *logical_oper.children().front();
   unique_ptr<PhysicalOperator> child_physical_oper;
   rc = create_vec(child_oper, child_physical_oper);
   if (OB_FAIL(rc)) {
@@ -475,7 +679,18 @@ RC PhysicalPlanGenerator::create_vec_plan(ProjectLogicalOperator &project_oper,
   RC rc = RC::SUCCESS;
   if (!child_opers.empty()) {
     LogicalOperator *child_oper = child_opers.front().get();
-    rc                          = create_vec(*child_oper, child_phy_oper);
+
+    vector<Expression *> project_expressions;
+    for (unique_ptr<Expression> &expr : project_oper.expressions()) {
+      project_expressions.push_back(expr.get());
+    }
+    rc = bind_vec_field_positions(*child_oper, project_expressions);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to bind field positions of project(vec) operator. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = create_vec(*child_oper, child_phy_oper);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to create project logical operator's child physical operator. rc=%s", strrc(rc));
       return rc;
@@ -520,4 +735,59 @@ RC PhysicalPlanGenerator::create_vec_plan(ExplainLogicalOperator &explain_oper,
 
   oper = std::move(explain_physical_oper);
   return rc;
-}
\ No newline at end of file
+}
+RC PhysicalPlanGenerator::create_vec_plan(JoinLogicalOperator &join_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  RC rc = RC::SUCCESS;
+
+  vector<unique_ptr<LogicalOperator>> &child_opers = join_oper.children();
+  if (child_opers.size() != 2) {
+    LOG_WARN("join operator should have 2 children, but have %d", child_opers.size());
+    return RC::INTERNAL;
+  }
+
+  vector<unique_ptr<Expression>> &join_conditions = join_oper.expressions();
+  if (join_conditions.empty()) {
+    LOG_WARN("vectorized join requires equal join conditions");
+    return RC::UNSUPPORTED;
+  }
+
+  // 连接键分别在左右孩子输出的chunk上计算
+  VecColumnLayout left_layout;
+  VecColumnLayout right_layout;
+  if (!collect_vec_output_layout(*child_opers[0], left_layout) ||
+      !collect_vec_output_layout(*child_opers[1], right_layout)) {
+    LOG_WARN("unsupported child operator of vectorized join");
+    return RC::UNSUPPORTED;
+  }
+
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  for (unique_ptr<Expression> &condition : join_conditions) {
+    ASSERT(condition->type() == ExprType::COMPARISON, "join condition should be a comparison expression");
+    auto comparison_expr = static_cast<ComparisonExpr *>(condition.get());
+    if (OB_FAIL(rc = bind_vec_field_positions(*comparison_expr->left(), left_layout)) ||
+        OB_FAIL(rc = bind_vec_field_positions(*comparison_expr->right(), right_layout))) {
+      LOG_WARN("failed to bind join keys. rc=%s", strrc(rc));
+      return rc;
+    }
+    left_keys.emplace_back(std::move(comparison_expr->left()));
+    right_keys.emplace_back(std::move(comparison_expr->right()));
+  }
+
+  auto join_physical_oper = make_unique<HashJoinVecPhysicalOperator>(std::move(left_keys), std::move(right_keys));
+  for (auto &child_oper : child_opers) {
+    unique_ptr<PhysicalOperator> child_physical_oper;
+    rc = create_vec(*child_oper, child_physical_oper);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create physical child oper. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    join_physical_oper->add_child(std::move(child_physical_oper));
+  }
+
+  oper = std::move(join_physical_oper);
+  LOG_TRACE("use vectorized hash join");
+  return rc;
+}
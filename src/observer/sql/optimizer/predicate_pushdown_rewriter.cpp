@@ -94,10 +94,14 @@ RC PredicatePushdownRewriter::get_exprs_can_pushdown(
   RC rc = RC::SUCCESS;
   if (expr->type() == ExprType::CONJUNCTION) {
     ConjunctionExpr *conjunction_expr = static_cast<ConjunctionExpr *>(expr.get());
-    // 或 操作的比较，太复杂，现在不考虑
+    // 或 操作只有所有的孩子都是可以下推的比较时才整体下推，比如 IN 列表展开成的多个等值比较
     if (conjunction_expr->conjunction_type() == ConjunctionExpr::Type::OR) {
-      LOG_WARN("unsupported or operation");
-      rc = RC::UNIMPLEMENTED;
+      for (std::unique_ptr<Expression> &child : conjunction_expr->children()) {
+        if (child->type() != ExprType::COMPARISON || !can_pushdown(static_cast<ComparisonExpr &>(*child))) {
+          return rc;
+        }
+      }
+      pushdown_exprs.emplace_back(std::move(expr));
       return rc;
     }
 
@@ -119,20 +123,24 @@ RC PredicatePushdownRewriter::get_exprs_can_pushdown(
     }
   } else if (expr->type() == ExprType::COMPARISON) {
     // 如果是比较操作，并且比较的左边或右边是表某个列值，那么就下推下去
-    auto   comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-
-    std::unique_ptr<Expression> &left_expr  = comparison_expr->left();
-    std::unique_ptr<Expression> &right_expr = comparison_expr->right();
-    // 比较操作的左右两边只要有一个是取列字段值的并且另一边也是取字段值或常量，就pushdown
-    if (left_expr->type() != ExprType::FIELD && right_expr->type() != ExprType::FIELD) {
-      return rc;
+    if (can_pushdown(static_cast<ComparisonExpr &>(*expr))) {
+      pushdown_exprs.emplace_back(std::move(expr));
     }
-    if (left_expr->type() != ExprType::FIELD && left_expr->type() != ExprType::VALUE &&
-        right_expr->type() != ExprType::FIELD && right_expr->type() != ExprType::VALUE) {
-      return rc;
-    }
-
-    pushdown_exprs.emplace_back(std::move(expr));
   }
   return rc;
 }
+
+bool PredicatePushdownRewriter::can_pushdown(ComparisonExpr &comparison_expr)
+{
+  std::unique_ptr<Expression> &left_expr  = comparison_expr.left();
+  std::unique_ptr<Expression> &right_expr = comparison_expr.right();
+  // 比较操作的左右两边只要有一个是取列字段值的并且另一边也是取字段值或常量，就pushdown
+  if (left_expr->type() != ExprType::FIELD && right_expr->type() != ExprType::FIELD) {
+    return false;
+  }
+  if (left_expr->type() != ExprType::FIELD && left_expr->type() != ExprType::VALUE &&
+      right_expr->type() != ExprType::FIELD && right_expr->type() != ExprType::VALUE) {
+    return false;
+  }
+  return true;
+}
@@ -17,6 +17,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/optimizer/rewrite_rule.h"
 #include <vector>
 
+class ComparisonExpr;
+
 /**
  * @brief 将一些谓词表达式下推到表数据扫描中
  * @ingroup Rewriter
@@ -34,4 +36,9 @@ private:
   RC get_exprs_can_pushdown(
       std::unique_ptr<Expression> &expr, std::vector<std::unique_ptr<Expression>> &pushdown_exprs);
   bool is_empty_predicate(std::unique_ptr<Expression> &expr);
+
+  /**
+   * @brief 比较操作的一边是表的字段，另一边是字段或常量时可以下推
+   */
+  bool can_pushdown(ComparisonExpr &comparison_expr);
 };
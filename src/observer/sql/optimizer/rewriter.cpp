@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "sql/operator/logical_operator.h"
 #include "sql/optimizer/expression_rewriter.h"
+#include "sql/optimizer/join_predicate_pushdown_rewriter.h"
 #include "sql/optimizer/predicate_pushdown_rewriter.h"
 #include "sql/optimizer/predicate_rewrite.h"
 
@@ -23,6 +24,7 @@ Rewriter::Rewriter()
 {
   rewrite_rules_.emplace_back(new ExpressionRewriter);
   rewrite_rules_.emplace_back(new PredicateRewriteRule);
+  rewrite_rules_.emplace_back(new JoinPredicatePushdownRewriter);
   rewrite_rules_.emplace_back(new PredicatePushdownRewriter);
 }
 
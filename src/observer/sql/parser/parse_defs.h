@@ -53,6 +53,7 @@ enum CompOp
   GREAT_THAN,   ///< ">"
   LIKE_OP,
   NOT_LIKE_OP,
+  IN_OP,  ///< "in"，右边是 right_values 中的常量列表
   NO_OP
 };
 
@@ -66,15 +67,16 @@ enum CompOp
  */
 struct ConditionSqlNode
 {
-  int left_is_attr;              ///< TRUE if left-hand side is an attribute
-                                 ///< 1时，操作符左边是属性名，0时，是属性值
-  Value          left_value;     ///< left-hand side value if left_is_attr = FALSE
-  RelAttrSqlNode left_attr;      ///< left-hand side attribute
-  CompOp         comp;           ///< comparison operator
-  int            right_is_attr;  ///< TRUE if right-hand side is an attribute
-                                 ///< 1时，操作符右边是属性名，0时，是属性值
-  RelAttrSqlNode right_attr;     ///< right-hand side attribute if right_is_attr = TRUE 右边的属性
-  Value          right_value;    ///< right-hand side value if right_is_attr = FALSE
+  int left_is_attr;                  ///< TRUE if left-hand side is an attribute
+                                     ///< 1时，操作符左边是属性名，0时，是属性值
+  Value              left_value;     ///< left-hand side value if left_is_attr = FALSE
+  RelAttrSqlNode     left_attr;      ///< left-hand side attribute
+  CompOp             comp;           ///< comparison operator
+  int                right_is_attr;  ///< TRUE if right-hand side is an attribute
+                                     ///< 1时，操作符右边是属性名，0时，是属性值
+  RelAttrSqlNode     right_attr;     ///< right-hand side attribute if right_is_attr = TRUE 右边的属性
+  Value              right_value;    ///< right-hand side value if right_is_attr = FALSE
+  std::vector<Value> right_values;   ///< IN 的常量列表，只有 comp = IN_OP 时有效
 };
 
 /**
@@ -185,6 +187,7 @@ struct CreateIndexSqlNode
   std::string              relation_name;    ///< Relation name
   std::vector<std::string> attribute_names;  ///< Attribute names
   bool                     unique = false;
+  std::string              index_type;       ///< USING 指定的索引类型，为空表示B+树
 };
 
 /**
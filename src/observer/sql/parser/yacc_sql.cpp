@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -120,8 +121,22 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
   return expr;
 }
 
+/**
+ * @brief 生成字段与常量比较的条件，用于 BETWEEN 展开成的两个比较
+ */
+ConditionSqlNode create_attr_value_condition(const RelAttrSqlNode &attr, CompOp comp, const Value &value)
+{
+  ConditionSqlNode condition;
+  condition.left_is_attr = 1;
+  condition.left_attr = attr;
+  condition.right_is_attr = 0;
+  condition.right_value = value;
+  condition.comp = comp;
+  return condition;
+}
+
 
-#line 125 "yacc_sql.cpp"
+#line 140 "yacc_sql.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -144,155 +159,132 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_YACC_SQL_HPP_INCLUDED
-# define YY_YY_YACC_SQL_HPP_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    SEMICOLON = 258,
-    BY = 259,
-    CREATE = 260,
-    DROP = 261,
-    GROUP = 262,
-    TABLE = 263,
-    TABLES = 264,
-    INDEX = 265,
-    MULTI_INDEX = 266,
-    CALC = 267,
-    SELECT = 268,
-    DESC = 269,
-    SHOW = 270,
-    SYNC = 271,
-    INSERT = 272,
-    DELETE = 273,
-    UPDATE = 274,
-    LBRACE = 275,
-    RBRACE = 276,
-    COMMA = 277,
-    TRX_BEGIN = 278,
-    TRX_COMMIT = 279,
-    TRX_ROLLBACK = 280,
-    INT_T = 281,
-    STRING_T = 282,
-    FLOAT_T = 283,
-    DATE_T = 284,
-    HELP = 285,
-    EXIT = 286,
-    DOT = 287,
-    INTO = 288,
-    VALUES = 289,
-    FROM = 290,
-    WHERE = 291,
-    NOT = 292,
-    LIKE = 293,
-    AND = 294,
-    SET = 295,
-    ON = 296,
-    LOAD = 297,
-    DATA = 298,
-    INFILE = 299,
-    EXPLAIN = 300,
-    STORAGE = 301,
-    FORMAT = 302,
-    EQ = 303,
-    LT = 304,
-    GT = 305,
-    LE = 306,
-    GE = 307,
-    NE = 308,
-    COUNT = 309,
-    MAX = 310,
-    MIN = 311,
-    AVG = 312,
-    SUM = 313,
-    INNER = 314,
-    JOIN = 315,
-    UNIQUE = 316,
-    NUMBER = 317,
-    FLOAT = 318,
-    ID = 319,
-    DATE_STR = 320,
-    SSS = 321,
-    UMINUS = 322
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-union YYSTYPE
+#include "yacc_sql.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 129 "yacc_sql.y"
-
-  ParsedSqlNode *                            sql_node;
-  ConditionSqlNode *                         condition;
-  Value *                                    value;
-  enum CompOp                                comp;
-  RelAttrSqlNode *                           rel_attr;
-  std::vector<AttrInfoSqlNode> *             attr_infos;
-  AttrInfoSqlNode *                          attr_info;
-  Expression *                               expression;
-  std::vector<std::unique_ptr<Expression>> * expression_list;
-  std::vector<Value> *                       value_list;
-  std::vector<std::vector<Value>> *          insert_list;
-  std::vector<ConditionSqlNode> *            condition_list;
-  std::vector<RelAttrSqlNode> *              rel_attr_list;
-  std::vector<std::string> *                 relation_list;
-  std::vector<std::pair<std::string, std::vector<ConditionSqlNode>>> * 
-                                             join_list;
-  std::vector<std::pair<std::string, Value>> *
-                                             eq_list;
-  std::vector<std::string> *                 id_list;
-  char *                                     string;
-  int                                        number;
-  float                                      floats;
-
-#line 270 "yacc_sql.cpp"
-
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SEMICOLON = 3,                  /* SEMICOLON  */
+  YYSYMBOL_BY = 4,                         /* BY  */
+  YYSYMBOL_CREATE = 5,                     /* CREATE  */
+  YYSYMBOL_DROP = 6,                       /* DROP  */
+  YYSYMBOL_GROUP = 7,                      /* GROUP  */
+  YYSYMBOL_TABLE = 8,                      /* TABLE  */
+  YYSYMBOL_TABLES = 9,                     /* TABLES  */
+  YYSYMBOL_INDEX = 10,                     /* INDEX  */
+  YYSYMBOL_CALC = 11,                      /* CALC  */
+  YYSYMBOL_SELECT = 12,                    /* SELECT  */
+  YYSYMBOL_DESC = 13,                      /* DESC  */
+  YYSYMBOL_SHOW = 14,                      /* SHOW  */
+  YYSYMBOL_SYNC = 15,                      /* SYNC  */
+  YYSYMBOL_INSERT = 16,                    /* INSERT  */
+  YYSYMBOL_DELETE = 17,                    /* DELETE  */
+  YYSYMBOL_UPDATE = 18,                    /* UPDATE  */
+  YYSYMBOL_LBRACE = 19,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 20,                    /* RBRACE  */
+  YYSYMBOL_COMMA = 21,                     /* COMMA  */
+  YYSYMBOL_TRX_BEGIN = 22,                 /* TRX_BEGIN  */
+  YYSYMBOL_TRX_COMMIT = 23,                /* TRX_COMMIT  */
+  YYSYMBOL_TRX_ROLLBACK = 24,              /* TRX_ROLLBACK  */
+  YYSYMBOL_INT_T = 25,                     /* INT_T  */
+  YYSYMBOL_STRING_T = 26,                  /* STRING_T  */
+  YYSYMBOL_FLOAT_T = 27,                   /* FLOAT_T  */
+  YYSYMBOL_DATE_T = 28,                    /* DATE_T  */
+  YYSYMBOL_HELP = 29,                      /* HELP  */
+  YYSYMBOL_EXIT = 30,                      /* EXIT  */
+  YYSYMBOL_DOT = 31,                       /* DOT  */
+  YYSYMBOL_INTO = 32,                      /* INTO  */
+  YYSYMBOL_VALUES = 33,                    /* VALUES  */
+  YYSYMBOL_FROM = 34,                      /* FROM  */
+  YYSYMBOL_WHERE = 35,                     /* WHERE  */
+  YYSYMBOL_NOT = 36,                       /* NOT  */
+  YYSYMBOL_LIKE = 37,                      /* LIKE  */
+  YYSYMBOL_AND = 38,                       /* AND  */
+  YYSYMBOL_SET = 39,                       /* SET  */
+  YYSYMBOL_ON = 40,                        /* ON  */
+  YYSYMBOL_LOAD = 41,                      /* LOAD  */
+  YYSYMBOL_DATA = 42,                      /* DATA  */
+  YYSYMBOL_INFILE = 43,                    /* INFILE  */
+  YYSYMBOL_EXPLAIN = 44,                   /* EXPLAIN  */
+  YYSYMBOL_STORAGE = 45,                   /* STORAGE  */
+  YYSYMBOL_FORMAT = 46,                    /* FORMAT  */
+  YYSYMBOL_EQ = 47,                        /* EQ  */
+  YYSYMBOL_LT = 48,                        /* LT  */
+  YYSYMBOL_GT = 49,                        /* GT  */
+  YYSYMBOL_LE = 50,                        /* LE  */
+  YYSYMBOL_GE = 51,                        /* GE  */
+  YYSYMBOL_NE = 52,                        /* NE  */
+  YYSYMBOL_COUNT = 53,                     /* COUNT  */
+  YYSYMBOL_MAX = 54,                       /* MAX  */
+  YYSYMBOL_MIN = 55,                       /* MIN  */
+  YYSYMBOL_AVG = 56,                       /* AVG  */
+  YYSYMBOL_SUM = 57,                       /* SUM  */
+  YYSYMBOL_INNER = 58,                     /* INNER  */
+  YYSYMBOL_JOIN = 59,                      /* JOIN  */
+  YYSYMBOL_UNIQUE = 60,                    /* UNIQUE  */
+  YYSYMBOL_NUMBER = 61,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 62,                     /* FLOAT  */
+  YYSYMBOL_ID = 63,                        /* ID  */
+  YYSYMBOL_DATE_STR = 64,                  /* DATE_STR  */
+  YYSYMBOL_SSS = 65,                       /* SSS  */
+  YYSYMBOL_66_ = 66,                       /* '+'  */
+  YYSYMBOL_67_ = 67,                       /* '-'  */
+  YYSYMBOL_68_ = 68,                       /* '*'  */
+  YYSYMBOL_69_ = 69,                       /* '/'  */
+  YYSYMBOL_UMINUS = 70,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 71,                  /* $accept  */
+  YYSYMBOL_commands = 72,                  /* commands  */
+  YYSYMBOL_command_wrapper = 73,           /* command_wrapper  */
+  YYSYMBOL_exit_stmt = 74,                 /* exit_stmt  */
+  YYSYMBOL_help_stmt = 75,                 /* help_stmt  */
+  YYSYMBOL_sync_stmt = 76,                 /* sync_stmt  */
+  YYSYMBOL_begin_stmt = 77,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 78,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 79,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 80,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 81,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 82,           /* desc_table_stmt  */
+  YYSYMBOL_id_list = 83,                   /* id_list  */
+  YYSYMBOL_create_index_stmt = 84,         /* create_index_stmt  */
+  YYSYMBOL_index_type = 85,                /* index_type  */
+  YYSYMBOL_drop_index_stmt = 86,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 87,         /* create_table_stmt  */
+  YYSYMBOL_attr_def_list = 88,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 89,                  /* attr_def  */
+  YYSYMBOL_number = 90,                    /* number  */
+  YYSYMBOL_type = 91,                      /* type  */
+  YYSYMBOL_insert_stmt = 92,               /* insert_stmt  */
+  YYSYMBOL_insert_list = 93,               /* insert_list  */
+  YYSYMBOL_value_list = 94,                /* value_list  */
+  YYSYMBOL_value = 95,                     /* value  */
+  YYSYMBOL_storage_format = 96,            /* storage_format  */
+  YYSYMBOL_delete_stmt = 97,               /* delete_stmt  */
+  YYSYMBOL_update_stmt = 98,               /* update_stmt  */
+  YYSYMBOL_select_stmt = 99,               /* select_stmt  */
+  YYSYMBOL_calc_stmt = 100,                /* calc_stmt  */
+  YYSYMBOL_expression_list = 101,          /* expression_list  */
+  YYSYMBOL_expression = 102,               /* expression  */
+  YYSYMBOL_rel_attr = 103,                 /* rel_attr  */
+  YYSYMBOL_relation = 104,                 /* relation  */
+  YYSYMBOL_rel_list = 105,                 /* rel_list  */
+  YYSYMBOL_join_list = 106,                /* join_list  */
+  YYSYMBOL_eq_list = 107,                  /* eq_list  */
+  YYSYMBOL_where = 108,                    /* where  */
+  YYSYMBOL_condition_list = 109,           /* condition_list  */
+  YYSYMBOL_between_condition = 110,        /* between_condition  */
+  YYSYMBOL_condition = 111,                /* condition  */
+  YYSYMBOL_comp_op = 112,                  /* comp_op  */
+  YYSYMBOL_group_by = 113,                 /* group_by  */
+  YYSYMBOL_load_data_stmt = 114,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 115,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 116,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 117             /* opt_semicolon  */
 };
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
-{
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
-};
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
-
-
-
-int yyparse (const char * sql_string, ParsedSqlResult * sql_result, void * scanner);
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-#endif /* !YY_YY_YACC_SQL_HPP_INCLUDED  */
 
 
 
@@ -333,6 +325,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -392,6 +396,7 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
 typedef yytype_uint8 yy_state_t;
 
@@ -410,6 +415,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -428,17 +434,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -467,7 +479,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -532,8 +544,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -601,25 +612,27 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  72
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   211
+#define YYLAST   239
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  72
+#define YYNTOKENS  71
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  45
+#define YYNNTS  47
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  110
+#define YYNRULES  116
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  215
+#define YYNSTATES  229
 
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   322
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   321
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -629,7 +642,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,    69,    67,     2,    68,     2,    70,     2,     2,
+       2,     2,    68,    66,     2,    67,     2,    69,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -657,35 +670,42 @@ static const yytype_int8 yytranslate[] =
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65,    66,    71
+      65,    70
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   212,   212,   220,   221,   222,   223,   224,   225,   226,
-     227,   228,   229,   230,   231,   232,   233,   234,   235,   236,
-     237,   238,   239,   243,   249,   254,   260,   266,   272,   278,
-     285,   291,   299,   304,   316,   326,   341,   351,   375,   378,
-     391,   399,   409,   412,   413,   414,   415,   418,   428,   434,
-     449,   455,   467,   471,   475,   481,   504,   507,   514,   526,
-     544,   568,   603,   612,   617,   628,   631,   634,   637,   640,
-     644,   647,   652,   658,   661,   664,   667,   670,   673,   680,
-     685,   695,   700,   705,   717,   723,   736,   742,   757,   760,
-     766,   769,   774,   781,   793,   805,   817,   832,   833,   834,
-     835,   836,   837,   838,   839,   845,   850,   863,   871,   881,
-     882
+       0,   227,   227,   235,   236,   237,   238,   239,   240,   241,
+     242,   243,   244,   245,   246,   247,   248,   249,   250,   251,
+     252,   253,   254,   258,   264,   269,   275,   281,   287,   293,
+     300,   306,   314,   319,   331,   345,   365,   368,   382,   392,
+     416,   419,   432,   440,   450,   453,   454,   455,   456,   459,
+     469,   475,   490,   496,   508,   512,   516,   522,   545,   548,
+     555,   567,   585,   609,   644,   653,   658,   669,   672,   675,
+     678,   681,   685,   688,   693,   699,   702,   705,   708,   711,
+     714,   721,   726,   736,   741,   746,   758,   764,   777,   783,
+     798,   801,   807,   810,   815,   820,   823,   831,   853,   865,
+     877,   889,   901,   925,   926,   927,   928,   929,   930,   931,
+     932,   938,   943,   956,   964,   974,   975
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SEMICOLON", "BY", "CREATE", "DROP",
-  "GROUP", "TABLE", "TABLES", "INDEX", "MULTI_INDEX", "CALC", "SELECT",
+  "\"end of file\"", "error", "\"invalid token\"", "SEMICOLON", "BY",
+  "CREATE", "DROP", "GROUP", "TABLE", "TABLES", "INDEX", "CALC", "SELECT",
   "DESC", "SHOW", "SYNC", "INSERT", "DELETE", "UPDATE", "LBRACE", "RBRACE",
   "COMMA", "TRX_BEGIN", "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T",
   "FLOAT_T", "DATE_T", "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM",
@@ -696,33 +716,24 @@ static const char *const yytname[] =
   "$accept", "commands", "command_wrapper", "exit_stmt", "help_stmt",
   "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
   "drop_table_stmt", "show_tables_stmt", "desc_table_stmt", "id_list",
-  "create_index_stmt", "drop_index_stmt", "create_table_stmt",
-  "attr_def_list", "attr_def", "number", "type", "insert_stmt",
-  "insert_list", "value_list", "value", "storage_format", "delete_stmt",
-  "update_stmt", "select_stmt", "calc_stmt", "expression_list",
-  "expression", "rel_attr", "relation", "rel_list", "join_list", "eq_list",
-  "where", "condition_list", "condition", "comp_op", "group_by",
-  "load_data_stmt", "explain_stmt", "set_variable_stmt", "opt_semicolon", YY_NULLPTR
+  "create_index_stmt", "index_type", "drop_index_stmt",
+  "create_table_stmt", "attr_def_list", "attr_def", "number", "type",
+  "insert_stmt", "insert_list", "value_list", "value", "storage_format",
+  "delete_stmt", "update_stmt", "select_stmt", "calc_stmt",
+  "expression_list", "expression", "rel_attr", "relation", "rel_list",
+  "join_list", "eq_list", "where", "condition_list", "between_condition",
+  "condition", "comp_op", "group_by", "load_data_stmt", "explain_stmt",
+  "set_variable_stmt", "opt_semicolon", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,   316,   317,   318,   319,   320,   321,    43,    45,    42,
-      47,   322
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-172)
+#define YYPACT_NINF (-174)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -732,209 +743,217 @@ static const yytype_int16 yytoknum[] =
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     132,    -2,    24,    15,    15,   -51,    21,  -172,     0,     9,
-     -19,  -172,  -172,  -172,  -172,  -172,   -18,     6,   132,    58,
-      84,  -172,  -172,  -172,  -172,  -172,  -172,  -172,  -172,  -172,
-    -172,  -172,  -172,  -172,  -172,  -172,  -172,  -172,  -172,  -172,
-    -172,    34,    35,    94,    42,    45,    15,    87,    95,    96,
-      97,    98,  -172,  -172,    82,  -172,  -172,    15,  -172,  -172,
-    -172,    60,  -172,    85,  -172,  -172,    55,    57,    83,    74,
-      80,  -172,  -172,  -172,  -172,   105,    90,    62,  -172,   111,
-     -17,    15,    15,    15,    15,    15,    75,  -172,    15,    15,
-      15,    15,    15,    89,   120,   122,   100,   -42,    93,   101,
-     102,   119,   103,  -172,    -7,    22,    26,    33,    43,  -172,
-    -172,   -60,   -60,  -172,  -172,  -172,   139,   -31,   148,   -47,
-    -172,   121,   122,  -172,   137,    39,   149,   153,   112,  -172,
-    -172,  -172,  -172,  -172,  -172,    89,   115,   122,  -172,   -42,
-    -172,   -12,   -12,  -172,   140,   -42,  -172,   170,  -172,  -172,
-    -172,  -172,   160,   101,   161,   117,   163,  -172,    89,  -172,
-    -172,   164,   162,   150,  -172,  -172,  -172,  -172,  -172,  -172,
-    -172,   -47,   -47,   -47,   165,   125,   124,   149,   144,   169,
-     171,   117,   152,  -172,   172,   -42,  -172,  -172,  -172,  -172,
-    -172,  -172,   100,  -172,  -172,   174,  -172,   151,  -172,   117,
-    -172,   175,   -47,   148,  -172,  -172,  -172,   154,  -172,  -172,
-     138,  -172,   135,  -172,  -172
+     148,    -5,    16,     6,     6,   -50,    27,  -174,     5,     7,
+     -23,  -174,  -174,  -174,  -174,  -174,     2,    24,   148,    85,
+      84,  -174,  -174,  -174,  -174,  -174,  -174,  -174,  -174,  -174,
+    -174,  -174,  -174,  -174,  -174,  -174,  -174,  -174,  -174,  -174,
+    -174,    26,    30,    86,    31,    39,     6,    89,    97,    98,
+     103,   127,  -174,  -174,    74,  -174,  -174,     6,  -174,  -174,
+    -174,    76,  -174,    69,  -174,  -174,    41,   104,   113,   121,
+     126,  -174,  -174,  -174,  -174,   154,   134,   112,  -174,   136,
+     -16,     6,     6,     6,     6,     6,   116,  -174,     6,     6,
+       6,     6,     6,   117,   149,   146,   120,   -53,   119,   122,
+     123,   150,   125,  -174,    14,    52,    64,    68,    72,  -174,
+    -174,   -48,   -48,  -174,  -174,  -174,   170,   -25,   174,   -17,
+    -174,   147,   146,  -174,   163,    73,   175,   178,   135,  -174,
+    -174,  -174,  -174,  -174,  -174,   117,   140,   146,  -174,   -53,
+    -174,    77,   -20,  -174,   162,   164,   -53,  -174,   193,  -174,
+    -174,  -174,  -174,   184,   122,   185,   141,   187,  -174,   117,
+    -174,  -174,   188,   186,   172,  -174,  -174,  -174,  -174,  -174,
+    -174,  -174,   -17,    45,   -17,   -17,   -17,   189,   151,   152,
+     175,   166,   191,   195,   141,   176,  -174,   196,   -53,  -174,
+    -174,  -174,   -53,   180,  -174,  -174,  -174,  -174,   120,  -174,
+    -174,   199,  -174,   177,  -174,   141,   157,   201,   -17,   174,
+    -174,   202,   -53,  -174,  -174,   179,  -174,   161,  -174,   157,
+     167,  -174,  -174,  -174,   165,  -174,  -174,  -174,  -174
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,    25,     0,     0,
        0,    26,    27,    28,    24,    23,     0,     0,     0,     0,
-     109,    22,    21,    14,    15,    16,    17,     9,    10,    11,
+     115,    22,    21,    14,    15,    16,    17,     9,    10,    11,
       12,    13,     8,     5,     7,     6,     4,     3,    18,    19,
       20,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,    52,    53,    79,    55,    54,     0,    78,    71,
-      62,    63,    72,     0,    31,    30,     0,     0,     0,     0,
-       0,   107,     1,   110,     2,     0,     0,     0,    29,     0,
-       0,     0,     0,     0,     0,     0,     0,    70,     0,     0,
-       0,     0,     0,     0,     0,    88,     0,     0,     0,     0,
-       0,     0,     0,    69,     0,     0,     0,     0,     0,    80,
-      64,    65,    66,    67,    68,    81,    82,    88,     0,    90,
-      58,     0,    88,   108,     0,     0,    38,     0,     0,    36,
-      73,    75,    76,    74,    77,     0,     0,    88,   105,     0,
-      47,     0,     0,    89,    91,     0,    59,     0,    43,    44,
-      45,    46,    41,     0,     0,     0,     0,    83,     0,   105,
-      60,     0,    50,     0,   103,    97,    98,    99,   100,   101,
-     102,     0,     0,    90,    86,     0,     0,    38,    56,    32,
-       0,     0,     0,    61,    48,     0,   104,    94,    96,    93,
-      95,    92,     0,   106,    42,     0,    39,     0,    37,     0,
-      34,     0,    90,     0,    51,    87,    40,     0,    33,    35,
-      84,    49,     0,    85,    57
+       0,     0,    54,    55,    81,    57,    56,     0,    80,    73,
+      64,    65,    74,     0,    31,    30,     0,     0,     0,     0,
+       0,   113,     1,   116,     2,     0,     0,     0,    29,     0,
+       0,     0,     0,     0,     0,     0,     0,    72,     0,     0,
+       0,     0,     0,     0,     0,    90,     0,     0,     0,     0,
+       0,     0,     0,    71,     0,     0,     0,     0,     0,    82,
+      66,    67,    68,    69,    70,    83,    84,    90,     0,    92,
+      60,     0,    90,   114,     0,     0,    40,     0,     0,    38,
+      75,    77,    78,    76,    79,     0,     0,    90,   111,     0,
+      49,     0,     0,    91,    95,    93,     0,    61,     0,    45,
+      46,    47,    48,    43,     0,     0,     0,     0,    85,     0,
+     111,    62,     0,    52,     0,   109,   103,   104,   105,   106,
+     107,   108,     0,     0,     0,    92,    92,    88,     0,     0,
+      40,    58,    32,     0,     0,     0,    63,    50,     0,   110,
+      99,   101,     0,     0,    98,   100,    96,    94,     0,   112,
+      44,     0,    41,     0,    39,     0,    36,     0,    92,     0,
+      53,     0,     0,    89,    42,     0,    33,     0,    34,    36,
+      86,    51,   102,    97,     0,    37,    35,    87,    59
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -172,  -172,   182,  -172,  -172,  -172,  -172,  -172,  -172,  -172,
-    -172,  -172,  -170,  -172,  -172,  -172,    27,    48,  -172,  -172,
-    -172,     2,    18,   -97,  -172,  -172,  -172,  -172,  -172,    -3,
-      51,  -116,    49,    71,    -1,    16,  -110,  -171,  -172,    68,
-      52,  -172,  -172,  -172,  -172
+    -174,  -174,   209,  -174,  -174,  -174,  -174,  -174,  -174,  -174,
+    -174,  -174,  -170,  -174,    10,  -174,  -174,    50,    78,  -174,
+    -174,  -174,    22,  -173,   -97,  -174,  -174,  -174,  -174,  -174,
+      -2,    66,  -118,    75,   100,    13,    38,   -99,  -169,  -174,
+    -174,    95,    79,  -174,  -174,  -174,  -174
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,   180,    30,    31,    32,   154,   126,   195,   152,
-      33,   140,   161,    59,   198,    34,    35,    36,    37,    60,
-      61,    62,   116,   117,   137,   122,   120,   143,   144,   171,
-     160,    38,    39,    40,    74
+       0,    19,    20,    21,    22,    23,    24,    25,    26,    27,
+      28,    29,   183,    30,   218,    31,    32,   155,   126,   201,
+     153,    33,   140,   162,    59,   204,    34,    35,    36,    37,
+      60,    61,    62,   116,   117,   137,   122,   120,   143,   144,
+     145,   172,   161,    38,    39,    40,    74
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-     123,    63,   191,   142,   103,   119,    41,   138,    42,    91,
-      92,   201,   146,    64,   130,    52,    53,    54,    55,    56,
-      52,    53,   141,    55,    56,   163,   164,   159,   136,   208,
-      65,   210,    44,    66,    45,    46,   165,   166,   167,   168,
-     169,   170,   162,   131,    67,    68,    69,   132,   174,    70,
-      89,    90,    91,    92,   133,   188,   190,   142,    72,    43,
-      89,    90,    91,    92,   134,   148,   149,   150,   151,    47,
-      48,    49,    50,    51,   187,   189,   141,    52,    53,    54,
-      55,    56,    88,    57,    58,   110,   142,    73,   162,    89,
-      90,    91,    92,    89,    90,    91,    92,    80,    75,    76,
-      89,    90,    91,    92,    77,   141,    78,    81,    87,    79,
-      89,    90,    91,    92,    86,    82,    83,    84,    85,    94,
-      93,    95,    97,    96,    98,    99,   101,    89,    90,    91,
-      92,   100,   104,   105,   106,   107,   108,     1,     2,   109,
-     111,   112,   113,   114,     3,     4,     5,     6,     7,     8,
-       9,    10,   102,   115,   118,    11,    12,    13,   119,   124,
-     128,   135,    14,    15,   121,   125,   127,   129,   139,   145,
-     147,   153,    16,   155,    17,   158,   156,    18,   175,   173,
-     176,   179,   178,   181,   185,   184,   194,   192,   186,   193,
-     197,   199,   200,   202,   203,   206,   209,   136,   207,   214,
-      71,   177,   212,   204,   196,   211,   157,   182,   205,   213,
-     172,   183
+     123,   142,    63,    41,   103,    42,   196,   197,    52,    53,
+     119,    55,    56,    64,   207,   210,   164,   165,   138,   211,
+      91,    92,   141,   147,    44,    46,    45,   166,   167,   168,
+     169,   170,   171,   136,   130,   216,    65,    66,   160,   220,
+      68,    67,   163,   173,    52,    53,    54,    55,    56,   177,
+      89,    90,    91,    92,   191,    43,   195,   142,   142,    47,
+      48,    49,    50,    51,   192,    69,    70,    52,    53,    54,
+      55,    56,   131,    57,    58,   190,   193,   194,   141,   141,
+      89,    90,    91,    92,   132,    72,   110,    73,   133,    75,
+     142,   163,   134,    76,    78,   163,    77,    88,   149,   150,
+     151,   152,    79,    93,    94,    86,    52,    53,    81,    55,
+      56,   141,    80,   164,   165,   223,    82,    83,    89,    90,
+      91,    92,    84,    87,   166,   167,   168,   169,   170,   171,
+      89,    90,    91,    92,    89,    90,    91,    92,    89,    90,
+      91,    92,    89,    90,    91,    92,    85,   104,   105,   106,
+     107,   108,    96,     1,     2,   111,   112,   113,   114,     3,
+       4,     5,     6,     7,     8,     9,    10,    95,    97,    98,
+      11,    12,    13,    99,   100,   101,   102,    14,    15,   109,
+     115,   119,   118,   121,   124,   125,   127,    16,   129,    17,
+     128,   135,    18,   139,   146,   148,   154,   156,   157,   159,
+     175,   178,   176,   179,   182,   181,   184,   188,   187,   189,
+     198,   203,   205,   200,   199,   206,   208,   209,   212,   214,
+     217,   219,   222,   215,   225,   136,   224,    71,   228,   226,
+     202,   221,   180,   227,   185,   158,   213,   174,     0,   186
 };
 
-static const yytype_uint8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-      97,     4,   173,   119,    21,    36,     8,   117,    10,    69,
-      70,   181,   122,    64,    21,    62,    63,    64,    65,    66,
-      62,    63,   119,    65,    66,    37,    38,   137,    59,   199,
-       9,   202,     8,    33,    10,    20,    48,    49,    50,    51,
-      52,    53,   139,    21,    35,    64,    64,    21,   145,    43,
-      67,    68,    69,    70,    21,   171,   172,   173,     0,    61,
-      67,    68,    69,    70,    21,    26,    27,    28,    29,    54,
-      55,    56,    57,    58,   171,   172,   173,    62,    63,    64,
-      65,    66,    22,    68,    69,    88,   202,     3,   185,    67,
-      68,    69,    70,    67,    68,    69,    70,    46,    64,    64,
-      67,    68,    69,    70,    10,   202,    64,    20,    57,    64,
-      67,    68,    69,    70,    32,    20,    20,    20,    20,    64,
-      35,    64,    48,    40,    44,    20,    64,    67,    68,    69,
-      70,    41,    81,    82,    83,    84,    85,     5,     6,    64,
-      89,    90,    91,    92,    12,    13,    14,    15,    16,    17,
-      18,    19,    41,    64,    34,    23,    24,    25,    36,    66,
-      41,    22,    30,    31,    64,    64,    64,    64,    20,    48,
-      33,    22,    40,    20,    42,    60,    64,    45,     8,    39,
-      20,    64,    21,    20,    22,    21,    62,    22,    38,    64,
-      46,    22,    21,    41,    22,    21,    21,    59,    47,    64,
-      18,   153,    48,   185,   177,   203,   135,   158,   192,   210,
-     142,   159
+      97,   119,     4,     8,    20,    10,   175,   176,    61,    62,
+      35,    64,    65,    63,   184,   188,    36,    37,   117,   192,
+      68,    69,   119,   122,     8,    19,    10,    47,    48,    49,
+      50,    51,    52,    58,    20,   205,     9,    32,   137,   208,
+      63,    34,   139,    63,    61,    62,    63,    64,    65,   146,
+      66,    67,    68,    69,   172,    60,   174,   175,   176,    53,
+      54,    55,    56,    57,    19,    63,    42,    61,    62,    63,
+      64,    65,    20,    67,    68,   172,   173,   174,   175,   176,
+      66,    67,    68,    69,    20,     0,    88,     3,    20,    63,
+     208,   188,    20,    63,    63,   192,    10,    21,    25,    26,
+      27,    28,    63,    34,    63,    31,    61,    62,    19,    64,
+      65,   208,    46,    36,    37,   212,    19,    19,    66,    67,
+      68,    69,    19,    57,    47,    48,    49,    50,    51,    52,
+      66,    67,    68,    69,    66,    67,    68,    69,    66,    67,
+      68,    69,    66,    67,    68,    69,    19,    81,    82,    83,
+      84,    85,    39,     5,     6,    89,    90,    91,    92,    11,
+      12,    13,    14,    15,    16,    17,    18,    63,    47,    43,
+      22,    23,    24,    19,    40,    63,    40,    29,    30,    63,
+      63,    35,    33,    63,    65,    63,    63,    39,    63,    41,
+      40,    21,    44,    19,    47,    32,    21,    19,    63,    59,
+      38,     8,    38,    19,    63,    20,    19,    21,    20,    37,
+      21,    45,    21,    61,    63,    20,    40,    21,    38,    20,
+      63,    20,    20,    46,    63,    58,    47,    18,    63,   219,
+     180,   209,   154,   220,   159,   135,   198,   142,    -1,   160
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,     5,     6,    12,    13,    14,    15,    16,    17,    18,
-      19,    23,    24,    25,    30,    31,    40,    42,    45,    73,
-      74,    75,    76,    77,    78,    79,    80,    81,    82,    83,
-      85,    86,    87,    92,    97,    98,    99,   100,   113,   114,
-     115,     8,    10,    61,     8,    10,    20,    54,    55,    56,
-      57,    58,    62,    63,    64,    65,    66,    68,    69,    95,
-     101,   102,   103,   101,    64,     9,    33,    35,    64,    64,
-      43,    74,     0,     3,   116,    64,    64,    10,    64,    64,
-     102,    20,    20,    20,    20,    20,    32,   102,    22,    67,
-      68,    69,    70,    35,    64,    64,    40,    48,    44,    20,
-      41,    64,    41,    21,   102,   102,   102,   102,   102,    64,
-     101,   102,   102,   102,   102,    64,   104,   105,    34,    36,
-     108,    64,   107,    95,    66,    64,    89,    64,    41,    64,
-      21,    21,    21,    21,    21,    22,    59,   106,   108,    20,
-      93,    95,   103,   109,   110,    48,   108,    33,    26,    27,
-      28,    29,    91,    22,    88,    20,    64,   105,    60,   108,
-     112,    94,    95,    37,    38,    48,    49,    50,    51,    52,
-      53,   111,   111,    39,    95,     8,    20,    89,    21,    64,
-      84,    20,   104,   112,    21,    22,    38,    95,   103,    95,
-     103,   109,    22,    64,    62,    90,    88,    46,    96,    22,
-      21,    84,    41,    22,    94,   107,    21,    47,    84,    21,
-     109,    93,    48,   106,    64
+       0,     5,     6,    11,    12,    13,    14,    15,    16,    17,
+      18,    22,    23,    24,    29,    30,    39,    41,    44,    72,
+      73,    74,    75,    76,    77,    78,    79,    80,    81,    82,
+      84,    86,    87,    92,    97,    98,    99,   100,   114,   115,
+     116,     8,    10,    60,     8,    10,    19,    53,    54,    55,
+      56,    57,    61,    62,    63,    64,    65,    67,    68,    95,
+     101,   102,   103,   101,    63,     9,    32,    34,    63,    63,
+      42,    73,     0,     3,   117,    63,    63,    10,    63,    63,
+     102,    19,    19,    19,    19,    19,    31,   102,    21,    66,
+      67,    68,    69,    34,    63,    63,    39,    47,    43,    19,
+      40,    63,    40,    20,   102,   102,   102,   102,   102,    63,
+     101,   102,   102,   102,   102,    63,   104,   105,    33,    35,
+     108,    63,   107,    95,    65,    63,    89,    63,    40,    63,
+      20,    20,    20,    20,    20,    21,    58,   106,   108,    19,
+      93,    95,   103,   109,   110,   111,    47,   108,    32,    25,
+      26,    27,    28,    91,    21,    88,    19,    63,   105,    59,
+     108,   113,    94,    95,    36,    37,    47,    48,    49,    50,
+      51,    52,   112,    63,   112,    38,    38,    95,     8,    19,
+      89,    20,    63,    83,    19,   104,   113,    20,    21,    37,
+      95,   103,    19,    95,    95,   103,   109,   109,    21,    63,
+      61,    90,    88,    45,    96,    21,    20,    83,    40,    21,
+      94,    94,    38,   107,    20,    46,    83,    63,    85,    20,
+     109,    93,    20,    95,    47,    63,    85,   106,    63
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    72,    73,    74,    74,    74,    74,    74,    74,    74,
-      74,    74,    74,    74,    74,    74,    74,    74,    74,    74,
-      74,    74,    74,    75,    76,    77,    78,    79,    80,    81,
-      82,    83,    84,    84,    85,    85,    86,    87,    88,    88,
-      89,    89,    90,    91,    91,    91,    91,    92,    93,    93,
-      94,    94,    95,    95,    95,    95,    96,    96,    97,    98,
-      99,    99,   100,   101,   101,   102,   102,   102,   102,   102,
-     102,   102,   102,   102,   102,   102,   102,   102,   102,   103,
-     103,   104,   105,   105,   106,   106,   107,   107,   108,   108,
-     109,   109,   109,   110,   110,   110,   110,   111,   111,   111,
-     111,   111,   111,   111,   111,   112,   113,   114,   115,   116,
-     116
+       0,    71,    72,    73,    73,    73,    73,    73,    73,    73,
+      73,    73,    73,    73,    73,    73,    73,    73,    73,    73,
+      73,    73,    73,    74,    75,    76,    77,    78,    79,    80,
+      81,    82,    83,    83,    84,    84,    85,    85,    86,    87,
+      88,    88,    89,    89,    90,    91,    91,    91,    91,    92,
+      93,    93,    94,    94,    95,    95,    95,    95,    96,    96,
+      97,    98,    99,    99,   100,   101,   101,   102,   102,   102,
+     102,   102,   102,   102,   102,   102,   102,   102,   102,   102,
+     102,   103,   103,   104,   105,   105,   106,   106,   107,   107,
+     108,   108,   109,   109,   109,   109,   109,   110,   111,   111,
+     111,   111,   111,   112,   112,   112,   112,   112,   112,   112,
+     112,   113,   114,   115,   116,   117,   117
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     3,
-       2,     2,     1,     3,     8,     9,     5,     8,     0,     3,
-       5,     2,     1,     1,     1,     1,     1,     5,     3,     5,
-       1,     3,     1,     1,     1,     1,     0,     4,     4,     5,
-       6,     7,     2,     1,     3,     3,     3,     3,     3,     3,
-       2,     1,     1,     4,     4,     4,     4,     4,     1,     1,
-       3,     1,     1,     3,     5,     6,     3,     5,     0,     2,
-       0,     1,     3,     3,     3,     3,     3,     1,     1,     1,
-       1,     1,     1,     1,     2,     0,     7,     2,     4,     0,
-       1
+       2,     2,     1,     3,     9,    10,     0,     2,     5,     8,
+       0,     3,     5,     2,     1,     1,     1,     1,     1,     5,
+       3,     5,     1,     3,     1,     1,     1,     1,     0,     4,
+       4,     5,     6,     7,     2,     1,     3,     3,     3,     3,
+       3,     3,     2,     1,     1,     4,     4,     4,     4,     4,
+       1,     1,     3,     1,     1,     3,     5,     6,     3,     5,
+       0,     2,     0,     1,     3,     1,     3,     5,     3,     3,
+       3,     3,     5,     1,     1,     1,     1,     1,     1,     1,
+       2,     0,     7,     2,     4,     0,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -956,10 +975,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -1003,12 +1021,19 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
@@ -1036,24 +1061,32 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location, sql_string, sql_result, scanner); \
+                  Kind, Value, Location, sql_string, sql_result, scanner); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -1064,22 +1097,19 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (yylocationp);
-  YYUSE (sql_string);
-  YYUSE (sql_result);
-  YYUSE (scanner);
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
+  YY_USE (sql_string);
+  YY_USE (sql_result);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -1089,14 +1119,15 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YY
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyo, *yylocationp);
+  YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yytype, yyvaluep, yylocationp, sql_string, sql_result, scanner);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, sql_string, sql_result, scanner);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1129,7 +1160,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1141,9 +1173,9 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule,
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       , sql_string, sql_result, scanner);
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]), sql_string, sql_result, scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1158,8 +1190,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1182,12 +1214,61 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
 static YYPTRDIFF_T
 yystrlen (const char *yystr)
@@ -1197,13 +1278,13 @@ yystrlen (const char *yystr)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -1217,10 +1298,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1235,7 +1316,6 @@ yytnamerr (char *yyres, const char *yystr)
     {
       YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -1269,31 +1349,15 @@ yytnamerr (char *yyres, const char *yystr)
   else
     return yystrlen (yystr);
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
   /* Actual size of YYARG. */
   int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1317,52 +1381,54 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
     default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
@@ -1370,17 +1436,23 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1389,7 +1461,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1401,7 +1473,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
@@ -1412,32 +1484,35 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
-  YYUSE (sql_string);
-  YYUSE (sql_result);
-  YYUSE (scanner);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
+  YY_USE (sql_string);
+  YY_USE (sql_result);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1445,7 +1520,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocatio
 int
 yyparse (const char * sql_string, ParsedSqlResult * sql_result, void * scanner)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1464,55 +1539,50 @@ static YYLTYPE yyloc_default
 YYLTYPE yylloc = yyloc_default;
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYPTRDIFF_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
   YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1520,17 +1590,10 @@ YYLTYPE yylloc = yyloc_default;
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
@@ -1553,10 +1616,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1587,7 +1651,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1598,11 +1662,11 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1622,6 +1686,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1642,18 +1707,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, &yylloc, scanner);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1725,104 +1802,104 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 2:
-#line 213 "yacc_sql.y"
+  case 2: /* commands: command_wrapper opt_semicolon  */
+#line 228 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1735 "yacc_sql.cpp"
+#line 1812 "yacc_sql.cpp"
     break;
 
-  case 23:
-#line 243 "yacc_sql.y"
+  case 23: /* exit_stmt: EXIT  */
+#line 258 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1744 "yacc_sql.cpp"
+#line 1821 "yacc_sql.cpp"
     break;
 
-  case 24:
-#line 249 "yacc_sql.y"
+  case 24: /* help_stmt: HELP  */
+#line 264 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1752 "yacc_sql.cpp"
+#line 1829 "yacc_sql.cpp"
     break;
 
-  case 25:
-#line 254 "yacc_sql.y"
+  case 25: /* sync_stmt: SYNC  */
+#line 269 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1760 "yacc_sql.cpp"
+#line 1837 "yacc_sql.cpp"
     break;
 
-  case 26:
-#line 260 "yacc_sql.y"
+  case 26: /* begin_stmt: TRX_BEGIN  */
+#line 275 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1768 "yacc_sql.cpp"
+#line 1845 "yacc_sql.cpp"
     break;
 
-  case 27:
-#line 266 "yacc_sql.y"
+  case 27: /* commit_stmt: TRX_COMMIT  */
+#line 281 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1776 "yacc_sql.cpp"
+#line 1853 "yacc_sql.cpp"
     break;
 
-  case 28:
-#line 272 "yacc_sql.y"
+  case 28: /* rollback_stmt: TRX_ROLLBACK  */
+#line 287 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1784 "yacc_sql.cpp"
+#line 1861 "yacc_sql.cpp"
     break;
 
-  case 29:
-#line 278 "yacc_sql.y"
+  case 29: /* drop_table_stmt: DROP TABLE ID  */
+#line 293 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1794 "yacc_sql.cpp"
+#line 1871 "yacc_sql.cpp"
     break;
 
-  case 30:
-#line 285 "yacc_sql.y"
+  case 30: /* show_tables_stmt: SHOW TABLES  */
+#line 300 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1802 "yacc_sql.cpp"
+#line 1879 "yacc_sql.cpp"
     break;
 
-  case 31:
-#line 291 "yacc_sql.y"
+  case 31: /* desc_table_stmt: DESC ID  */
+#line 306 "yacc_sql.y"
              {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1812 "yacc_sql.cpp"
+#line 1889 "yacc_sql.cpp"
     break;
 
-  case 32:
-#line 299 "yacc_sql.y"
+  case 32: /* id_list: ID  */
+#line 314 "yacc_sql.y"
        {
       (yyval.id_list) = new std::vector<std::string>();
       (yyval.id_list)->push_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 1822 "yacc_sql.cpp"
+#line 1899 "yacc_sql.cpp"
     break;
 
-  case 33:
-#line 304 "yacc_sql.y"
+  case 33: /* id_list: ID COMMA id_list  */
+#line 319 "yacc_sql.y"
                        {
       if ((yyvsp[0].id_list) != nullptr) {
         (yyval.id_list) = (yyvsp[0].id_list);
@@ -1832,41 +1909,72 @@ yyreduce:
       (yyval.id_list)->insert((yyval.id_list)->begin(), (yyvsp[-2].string));
       free((yyvsp[-2].string));
     }
-#line 1836 "yacc_sql.cpp"
+#line 1913 "yacc_sql.cpp"
     break;
 
-  case 34:
-#line 317 "yacc_sql.y"
+  case 34: /* create_index_stmt: CREATE INDEX ID ON ID LBRACE id_list RBRACE index_type  */
+#line 332 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-      create_index.index_name = (yyvsp[-5].string);
-      create_index.relation_name = (yyvsp[-3].string);
-      create_index.attribute_names.swap(*(yyvsp[-1].id_list));
-      free((yyvsp[-5].string));
-      free((yyvsp[-3].string));
+      create_index.index_name = (yyvsp[-6].string);
+      create_index.relation_name = (yyvsp[-4].string);
+      create_index.attribute_names.swap(*(yyvsp[-2].id_list));
+      free((yyvsp[-6].string));
+      free((yyvsp[-4].string));
+      if ((yyvsp[0].string) != nullptr) {
+        create_index.index_type = (yyvsp[0].string);
+        free((yyvsp[0].string));
+      }
     }
-#line 1850 "yacc_sql.cpp"
+#line 1931 "yacc_sql.cpp"
     break;
 
-  case 35:
-#line 327 "yacc_sql.y"
+  case 35: /* create_index_stmt: CREATE UNIQUE INDEX ID ON ID LBRACE id_list RBRACE index_type  */
+#line 346 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-      create_index.index_name = (yyvsp[-5].string);
-      create_index.relation_name = (yyvsp[-3].string);
-      create_index.attribute_names.swap(*(yyvsp[-1].id_list));
+      create_index.index_name = (yyvsp[-6].string);
+      create_index.relation_name = (yyvsp[-4].string);
+      create_index.attribute_names.swap(*(yyvsp[-2].id_list));
       create_index.unique = true;
-      free((yyvsp[-5].string));
-      free((yyvsp[-3].string));
+      free((yyvsp[-6].string));
+      free((yyvsp[-4].string));
     //   free($7);
+      if ((yyvsp[0].string) != nullptr) {
+        create_index.index_type = (yyvsp[0].string);
+        free((yyvsp[0].string));
+      }
     }
-#line 1866 "yacc_sql.cpp"
+#line 1951 "yacc_sql.cpp"
     break;
 
-  case 36:
-#line 342 "yacc_sql.y"
+  case 36: /* index_type: %empty  */
+#line 365 "yacc_sql.y"
+    {
+      (yyval.string) = nullptr;
+    }
+#line 1959 "yacc_sql.cpp"
+    break;
+
+  case 37: /* index_type: ID ID  */
+#line 369 "yacc_sql.y"
+    {
+      if (strcasecmp((yyvsp[-1].string), "using") != 0) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect USING");
+        free((yyvsp[-1].string));
+        free((yyvsp[0].string));
+        YYERROR;
+      }
+      free((yyvsp[-1].string));
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 1974 "yacc_sql.cpp"
+    break;
+
+  case 38: /* drop_index_stmt: DROP INDEX ID ON ID  */
+#line 383 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
@@ -1874,11 +1982,11 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 1878 "yacc_sql.cpp"
+#line 1986 "yacc_sql.cpp"
     break;
 
-  case 37:
-#line 352 "yacc_sql.y"
+  case 39: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format  */
+#line 393 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
@@ -1899,19 +2007,19 @@ yyreduce:
         free((yyvsp[0].string));
       }
     }
-#line 1903 "yacc_sql.cpp"
+#line 2011 "yacc_sql.cpp"
     break;
 
-  case 38:
-#line 375 "yacc_sql.y"
+  case 40: /* attr_def_list: %empty  */
+#line 416 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 1911 "yacc_sql.cpp"
+#line 2019 "yacc_sql.cpp"
     break;
 
-  case 39:
-#line 379 "yacc_sql.y"
+  case 41: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 420 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -1921,11 +2029,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 1925 "yacc_sql.cpp"
+#line 2033 "yacc_sql.cpp"
     break;
 
-  case 40:
-#line 392 "yacc_sql.y"
+  case 42: /* attr_def: ID type LBRACE number RBRACE  */
+#line 433 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-3].number);
@@ -1933,11 +2041,11 @@ yyreduce:
       (yyval.attr_info)->length = (yyvsp[-1].number);
       free((yyvsp[-4].string));
     }
-#line 1937 "yacc_sql.cpp"
+#line 2045 "yacc_sql.cpp"
     break;
 
-  case 41:
-#line 400 "yacc_sql.y"
+  case 43: /* attr_def: ID type  */
+#line 441 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[0].number);
@@ -1945,41 +2053,41 @@ yyreduce:
       (yyval.attr_info)->length = 4;
       free((yyvsp[-1].string));
     }
-#line 1949 "yacc_sql.cpp"
+#line 2057 "yacc_sql.cpp"
     break;
 
-  case 42:
-#line 409 "yacc_sql.y"
+  case 44: /* number: NUMBER  */
+#line 450 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 1955 "yacc_sql.cpp"
+#line 2063 "yacc_sql.cpp"
     break;
 
-  case 43:
-#line 412 "yacc_sql.y"
+  case 45: /* type: INT_T  */
+#line 453 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::INTS); }
-#line 1961 "yacc_sql.cpp"
+#line 2069 "yacc_sql.cpp"
     break;
 
-  case 44:
-#line 413 "yacc_sql.y"
+  case 46: /* type: STRING_T  */
+#line 454 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::CHARS); }
-#line 1967 "yacc_sql.cpp"
+#line 2075 "yacc_sql.cpp"
     break;
 
-  case 45:
-#line 414 "yacc_sql.y"
+  case 47: /* type: FLOAT_T  */
+#line 455 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::FLOATS); }
-#line 1973 "yacc_sql.cpp"
+#line 2081 "yacc_sql.cpp"
     break;
 
-  case 46:
-#line 415 "yacc_sql.y"
+  case 48: /* type: DATE_T  */
+#line 456 "yacc_sql.y"
                { (yyval.number) = static_cast<int>(AttrType::DATES); }
-#line 1979 "yacc_sql.cpp"
+#line 2087 "yacc_sql.cpp"
     break;
 
-  case 47:
-#line 419 "yacc_sql.y"
+  case 49: /* insert_stmt: INSERT INTO ID VALUES insert_list  */
+#line 460 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-2].string);
@@ -1987,21 +2095,21 @@ yyreduce:
       delete (yyvsp[0].insert_list);
       free((yyvsp[-2].string));
     }
-#line 1991 "yacc_sql.cpp"
+#line 2099 "yacc_sql.cpp"
     break;
 
-  case 48:
-#line 429 "yacc_sql.y"
+  case 50: /* insert_list: LBRACE value_list RBRACE  */
+#line 470 "yacc_sql.y"
     {
       (yyval.insert_list) = new std::vector<std::vector<Value>>();
       (yyval.insert_list)->push_back(*(yyvsp[-1].value_list));
       delete (yyvsp[-1].value_list);
     }
-#line 2001 "yacc_sql.cpp"
+#line 2109 "yacc_sql.cpp"
     break;
 
-  case 49:
-#line 435 "yacc_sql.y"
+  case 51: /* insert_list: LBRACE value_list RBRACE COMMA insert_list  */
+#line 476 "yacc_sql.y"
     {
       (yyval.insert_list) = new std::vector<std::vector<Value>>();
       if ((yyvsp[0].insert_list) != nullptr) {
@@ -2014,21 +2122,21 @@ yyreduce:
       delete (yyvsp[0].insert_list);
       delete (yyvsp[-3].value_list);
     }
-#line 2018 "yacc_sql.cpp"
+#line 2126 "yacc_sql.cpp"
     break;
 
-  case 50:
-#line 450 "yacc_sql.y"
+  case 52: /* value_list: value  */
+#line 491 "yacc_sql.y"
     {
       (yyval.value_list) = new std::vector<Value>();
       (yyval.value_list)->push_back(*(yyvsp[0].value));
       delete (yyvsp[0].value);
     }
-#line 2028 "yacc_sql.cpp"
+#line 2136 "yacc_sql.cpp"
     break;
 
-  case 51:
-#line 456 "yacc_sql.y"
+  case 53: /* value_list: value COMMA value_list  */
+#line 497 "yacc_sql.y"
     { 
       (yyval.value_list) = new std::vector<Value>();
       if ((yyvsp[0].value_list) != nullptr) {
@@ -2038,40 +2146,40 @@ yyreduce:
 
       delete (yyvsp[-2].value);
     }
-#line 2042 "yacc_sql.cpp"
+#line 2150 "yacc_sql.cpp"
     break;
 
-  case 52:
-#line 467 "yacc_sql.y"
+  case 54: /* value: NUMBER  */
+#line 508 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2051 "yacc_sql.cpp"
+#line 2159 "yacc_sql.cpp"
     break;
 
-  case 53:
-#line 471 "yacc_sql.y"
+  case 55: /* value: FLOAT  */
+#line 512 "yacc_sql.y"
            {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2060 "yacc_sql.cpp"
+#line 2168 "yacc_sql.cpp"
     break;
 
-  case 54:
-#line 475 "yacc_sql.y"
+  case 56: /* value: SSS  */
+#line 516 "yacc_sql.y"
          {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
       free((yyvsp[0].string));
     }
-#line 2071 "yacc_sql.cpp"
+#line 2179 "yacc_sql.cpp"
     break;
 
-  case 55:
-#line 481 "yacc_sql.y"
+  case 57: /* value: DATE_STR  */
+#line 522 "yacc_sql.y"
               {
       // char *tmp = common::substr($1,1,strlen($1)-2);
       // $$ = new Value(tmp);
@@ -2092,27 +2200,27 @@ yyreduce:
       (yyval.value) = value;
       free(tmp);
     }
-#line 2096 "yacc_sql.cpp"
+#line 2204 "yacc_sql.cpp"
     break;
 
-  case 56:
-#line 504 "yacc_sql.y"
+  case 58: /* storage_format: %empty  */
+#line 545 "yacc_sql.y"
     {
       (yyval.string) = nullptr;
     }
-#line 2104 "yacc_sql.cpp"
+#line 2212 "yacc_sql.cpp"
     break;
 
-  case 57:
-#line 508 "yacc_sql.y"
+  case 59: /* storage_format: STORAGE FORMAT EQ ID  */
+#line 549 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2112 "yacc_sql.cpp"
+#line 2220 "yacc_sql.cpp"
     break;
 
-  case 58:
-#line 515 "yacc_sql.y"
+  case 60: /* delete_stmt: DELETE FROM ID where  */
+#line 556 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
@@ -2122,11 +2230,11 @@ yyreduce:
       }
       free((yyvsp[-1].string));
     }
-#line 2126 "yacc_sql.cpp"
+#line 2234 "yacc_sql.cpp"
     break;
 
-  case 59:
-#line 527 "yacc_sql.y"
+  case 61: /* update_stmt: UPDATE ID SET eq_list where  */
+#line 568 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-3].string);
@@ -2142,11 +2250,11 @@ yyreduce:
       free((yyvsp[-3].string));
       delete (yyvsp[-1].eq_list);
     }
-#line 2146 "yacc_sql.cpp"
+#line 2254 "yacc_sql.cpp"
     break;
 
-  case 60:
-#line 545 "yacc_sql.y"
+  case 62: /* select_stmt: SELECT expression_list FROM rel_list where group_by  */
+#line 586 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[-4].expression_list) != nullptr) {
@@ -2169,11 +2277,11 @@ yyreduce:
         delete (yyvsp[0].expression_list);
       }
     }
-#line 2173 "yacc_sql.cpp"
+#line 2281 "yacc_sql.cpp"
     break;
 
-  case 61:
-#line 569 "yacc_sql.y"
+  case 63: /* select_stmt: SELECT expression_list FROM rel_list join_list where group_by  */
+#line 610 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
       if ((yyvsp[-5].expression_list) != nullptr) {
@@ -2206,30 +2314,30 @@ yyreduce:
         delete (yyvsp[0].expression_list);
       }
     }
-#line 2210 "yacc_sql.cpp"
+#line 2318 "yacc_sql.cpp"
     break;
 
-  case 62:
-#line 604 "yacc_sql.y"
+  case 64: /* calc_stmt: CALC expression_list  */
+#line 645 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 2220 "yacc_sql.cpp"
+#line 2328 "yacc_sql.cpp"
     break;
 
-  case 63:
-#line 613 "yacc_sql.y"
+  case 65: /* expression_list: expression  */
+#line 654 "yacc_sql.y"
     {
       (yyval.expression_list) = new std::vector<std::unique_ptr<Expression>>;
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2229 "yacc_sql.cpp"
+#line 2337 "yacc_sql.cpp"
     break;
 
-  case 64:
-#line 618 "yacc_sql.y"
+  case 66: /* expression_list: expression COMMA expression_list  */
+#line 659 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2238,139 +2346,139 @@ yyreduce:
       }
       (yyval.expression_list)->emplace((yyval.expression_list)->begin(), (yyvsp[-2].expression));
     }
-#line 2242 "yacc_sql.cpp"
+#line 2350 "yacc_sql.cpp"
     break;
 
-  case 65:
-#line 628 "yacc_sql.y"
+  case 67: /* expression: expression '+' expression  */
+#line 669 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2250 "yacc_sql.cpp"
+#line 2358 "yacc_sql.cpp"
     break;
 
-  case 66:
-#line 631 "yacc_sql.y"
+  case 68: /* expression: expression '-' expression  */
+#line 672 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2258 "yacc_sql.cpp"
+#line 2366 "yacc_sql.cpp"
     break;
 
-  case 67:
-#line 634 "yacc_sql.y"
+  case 69: /* expression: expression '*' expression  */
+#line 675 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2266 "yacc_sql.cpp"
+#line 2374 "yacc_sql.cpp"
     break;
 
-  case 68:
-#line 637 "yacc_sql.y"
+  case 70: /* expression: expression '/' expression  */
+#line 678 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2274 "yacc_sql.cpp"
+#line 2382 "yacc_sql.cpp"
     break;
 
-  case 69:
-#line 640 "yacc_sql.y"
+  case 71: /* expression: LBRACE expression RBRACE  */
+#line 681 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2283 "yacc_sql.cpp"
+#line 2391 "yacc_sql.cpp"
     break;
 
-  case 70:
-#line 644 "yacc_sql.y"
+  case 72: /* expression: '-' expression  */
+#line 685 "yacc_sql.y"
                                   {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2291 "yacc_sql.cpp"
+#line 2399 "yacc_sql.cpp"
     break;
 
-  case 71:
-#line 647 "yacc_sql.y"
+  case 73: /* expression: value  */
+#line 688 "yacc_sql.y"
             {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value);
     }
-#line 2301 "yacc_sql.cpp"
+#line 2409 "yacc_sql.cpp"
     break;
 
-  case 72:
-#line 652 "yacc_sql.y"
+  case 74: /* expression: rel_attr  */
+#line 693 "yacc_sql.y"
                {
       RelAttrSqlNode *node = (yyvsp[0].rel_attr);
       (yyval.expression) = new UnboundFieldExpr(node->relation_name, node->attribute_name);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].rel_attr);
     }
-#line 2312 "yacc_sql.cpp"
+#line 2420 "yacc_sql.cpp"
     break;
 
-  case 73:
-#line 658 "yacc_sql.y"
+  case 75: /* expression: COUNT LBRACE expression RBRACE  */
+#line 699 "yacc_sql.y"
                                      {
       (yyval.expression) = create_aggregate_expression("count", (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2320 "yacc_sql.cpp"
+#line 2428 "yacc_sql.cpp"
     break;
 
-  case 74:
-#line 661 "yacc_sql.y"
+  case 76: /* expression: AVG LBRACE expression RBRACE  */
+#line 702 "yacc_sql.y"
                                    {
       (yyval.expression) = create_aggregate_expression("avg", (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2328 "yacc_sql.cpp"
+#line 2436 "yacc_sql.cpp"
     break;
 
-  case 75:
-#line 664 "yacc_sql.y"
+  case 77: /* expression: MAX LBRACE expression RBRACE  */
+#line 705 "yacc_sql.y"
                                    {
       (yyval.expression) = create_aggregate_expression("max", (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2336 "yacc_sql.cpp"
+#line 2444 "yacc_sql.cpp"
     break;
 
-  case 76:
-#line 667 "yacc_sql.y"
+  case 78: /* expression: MIN LBRACE expression RBRACE  */
+#line 708 "yacc_sql.y"
                                    {
       (yyval.expression) = create_aggregate_expression("min", (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2344 "yacc_sql.cpp"
+#line 2452 "yacc_sql.cpp"
     break;
 
-  case 77:
-#line 670 "yacc_sql.y"
+  case 79: /* expression: SUM LBRACE expression RBRACE  */
+#line 711 "yacc_sql.y"
                                    {
       (yyval.expression) = create_aggregate_expression("sum", (yyvsp[-1].expression), sql_string, &(yyloc));
     }
-#line 2352 "yacc_sql.cpp"
+#line 2460 "yacc_sql.cpp"
     break;
 
-  case 78:
-#line 673 "yacc_sql.y"
+  case 80: /* expression: '*'  */
+#line 714 "yacc_sql.y"
           {
       (yyval.expression) = new StarExpr();
     }
-#line 2360 "yacc_sql.cpp"
+#line 2468 "yacc_sql.cpp"
     break;
 
-  case 79:
-#line 680 "yacc_sql.y"
+  case 81: /* rel_attr: ID  */
+#line 721 "yacc_sql.y"
        {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->attribute_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2370 "yacc_sql.cpp"
+#line 2478 "yacc_sql.cpp"
     break;
 
-  case 80:
-#line 685 "yacc_sql.y"
+  case 82: /* rel_attr: ID DOT ID  */
+#line 726 "yacc_sql.y"
                 {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->relation_name  = (yyvsp[-2].string);
@@ -2378,29 +2486,29 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2382 "yacc_sql.cpp"
+#line 2490 "yacc_sql.cpp"
     break;
 
-  case 81:
-#line 695 "yacc_sql.y"
+  case 83: /* relation: ID  */
+#line 736 "yacc_sql.y"
        {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2390 "yacc_sql.cpp"
+#line 2498 "yacc_sql.cpp"
     break;
 
-  case 82:
-#line 700 "yacc_sql.y"
+  case 84: /* rel_list: relation  */
+#line 741 "yacc_sql.y"
              {
       (yyval.relation_list) = new std::vector<std::string>();
       (yyval.relation_list)->push_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 2400 "yacc_sql.cpp"
+#line 2508 "yacc_sql.cpp"
     break;
 
-  case 83:
-#line 705 "yacc_sql.y"
+  case 85: /* rel_list: relation COMMA rel_list  */
+#line 746 "yacc_sql.y"
                               {
       if ((yyvsp[0].relation_list) != nullptr) {
         (yyval.relation_list) = (yyvsp[0].relation_list);
@@ -2411,22 +2519,22 @@ yyreduce:
       (yyval.relation_list)->insert((yyval.relation_list)->begin(), (yyvsp[-2].string));
       free((yyvsp[-2].string));
     }
-#line 2415 "yacc_sql.cpp"
+#line 2523 "yacc_sql.cpp"
     break;
 
-  case 84:
-#line 717 "yacc_sql.y"
+  case 86: /* join_list: INNER JOIN relation ON condition_list  */
+#line 758 "yacc_sql.y"
                                           {
       (yyval.join_list) = new std::vector<std::pair<std::string, std::vector<ConditionSqlNode>>>();
       (yyval.join_list)->push_back({std::string((yyvsp[-2].string)), *(yyvsp[0].condition_list)});
       free((yyvsp[-2].string));
       delete (yyvsp[0].condition_list);
     }
-#line 2426 "yacc_sql.cpp"
+#line 2534 "yacc_sql.cpp"
     break;
 
-  case 85:
-#line 723 "yacc_sql.y"
+  case 87: /* join_list: INNER JOIN relation ON condition_list join_list  */
+#line 764 "yacc_sql.y"
                                                       {
       if ((yyvsp[0].join_list) != nullptr) {
         (yyval.join_list) = (yyvsp[0].join_list);
@@ -2438,22 +2546,22 @@ yyreduce:
       free((yyvsp[-3].string));
       delete (yyvsp[-1].condition_list);
     }
-#line 2442 "yacc_sql.cpp"
+#line 2550 "yacc_sql.cpp"
     break;
 
-  case 86:
-#line 736 "yacc_sql.y"
+  case 88: /* eq_list: ID EQ value  */
+#line 777 "yacc_sql.y"
                 {
       (yyval.eq_list) = new std::vector<std::pair<std::string, Value>>();
       (yyval.eq_list)->push_back({std::string((yyvsp[-2].string)), *(yyvsp[0].value)});
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 2453 "yacc_sql.cpp"
+#line 2561 "yacc_sql.cpp"
     break;
 
-  case 87:
-#line 742 "yacc_sql.y"
+  case 89: /* eq_list: ID EQ value COMMA eq_list  */
+#line 783 "yacc_sql.y"
                                 {
       if ((yyvsp[0].eq_list) != nullptr) {
         (yyval.eq_list) = (yyvsp[0].eq_list);
@@ -2465,55 +2573,97 @@ yyreduce:
       free((yyvsp[-4].string));
       delete (yyvsp[-2].value);
     }
-#line 2469 "yacc_sql.cpp"
+#line 2577 "yacc_sql.cpp"
     break;
 
-  case 88:
-#line 757 "yacc_sql.y"
+  case 90: /* where: %empty  */
+#line 798 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2477 "yacc_sql.cpp"
+#line 2585 "yacc_sql.cpp"
     break;
 
-  case 89:
-#line 760 "yacc_sql.y"
+  case 91: /* where: WHERE condition_list  */
+#line 801 "yacc_sql.y"
                            {
       (yyval.condition_list) = (yyvsp[0].condition_list);  
     }
-#line 2485 "yacc_sql.cpp"
+#line 2593 "yacc_sql.cpp"
     break;
 
-  case 90:
-#line 766 "yacc_sql.y"
+  case 92: /* condition_list: %empty  */
+#line 807 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2493 "yacc_sql.cpp"
+#line 2601 "yacc_sql.cpp"
     break;
 
-  case 91:
-#line 769 "yacc_sql.y"
+  case 93: /* condition_list: condition  */
+#line 810 "yacc_sql.y"
                 {
       (yyval.condition_list) = new std::vector<ConditionSqlNode>;
       (yyval.condition_list)->emplace_back(*(yyvsp[0].condition));
       delete (yyvsp[0].condition);
     }
-#line 2503 "yacc_sql.cpp"
+#line 2611 "yacc_sql.cpp"
     break;
 
-  case 92:
-#line 774 "yacc_sql.y"
+  case 94: /* condition_list: condition AND condition_list  */
+#line 815 "yacc_sql.y"
                                    {
       (yyval.condition_list) = (yyvsp[0].condition_list);
       (yyval.condition_list)->emplace_back(*(yyvsp[-2].condition));
       delete (yyvsp[-2].condition);
     }
-#line 2513 "yacc_sql.cpp"
+#line 2621 "yacc_sql.cpp"
+    break;
+
+  case 95: /* condition_list: between_condition  */
+#line 820 "yacc_sql.y"
+                        {
+      (yyval.condition_list) = (yyvsp[0].condition_list);
+    }
+#line 2629 "yacc_sql.cpp"
+    break;
+
+  case 96: /* condition_list: between_condition AND condition_list  */
+#line 823 "yacc_sql.y"
+                                           {
+      (yyval.condition_list) = (yyvsp[0].condition_list);
+      (yyval.condition_list)->insert((yyval.condition_list)->end(), (yyvsp[-2].condition_list)->begin(), (yyvsp[-2].condition_list)->end());
+      delete (yyvsp[-2].condition_list);
+    }
+#line 2639 "yacc_sql.cpp"
     break;
 
-  case 93:
-#line 782 "yacc_sql.y"
+  case 97: /* between_condition: rel_attr ID value AND value  */
+#line 832 "yacc_sql.y"
+    {
+      if (strcasecmp((yyvsp[-3].string), "between") != 0) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect BETWEEN");
+        free((yyvsp[-3].string));
+        delete (yyvsp[-4].rel_attr);
+        delete (yyvsp[-2].value);
+        delete (yyvsp[0].value);
+        YYERROR;
+      }
+
+      // a BETWEEN x AND y 等价于 a >= x AND a <= y
+      (yyval.condition_list) = new std::vector<ConditionSqlNode>;
+      (yyval.condition_list)->emplace_back(create_attr_value_condition(*(yyvsp[-4].rel_attr), LESS_EQUAL, *(yyvsp[0].value)));
+      (yyval.condition_list)->emplace_back(create_attr_value_condition(*(yyvsp[-4].rel_attr), GREAT_EQUAL, *(yyvsp[-2].value)));
+      free((yyvsp[-3].string));
+      delete (yyvsp[-4].rel_attr);
+      delete (yyvsp[-2].value);
+      delete (yyvsp[0].value);
+    }
+#line 2663 "yacc_sql.cpp"
+    break;
+
+  case 98: /* condition: rel_attr comp_op value  */
+#line 854 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 1;
@@ -2525,11 +2675,11 @@ yyreduce:
       delete (yyvsp[-2].rel_attr);
       delete (yyvsp[0].value);
     }
-#line 2529 "yacc_sql.cpp"
+#line 2679 "yacc_sql.cpp"
     break;
 
-  case 94:
-#line 794 "yacc_sql.y"
+  case 99: /* condition: value comp_op value  */
+#line 866 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 0;
@@ -2541,11 +2691,11 @@ yyreduce:
       delete (yyvsp[-2].value);
       delete (yyvsp[0].value);
     }
-#line 2545 "yacc_sql.cpp"
+#line 2695 "yacc_sql.cpp"
     break;
 
-  case 95:
-#line 806 "yacc_sql.y"
+  case 100: /* condition: rel_attr comp_op rel_attr  */
+#line 878 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 1;
@@ -2557,11 +2707,11 @@ yyreduce:
       delete (yyvsp[-2].rel_attr);
       delete (yyvsp[0].rel_attr);
     }
-#line 2561 "yacc_sql.cpp"
+#line 2711 "yacc_sql.cpp"
     break;
 
-  case 96:
-#line 818 "yacc_sql.y"
+  case 101: /* condition: value comp_op rel_attr  */
+#line 890 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 0;
@@ -2573,67 +2723,92 @@ yyreduce:
       delete (yyvsp[-2].value);
       delete (yyvsp[0].rel_attr);
     }
-#line 2577 "yacc_sql.cpp"
+#line 2727 "yacc_sql.cpp"
     break;
 
-  case 97:
-#line 832 "yacc_sql.y"
+  case 102: /* condition: rel_attr ID LBRACE value_list RBRACE  */
+#line 902 "yacc_sql.y"
+    {
+      if (strcasecmp((yyvsp[-3].string), "in") != 0) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "syntax error, expect IN");
+        free((yyvsp[-3].string));
+        delete (yyvsp[-4].rel_attr);
+        delete (yyvsp[-1].value_list);
+        YYERROR;
+      }
+
+      (yyval.condition) = new ConditionSqlNode;
+      (yyval.condition)->left_is_attr = 1;
+      (yyval.condition)->left_attr = *(yyvsp[-4].rel_attr);
+      (yyval.condition)->right_is_attr = 0;
+      (yyval.condition)->right_values.swap(*(yyvsp[-1].value_list));
+      (yyval.condition)->comp = IN_OP;
+
+      free((yyvsp[-3].string));
+      delete (yyvsp[-4].rel_attr);
+      delete (yyvsp[-1].value_list);
+    }
+#line 2752 "yacc_sql.cpp"
+    break;
+
+  case 103: /* comp_op: EQ  */
+#line 925 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 2583 "yacc_sql.cpp"
+#line 2758 "yacc_sql.cpp"
     break;
 
-  case 98:
-#line 833 "yacc_sql.y"
+  case 104: /* comp_op: LT  */
+#line 926 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 2589 "yacc_sql.cpp"
+#line 2764 "yacc_sql.cpp"
     break;
 
-  case 99:
-#line 834 "yacc_sql.y"
+  case 105: /* comp_op: GT  */
+#line 927 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 2595 "yacc_sql.cpp"
+#line 2770 "yacc_sql.cpp"
     break;
 
-  case 100:
-#line 835 "yacc_sql.y"
+  case 106: /* comp_op: LE  */
+#line 928 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 2601 "yacc_sql.cpp"
+#line 2776 "yacc_sql.cpp"
     break;
 
-  case 101:
-#line 836 "yacc_sql.y"
+  case 107: /* comp_op: GE  */
+#line 929 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 2607 "yacc_sql.cpp"
+#line 2782 "yacc_sql.cpp"
     break;
 
-  case 102:
-#line 837 "yacc_sql.y"
+  case 108: /* comp_op: NE  */
+#line 930 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 2613 "yacc_sql.cpp"
+#line 2788 "yacc_sql.cpp"
     break;
 
-  case 103:
-#line 838 "yacc_sql.y"
+  case 109: /* comp_op: LIKE  */
+#line 931 "yacc_sql.y"
            { (yyval.comp) = LIKE_OP; }
-#line 2619 "yacc_sql.cpp"
+#line 2794 "yacc_sql.cpp"
     break;
 
-  case 104:
-#line 839 "yacc_sql.y"
+  case 110: /* comp_op: NOT LIKE  */
+#line 932 "yacc_sql.y"
                { (yyval.comp) = NOT_LIKE_OP; }
-#line 2625 "yacc_sql.cpp"
+#line 2800 "yacc_sql.cpp"
     break;
 
-  case 105:
-#line 845 "yacc_sql.y"
+  case 111: /* group_by: %empty  */
+#line 938 "yacc_sql.y"
     {
       (yyval.expression_list) = nullptr;
     }
-#line 2633 "yacc_sql.cpp"
+#line 2808 "yacc_sql.cpp"
     break;
 
-  case 106:
-#line 851 "yacc_sql.y"
+  case 112: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 944 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -2643,20 +2818,20 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 2647 "yacc_sql.cpp"
+#line 2822 "yacc_sql.cpp"
     break;
 
-  case 107:
-#line 864 "yacc_sql.y"
+  case 113: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 957 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 2656 "yacc_sql.cpp"
+#line 2831 "yacc_sql.cpp"
     break;
 
-  case 108:
-#line 872 "yacc_sql.y"
+  case 114: /* set_variable_stmt: SET ID EQ value  */
+#line 965 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
@@ -2664,11 +2839,11 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 2668 "yacc_sql.cpp"
+#line 2843 "yacc_sql.cpp"
     break;
 
 
-#line 2672 "yacc_sql.cpp"
+#line 2847 "yacc_sql.cpp"
 
       default: break;
     }
@@ -2683,11 +2858,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -2712,50 +2886,45 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (&yylloc, sql_string, sql_result, scanner, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (&yylloc, sql_string, sql_result, scanner, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2788,6 +2957,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2804,13 +2974,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2824,7 +2995,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp, sql_string, sql_result, scanner);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, sql_string, sql_result, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2835,13 +3006,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2852,7 +3021,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2860,24 +3029,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (&yylloc, sql_string, sql_result, scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2893,20 +3060,19 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp, yylsp, sql_string, sql_result, scanner);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, sql_string, sql_result, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 884 "yacc_sql.y"
+
+#line 977 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
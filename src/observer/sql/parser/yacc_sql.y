@@ -52,6 +52,20 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
   return expr;
 }
 
+/**
+ * @brief 生成字段与常量比较的条件，用于 BETWEEN 展开成的两个比较
+ */
+ConditionSqlNode create_attr_value_condition(const RelAttrSqlNode &attr, CompOp comp, const Value &value)
+{
+  ConditionSqlNode condition;
+  condition.left_is_attr = 1;
+  condition.left_attr = attr;
+  condition.right_is_attr = 0;
+  condition.right_value = value;
+  condition.comp = comp;
+  return condition;
+}
+
 %}
 
 %define api.pure full
@@ -172,7 +186,9 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <insert_list>         insert_list
 %type <condition_list>      where
 %type <condition_list>      condition_list
+%type <condition_list>      between_condition
 %type <string>              storage_format
+%type <string>              index_type
 %type <relation_list>       rel_list
 %type <join_list>           join_list
 %type <eq_list>             eq_list
@@ -312,7 +328,7 @@ id_list:
     ;
 
 create_index_stmt:    /*create index 语句的语法解析树*/
-    CREATE INDEX ID ON ID LBRACE id_list RBRACE
+    CREATE INDEX ID ON ID LBRACE id_list RBRACE index_type
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
@@ -321,8 +337,12 @@ create_index_stmt:    /*create index 语句的语法解析树*/
       create_index.attribute_names.swap(*$7);
       free($3);
       free($5);
+      if ($9 != nullptr) {
+        create_index.index_type = $9;
+        free($9);
+      }
     }
-    | CREATE UNIQUE INDEX ID ON ID LBRACE id_list RBRACE
+    | CREATE UNIQUE INDEX ID ON ID LBRACE id_list RBRACE index_type
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
@@ -333,6 +353,28 @@ create_index_stmt:    /*create index 语句的语法解析树*/
       free($4);
       free($6);
     //   free($7);
+      if ($10 != nullptr) {
+        create_index.index_type = $10;
+        free($10);
+      }
+    }
+    ;
+/* USING 不是关键字，按照标识符解析 */
+index_type:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | ID ID
+    {
+      if (strcasecmp($1, "using") != 0) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect USING");
+        free($1);
+        free($2);
+        YYERROR;
+      }
+      free($1);
+      $$ = $2;
     }
     ;
 
@@ -775,6 +817,37 @@ condition_list:
       $$->emplace_back(*$1);
       delete $1;
     }
+    | between_condition {
+      $$ = $1;
+    }
+    | between_condition AND condition_list {
+      $$ = $3;
+      $$->insert($$->end(), $1->begin(), $1->end());
+      delete $1;
+    }
+    ;
+/* IN 和 BETWEEN 不是关键字，按照标识符解析，避免影响使用这些名字的表和字段 */
+between_condition:
+    rel_attr ID value AND value
+    {
+      if (strcasecmp($2, "between") != 0) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect BETWEEN");
+        free($2);
+        delete $1;
+        delete $3;
+        delete $5;
+        YYERROR;
+      }
+
+      // a BETWEEN x AND y 等价于 a >= x AND a <= y
+      $$ = new std::vector<ConditionSqlNode>;
+      $$->emplace_back(create_attr_value_condition(*$1, LESS_EQUAL, *$5));
+      $$->emplace_back(create_attr_value_condition(*$1, GREAT_EQUAL, *$3));
+      free($2);
+      delete $1;
+      delete $3;
+      delete $5;
+    }
     ;
 condition:
     rel_attr comp_op value
@@ -825,6 +898,27 @@ condition:
       delete $1;
       delete $3;
     }
+    | rel_attr ID LBRACE value_list RBRACE
+    {
+      if (strcasecmp($2, "in") != 0) {
+        yyerror(&@$, sql_string, sql_result, scanner, "syntax error, expect IN");
+        free($2);
+        delete $1;
+        delete $4;
+        YYERROR;
+      }
+
+      $$ = new ConditionSqlNode;
+      $$->left_is_attr = 1;
+      $$->left_attr = *$1;
+      $$->right_is_attr = 0;
+      $$->right_values.swap(*$4);
+      $$->comp = IN_OP;
+
+      free($2);
+      delete $1;
+      delete $4;
+    }
     ;
 
 comp_op:
@@ -0,0 +1,40 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/plan_cache/cached_plan_physical_operator.h"
+#include "common/log/log.h"
+
+CachedPlanPhysicalOperator::CachedPlanPhysicalOperator(
+    PlanCache *plan_cache, shared_ptr<PlanCacheEntry> entry, unique_ptr<CachedPlan> plan)
+    : plan_cache_(plan_cache), entry_(std::move(entry)), plan_(std::move(plan))
+{}
+
+CachedPlanPhysicalOperator::~CachedPlanPhysicalOperator()
+{
+  plan_cache_->release(entry_, std::move(plan_), reusable_);
+}
+
+RC CachedPlanPhysicalOperator::open(Trx *trx)
+{
+  // 在正常关闭之前，计划都不能给别的请求使用
+  reusable_ = false;
+  return plan_->physical_oper->open(trx);
+}
+
+RC CachedPlanPhysicalOperator::close()
+{
+  RC rc = plan_->physical_oper->close();
+  if (OB_SUCC(rc)) {
+    reusable_ = true;
+  } else {
+    LOG_WARN("failed to close cached plan. rc=%s", strrc(rc));
+  }
+  return rc;
+}
@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/plan_cache/plan_cache.h"
+
+/**
+ * @brief 包装一份从缓存中取出的计划
+ * @ingroup PhysicalOperator
+ * @details 所有的调用都转发给真正的计划。SqlResult 执行完会销毁算子，此时把计划归还给缓存。
+ * 如果计划打开之后没有正常关闭，内部状态可能不完整，就直接丢弃。
+ */
+class CachedPlanPhysicalOperator : public PhysicalOperator
+{
+public:
+  CachedPlanPhysicalOperator(PlanCache *plan_cache, shared_ptr<PlanCacheEntry> entry, unique_ptr<CachedPlan> plan);
+  virtual ~CachedPlanPhysicalOperator();
+
+  std::string name() const override { return plan_->physical_oper->name(); }
+  std::string param() const override { return plan_->physical_oper->param(); }
+
+  PhysicalOperatorType type() const override { return plan_->physical_oper->type(); }
+
+  RC open(Trx *trx) override;
+  RC next() override { return plan_->physical_oper->next(); }
+  RC next(Chunk &chunk) override { return plan_->physical_oper->next(chunk); }
+  RC close() override;
+
+  Tuple *current_tuple() override { return plan_->physical_oper->current_tuple(); }
+
+  RC tuple_schema(TupleSchema &schema) const override { return plan_->physical_oper->tuple_schema(schema); }
+
+private:
+  PlanCache                 *plan_cache_ = nullptr;
+  shared_ptr<PlanCacheEntry> entry_;
+  unique_ptr<CachedPlan>     plan_;
+  bool                       reusable_ = true;
+};
@@ -0,0 +1,114 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sql/plan_cache/parameterized_sql.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+#include "common/time/datetime.h"
+#include "common/type/attr_type.h"
+#include "sql/parser/parse_defs.h"
+#include "sql/parser/yacc_sql.hpp"
+#include "sql/parser/lex_sql.h"
+
+extern void scan_string(const char *str, yyscan_t scanner);
+
+/**
+ * @brief 与语法文件中 value 规则的处理方式保持一致，把常量token转换成Value
+ */
+static RC literal_value(int token, const YYSTYPE &yylval, Value &value)
+{
+  switch (token) {
+    case NUMBER: {
+      value = Value(yylval.number);
+    } break;
+    case FLOAT: {
+      value = Value(yylval.floats);
+    } break;
+    case SSS: {
+      char *tmp = common::substr(yylval.string, 1, strlen(yylval.string) - 2);
+      value     = Value(tmp);
+      free(tmp);
+    } break;
+    case DATE_STR: {
+      char   *tmp = common::substr(yylval.string, 1, strlen(yylval.string) - 2);
+      string  str(tmp);
+      int32_t date = 0;
+      free(tmp);
+      if (string_to_date(str, date) < 0) {
+        LOG_TRACE("invalid date literal. date=%s", str.c_str());
+        return RC::INVALID_ARGUMENT;
+      }
+      value.set_date(date);
+    } break;
+    default: {
+      return RC::NOTFOUND;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC ParameterizedSql::parameterize(const string &sql, ParameterizedSql &result)
+{
+  result.key_.clear();
+  result.literals_.clear();
+  result.is_select_ = false;
+
+  yyscan_t scanner;
+  yylex_init(&scanner);
+  scan_string(sql.c_str(), scanner);
+
+  RC     rc         = RC::SUCCESS;
+  size_t copied_pos = 0;  // sql中已经拷贝到key的位置
+  bool   first      = true;
+  while (OB_SUCC(rc)) {
+    YYSTYPE yylval;
+    YYLTYPE yylloc;
+    memset(&yylval, 0, sizeof(yylval));
+    int token = yylex(&yylval, &yylloc, scanner);
+    if (token == 0) {
+      break;
+    }
+
+    if (first) {
+      result.is_select_ = (token == SELECT);
+      first             = false;
+    }
+
+    Value value;
+    RC    value_rc = literal_value(token, yylval, value);
+    if (value_rc == RC::SUCCESS) {
+      const size_t begin = yylloc.first_column;
+      const size_t end   = yylloc.last_column + 1;
+
+      result.key_.append(sql, copied_pos, begin - copied_pos);
+      result.key_.append("?");
+      result.key_.append(attr_type_to_string(value.attr_type()));
+      copied_pos = end;
+
+      result.literals_.push_back(SqlLiteral{value, sql.substr(begin, end - begin)});
+    } else if (value_rc != RC::NOTFOUND) {
+      rc = value_rc;
+    }
+
+    if (token == ID || token == SSS || token == DATE_STR) {
+      free(yylval.string);
+    }
+  }
+
+  yylex_destroy(scanner);
+
+  if (OB_SUCC(rc) && copied_pos < sql.size()) {
+    result.key_.append(sql, copied_pos, string::npos);
+  }
+  return rc;
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/value.h"
+
+class ValueExpr;
+
+/**
+ * @brief SQL中的一个常量
+ * @ingroup SQLStage
+ */
+struct SqlLiteral
+{
+  Value  value;  ///< 按照语法解析的规则得到的值
+  string text;   ///< 常量在SQL中的原始文本
+};
+
+/**
+ * @brief 执行计划中的一个常量表达式
+ * @ingroup SQLStage
+ * @details 在生成物理计划之前从逻辑计划中收集，物理计划会接管这些表达式，地址不变
+ */
+struct PlanValue
+{
+  ValueExpr *expr        = nullptr;
+  bool       affect_name = false;  ///< 是否出现在输出列中。输出列的名字来自SQL原文，这类常量不能参数化
+};
+
+/**
+ * @brief 参数化之后的SQL
+ * @ingroup SQLStage
+ * @details 使用SQL的词法分析器把语句切分成token，把其中的常量（数字、字符串、日期）替换成 `?类型`，
+ * 得到的文本作为执行计划缓存的key，常量按照出现的顺序保存下来，命中缓存时用它们替换计划中的值。
+ * 除了常量之外，SQL原文的其它部分（包括空白）都原样保留，因为表达式的名字会直接截取原始SQL文本，
+ * 文本不同的两条语句，输出的列名也可能不同。
+ */
+class ParameterizedSql
+{
+public:
+  ParameterizedSql()  = default;
+  ~ParameterizedSql() = default;
+
+  /**
+   * @brief 对SQL做参数化
+   * @return 如果SQL中有不能转换的常量（比如非法的日期），返回失败，这类语句不使用缓存
+   */
+  static RC parameterize(const string &sql, ParameterizedSql &result);
+
+  const string             &key() const { return key_; }
+  const vector<SqlLiteral> &literals() const { return literals_; }
+
+  /// @brief 是否是SELECT语句。只看第一个token
+  bool is_select() const { return is_select_; }
+
+private:
+  string             key_;
+  vector<SqlLiteral> literals_;
+  bool               is_select_ = false;
+};
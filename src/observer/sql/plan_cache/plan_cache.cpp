@@ -0,0 +1,152 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/plan_cache/plan_cache.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+PlanCache::PlanCache(size_t capacity, size_t max_idle_plans) : capacity_(capacity), max_idle_plans_(max_idle_plans)
+{}
+
+PlanCache::~PlanCache()
+{
+  lock_guard<mutex> guard(lock_);
+  entries_.destroy();
+}
+
+bool PlanCache::is_valid(const PlanCacheEntry &entry, Db *db) const
+{
+  if (entry.db != db || entry.db_version != db->schema_version()) {
+    return false;
+  }
+
+  for (const auto &[table, version] : entry.tables) {
+    if (table->table_meta().version() != version) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC PlanCache::get(const string &key, const vector<SqlLiteral> &literals, Db *db, shared_ptr<PlanCacheEntry> &entry,
+    unique_ptr<CachedPlan> &plan)
+{
+  {
+    lock_guard<mutex> guard(lock_);
+
+    if (!entries_.get(key, entry)) {
+      miss_count_++;
+      return RC::NOTFOUND;
+    }
+
+    if (!is_valid(*entry, db)) {
+      LOG_INFO("plan cache entry is stale. sql=%s", key.c_str());
+      entries_.remove(key);
+      entry.reset();
+      miss_count_++;
+      return RC::NOTFOUND;
+    }
+
+    for (const auto &[index, text] : entry->fixed_literals) {
+      if (literals[index].text != text) {
+        entry.reset();
+        miss_count_++;
+        return RC::NOTFOUND;
+      }
+    }
+
+    if (entry->idle_plans.empty()) {
+      // 所有的计划都在执行中
+      entry.reset();
+      miss_count_++;
+      return RC::NOTFOUND;
+    }
+
+    plan = std::move(entry->idle_plans.back());
+    entry->idle_plans.pop_back();
+  }
+
+  // 计划已经由当前请求独占，绑定参数不需要加锁
+  for (size_t i = 0; i < entry->param_literals.size(); i++) {
+    ValueExpr   *param_expr = plan->params[i];
+    const Value &literal    = literals[entry->param_literals[i]].value;
+
+    Value value;
+    if (literal.attr_type() == param_expr->value_type()) {
+      value = literal;
+    } else if (OB_FAIL(Value::cast_to(literal, param_expr->value_type(), value))) {
+      LOG_TRACE("failed to bind parameter. literal=%s, type=%s",
+          literal.to_string().c_str(), attr_type_to_string(param_expr->value_type()));
+      release(entry, std::move(plan), true /*reusable*/);
+      entry.reset();
+      miss_count_++;
+      return RC::NOTFOUND;
+    }
+    param_expr->set_value(value);
+  }
+
+  hit_count_++;
+  return RC::SUCCESS;
+}
+
+void PlanCache::put(shared_ptr<PlanCacheEntry> new_entry, shared_ptr<PlanCacheEntry> &entry)
+{
+  lock_guard<mutex> guard(lock_);
+
+  shared_ptr<PlanCacheEntry> old_entry;
+  if (entries_.get(new_entry->key, old_entry) && is_valid(*old_entry, new_entry->db) &&
+      old_entry->param_literals == new_entry->param_literals && old_entry->fixed_literals == new_entry->fixed_literals) {
+    entry = old_entry;
+    return;
+  }
+
+  // 没有缓存过，或者旧的缓存已经不能用了，旧缓存项中正在执行的计划归还时会直接释放
+  entries_.put(new_entry->key, new_entry);
+  entry = new_entry;
+  evict_if_need();
+}
+
+void PlanCache::release(const shared_ptr<PlanCacheEntry> &entry, unique_ptr<CachedPlan> plan, bool reusable)
+{
+  {
+    lock_guard<mutex> guard(lock_);
+
+    shared_ptr<PlanCacheEntry> current_entry;
+    if (reusable && entries_.get(entry->key, current_entry) && current_entry == entry &&
+        entry->idle_plans.size() < max_idle_plans_) {
+      entry->idle_plans.emplace_back(std::move(plan));
+      return;
+    }
+  }
+
+  // 计划在锁外面释放
+  plan.reset();
+}
+
+size_t PlanCache::count()
+{
+  lock_guard<mutex> guard(lock_);
+  return entries_.count();
+}
+
+void PlanCache::evict_if_need()
+{
+  while (entries_.count() > capacity_) {
+    string victim;
+    entries_.foreach_reverse([&victim](const string &key, const shared_ptr<PlanCacheEntry> &) {
+      victim = key;
+      return false;
+    });
+    LOG_TRACE("evict plan cache entry. sql=%s", victim.c_str());
+    entries_.remove(victim);
+  }
+}
@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/atomic.h"
+#include "common/lang/lru_cache.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/utility.h"
+#include "common/lang/vector.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/physical_operator.h"
+#include "sql/plan_cache/parameterized_sql.h"
+
+class Db;
+class Table;
+class ValueExpr;
+
+/**
+ * @brief 一份缓存的执行计划
+ * @ingroup SQLStage
+ * @details 物理计划在执行时会修改自身的状态，所以同一份计划同时只能给一个请求使用。
+ * 逻辑计划也保存下来，保证从中收集到的常量表达式一直有效。
+ */
+struct CachedPlan
+{
+  unique_ptr<LogicalOperator>  logical_oper;
+  unique_ptr<PhysicalOperator> physical_oper;
+  vector<ValueExpr *>          params;  ///< 参数对应的常量表达式，与 PlanCacheEntry::param_literals 一一对应
+};
+
+/**
+ * @brief 执行计划缓存中的一项，对应一个参数化之后的SQL
+ * @ingroup SQLStage
+ */
+struct PlanCacheEntry
+{
+  string key;
+
+  Db                            *db         = nullptr;
+  int64_t                        db_version = 0;  ///< 生成计划时数据库的表结构版本
+  vector<pair<Table *, int64_t>> tables;          ///< 计划用到的表以及表元数据的版本
+  vector<int>                    param_literals;  ///< 第i个参数取SQL中第几个常量
+  vector<pair<int, string>>      fixed_literals;  ///< 不能参数化的常量，命中时要求原文相同
+
+  vector<unique_ptr<CachedPlan>> idle_plans;  ///< 当前空闲、可以直接执行的计划
+};
+
+/**
+ * @brief 执行计划缓存
+ * @ingroup SQLStage
+ * @details 以参数化之后的SQL为key，缓存生成好的物理计划，命中时跳过语法解析、语义解析和优化。
+ * 数据库或表的元数据版本发生变化（建表、删表、建索引）时，相关的计划会失效。
+ * 缓存是全局的，所有的会话共享。
+ */
+class PlanCache
+{
+public:
+  static constexpr size_t DEFAULT_CAPACITY       = 1024;
+  static constexpr size_t DEFAULT_MAX_IDLE_PLANS = 8;
+
+  /**
+   * @param capacity 最多缓存多少种SQL
+   * @param max_idle_plans 每种SQL最多保留多少份空闲的计划，同一种SQL并发执行时每个请求需要一份计划
+   */
+  PlanCache(size_t capacity, size_t max_idle_plans);
+  ~PlanCache();
+
+  /**
+   * @brief 查找可以执行的计划
+   * @details 如果命中，会把参数绑定到计划中，返回的计划由调用者独占，用完之后调用 release 归还
+   * @param key      缓存的key，由参数化之后的SQL和影响计划生成的会话变量组成
+   * @param literals SQL中的常量
+   * @param db       当前会话使用的数据库
+   * @param[out] entry 命中的缓存项
+   * @param[out] plan  命中的计划
+   * @return 没有命中返回 RC::NOTFOUND
+   */
+  RC get(const string &key, const vector<SqlLiteral> &literals, Db *db, shared_ptr<PlanCacheEntry> &entry,
+      unique_ptr<CachedPlan> &plan);
+
+  /**
+   * @brief 把新生成的计划放到缓存中
+   * @details 计划并不会直接变成空闲状态，而是返回对应的缓存项，调用者执行完之后调用 release 归还
+   * @param new_entry 新的缓存项，包含了元数据版本和参数的对应关系，不包含计划
+   * @param[out] entry 计划归属的缓存项，如果已经有相同的缓存项，就使用已有的
+   */
+  void put(shared_ptr<PlanCacheEntry> new_entry, shared_ptr<PlanCacheEntry> &entry);
+
+  /**
+   * @brief 归还执行完的计划
+   * @param reusable 计划的状态是否完整，执行出错的计划不能再用
+   */
+  void release(const shared_ptr<PlanCacheEntry> &entry, unique_ptr<CachedPlan> plan, bool reusable);
+
+  int64_t hit_count() const { return hit_count_.load(); }
+  int64_t miss_count() const { return miss_count_.load(); }
+  size_t  count();
+
+private:
+  bool is_valid(const PlanCacheEntry &entry, Db *db) const;
+  void evict_if_need();
+
+private:
+  using EntryCache = common::LruCache<string, shared_ptr<PlanCacheEntry>>;
+
+  mutex      lock_;
+  EntryCache entries_;
+  size_t     capacity_       = 0;
+  size_t     max_idle_plans_ = 0;
+
+  atomic<int64_t> hit_count_{0};
+  atomic<int64_t> miss_count_{0};
+};
@@ -17,9 +17,228 @@ See the Mulan PSL v2 for more details. */
 
 #include "plan_cache_stage.h"
 
-#include "common/conf/ini.h"
-#include "common/io/io.h"
+#include "common/global_context.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_debug.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/operator/group_by_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "sql/plan_cache/cached_plan_physical_operator.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/stmt/select_stmt.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
 
+using namespace std;
 using namespace common;
+
+namespace {
+
+RC collect_expression_values(unique_ptr<Expression> &expr, bool affect_name, vector<PlanValue> &values)
+{
+  if (expr->type() == ExprType::VALUE) {
+    values.push_back(PlanValue{static_cast<ValueExpr *>(expr.get()), affect_name});
+    return RC::SUCCESS;
+  }
+
+  return ExpressionIterator::iterate_child_expr(*expr, [affect_name, &values](unique_ptr<Expression> &child) {
+    return collect_expression_values(child, affect_name, values);
+  });
+}
+
+/**
+ * @brief SQL中的常量是否就是计划中的这个值
+ * @details 常量在生成计划时可能做过类型转换，这里按照计划中的类型比较
+ */
+bool literal_match(const Value &literal, const ValueExpr &expr)
+{
+  const Value &plan_value = expr.get_value();
+  if (literal.attr_type() == plan_value.attr_type()) {
+    return literal.compare(plan_value) == 0;
+  }
+
+  Value cast_value;
+  if (OB_FAIL(Value::cast_to(literal, plan_value.attr_type(), cast_value))) {
+    return false;
+  }
+  return cast_value.compare(plan_value) == 0;
+}
+
+/**
+ * @brief 找出SQL中的常量与计划中常量表达式的对应关系
+ * @details 只有与计划中的某个常量一一对应的SQL常量才能作为参数，其它的常量（比如被优化掉的、
+ * 出现在输出列中的、或者值相同无法区分的）都要求下次执行时原文相同
+ */
+void bind_literals(const vector<SqlLiteral> &literals, const vector<PlanValue> &plan_values, PlanCacheEntry &entry,
+    vector<ValueExpr *> &params)
+{
+  vector<int> candidates(literals.size(), -1);
+  vector<int> match_counts(plan_values.size(), 0);
+  for (size_t i = 0; i < literals.size(); i++) {
+    int  matched_slot = -1;
+    int  match_num    = 0;
+    bool name_matched = false;
+    for (size_t slot = 0; slot < plan_values.size(); slot++) {
+      const PlanValue &plan_value = plan_values[slot];
+      // 布尔值只会来自于改写规则，比如条件下推后留下的 true
+      if (plan_value.expr->value_type() == AttrType::BOOLEANS || !literal_match(literals[i].value, *plan_value.expr)) {
+        continue;
+      }
+
+      if (plan_value.affect_name) {
+        name_matched = true;
+      } else {
+        matched_slot = static_cast<int>(slot);
+        match_num++;
+      }
+    }
+
+    if (!name_matched && match_num == 1) {
+      candidates[i] = matched_slot;
+      match_counts[matched_slot]++;
+    }
+  }
+
+  for (size_t i = 0; i < literals.size(); i++) {
+    const int slot = candidates[i];
+    if (slot >= 0 && match_counts[slot] == 1) {
+      entry.param_literals.push_back(static_cast<int>(i));
+      params.push_back(plan_values[slot].expr);
+    } else {
+      entry.fixed_literals.emplace_back(static_cast<int>(i), literals[i].text);
+    }
+  }
+}
+
+/**
+ * @brief 缓存的key，除了SQL之外还包含会影响计划生成的会话变量
+ */
+string plan_cache_key(const ParameterizedSql &sql, const Session &session)
+{
+  return to_string(static_cast<int>(session.get_execution_mode())) + "|" +
+         to_string(session.hash_join_memory_limit()) + "|" + sql.key();
+}
+
+}  // namespace
+
+RC PlanCacheStage::collect_plan_values(LogicalOperator &oper, vector<PlanValue> &values)
+{
+  RC rc = RC::SUCCESS;
+
+  const bool affect_name = oper.type() == LogicalOperatorType::PROJECTION ||
+                           oper.type() == LogicalOperatorType::GROUP_BY ||
+                           oper.type() == LogicalOperatorType::CALC;
+  for (unique_ptr<Expression> &expr : oper.expressions()) {
+    if (OB_FAIL(rc = collect_expression_values(expr, affect_name, values))) {
+      return rc;
+    }
+  }
+
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    for (unique_ptr<Expression> &expr : static_cast<TableGetLogicalOperator &>(oper).predicates()) {
+      if (OB_FAIL(rc = collect_expression_values(expr, false /*affect_name*/, values))) {
+        return rc;
+      }
+    }
+  } else if (oper.type() == LogicalOperatorType::GROUP_BY) {
+    for (unique_ptr<Expression> &expr : static_cast<GroupByLogicalOperator &>(oper).group_by_expressions()) {
+      if (OB_FAIL(rc = collect_expression_values(expr, true /*affect_name*/, values))) {
+        return rc;
+      }
+    }
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    if (OB_FAIL(rc = collect_plan_values(*child, values))) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC PlanCacheStage::handle_request(SQLStageEvent *sql_event, bool &hit)
+{
+  hit = false;
+
+  PlanCache *plan_cache = GCTX.plan_cache_;
+  if (nullptr == plan_cache) {
+    return RC::SUCCESS;
+  }
+
+  ParameterizedSql sql;
+  RC               rc = ParameterizedSql::parameterize(sql_event->sql(), sql);
+  if (OB_FAIL(rc) || !sql.is_select()) {
+    return RC::SUCCESS;
+  }
+
+  Session                   *session = sql_event->session_event()->session();
+  shared_ptr<PlanCacheEntry> entry;
+  unique_ptr<CachedPlan>     plan;
+  rc = plan_cache->get(plan_cache_key(sql, *session), sql.literals(), session->get_current_db(), entry, plan);
+  if (rc == RC::NOTFOUND) {
+    LOG_TRACE("plan cache miss. sql=%s", sql.key().c_str());
+    sql_debug("plan cache miss. hits=%ld, misses=%ld", plan_cache->hit_count(), plan_cache->miss_count());
+    return RC::SUCCESS;
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LOG_TRACE("plan cache hit. sql=%s", sql.key().c_str());
+  sql_debug("plan cache hit. hits=%ld, misses=%ld", plan_cache->hit_count(), plan_cache->miss_count());
+
+  // 只缓存了火山模型的计划
+  session->set_used_chunk_mode(false);
+  for (const auto &table_version : entry->tables) {
+    sql_event->tables().push_back(table_version.first);
+  }
+  sql_event->set_operator(make_unique<CachedPlanPhysicalOperator>(plan_cache, std::move(entry), std::move(plan)));
+  hit = true;
+  return RC::SUCCESS;
+}
+
+RC PlanCacheStage::add_plan(SQLStageEvent *sql_event)
+{
+  PlanCache *plan_cache = GCTX.plan_cache_;
+  Stmt      *stmt       = sql_event->stmt();
+  Session   *session    = sql_event->session_event()->session();
+  if (nullptr == plan_cache || nullptr == stmt || stmt->type() != StmtType::SELECT ||
+      !sql_event->physical_operator() || !sql_event->logical_operator() || session->used_chunk_mode()) {
+    return RC::SUCCESS;
+  }
+
+  ParameterizedSql sql;
+  RC               rc = ParameterizedSql::parameterize(sql_event->sql(), sql);
+  if (OB_FAIL(rc) || !sql.is_select()) {
+    return RC::SUCCESS;
+  }
+
+  auto new_entry        = make_shared<PlanCacheEntry>();
+  new_entry->key        = plan_cache_key(sql, *session);
+  new_entry->db         = session->get_current_db();
+  new_entry->db_version = new_entry->db->schema_version();
+
+  auto select_stmt = static_cast<SelectStmt *>(stmt);
+  for (const vector<Table *> *tables : {&select_stmt->tables(), &select_stmt->join_tables()}) {
+    for (Table *table : *tables) {
+      new_entry->tables.emplace_back(table, table->table_meta().version());
+    }
+  }
+
+  auto plan = make_unique<CachedPlan>();
+  bind_literals(sql.literals(), sql_event->plan_values(), *new_entry, plan->params);
+  plan->logical_oper  = std::move(sql_event->logical_operator());
+  plan->physical_oper = std::move(sql_event->physical_operator());
+
+  shared_ptr<PlanCacheEntry> entry;
+  plan_cache->put(std::move(new_entry), entry);
+  LOG_TRACE("add plan to cache. sql=%s, params=%d", sql.key().c_str(), static_cast<int>(entry->param_literals.size()));
+
+  sql_event->set_operator(make_unique<CachedPlanPhysicalOperator>(plan_cache, std::move(entry), std::move(plan)));
+  return RC::SUCCESS;
+}
@@ -15,12 +15,43 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "common/lang/vector.h"
+#include "sql/plan_cache/parameterized_sql.h"
+
+class LogicalOperator;
+class SQLStageEvent;
 
 /**
  * @brief 尝试从Plan的缓存中获取Plan，如果没有命中，则执行Optimizer
  * @ingroup SQLStage
- * @details 实际上现在什么都没做。不过PlanCache对数据库的优化提升明显，是一个非常有趣的功能，
- * 感兴趣的同学可以参考OceanBase的实现
+ * @details SQL按照词法分析的结果做参数化（常量替换成参数），以参数化之后的文本作为key查找缓存。
+ * 命中之后把新的常量绑定到计划中，直接交给执行阶段，跳过Parse、Resolve和Optimize。
+ * 没有命中时走完整的流程，优化之后再把生成的计划放到缓存中。
+ * 当前只缓存使用火山模型执行的SELECT语句，其它语句可能在执行时修改元数据，或者计划的状态不能重复使用。
+ * 可以参考OceanBase的实现。
  */
 class PlanCacheStage
-{};
+{
+public:
+  PlanCacheStage()          = default;
+  virtual ~PlanCacheStage() = default;
+
+public:
+  /**
+   * @brief 查找缓存的计划
+   * @param[out] hit 是否命中。命中时计划已经设置到 sql_event 中
+   */
+  RC handle_request(SQLStageEvent *sql_event, bool &hit);
+
+  /**
+   * @brief 把优化阶段生成的计划放到缓存中
+   * @details 如果可以缓存，sql_event 中的计划会被替换成一个包装算子，执行结束后计划归还给缓存
+   */
+  RC add_plan(SQLStageEvent *sql_event);
+
+  /**
+   * @brief 收集逻辑计划中的常量表达式
+   * @details 需要在生成物理计划之前调用，之后表达式会移交给物理算子
+   */
+  static RC collect_plan_values(LogicalOperator &oper, vector<PlanValue> &values);
+};
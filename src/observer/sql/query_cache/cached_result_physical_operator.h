@@ -0,0 +1,59 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/physical_operator.h"
+#include "sql/query_cache/query_cache.h"
+
+/**
+ * @brief 从查询缓存中输出结果
+ * @ingroup PhysicalOperator
+ * @details 查询缓存命中时使用，按顺序解码缓存的每一行，不访问任何表
+ */
+class CachedResultPhysicalOperator : public PhysicalOperator
+{
+public:
+  explicit CachedResultPhysicalOperator(shared_ptr<const QueryResult> result) : result_(std::move(result)) {}
+  virtual ~CachedResultPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::CACHED_RESULT; }
+
+  RC open(Trx *) override
+  {
+    offset_ = 0;
+    return RC::SUCCESS;
+  }
+
+  RC next() override
+  {
+    std::vector<Value> cells;
+    RC                 rc = result_->read_row(offset_, cells);
+    if (OB_SUCC(rc)) {
+      tuple_.set_cells(cells);
+    }
+    return rc;
+  }
+
+  RC close() override { return RC::SUCCESS; }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+  RC tuple_schema(TupleSchema &schema) const override
+  {
+    schema = result_->schema();
+    return RC::SUCCESS;
+  }
+
+private:
+  shared_ptr<const QueryResult> result_;
+  size_t                        offset_ = 0;
+  ValueListTuple                tuple_;
+};
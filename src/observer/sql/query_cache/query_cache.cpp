@@ -0,0 +1,229 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/query_cache/query_cache.h"
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+void QueryResult::append(const void *data, size_t len)
+{
+  const char *p = static_cast<const char *>(data);
+  data_.insert(data_.end(), p, p + len);
+}
+
+RC QueryResult::append_row(const Tuple &tuple)
+{
+  RC            rc       = RC::SUCCESS;
+  const int32_t cell_num = tuple.cell_num();
+  append(&cell_num, sizeof(cell_num));
+
+  Value cell;
+  for (int i = 0; i < cell_num; i++) {
+    if (OB_FAIL(rc = tuple.cell_at(i, cell))) {
+      LOG_WARN("failed to get tuple cell value. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    const int8_t type = static_cast<int8_t>(cell.attr_type());
+    int32_t      len  = 0;
+    switch (cell.attr_type()) {
+      case AttrType::CHARS: {
+        len = (nullptr == cell.data()) ? 0 : static_cast<int32_t>(strlen(cell.data()));
+        append(&type, sizeof(type));
+        append(&len, sizeof(len));
+        append(len > 0 ? cell.data() : "", len);
+        append("", 1);
+      } break;
+
+      case AttrType::INTS:
+      case AttrType::DATES:
+      case AttrType::FLOATS:
+      case AttrType::BOOLEANS: {
+        // 布尔值在Value中只占一个字节，这里统一转换成4个字节的整数
+        int32_t data = 0;
+        if (cell.attr_type() == AttrType::FLOATS) {
+          float float_value = cell.get_float();
+          memcpy(&data, &float_value, sizeof(data));
+        } else if (cell.attr_type() == AttrType::BOOLEANS) {
+          data = cell.get_boolean() ? 1 : 0;
+        } else {
+          data = cell.get_int();
+        }
+        len = cell.length();
+        append(&type, sizeof(type));
+        append(&len, sizeof(len));
+        append(&data, sizeof(data));
+      } break;
+
+      default: {
+        LOG_TRACE("unsupported value type in query cache. type=%s", attr_type_to_string(cell.attr_type()));
+        return RC::UNSUPPORTED;
+      }
+    }
+  }
+
+  row_count_++;
+  return rc;
+}
+
+RC QueryResult::read_row(size_t &offset, vector<Value> &cells) const
+{
+  if (offset >= data_.size()) {
+    return RC::RECORD_EOF;
+  }
+
+  const char *p = data_.data() + offset;
+
+  int32_t cell_num = 0;
+  memcpy(&cell_num, p, sizeof(cell_num));
+  p += sizeof(cell_num);
+
+  cells.resize(cell_num);
+  for (int i = 0; i < cell_num; i++) {
+    const AttrType type = static_cast<AttrType>(*p);
+    p += sizeof(int8_t);
+
+    int32_t len = 0;
+    memcpy(&len, p, sizeof(len));
+    p += sizeof(len);
+
+    Value &cell = cells[i];
+    cell.reset();
+    cell.set_type(type);
+    cell.set_data(p, len);
+    p += (type == AttrType::CHARS) ? len + 1 : sizeof(int32_t);
+  }
+
+  offset = p - data_.data();
+  return RC::SUCCESS;
+}
+
+size_t QueryCacheEntry::memory_size() const
+{
+  return sizeof(*this) + key.size() + tables.size() * sizeof(QueryCacheTable) + sizeof(QueryResult) +
+         (result ? result->size() : 0);
+}
+
+QueryCache::QueryCache(size_t capacity, size_t max_result_size)
+    : capacity_(capacity), max_result_size_(max_result_size)
+{}
+
+QueryCache::~QueryCache()
+{
+  lock_guard<mutex> guard(lock_);
+  entries_.destroy();
+}
+
+shared_ptr<QueryCacheEntry> QueryCache::make_entry(const string &key, Db *db, const vector<Table *> &tables)
+{
+  auto entry        = make_shared<QueryCacheEntry>();
+  entry->key        = key;
+  entry->db         = db;
+  entry->db_version = db->schema_version();
+  for (Table *table : tables) {
+    entry->tables.push_back(QueryCacheTable{table, table->table_meta().version(), table->data_version()});
+  }
+  return entry;
+}
+
+bool QueryCache::is_valid(const QueryCacheEntry &entry, Db *db) const
+{
+  if (entry.db != db || entry.db_version != db->schema_version()) {
+    return false;
+  }
+
+  for (const QueryCacheTable &table : entry.tables) {
+    if (table.table->table_meta().version() != table.meta_version ||
+        table.table->data_version() != table.data_version) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC QueryCache::get(const string &key, Db *db, shared_ptr<const QueryResult> &result)
+{
+  lock_guard<mutex> guard(lock_);
+
+  shared_ptr<QueryCacheEntry> entry;
+  if (!entries_.get(key, entry)) {
+    miss_count_++;
+    return RC::NOTFOUND;
+  }
+
+  if (!is_valid(*entry, db)) {
+    LOG_TRACE("query cache entry is stale. sql=%s", key.c_str());
+    remove(key);
+    miss_count_++;
+    return RC::NOTFOUND;
+  }
+
+  result = entry->result;
+  hit_count_++;
+  return RC::SUCCESS;
+}
+
+bool QueryCache::put(shared_ptr<QueryCacheEntry> entry)
+{
+  if (!entry->result || entry->result->size() > max_result_size_) {
+    return false;
+  }
+
+  lock_guard<mutex> guard(lock_);
+
+  // 执行期间数据发生了变化，结果可能只包含了部分修改
+  if (!is_valid(*entry, entry->db)) {
+    LOG_TRACE("tables changed while executing query. sql=%s", entry->key.c_str());
+    return false;
+  }
+
+  remove(entry->key);
+  memory_size_ += entry->memory_size();
+  entries_.put(entry->key, entry);
+  evict_if_need();
+  return true;
+}
+
+size_t QueryCache::count()
+{
+  lock_guard<mutex> guard(lock_);
+  return entries_.count();
+}
+
+size_t QueryCache::memory_size()
+{
+  lock_guard<mutex> guard(lock_);
+  return memory_size_;
+}
+
+void QueryCache::remove(const string &key)
+{
+  shared_ptr<QueryCacheEntry> entry;
+  if (entries_.get(key, entry)) {
+    memory_size_ -= entry->memory_size();
+    entries_.remove(key);
+  }
+}
+
+void QueryCache::evict_if_need()
+{
+  while (memory_size_ > capacity_ && entries_.count() > 0) {
+    string victim;
+    entries_.foreach_reverse([&victim](const string &key, const shared_ptr<QueryCacheEntry> &) {
+      victim = key;
+      return false;
+    });
+    LOG_TRACE("evict query cache entry. sql=%s", victim.c_str());
+    remove(victim);
+  }
+}
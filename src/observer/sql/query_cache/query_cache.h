@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/atomic.h"
+#include "common/lang/lru_cache.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/value.h"
+#include "sql/expr/tuple.h"
+
+class Db;
+class Table;
+
+/**
+ * @brief 序列化之后的查询结果
+ * @ingroup SQLStage
+ * @details 所有行按顺序编码到一块连续的内存中。每行先是列数，每列是类型、长度和数据，
+ * 字符串的数据带结尾的'\0'，其它类型的数据固定是4个字节。放到缓存之后就不会再修改，可以被多个请求同时读取。
+ */
+class QueryResult
+{
+public:
+  QueryResult()  = default;
+  ~QueryResult() = default;
+
+  TupleSchema       &schema() { return schema_; }
+  const TupleSchema &schema() const { return schema_; }
+
+  /**
+   * @brief 把一行数据追加到结果的末尾
+   */
+  RC append_row(const Tuple &tuple);
+
+  /**
+   * @brief 读取一行数据
+   * @param[in,out] offset 行的起始位置，读取之后指向下一行
+   * @return 读到末尾时返回 RC::RECORD_EOF
+   */
+  RC read_row(size_t &offset, vector<Value> &cells) const;
+
+  int    row_count() const { return row_count_; }
+  size_t size() const { return data_.size(); }
+
+private:
+  void append(const void *data, size_t len);
+
+private:
+  TupleSchema  schema_;
+  vector<char> data_;
+  int          row_count_ = 0;
+};
+
+/**
+ * @brief 查询结果依赖的表
+ * @ingroup SQLStage
+ */
+struct QueryCacheTable
+{
+  Table  *table        = nullptr;
+  int64_t meta_version = 0;  ///< 表元数据的版本，比如创建索引之后会变化
+  int64_t data_version = 0;  ///< 表数据的版本，修改数据之后会变化
+};
+
+/**
+ * @brief 查询缓存中的一项，对应一条SQL的结果
+ * @ingroup SQLStage
+ */
+struct QueryCacheEntry
+{
+  string key;
+
+  Db                     *db         = nullptr;
+  int64_t                 db_version = 0;  ///< 执行查询时数据库的表结构版本
+  vector<QueryCacheTable> tables;          ///< 查询用到的表以及它们的版本
+
+  shared_ptr<const QueryResult> result;
+
+  /// @brief 缓存项占用的内存，用于控制缓存的总大小
+  size_t memory_size() const;
+};
+
+/**
+ * @brief 查询结果缓存
+ * @ingroup SQLStage
+ * @details 以SQL原文为key缓存查询结果。查询用到的任何一张表的数据或元数据发生变化，或者数据库中
+ * 创建、删除了表，缓存的结果就会失效。缓存占用的内存超过容量时，按照LRU的顺序淘汰。
+ * 缓存是全局的，所有的会话共享。
+ */
+class QueryCache
+{
+public:
+  static constexpr size_t DEFAULT_CAPACITY        = 64 * 1024 * 1024;
+  static constexpr size_t DEFAULT_MAX_RESULT_SIZE = 1024 * 1024;
+
+  /**
+   * @param capacity 缓存最多占用多少字节
+   * @param max_result_size 单个结果最多占用多少字节，超过的结果不缓存
+   */
+  QueryCache(size_t capacity, size_t max_result_size);
+  ~QueryCache();
+
+  /**
+   * @brief 记录查询开始执行之前各个表的版本
+   * @details 在执行之前记录，执行完之后版本没有变化，才能说明结果与当前的数据一致
+   */
+  static shared_ptr<QueryCacheEntry> make_entry(const string &key, Db *db, const vector<Table *> &tables);
+
+  /**
+   * @brief 查找缓存的结果
+   * @return 没有命中或者结果已经失效时返回 RC::NOTFOUND
+   */
+  RC get(const string &key, Db *db, shared_ptr<const QueryResult> &result);
+
+  /**
+   * @brief 把执行完的查询结果放到缓存中
+   * @details 如果执行期间表的版本发生了变化，或者结果太大，就不缓存
+   * @return 是否放到了缓存中
+   */
+  bool put(shared_ptr<QueryCacheEntry> entry);
+
+  size_t max_result_size() const { return max_result_size_; }
+
+  int64_t hit_count() const { return hit_count_.load(); }
+  int64_t miss_count() const { return miss_count_.load(); }
+  size_t  count();
+  size_t  memory_size();
+
+private:
+  bool is_valid(const QueryCacheEntry &entry, Db *db) const;
+  void remove(const string &key);
+  void evict_if_need();
+
+private:
+  using EntryCache = common::LruCache<string, shared_ptr<QueryCacheEntry>>;
+
+  mutex      lock_;
+  EntryCache entries_;
+  size_t     capacity_        = 0;
+  size_t     max_result_size_ = 0;
+  size_t     memory_size_     = 0;
+
+  atomic<int64_t> hit_count_{0};
+  atomic<int64_t> miss_count_{0};
+};
@@ -17,14 +17,91 @@ See the Mulan PSL v2 for more details. */
 
 #include "query_cache_stage.h"
 
-#include "common/conf/ini.h"
-#include "common/io/io.h"
+#include "common/global_context.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_debug.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/query_cache/cached_result_physical_operator.h"
+#include "sql/query_cache/query_cache.h"
+#include "sql/query_cache/result_caching_physical_operator.h"
+#include "sql/stmt/select_stmt.h"
+#include "storage/db/db.h"
 
+using namespace std;
 using namespace common;
 
-RC QueryCacheStage::handle_request(SQLStageEvent *sql_event)
+namespace {
+
+/**
+ * @brief 缓存的key
+ * @details 不同数据库中可能有同名的表，所以带上数据库的名字。列名来自SQL原文，SQL文本需要完全相同
+ */
+string query_cache_key(const SQLStageEvent &sql_event, Db &db) { return string(db.name()) + "|" + sql_event.sql(); }
+
+}  // namespace
+
+RC QueryCacheStage::handle_request(SQLStageEvent *sql_event, bool &hit)
 {
+  hit = false;
+
+  QueryCache *query_cache = GCTX.query_cache_;
+  Session    *session     = sql_event->session_event()->session();
+  Db         *db          = session->get_current_db();
+  if (nullptr == query_cache || nullptr == db || session->is_trx_multi_operation_mode()) {
+    return RC::SUCCESS;
+  }
+
+  shared_ptr<const QueryResult> result;
+  RC rc = query_cache->get(query_cache_key(*sql_event, *db), db, result);
+  if (rc == RC::NOTFOUND) {
+    return RC::SUCCESS;
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LOG_TRACE("query cache hit. sql=%s, rows=%d", sql_event->sql().c_str(), result->row_count());
+  sql_debug("query cache hit. hits=%ld, misses=%ld", query_cache->hit_count(), query_cache->miss_count());
+
+  // 缓存的结果按行输出
+  session->set_used_chunk_mode(false);
+  sql_event->set_operator(make_unique<CachedResultPhysicalOperator>(std::move(result)));
+  hit = true;
+  return RC::SUCCESS;
+}
+
+RC QueryCacheStage::cache_result(SQLStageEvent *sql_event)
+{
+  QueryCache *query_cache = GCTX.query_cache_;
+  Session    *session     = sql_event->session_event()->session();
+  Db         *db          = session->get_current_db();
+  if (nullptr == query_cache || nullptr == db || session->is_trx_multi_operation_mode() ||
+      session->used_chunk_mode() || !sql_event->physical_operator()) {
+    return RC::SUCCESS;
+  }
+
+  // 没有stmt时计划来自计划缓存，计划缓存中只有SELECT语句
+  Stmt *stmt = sql_event->stmt();
+  if (nullptr != stmt) {
+    if (stmt->type() != StmtType::SELECT) {
+      return RC::SUCCESS;
+    }
+
+    auto select_stmt = static_cast<SelectStmt *>(stmt);
+    sql_event->tables().clear();
+    for (const vector<Table *> *tables : {&select_stmt->tables(), &select_stmt->join_tables()}) {
+      sql_event->tables().insert(sql_event->tables().end(), tables->begin(), tables->end());
+    }
+  }
+
+  // 在执行之前记录表的版本
+  shared_ptr<QueryCacheEntry> entry = QueryCache::make_entry(query_cache_key(*sql_event, *db), db, sql_event->tables());
+  sql_event->set_operator(make_unique<ResultCachingPhysicalOperator>(
+      query_cache, std::move(entry), std::move(sql_event->physical_operator())));
+
+  sql_debug("query cache miss. hits=%ld, misses=%ld", query_cache->hit_count(), query_cache->miss_count());
   return RC::SUCCESS;
 }
@@ -21,7 +21,8 @@ class SQLStageEvent;
 /**
  * @brief 查询缓存处理
  * @ingroup SQLStage
- * @details 当前什么都没做
+ * @details 缓存SELECT语句的执行结果。只在自动提交的模式下使用，多语句事务中可能有当前事务未提交的修改，
+ * 缓存的结果看不到这些修改，执行的结果也不能给别的事务使用。
  */
 class QueryCacheStage
 {
@@ -30,5 +31,14 @@ public:
   virtual ~QueryCacheStage() = default;
 
 public:
-  RC handle_request(SQLStageEvent *sql_event);
+  /**
+   * @brief 查找缓存的结果
+   * @param[out] hit 是否命中。命中时会设置输出缓存结果的算子，不需要再解析和生成计划
+   */
+  RC handle_request(SQLStageEvent *sql_event, bool &hit);
+
+  /**
+   * @brief 生成计划之后调用，在执行的同时收集结果
+   */
+  RC cache_result(SQLStageEvent *sql_event);
 };
@@ -0,0 +1,61 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/query_cache/result_caching_physical_operator.h"
+#include "common/log/log.h"
+
+ResultCachingPhysicalOperator::ResultCachingPhysicalOperator(
+    QueryCache *query_cache, shared_ptr<QueryCacheEntry> entry, unique_ptr<PhysicalOperator> child)
+    : query_cache_(query_cache), entry_(std::move(entry)), child_(std::move(child))
+{}
+
+RC ResultCachingPhysicalOperator::open(Trx *trx)
+{
+  eof_    = false;
+  result_ = make_shared<QueryResult>();
+
+  RC rc = child_->tuple_schema(result_->schema());
+  if (OB_FAIL(rc)) {
+    stop_caching();
+  }
+  return child_->open(trx);
+}
+
+RC ResultCachingPhysicalOperator::next()
+{
+  RC rc = child_->next();
+  if (rc == RC::RECORD_EOF) {
+    eof_ = true;
+  } else if (OB_FAIL(rc)) {
+    stop_caching();
+  } else if (result_) {
+    Tuple *tuple = child_->current_tuple();
+    if (nullptr == tuple || OB_FAIL(result_->append_row(*tuple)) ||
+        result_->size() > query_cache_->max_result_size()) {
+      stop_caching();
+    }
+  }
+  return rc;
+}
+
+RC ResultCachingPhysicalOperator::close()
+{
+  RC rc = child_->close();
+  if (OB_SUCC(rc) && eof_ && result_) {
+    entry_->result = std::move(result_);
+    bool cached    = query_cache_->put(entry_);
+    LOG_TRACE("query result %s cached. sql=%s, rows=%d",
+        cached ? "is" : "is not", entry_->key.c_str(), entry_->result->row_count());
+  }
+  stop_caching();
+  return rc;
+}
+
+void ResultCachingPhysicalOperator::stop_caching() { result_.reset(); }
@@ -0,0 +1,51 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/physical_operator.h"
+#include "sql/query_cache/query_cache.h"
+
+/**
+ * @brief 在执行查询的同时收集结果，执行完之后放到查询缓存中
+ * @ingroup PhysicalOperator
+ * @details 所有的调用都转发给真正的计划。只有完整地读完所有的行并正常关闭，结果才会放到缓存中。
+ * 结果超过缓存允许的大小时就不再收集。
+ */
+class ResultCachingPhysicalOperator : public PhysicalOperator
+{
+public:
+  ResultCachingPhysicalOperator(
+      QueryCache *query_cache, shared_ptr<QueryCacheEntry> entry, unique_ptr<PhysicalOperator> child);
+  virtual ~ResultCachingPhysicalOperator() = default;
+
+  std::string name() const override { return child_->name(); }
+  std::string param() const override { return child_->param(); }
+
+  PhysicalOperatorType type() const override { return child_->type(); }
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override { return child_->current_tuple(); }
+
+  RC tuple_schema(TupleSchema &schema) const override { return child_->tuple_schema(schema); }
+
+private:
+  void stop_caching();
+
+private:
+  QueryCache                  *query_cache_ = nullptr;
+  shared_ptr<QueryCacheEntry>  entry_;
+  unique_ptr<PhysicalOperator> child_;
+  shared_ptr<QueryResult>      result_;
+  bool                         eof_ = false;
+};
@@ -58,9 +58,31 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     return RC::SCHEMA_INDEX_NAME_REPEAT;
   }
 
+  IndexType index_type = IndexType::BPLUS_TREE;
+  if (!create_index.index_type.empty()) {
+    RC rc = get_index_type(create_index.index_type.c_str(), index_type);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("unsupported index type. index name=%s, type=%s",
+               create_index.index_name.c_str(), create_index.index_type.c_str());
+      return rc;
+    }
+  }
+
   CreateIndexStmt *create_index_stmt =
-      new CreateIndexStmt(table, field_metas, create_index.index_name, create_index.unique);
+      new CreateIndexStmt(table, field_metas, create_index.index_name, create_index.unique, index_type);
 
   stmt = create_index_stmt;
   return RC::SUCCESS;
 }
+
+RC CreateIndexStmt::get_index_type(const char *type_str, IndexType &index_type)
+{
+  if (0 == strcasecmp(type_str, "BTREE")) {
+    index_type = IndexType::BPLUS_TREE;
+  } else if (0 == strcasecmp(type_str, "HASH")) {
+    index_type = IndexType::HASH;
+  } else {
+    return RC::INVALID_ARGUMENT;
+  }
+  return RC::SUCCESS;
+}
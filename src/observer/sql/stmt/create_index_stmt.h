@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 
 #include "sql/stmt/stmt.h"
+#include "storage/index/index_meta.h"
 
 struct CreateIndexSqlNode;
 class Table;
@@ -29,8 +30,13 @@ class FieldMeta;
 class CreateIndexStmt : public Stmt
 {
 public:
-  CreateIndexStmt(Table *table, std::vector<const FieldMeta *> field_metas, const std::string &index_name, bool unique)
-      : unique_(unique), table_(table), field_metas_(std::move(field_metas)), index_name_(index_name)
+  CreateIndexStmt(Table *table, std::vector<const FieldMeta *> field_metas, const std::string &index_name, bool unique,
+      IndexType index_type = IndexType::BPLUS_TREE)
+      : unique_(unique),
+        index_type_(index_type),
+        table_(table),
+        field_metas_(std::move(field_metas)),
+        index_name_(index_name)
   {}
 
   virtual ~CreateIndexStmt() = default;
@@ -41,12 +47,19 @@ public:
   const std::vector<const FieldMeta *> &field_metas() const { return field_metas_; }
   const std::string                    &index_name() const { return index_name_; }
   const bool                            unique() const { return unique_; }
+  IndexType                             index_type() const { return index_type_; }
 
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
 
+  /**
+   * @brief 解析 USING 后面的索引类型，支持 BTREE 和 HASH，不区分大小写
+   */
+  static RC get_index_type(const char *type_str, IndexType &index_type);
+
 private:
-  bool                           unique_ = false;
+  bool                           unique_     = false;
+  IndexType                      index_type_ = IndexType::BPLUS_TREE;
   Table                         *table_  = nullptr;
   std::vector<const FieldMeta *> field_metas_;
   std::string                    index_name_;
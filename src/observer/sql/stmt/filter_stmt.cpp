@@ -118,6 +118,10 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_m
     FilterObj filter_obj;
     filter_obj.init_attr(Field(table, field));
     filter_unit->set_right(filter_obj);
+  } else if (comp == IN_OP) {
+    FilterObj filter_obj;
+    filter_obj.init_values(condition.right_values);
+    filter_unit->set_right(filter_obj);
   } else {
     FilterObj filter_obj;
     filter_obj.init_value(condition.right_value);
@@ -26,9 +26,10 @@ class FieldMeta;
 
 struct FilterObj
 {
-  bool  is_attr;
-  Field field;
-  Value value;
+  bool               is_attr;
+  Field              field;
+  Value              value;
+  std::vector<Value> values;  ///< IN 的常量列表
 
   void init_attr(const Field &field)
   {
@@ -41,6 +42,12 @@ struct FilterObj
     is_attr     = false;
     this->value = value;
   }
+
+  void init_values(const std::vector<Value> &values)
+  {
+    is_attr      = false;
+    this->values = values;
+  }
 };
 
 class FilterUnit
@@ -0,0 +1,61 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/buffer/dirty_page_list.h"
+#include "storage/buffer/frame.h"
+
+void DirtyPageList::mark_dirty(Frame *frame)
+{
+  lock_guard<mutex> lock_guard(lock_);
+  if (frame->dirty_.exchange(true)) {
+    return;
+  }
+
+  // 修改页面的日志还没有写，它的LSN一定比当前的LSN大
+  const LSN recovery_lsn = (lsn_provider_ ? lsn_provider_() : 0) + 1;
+  frame->recovery_lsn_   = recovery_lsn;
+  frames_.emplace(recovery_lsn, frame);
+}
+
+void DirtyPageList::clear_dirty(Frame *frame)
+{
+  lock_guard<mutex> lock_guard(lock_);
+  if (!frame->dirty_.exchange(false)) {
+    return;
+  }
+
+  frames_.erase({frame->recovery_lsn_, frame});
+  frame->recovery_lsn_ = 0;
+}
+
+void DirtyPageList::oldest(int count, LSN max_recovery_lsn, vector<Frame *> &frames)
+{
+  lock_guard<mutex> lock_guard(lock_);
+  int               num = 0;
+  for (const auto &[recovery_lsn, frame] : frames_) {
+    if (num >= count || recovery_lsn > max_recovery_lsn) {
+      break;
+    }
+    frames.push_back(frame);
+    num++;
+  }
+}
+
+LSN DirtyPageList::min_recovery_lsn()
+{
+  lock_guard<mutex> lock_guard(lock_);
+  return frames_.empty() ? 0 : frames_.begin()->first;
+}
+
+size_t DirtyPageList::size()
+{
+  lock_guard<mutex> lock_guard(lock_);
+  return frames_.size();
+}
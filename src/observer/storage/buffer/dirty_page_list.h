@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/functional.h"
+#include "common/lang/mutex.h"
+#include "common/lang/set.h"
+#include "common/lang/utility.h"
+#include "common/lang/vector.h"
+#include "common/types.h"
+
+class Frame;
+
+/**
+ * @brief 脏页链表
+ * @ingroup BufferPool
+ * @details 按照页面第一次变脏时的LSN(recovery lsn)排序，记录一个页帧分区中所有的脏页。
+ * 页面从干净变成脏的时候加入链表，刷新到磁盘之后从链表中删除，页面再次修改也不会改变它在链表中的位置。
+ * 所以链表头部就是最早修改、还没有落盘的页面：
+ * - 后台刷脏线程优先刷新链表头部的页面；
+ * - 所有链表中最小的 recovery lsn 之前的日志，对应的修改都已经落盘了，检查点可以推进到这里。
+ *
+ * 修改页面时要先标记脏页，再写日志，这样页面的 recovery lsn 一定不大于修改它的日志的LSN。
+ */
+class DirtyPageList
+{
+public:
+  DirtyPageList()  = default;
+  ~DirtyPageList() = default;
+
+  /**
+   * @brief 设置获取当前LSN的函数
+   * @details 页面变脏时使用当前LSN加1作为 recovery lsn。需要在页面变脏之前设置，没有设置时当作0
+   */
+  void set_lsn_provider(function<LSN()> lsn_provider) { lsn_provider_ = std::move(lsn_provider); }
+
+  /**
+   * @brief 页面被修改了，如果之前是干净的，就放到链表的尾部
+   */
+  void mark_dirty(Frame *frame);
+
+  /**
+   * @brief 页面已经刷新到磁盘，如果是脏的，就从链表中删除
+   */
+  void clear_dirty(Frame *frame);
+
+  /**
+   * @brief 最早变脏的几个页面
+   * @param count 最多返回多少个页面
+   * @param max_recovery_lsn 只返回 recovery lsn 小于等于它的页面
+   * @param[out] frames 页帧，recovery lsn 从小到大排列
+   */
+  void oldest(int count, LSN max_recovery_lsn, vector<Frame *> &frames);
+
+  /**
+   * @brief 链表中最小的 recovery lsn，没有脏页时返回0
+   */
+  LSN min_recovery_lsn();
+
+  size_t size();
+
+private:
+  mutex                   lock_;
+  set<pair<LSN, Frame *>> frames_;  ///< 按照 recovery lsn 排序
+  function<LSN()>         lsn_provider_;
+};
@@ -17,8 +17,12 @@ See the Mulan PSL v2 for more details. */
 #include "common/io/io.h"
 #include "common/lang/mutex.h"
 #include "common/lang/algorithm.h"
+#include "common/lang/chrono.h"
+#include "common/lang/limits.h"
 #include "common/log/log.h"
 #include "common/math/crc.h"
+#include "common/queue/blocking_queue.h"
+#include "common/thread/thread_util.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/db/db.h"
@@ -38,30 +42,52 @@ string BPFileHeader::to_string() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
-BPFrameManager::BPFrameManager(const char *name) : allocator_(name) {}
+BPFrameManager::BPFrameManager(const char *name) : tag_(name) {}
 
-RC BPFrameManager::init(int pool_num)
+RC BPFrameManager::init(int pool_num, int shard_num, FrameReplacerType replacer_type, int lru_k)
 {
-  int ret = allocator_.init(false, pool_num);
-  if (ret == 0) {
-    return RC::SUCCESS;
+  const int frame_num = pool_num * DEFAULT_ITEM_NUM_PER_POOL;
+  if (frame_num <= 0 || shard_num <= 0) {
+    LOG_WARN("invalid arguments. pool num=%d, shard num=%d", pool_num, shard_num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 内存平均分给每个分区，每个分区至少有一个页帧
+  shard_num                     = min(shard_num, frame_num);
+  const int frame_num_per_shard = (frame_num + shard_num - 1) / shard_num;
+  for (int i = 0; i < shard_num; i++) {
+    auto shard = make_unique<FrameShard>(tag_.c_str());
+    int  ret   = shard->allocator.init(false, 1 /*pool_num*/, frame_num_per_shard);
+    if (ret != 0) {
+      shards_.clear();
+      return RC::NOMEM;
+    }
+    shard->replacer = FrameReplacer::create(replacer_type, frame_num_per_shard, lru_k);
+    shards_.push_back(std::move(shard));
   }
-  return RC::NOMEM;
+  replacer_type_       = replacer_type;
+  frame_num_per_shard_ = frame_num_per_shard;
+  LOG_INFO("frame manager init. frame num=%d, shard num=%d, replacer=%s",
+           frame_num_per_shard * shard_num, shard_num, frame_replacer_type_name(replacer_type));
+  return RC::SUCCESS;
 }
 
 RC BPFrameManager::cleanup()
 {
-  if (frames_.count() > 0) {
+  if (frame_num() > 0) {
     return RC::INTERNAL;
   }
 
-  frames_.destroy();
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    shard->frames.clear();
+  }
   return RC::SUCCESS;
 }
 
-int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
+int BPFrameManager::purge_frames(int buffer_pool_id, PageNum page_num, int count, function<RC(Frame *frame)> purger)
 {
-  lock_guard<mutex> lock_guard(lock_);
+  FrameShard       &shard = shard_of(FrameId(buffer_pool_id, page_num));
+  lock_guard<mutex> lock_guard(shard.lock);
 
   vector<Frame *> frames_can_purge;
   if (count <= 0) {
@@ -69,27 +95,26 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
   }
   frames_can_purge.reserve(count);
 
-  auto purge_finder = [&frames_can_purge, count](const FrameId &frame_id, Frame *const frame) {
-    if (frame->can_purge()) {
-      frame->pin();
-      frames_can_purge.push_back(frame);
-      if (frames_can_purge.size() >= static_cast<size_t>(count)) {
-        return false;  // false to break the progress
-      }
+  // 选出来的页帧会被pin住，不会被重复选中
+  auto evictable = [](Frame *frame) { return frame->can_purge(); };
+  while (frames_can_purge.size() < static_cast<size_t>(count)) {
+    Frame *frame = shard.replacer->victim(evictable);
+    if (nullptr == frame) {
+      break;
     }
-    return true;  // true continue to look up
-  };
-
-  frames_.foreach_reverse(purge_finder);
+    frame->pin();
+    frames_can_purge.push_back(frame);
+  }
   LOG_INFO("purge frames find %ld pages total", frames_can_purge.size());
 
-  /// 当前还在frameManager的锁内，而 purger 是一个非常耗时的操作
-  /// 他需要把脏页数据刷新到磁盘上去，所以这里会极大地降低并发度
+  /// 当前还在分区的锁内，而 purger 是一个非常耗时的操作
+  /// 他需要把脏页数据刷新到磁盘上去，所以这里会降低这个分区的并发度
   int freed_count = 0;
   for (Frame *frame : frames_can_purge) {
     RC rc = purger(frame);
     if (RC::SUCCESS == rc) {
-      free_internal(frame->frame_id(), frame);
+      shard.replacer->evict(frame);
+      free_internal(shard, frame->frame_id(), frame);
       freed_count++;
     } else {
       frame->unpin();
@@ -101,90 +126,238 @@ int BPFrameManager::purge_frames(int count, function<RC(Frame *frame)> purger)
   return freed_count;
 }
 
+RC BPFrameManager::purge_frame(int buffer_pool_id, PageNum page_num, function<RC(Frame *frame)> purger)
+{
+  FrameId           frame_id(buffer_pool_id, page_num);
+  FrameShard       &shard = shard_of(frame_id);
+  lock_guard<mutex> lock_guard(shard.lock);
+
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return RC::NOTFOUND;
+  }
+
+  Frame *frame = iter->second;
+  if (!frame->can_purge()) {
+    return RC::LOCKED_UNLOCK;
+  }
+
+  frame->pin();
+  RC rc = purger(frame);
+  if (OB_FAIL(rc)) {
+    frame->unpin();
+    LOG_WARN("failed to purge frame. frame_id=%s, rc=%s", frame_id.to_string().c_str(), strrc(rc));
+    return rc;
+  }
+
+  shard.replacer->evict(frame);
+  return free_internal(shard, frame_id, frame);
+}
+
 Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
 {
-  FrameId                     frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return get_internal(frame_id);
+  lock_guard<mutex> lock_guard(shard.lock);
+  return get_internal(shard, frame_id);
 }
 
-Frame *BPFrameManager::get_internal(const FrameId &frame_id)
+Frame *BPFrameManager::pin(int buffer_pool_id, PageNum page_num)
 {
-  Frame *frame = nullptr;
-  (void)frames_.get(frame_id, frame);
-  if (frame != nullptr) {
-    frame->pin();
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
+
+  lock_guard<mutex> lock_guard(shard.lock);
+  auto              iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
+  }
+
+  iter->second->pin();
+  return iter->second;
+}
+
+Frame *BPFrameManager::get_internal(FrameShard &shard, const FrameId &frame_id)
+{
+  auto iter = shard.frames.find(frame_id);
+  if (iter == shard.frames.end()) {
+    return nullptr;
   }
+
+  Frame *frame = iter->second;
+  frame->pin();
+  shard.replacer->access(frame);
   return frame;
 }
 
 Frame *BPFrameManager::alloc(int buffer_pool_id, PageNum page_num)
 {
-  FrameId frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
+  lock_guard<mutex> lock_guard(shard.lock);
 
-  Frame                      *frame = get_internal(frame_id);
+  Frame *frame = get_internal(shard, frame_id);
   if (frame != nullptr) {
     return frame;
   }
 
-  frame = allocator_.alloc();
+  return alloc_internal(shard, frame_id);
+}
+
+Frame *BPFrameManager::alloc_if_absent(int buffer_pool_id, PageNum page_num)
+{
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
+
+  lock_guard<mutex> lock_guard(shard.lock);
+  if (shard.frames.find(frame_id) != shard.frames.end()) {
+    return nullptr;
+  }
+  return alloc_internal(shard, frame_id);
+}
+
+Frame *BPFrameManager::alloc_internal(FrameShard &shard, const FrameId &frame_id)
+{
+  Frame *frame = shard.allocator.alloc();
   if (frame != nullptr) {
-    ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s", 
+    ASSERT(frame->pin_count() == 0, "got an invalid frame that pin count is not 0. frame=%s",
            frame->to_string().c_str());
-    frame->set_buffer_pool_id(buffer_pool_id);
-    frame->set_page_num(page_num);
+    frame->set_buffer_pool_id(frame_id.buffer_pool_id());
+    frame->set_page_num(frame_id.page_num());
+    frame->set_loading(true);
+    frame->set_prefetched(false);
+    frame->set_dirty_list(&shard.dirty_list);
     frame->pin();
-    frames_.put(frame_id, frame);
+    shard.frames.emplace(frame_id, frame);
+    shard.replacer->insert(frame);
   }
   return frame;
 }
 
 RC BPFrameManager::free(int buffer_pool_id, PageNum page_num, Frame *frame)
 {
-  FrameId frame_id(buffer_pool_id, page_num);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
 
-  lock_guard<mutex> lock_guard(lock_);
-  return free_internal(frame_id, frame);
+  lock_guard<mutex> lock_guard(shard.lock);
+  return free_internal(shard, frame_id, frame);
 }
 
-RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
+RC BPFrameManager::free_if_unpinned(int buffer_pool_id, PageNum page_num, Frame *frame)
 {
-  Frame                *frame_source = nullptr;
-  [[maybe_unused]] bool found        = frames_.get(frame_id, frame_source);
+  FrameId     frame_id(buffer_pool_id, page_num);
+  FrameShard &shard = shard_of(frame_id);
+
+  lock_guard<mutex> lock_guard(shard.lock);
+  if (frame->pin_count() != 1) {
+    return RC::LOCKED_UNLOCK;
+  }
+  return free_internal(shard, frame_id, frame);
+}
+
+RC BPFrameManager::free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame)
+{
+  auto                  iter         = shard.frames.find(frame_id);
+  [[maybe_unused]] bool found        = (iter != shard.frames.end());
+  Frame                *frame_source = found ? iter->second : nullptr;
   ASSERT(found && frame == frame_source && frame->pin_count() == 1,
       "failed to free frame. found=%d, frameId=%s, frame_source=%p, frame=%p, pinCount=%d, lbt=%s",
       found, frame_id.to_string().c_str(), frame_source, frame, frame->pin_count(), lbt());
 
+  // 释放的页面不再需要刷新，比如已经删除的页面
+  frame->clear_dirty();
+  shard.replacer->remove(frame);
   frame->set_page_num(-1);
   frame->unpin();
-  frames_.remove(frame_id);
-  allocator_.free(frame);
+  shard.frames.erase(frame_id);
+  shard.allocator.free(frame);
   return RC::SUCCESS;
 }
 
 list<Frame *> BPFrameManager::find_list(int buffer_pool_id)
 {
-  lock_guard<mutex> lock_guard(lock_);
-
   list<Frame *> frames;
-  auto               fetcher = [&frames, buffer_pool_id](const FrameId &frame_id, Frame *const frame) -> bool {
-    if (buffer_pool_id == frame_id.buffer_pool_id()) {
-      frame->pin();
-      frames.push_back(frame);
+  // 每次只锁一个分区，不会同时持有多个分区的锁
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    for (auto &[frame_id, frame] : shard->frames) {
+      if (buffer_pool_id == frame_id.buffer_pool_id()) {
+        frame->pin();
+        frames.push_back(frame);
+      }
     }
-    return true;
-  };
-  frames_.foreach (fetcher);
+  }
   return frames;
 }
 
+size_t BPFrameManager::frame_num()
+{
+  size_t num = 0;
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    lock_guard<mutex> lock_guard(shard->lock);
+    num += shard->frames.size();
+  }
+  return num;
+}
+
+void BPFrameManager::set_lsn_provider(function<LSN()> lsn_provider)
+{
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    shard->dirty_list.set_lsn_provider(lsn_provider);
+  }
+}
+
+size_t BPFrameManager::dirty_frame_num(int shard_index) { return shards_[shard_index]->dirty_list.size(); }
+
+size_t BPFrameManager::dirty_frame_num()
+{
+  size_t num = 0;
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    num += shard->dirty_list.size();
+  }
+  return num;
+}
+
+void BPFrameManager::oldest_dirty_frames(int shard_index, int count, LSN max_recovery_lsn, vector<FrameId> &frame_ids)
+{
+  FrameShard &shard = *shards_[shard_index];
+
+  // 持有分区的锁，链表中的页帧就不会被释放
+  lock_guard<mutex> lock_guard(shard.lock);
+  vector<Frame *>   frames;
+  shard.dirty_list.oldest(count, max_recovery_lsn, frames);
+  for (Frame *frame : frames) {
+    frame_ids.push_back(frame->frame_id());
+  }
+}
+
+LSN BPFrameManager::min_recovery_lsn()
+{
+  LSN min_lsn = 0;
+  for (unique_ptr<FrameShard> &shard : shards_) {
+    const LSN lsn = shard->dirty_list.min_recovery_lsn();
+    if (lsn > 0 && (min_lsn == 0 || lsn < min_lsn)) {
+      min_lsn = lsn;
+    }
+  }
+  return min_lsn;
+}
+
+size_t BPFrameManager::total_frame_num() const
+{
+  size_t num = 0;
+  for (const unique_ptr<FrameShard> &shard : shards_) {
+    num += shard->allocator.get_size();
+  }
+  return num;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 BufferPoolIterator::BufferPoolIterator() {}
 BufferPoolIterator::~BufferPoolIterator() {}
-RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
+RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */, PageNum end_page /* = -1 */)
 {
   bitmap_.init(bp.file_header_->bitmap, bp.file_header_->page_count);
   if (start_page <= 0) {
@@ -192,14 +365,22 @@ RC BufferPoolIterator::init(DiskBufferPool &bp, PageNum start_page /* = 0 */)
   } else {
     current_page_num_ = start_page - 1;
   }
+  end_page_num_ = end_page;
   return RC::SUCCESS;
 }
 
-bool BufferPoolIterator::has_next() { return bitmap_.next_setted_bit(current_page_num_ + 1) != -1; }
+bool BufferPoolIterator::has_next()
+{
+  PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  return next_page != -1 && (end_page_num_ < 0 || next_page < end_page_num_);
+}
 
 PageNum BufferPoolIterator::next()
 {
   PageNum next_page = bitmap_.next_setted_bit(current_page_num_ + 1);
+  if (end_page_num_ >= 0 && next_page >= end_page_num_) {
+    next_page = -1;
+  }
   if (next_page != -1) {
     current_page_num_ = next_page;
   }
@@ -259,7 +440,9 @@ RC DiskBufferPool::open_file(const char *file_name)
   hdr_frame_->set_buffer_pool_id(id());
   hdr_frame_->access();
 
-  if ((rc = load_page(BP_HEADER_PAGE, hdr_frame_)) != RC::SUCCESS) {
+  rc = load_page(BP_HEADER_PAGE, hdr_frame_);
+  hdr_frame_->set_loading(false);
+  if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to load first page of %s, due to %s.", file_name, strerror(errno));
     purge_frame(BP_HEADER_PAGE, hdr_frame_);
     close(fd);
@@ -281,6 +464,15 @@ RC DiskBufferPool::close_file()
     return rc;
   }
 
+  // 等待后台刷脏页的线程不再访问当前文件
+  unique_lock<shared_mutex> close_guard(bp_manager_.close_lock());
+
+  wait_read_ahead_done();
+  if (read_ahead_pages_.load() > 0) {
+    LOG_INFO("read ahead stat of %s: pages=%ld, hits=%ld, hit ratio=%.2f",
+             file_name_.c_str(), read_ahead_pages_.load(), read_ahead_hits_.load(), read_ahead_hit_ratio());
+  }
+
   hdr_frame_->unpin();
 
   // TODO: 理论上是在回放时回滚未提交事务，但目前没有undo log，因此不下刷数据page，只通过redo log回放
@@ -309,24 +501,53 @@ RC DiskBufferPool::close_file()
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
+RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame, ScanRing *scan_ring /* = nullptr */)
 {
-  RC rc  = RC::SUCCESS;
   *frame = nullptr;
 
   Frame *used_match_frame = frame_manager_.get(id(), page_num);
-  if (used_match_frame != nullptr) {
-    used_match_frame->access();
-    *frame = used_match_frame;
-    return RC::SUCCESS;
+  if (used_match_frame == nullptr) {
+    RC rc = load_frame(page_num, used_match_frame, scan_ring);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  // 页面可能正在被其它线程加载，比如预读
+  used_match_frame->wait_loaded();
+  used_match_frame->access();
+
+  if (used_match_frame->take_prefetched()) {
+    read_ahead_hits_++;
+    // 为这次扫描预读的页面，与扫描自己加载的页面一样放到页帧环上
+    if (scan_ring != nullptr) {
+      scoped_lock lock_guard(lock_);
+      add_to_scan_ring(*scan_ring, page_num);
+    }
   }
 
+  if (scan_ring != nullptr) {
+    read_ahead(*scan_ring, page_num);
+  }
+
+  *frame = used_match_frame;
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::load_frame(PageNum page_num, Frame *&frame, ScanRing *scan_ring)
+{
   scoped_lock lock_guard(lock_);  // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
 
+  // 加锁之前，其它线程可能已经开始加载这个页面了
+  frame = frame_manager_.get(id(), page_num);
+  if (frame != nullptr) {
+    return RC::SUCCESS;
+  }
+
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
 
-  rc = allocate_frame(page_num, &allocated_frame);
+  RC rc = allocate_frame(page_num, &allocated_frame);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to alloc frame %s:%d, due to failed to alloc page.", file_name_.c_str(), page_num);
     return rc;
@@ -334,18 +555,185 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
 
   allocated_frame->set_buffer_pool_id(id());
   // allocated_frame->pin(); // pined in manager::get
-  allocated_frame->access();
 
-  if ((rc = load_page(page_num, allocated_frame)) != RC::SUCCESS) {
+  rc = load_page(page_num, allocated_frame);
+  allocated_frame->set_loading(false);
+  if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to load page %s:%d", file_name_.c_str(), page_num);
     purge_frame(page_num, allocated_frame);
     return rc;
   }
 
-  *frame = allocated_frame;
+  if (scan_ring != nullptr) {
+    add_to_scan_ring(*scan_ring, page_num);
+  }
+
+  frame = allocated_frame;
   return RC::SUCCESS;
 }
 
+void DiskBufferPool::add_to_scan_ring(ScanRing &scan_ring, PageNum page_num)
+{
+  const int ring_size = bp_manager_.options().scan_ring_size;
+  if (ring_size <= 0) {
+    return;
+  }
+
+  scan_ring.pages_.push_back(page_num);
+
+  auto purger = [this](Frame *frame) { return frame->dirty() ? flush_page_internal(*frame) : RC::SUCCESS; };
+  while (static_cast<int>(scan_ring.pages_.size()) > ring_size) {
+    PageNum old_page_num = scan_ring.pages_.front();
+    scan_ring.pages_.pop_front();
+
+    // 页面可能正在被其它人使用，或者已经被淘汰了，就交给淘汰策略处理
+    RC rc = frame_manager_.purge_frame(id(), old_page_num, purger);
+    if (OB_FAIL(rc) && rc != RC::NOTFOUND && rc != RC::LOCKED_UNLOCK) {
+      LOG_WARN("failed to purge page in scan ring. file=%s, page=%d, rc=%s", 
+               file_name_.c_str(), old_page_num, strrc(rc));
+    }
+  }
+}
+
+void DiskBufferPool::read_ahead(ScanRing &scan_ring, PageNum page_num)
+{
+  const int read_ahead_pages = bp_manager_.options().read_ahead_pages;
+  if (read_ahead_pages <= 0 || page_num == scan_ring.last_page_num_) {
+    return;
+  }
+
+  // 扫描时会跳过没有分配的页面，所以只要是向后访问就认为是连续的
+  if (page_num > scan_ring.last_page_num_) {
+    scan_ring.sequential_count_++;
+  } else {
+    scan_ring.sequential_count_ = 1;
+    scan_ring.read_ahead_until_ = -1;
+  }
+  scan_ring.last_page_num_ = page_num;
+
+  if (scan_ring.sequential_count_ < SEQUENTIAL_THRESHOLD) {
+    return;
+  }
+
+  if (scan_ring.read_ahead_until_ - page_num > read_ahead_pages / 2) {
+    return;
+  }
+
+  const PageNum first = max(scan_ring.read_ahead_until_, page_num) + 1;
+  const PageNum last  = page_num + read_ahead_pages;
+  scan_ring.read_ahead_until_ = last;
+  submit_read_ahead(first, last);
+}
+
+void DiskBufferPool::read_ahead_page(PageNum page_num)
+{
+  if (page_num == BP_INVALID_PAGE_NUM || bp_manager_.options().read_ahead_pages <= 0) {
+    return;
+  }
+
+  submit_read_ahead(page_num, page_num);
+}
+
+void DiskBufferPool::submit_read_ahead(PageNum first, PageNum last)
+{
+  common::ThreadPoolExecutor *executor = bp_manager_.read_ahead_executor();
+  if (executor == nullptr) {
+    return;
+  }
+
+  auto done = [this]() {
+    pending_read_ahead_--;
+    pending_read_ahead_.notify_all();
+  };
+
+  pending_read_ahead_++;
+  int ret = executor->execute([this, first, last, done]() {
+    for (PageNum page_num = first; page_num <= last; page_num++) {
+      RC rc = prefetch_page(page_num);
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("stop read ahead. file=%s, page=%d, rc=%s", file_name_.c_str(), page_num, strrc(rc));
+        break;
+      }
+    }
+    done();
+  });
+
+  if (ret != 0) {
+    LOG_WARN("failed to submit read ahead task. file=%s, pages=[%d, %d]", file_name_.c_str(), first, last);
+    done();
+  }
+}
+
+RC DiskBufferPool::prefetch_page(PageNum page_num)
+{
+  Frame *frame = nullptr;
+  {
+    scoped_lock lock_guard(lock_);
+    if (page_num >= file_header_->page_count) {
+      return RC::BUFFERPOOL_INVALID_PAGE_NUM;
+    }
+
+    Bitmap bitmap(file_header_->bitmap, file_header_->page_count);
+    if (!bitmap.get_bit(page_num)) {
+      return RC::SUCCESS;
+    }
+
+    // 预读只使用空闲的页帧，或者淘汰一个干净的页帧，不会为了预读去刷新脏页。
+    // 没有开启 CONCURRENCY 编译时 lock_ 什么都不做，所以这里不能使用 allocate_frame，
+    // 否则可能拿到前台线程刚刚加载并且正在修改的页帧
+    frame = frame_manager_.alloc_if_absent(id(), page_num);
+    if (frame == nullptr) {
+      Frame *resident_frame = frame_manager_.get(id(), page_num);
+      if (resident_frame != nullptr) {
+        resident_frame->unpin();
+        return RC::SUCCESS;
+      }
+
+      auto clean_purger = [](Frame *frame) { return frame->dirty() ? RC::LOCKED_UNLOCK : RC::SUCCESS; };
+      (void)frame_manager_.purge_frames(id(), page_num, 1 /*count*/, clean_purger);
+      frame = frame_manager_.alloc_if_absent(id(), page_num);
+      if (frame == nullptr) {
+        LOG_TRACE("no clean frame for read ahead. file=%s, page=%d", file_name_.c_str(), page_num);
+        return RC::BUFFERPOOL_NOBUF;
+      }
+    }
+  }
+
+  // 读取磁盘数据时不加锁，其它线程访问这个页面时会等待加载完成
+  RC rc = load_page(page_num, frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to load page for read ahead. file=%s, page=%d, rc=%s", file_name_.c_str(), page_num, strrc(rc));
+    frame->set_loading(false);
+
+    scoped_lock lock_guard(lock_);
+    if (OB_FAIL(purge_frame(page_num, frame))) {
+      frame->unpin();
+    }
+    return rc;
+  }
+
+  frame->set_prefetched(true);
+  frame->set_loading(false);
+  frame->unpin();
+  read_ahead_pages_++;
+  return RC::SUCCESS;
+}
+
+void DiskBufferPool::wait_read_ahead_done()
+{
+  int pending = pending_read_ahead_.load();
+  while (pending != 0) {
+    pending_read_ahead_.wait(pending);
+    pending = pending_read_ahead_.load();
+  }
+}
+
+double DiskBufferPool::read_ahead_hit_ratio() const
+{
+  const int64_t pages = read_ahead_pages_.load();
+  return pages == 0 ? 0.0 : static_cast<double>(read_ahead_hits_.load()) / pages;
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
@@ -385,6 +773,8 @@ RC DiskBufferPool::allocate_page(Frame **frame)
     return RC::BUFFERPOOL_NOBUF;
   }
 
+  // 先标记脏页再写日志，参考 DirtyPageList
+  hdr_frame_->mark_dirty();
   LSN lsn = 0;
   rc = log_handler_.allocate_page(file_header_->page_count, lsn);
   if (OB_FAIL(rc)) {
@@ -416,6 +806,7 @@ RC DiskBufferPool::allocate_page(Frame **frame)
   allocated_frame->access();
   allocated_frame->clear_page();
   allocated_frame->set_page_num(file_header_->page_count - 1);
+  allocated_frame->set_loading(false);
 
   // Use flush operation to extension file
   if ((rc = flush_page_internal(*allocated_frame)) != RC::SUCCESS) {
@@ -437,15 +828,27 @@ RC DiskBufferPool::dispose_page(PageNum page_num)
     return RC::INTERNAL;
   }
   
-  scoped_lock lock_guard(lock_);
-  Frame           *used_frame = frame_manager_.get(id(), page_num);
-  if (used_frame != nullptr) {
-    ASSERT("the page try to dispose is in use. frame:%s", used_frame->to_string().c_str());
-    frame_manager_.free(id(), page_num, used_frame);
-  } else {
+  unique_lock<common::Mutex> lock_guard(lock_);
+  Frame                     *used_frame = frame_manager_.get(id(), page_num);
+  while (used_frame != nullptr) {
+    used_frame->wait_loaded();
+    if (OB_SUCC(frame_manager_.free_if_unpinned(id(), page_num, used_frame))) {
+      break;
+    }
+
+    // 乐观读的线程暂时 pin 住了这个页面，先放开锁，它们可能需要加载其它页面
+    used_frame->unpin();
+    lock_guard.unlock();
+    this_thread::yield();
+    lock_guard.lock();
+    used_frame = frame_manager_.get(id(), page_num);
+  }
+
+  if (used_frame == nullptr) {
     LOG_DEBUG("page not found in memory while disposing it. pageNum=%d", page_num);
   }
 
+  hdr_frame_->mark_dirty();
   LSN lsn = 0;
   RC rc = log_handler_.deallocate_page(page_num, lsn);
   if (OB_FAIL(rc)) {
@@ -454,7 +857,6 @@ RC DiskBufferPool::dispose_page(PageNum page_num)
   }
 
   hdr_frame_->set_lsn(lsn);
-  hdr_frame_->mark_dirty();
   file_header_->allocated_pages--;
   char tmp = 1 << (page_num % 8);
   file_header_->bitmap[page_num / 8] &= ~tmp;
@@ -534,6 +936,8 @@ RC DiskBufferPool::check_all_pages_unpinned()
 
 RC DiskBufferPool::flush_page(Frame &frame)
 {
+  frame.wait_loaded();
+
   scoped_lock lock_guard(lock_);
   return flush_page_internal(frame);
 }
@@ -562,6 +966,40 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
   return RC::SUCCESS;
 }
 
+int DiskBufferPool::flush_dirty_pages(const vector<PageNum> &page_nums)
+{
+  int flushed_count = 0;
+
+  scoped_lock lock_guard(lock_);
+  for (PageNum page_num : page_nums) {
+    Frame *frame = frame_manager_.pin(id(), page_num);
+    if (frame == nullptr) {
+      continue;
+    }
+
+    // 文件头页面只在 lock_ 内修改，其它页面需要加读锁，防止刷新一个修改了一半的页面。
+    // 页面正在被修改时直接跳过，下一轮再刷新
+    RC rc = RC::SUCCESS;
+    if (frame->dirty() && !frame->loading()) {
+      if (page_num == BP_HEADER_PAGE) {
+        rc = flush_page_internal(*frame);
+        flushed_count += OB_SUCC(rc) ? 1 : 0;
+      } else if (frame->try_read_latch()) {
+        rc = flush_page_internal(*frame);
+        frame->read_unlatch();
+        flushed_count += OB_SUCC(rc) ? 1 : 0;
+      }
+    }
+    frame->unpin();
+
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to flush dirty page. file=%s, page=%d, rc=%s", file_name_.c_str(), page_num, strrc(rc));
+      break;
+    }
+  }
+  return flushed_count;
+}
+
 RC DiskBufferPool::flush_all_pages()
 {
   list<Frame *> used = frame_manager_.find_list(id());
@@ -710,7 +1148,7 @@ RC DiskBufferPool::allocate_frame(PageNum page_num, Frame **buffer)
     }
 
     LOG_TRACE("frames are all allocated, so we should purge some frames to get one free frame");
-    (void)frame_manager_.purge_frames(1 /*count*/, purger);
+    (void)frame_manager_.purge_frames(id(), page_num, 1 /*count*/, purger);
   }
   return RC::BUFFERPOOL_NOBUF;
 }
@@ -736,15 +1174,9 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
     return rc;
   }
 
-  scoped_lock lock_guard(wr_lock_);
-  int64_t          offset = ((int64_t)page_num) * BP_PAGE_SIZE;
-  if (lseek(file_desc_, offset, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to load page %s:%d, due to failed to lseek:%s.", file_name_.c_str(), page_num, strerror(errno));
-
-    return RC::IOERR_SEEK;
-  }
-
-  int ret = readn(file_desc_, &page, BP_PAGE_SIZE);
+  // 使用 pread 不会修改文件的读写位置，不需要与写页面互斥，预读线程也可以同时读取
+  int64_t offset = ((int64_t)page_num) * BP_PAGE_SIZE;
+  int     ret    = preadn(file_desc_, &page, BP_PAGE_SIZE, offset);
   if (ret != 0) {
     LOG_ERROR("Failed to load page %s, file_desc:%d, page num:%d, due to failed to read data:%s, ret=%d, page count=%d",
               file_name_.c_str(), file_desc_, page_num, strerror(errno), ret, file_header_->allocated_pages);
@@ -761,25 +1193,50 @@ RC DiskBufferPool::load_page(PageNum page_num, Frame *frame)
 int DiskBufferPool::file_desc() const { return file_desc_; }
 
 ////////////////////////////////////////////////////////////////////////////////
-BufferPoolManager::BufferPoolManager(int memory_size /* = 0 */)
+BufferPoolManager::BufferPoolManager(const BufferPoolOptions &options /* = BufferPoolOptions() */) : options_(options)
 {
-  if (memory_size <= 0) {
-    memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
+  if (options_.memory_size <= 0) {
+    options_.memory_size = MEM_POOL_ITEM_NUM * DEFAULT_ITEM_NUM_PER_POOL * BP_PAGE_SIZE;
+  }
+  if (options_.frame_shard_num <= 0) {
+    options_.frame_shard_num = BPFrameManager::DEFAULT_SHARD_NUM;
+  }
+  const int pool_num = max(options_.memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
+  frame_manager_.init(pool_num, options_.frame_shard_num, options_.replacer_type, options_.lru_k);
+
+  if (options_.read_ahead_pages > 0) {
+    const int thread_num = max(options_.read_ahead_thread_num, 1);
+    read_ahead_executor_ = make_unique<common::ThreadPoolExecutor>();
+    int ret = read_ahead_executor_->init("ReadAhead", thread_num, thread_num, 60 * 1000,
+        make_unique<common::BlockingQueue<unique_ptr<common::Runnable>>>());
+    if (ret != 0) {
+      LOG_WARN("failed to init read ahead thread pool, read ahead is disabled. ret=%d", ret);
+      read_ahead_executor_.reset();
+      options_.read_ahead_pages = 0;
+    }
   }
-  const int pool_num = max(memory_size / BP_PAGE_SIZE / DEFAULT_ITEM_NUM_PER_POOL, 1);
-  frame_manager_.init(pool_num);
-  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d",
-           memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num);
+
+  LOG_INFO("buffer pool manager init with memory size %d, page num: %d, pool num: %d, frame shard num: %d, "
+           "replacer: %s, scan ring size: %d, read ahead pages: %d",
+           options_.memory_size, pool_num * DEFAULT_ITEM_NUM_PER_POOL, pool_num, frame_manager_.shard_num(),
+           frame_replacer_type_name(options_.replacer_type), options_.scan_ring_size, options_.read_ahead_pages);
 }
 
 BufferPoolManager::~BufferPoolManager()
 {
+  stop_page_cleaner();
+
   unordered_map<string, DiskBufferPool *> tmp_bps;
   tmp_bps.swap(buffer_pools_);
 
   for (auto &iter : tmp_bps) {
     delete iter.second;
   }
+
+  if (read_ahead_executor_) {
+    read_ahead_executor_->shutdown();
+    read_ahead_executor_->await_termination();
+  }
 }
 
 RC BufferPoolManager::init(unique_ptr<DoubleWriteBuffer> dblwr_buffer)
@@ -901,6 +1358,147 @@ RC BufferPoolManager::flush_page(Frame &frame)
   return bp->flush_page(frame);
 }
 
+void BufferPoolManager::set_log_handler(LogHandler &log_handler)
+{
+  log_handler_ = &log_handler;
+  frame_manager_.set_lsn_provider([this]() { return log_handler_->current_lsn(); });
+}
+
+RC BufferPoolManager::start_page_cleaner()
+{
+  const int thread_num = options_.page_cleaner_thread_num;
+  if (thread_num <= 0 || !page_cleaner_threads_.empty()) {
+    return RC::SUCCESS;
+  }
+
+#ifndef CONCURRENCY
+  // 没有开启并发编译时，页面的读写锁什么都不做，后台线程可能刷新一个正在修改的页面
+  LOG_INFO("page cleaner is disabled without CONCURRENCY, dirty pages are flushed on eviction");
+  return RC::SUCCESS;
+#endif
+
+  page_cleaner_stopped_ = false;
+  for (int i = 0; i < thread_num; i++) {
+    page_cleaner_threads_.emplace_back(&BufferPoolManager::page_cleaner_func, this, i, thread_num);
+  }
+  LOG_INFO("page cleaner started. thread num=%d, interval=%dms, batch size=%d, dirty page ratio=%d%%, "
+           "max dirty page age=%d",
+           thread_num, options_.page_cleaner_interval_ms, options_.page_cleaner_batch_size,
+           options_.dirty_page_ratio, options_.max_dirty_page_age);
+  return RC::SUCCESS;
+}
+
+void BufferPoolManager::stop_page_cleaner()
+{
+  if (page_cleaner_threads_.empty()) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock_guard(page_cleaner_lock_);
+    page_cleaner_stopped_ = true;
+  }
+  page_cleaner_cond_.notify_all();
+
+  for (thread &cleaner : page_cleaner_threads_) {
+    cleaner.join();
+  }
+  page_cleaner_threads_.clear();
+  LOG_INFO("page cleaner stopped. cleaned pages=%ld", cleaned_pages_.load());
+}
+
+void BufferPoolManager::page_cleaner_func(int index, int thread_num)
+{
+  thread_set_name("PageCleaner");
+
+  const auto interval = chrono::milliseconds(max(options_.page_cleaner_interval_ms, 1));
+
+  unique_lock<mutex> lock(page_cleaner_lock_);
+  while (!page_cleaner_stopped_) {
+    page_cleaner_cond_.wait_for(lock, interval, [this]() { return page_cleaner_stopped_; });
+    if (page_cleaner_stopped_) {
+      break;
+    }
+
+    lock.unlock();
+    for (int shard_index = index; shard_index < frame_manager_.shard_num(); shard_index += thread_num) {
+      cleaned_pages_ += clean_dirty_pages(shard_index);
+    }
+    lock.lock();
+  }
+}
+
+int BufferPoolManager::clean_dirty_pages(int shard_index)
+{
+  const int    batch_size = max(options_.page_cleaner_batch_size, 1);
+  const size_t dirty_num  = frame_manager_.dirty_frame_num(shard_index);
+  if (dirty_num == 0) {
+    return 0;
+  }
+
+  // 脏页太多时，不等淘汰页面时再刷新，前台线程就不需要等待写磁盘了
+  const size_t shard_size = static_cast<size_t>(frame_manager_.frame_num_per_shard());
+  if (dirty_num * 100 > shard_size * options_.dirty_page_ratio) {
+    return flush_oldest_pages(shard_index, batch_size, numeric_limits<LSN>::max());
+  }
+
+  // 刷新太老的脏页，检查点才能向前推进
+  if (options_.max_dirty_page_age > 0 && log_handler_ != nullptr) {
+    const LSN current_lsn = log_handler_->current_lsn();
+    if (current_lsn > options_.max_dirty_page_age) {
+      return flush_oldest_pages(shard_index, batch_size, current_lsn - options_.max_dirty_page_age);
+    }
+  }
+  return 0;
+}
+
+int BufferPoolManager::flush_oldest_pages(int shard_index, int count, LSN max_recovery_lsn)
+{
+  vector<FrameId> frame_ids;
+  frame_manager_.oldest_dirty_frames(shard_index, count, max_recovery_lsn, frame_ids);
+  if (frame_ids.empty()) {
+    return 0;
+  }
+
+  // 按照文件和页面编号排序，同一个文件的页面一起刷新
+  sort(frame_ids.begin(), frame_ids.end(), [](const FrameId &a, const FrameId &b) {
+    return a.buffer_pool_id() < b.buffer_pool_id() ||
+           (a.buffer_pool_id() == b.buffer_pool_id() && a.page_num() < b.page_num());
+  });
+
+  shared_lock<shared_mutex> close_guard(close_lock_);
+
+  int             flushed_count = 0;
+  vector<PageNum> page_nums;
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    page_nums.push_back(frame_ids[i].page_num());
+
+    const int buffer_pool_id = frame_ids[i].buffer_pool_id();
+    if (i + 1 < frame_ids.size() && frame_ids[i + 1].buffer_pool_id() == buffer_pool_id) {
+      continue;
+    }
+
+    // 不能持有 lock_ 去加 DiskBufferPool 的锁，淘汰页面时是反过来加锁的
+    DiskBufferPool *bp = nullptr;
+    {
+      scoped_lock lock_guard(lock_);
+      auto        iter = id_to_buffer_pools_.find(buffer_pool_id);
+      if (iter != id_to_buffer_pools_.end()) {
+        bp = iter->second;
+      }
+    }
+
+    if (bp != nullptr) {
+      flushed_count += bp->flush_dirty_pages(page_nums);
+    }
+    page_nums.clear();
+  }
+
+  LOG_TRACE("flush oldest dirty pages. shard=%d, pages=%d, flushed=%d", 
+            shard_index, static_cast<int>(frame_ids.size()), flushed_count);
+  return flushed_count;
+}
+
 RC BufferPoolManager::get_buffer_pool(int32_t id, DiskBufferPool *&bp)
 {
   bp = nullptr;
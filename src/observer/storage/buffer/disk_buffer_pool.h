@@ -26,14 +26,20 @@ See the Mulan PSL v2 for more details. */
 #include <optional>
 
 #include "common/lang/bitmap.h"
-#include "common/lang/lru_cache.h"
+#include "common/lang/deque.h"
 #include "common/lang/mutex.h"
 #include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/thread.h"
 #include "common/lang/unordered_map.h"
+#include "common/lang/vector.h"
 #include "common/mm/mem_pool.h"
 #include "common/rc.h"
+#include "common/thread/thread_pool_executor.h"
 #include "common/types.h"
+#include "storage/buffer/dirty_page_list.h"
 #include "storage/buffer/frame.h"
+#include "storage/buffer/frame_replacer.h"
 #include "storage/buffer/page.h"
 #include "storage/buffer/buffer_pool_log.h"
 
@@ -83,13 +89,27 @@ struct BPFileHeader
  * 当内存中的页帧不够用时，需要从内存中淘汰一些页帧，以便为新的页帧腾出空间。
  * 这个管理器负责为所有的BufferPool提供页帧管理服务，也就是所有的BufferPool磁盘文件
  * 在访问时都使用这个管理器映射到内存。
+ * 页帧按照页面的编号哈希到多个分区中，每个分区有自己的锁、淘汰策略和空闲页帧，访问不同分区的
+ * 页面不会互相阻塞。页帧只在分区内部淘汰，内存也是平均分给每个分区的。
+ * 淘汰策略可以是LRU、LRU-K或者CLOCK-Pro，参考 FrameReplacer。
+ * 每个分区还按照页面变脏的先后顺序记录了分区内的脏页，供后台刷脏页和检查点使用，参考 DirtyPageList。
  */
 class BPFrameManager
 {
 public:
+  static constexpr int DEFAULT_SHARD_NUM = 8;
+
   BPFrameManager(const char *tag);
 
-  RC init(int pool_num);
+  /**
+   * @brief 初始化
+   * @param pool_num 内存池的个数，每个内存池包含 DEFAULT_ITEM_NUM_PER_POOL 个页帧
+   * @param shard_num 分区的个数
+   * @param replacer_type 页帧的淘汰策略
+   * @param lru_k 淘汰策略是 LRU-K 时的K
+   */
+  RC init(int pool_num, int shard_num = 1, FrameReplacerType replacer_type = FrameReplacerType::LRU,
+      int lru_k = LruKFrameReplacer::DEFAULT_K);
   RC cleanup();
 
   /**
@@ -101,6 +121,12 @@ public:
    */
   Frame *get(int buffer_pool_id, PageNum page_num);
 
+  /**
+   * @brief 获取指定的页面，但是不算作一次访问，不影响淘汰策略
+   * @details 后台刷脏页时使用
+   */
+  Frame *pin(int buffer_pool_id, PageNum page_num);
+
   /**
    * @brief 列出所有指定文件的页面
    *
@@ -111,52 +137,121 @@ public:
 
   /**
    * @brief 分配一个新的页面
-   *
+   * @details 如果页面所在的分区没有空闲的页帧，就返回空，即使其它的分区还有空闲页帧
    * @param buffer_pool_id buffer Pool标识
    * @param page_num 页面编号
    * @return Frame* 页帧指针
    */
   Frame *alloc(int buffer_pool_id, PageNum page_num);
 
+  /**
+   * @brief 页面不在内存中时，分配一个新的页帧
+   * @details 预读使用。页面已经在内存中，或者分区没有空闲的页帧时返回空。
+   * 与 alloc 不同，不会返回其它线程已经加载的页帧，调用者拿到的页帧一定需要自己加载。
+   */
+  Frame *alloc_if_absent(int buffer_pool_id, PageNum page_num);
+
   /**
    * 尽管frame中已经包含了buffer_pool_id和page_num，但是依然要求
    * 传入，因为frame可能忘记初始化或者没有初始化
    */
   RC free(int buffer_pool_id, PageNum page_num, Frame *frame);
 
+  /**
+   * @brief 页帧只被调用者自己 pin 住时才释放，否则返回 LOCKED_UNLOCK
+   * @details 不加锁读取页面的线程(参考 BplusTreeHandler::optimistic_find_leaf)可能暂时 pin 住了
+   * 将要释放的页面，它们校验失败之后很快就会释放，调用者可以稍后重试
+   */
+  RC free_if_unpinned(int buffer_pool_id, PageNum page_num, Frame *frame);
+
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
    * 尝试从pin count=0的页面中淘汰一些
+   * @param buffer_pool_id 想要分配的页面属于哪个buffer pool，从这个页面所在的分区中淘汰
+   * @param page_num 想要分配的页面编号
    * @param count 想要purge多少个页面
    * @param purger 需要在释放frame之前，对页面做些什么操作。当前是刷新脏数据到磁盘
    * @return 返回本次清理了多少个页面
    */
-  int purge_frames(int count, function<RC(Frame *frame)> purger);
+  int purge_frames(int buffer_pool_id, PageNum page_num, int count, function<RC(Frame *frame)> purger);
+
+  /**
+   * @brief 淘汰指定的页面
+   * @details 页面被pin住时不会淘汰
+   * @param purger 与 purge_frames 中的相同
+   * @return 页面不在内存中时返回 RC::NOTFOUND，页面正在使用时返回 RC::LOCKED_UNLOCK
+   */
+  RC purge_frame(int buffer_pool_id, PageNum page_num, function<RC(Frame *frame)> purger);
 
-  size_t frame_num() const { return frames_.count(); }
+  size_t frame_num();
 
   /**
    * 测试使用。返回已经从内存申请的个数
    */
-  size_t total_frame_num() const { return allocator_.get_size(); }
+  size_t total_frame_num() const;
 
-private:
-  Frame *get_internal(const FrameId &frame_id);
-  RC     free_internal(const FrameId &frame_id, Frame *frame);
+  int shard_num() const { return static_cast<int>(shards_.size()); }
+
+  /**
+   * @brief 每个分区的页帧个数
+   */
+  int frame_num_per_shard() const { return frame_num_per_shard_; }
+
+  /**
+   * @brief 设置获取当前日志LSN的函数，参考 DirtyPageList::set_lsn_provider
+   */
+  void set_lsn_provider(function<LSN()> lsn_provider);
+
+  /**
+   * @brief 分区中脏页的个数
+   */
+  size_t dirty_frame_num(int shard_index);
+  size_t dirty_frame_num();
+
+  /**
+   * @brief 分区中最早变脏的一些页面
+   * @param max_recovery_lsn 只返回 recovery lsn 不大于它的页面
+   * @param[out] frame_ids 页面标识，不会pin住页帧，使用时需要重新获取
+   */
+  void oldest_dirty_frames(int shard_index, int count, LSN max_recovery_lsn, vector<FrameId> &frame_ids);
+
+  /**
+   * @brief 所有脏页中最小的 recovery lsn，没有脏页时返回0
+   * @details 这个LSN之前的日志，对应的修改都已经刷新到磁盘上了
+   */
+  LSN min_recovery_lsn();
+
+  FrameReplacerType replacer_type() const { return replacer_type_; }
 
 private:
-  class BPFrameIdHasher
+  using FrameMap       = unordered_map<FrameId, Frame *, FrameIdHasher>;
+  using FrameAllocator = common::MemPoolSimple<Frame>;
+
+  /**
+   * @brief 页帧的一个分区
+   */
+  struct FrameShard
   {
-  public:
-    size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+    explicit FrameShard(const char *tag) : allocator(tag) {}
+
+    mutex                     lock;
+    FrameMap                  frames;
+    unique_ptr<FrameReplacer> replacer;    /// 分区内页帧的淘汰策略
+    FrameAllocator            allocator;   /// 分区的空闲页帧，页帧释放时还给它
+    DirtyPageList             dirty_list;  /// 分区内的脏页，按照变脏的先后顺序排列
   };
 
-  using FrameLruCache  = common::LruCache<FrameId, Frame *, BPFrameIdHasher>;
-  using FrameAllocator = common::MemPoolSimple<Frame>;
+  FrameShard &shard_of(const FrameId &frame_id) { return *shards_[frame_id.hash() % shards_.size()]; }
 
-  mutex          lock_;
-  FrameLruCache  frames_;
-  FrameAllocator allocator_;
+  Frame *get_internal(FrameShard &shard, const FrameId &frame_id);
+  Frame *alloc_internal(FrameShard &shard, const FrameId &frame_id);
+  RC     free_internal(FrameShard &shard, const FrameId &frame_id, Frame *frame);
+
+private:
+  string                         tag_;
+  FrameReplacerType              replacer_type_       = FrameReplacerType::LRU;
+  int                            frame_num_per_shard_ = 0;
+  vector<unique_ptr<FrameShard>> shards_;
 };
 
 /**
@@ -169,7 +264,12 @@ public:
   BufferPoolIterator();
   ~BufferPoolIterator();
 
-  RC      init(DiskBufferPool &bp, PageNum start_page = 0);
+  /**
+   * @brief 初始化
+   * @param start_page 从哪个页面开始遍历
+   * @param end_page 遍历到哪个页面为止(不包含)，小于0时遍历到文件末尾。可以把文件划分成多个区间并行遍历
+   */
+  RC      init(DiskBufferPool &bp, PageNum start_page = 0, PageNum end_page = -1);
   bool    has_next();
   PageNum next();
   RC      reset();
@@ -177,6 +277,52 @@ public:
 private:
   common::Bitmap bitmap_;
   PageNum        current_page_num_ = -1;
+  PageNum        end_page_num_     = -1;
+};
+
+/**
+ * @brief 顺序扫描使用的页帧环
+ * @ingroup BufferPool
+ * @details 全表扫描会依次访问文件中的每个页面，这些页面通常只访问一次。如果按照普通的方式加载，
+ * 很快就会把缓冲池中反复访问的页面，比如B+树的内部节点，都淘汰出去。
+ * 扫描时带上一个页帧环，扫描过程中新加载的页面会记录在环上，环满了之后，就淘汰掉最早加载的页面，
+ * 把它的页帧还给空闲链表，给下一个页面使用。这样一次扫描最多只占用环大小的页帧。
+ * 已经在内存中的页面不会放到环上，也就不会被扫描淘汰。
+ * 环的大小由 BufferPoolManager 的配置决定。
+ *
+ * 页帧环同时记录了这次扫描的访问位置，用来识别顺序访问并触发预读，参考 DiskBufferPool::read_ahead。
+ * 每个扫描单独识别，同一个文件上的多个扫描不会互相打断。
+ */
+class ScanRing
+{
+public:
+  static constexpr int DEFAULT_SIZE = 16;
+
+  ScanRing()  = default;
+  ~ScanRing() = default;
+
+  /**
+   * @brief 开始新的扫描时清空
+   * @details 不会淘汰环上的页面，它们之后按照正常的淘汰策略淘汰
+   */
+  void clear()
+  {
+    pages_.clear();
+    last_page_num_    = -1;
+    sequential_count_ = 0;
+    read_ahead_until_ = -1;
+  }
+
+  size_t size() const { return pages_.size(); }
+
+private:
+  friend class DiskBufferPool;
+
+  deque<PageNum> pages_;  ///< 扫描加载的页面，最早加载的在前面
+
+  PageNum last_page_num_    = -1;  ///< 上次访问的页面
+  int     sequential_count_ = 0;   ///< 连续向后访问的页面个数
+  PageNum read_ahead_until_ = -1;  ///< 已经提交预读的最大页面编号
 };
 
 /**
@@ -204,8 +350,9 @@ public:
 
   /**
    * 根据文件ID和页号获取指定页面到缓冲区，返回页面句柄指针。
+   * @param scan_ring 顺序扫描时使用的页帧环，参考 ScanRing
    */
-  RC get_this_page(PageNum page_num, Frame **frame);
+  RC get_this_page(PageNum page_num, Frame **frame, ScanRing *scan_ring = nullptr);
 
   /**
    * @brief 在指定文件中分配一个新的页面，并将其放入缓冲区，返回页面句柄指针。
@@ -255,6 +402,13 @@ public:
    */
   RC flush_all_pages();
 
+  /**
+   * @brief 后台刷新一批脏页到double write buffer
+   * @details 正在被修改的页面会跳过，不会等待。不影响页面的淘汰顺序
+   * @return 刷新的页面个数
+   */
+  int flush_dirty_pages(const vector<PageNum> &page_nums);
+
   /**
    * 回放日志时处理page0中已被认定为不存在的page
    */
@@ -268,11 +422,27 @@ public:
   RC redo_allocate_page(LSN lsn, PageNum page_num);
   RC redo_deallocate_page(LSN lsn, PageNum page_num);
 
+  /**
+   * @brief 提示马上要访问某个页面，在后台把它加载到内存中
+   * @details 比如B+树扫描时预读下一个叶子节点。没有开启预读或者页面已经在内存中时什么都不做。
+   */
+  void read_ahead_page(PageNum page_num);
+
 public:
   int32_t id() const { return buffer_pool_id_; }
 
+  /// 预读加载的页面个数
+  int64_t read_ahead_pages() const { return read_ahead_pages_.load(); }
+  /// 预读加载的页面中，之后被访问到的页面个数
+  int64_t read_ahead_hits() const { return read_ahead_hits_.load(); }
+  /// 预读的命中率
+  double read_ahead_hit_ratio() const;
+
   const char *filename() const { return file_name_.c_str(); }
 
+  /// 文件中一共有多少个页面，包括没有分配的页面
+  int32_t page_count() const { return file_header_->page_count; }
+
 protected:
   RC allocate_frame(PageNum page_num, Frame **buf);
 
@@ -282,11 +452,45 @@ protected:
   RC purge_frame(PageNum page_num, Frame *used_frame);
   RC check_page_num(PageNum page_num);
 
+  /**
+   * @brief 页面不在内存中时，分配页帧并加载页面
+   * @details 如果加锁之后发现其它线程已经在加载这个页面了，就直接返回它的页帧，调用者需要等待加载完成
+   */
+  RC load_frame(PageNum page_num, Frame *&frame, ScanRing *scan_ring);
+
   /**
    * 加载指定页面的数据到内存中
    */
   RC load_page(PageNum page_num, Frame *frame);
 
+  /**
+   * @brief 把扫描新加载的页面放到页帧环上，环满了就淘汰最早的页面
+   */
+  void add_to_scan_ring(ScanRing &scan_ring, PageNum page_num);
+
+  /**
+   * @brief 扫描访问了一个页面，如果是顺序访问，就预读后面的页面
+   * @details 连续向后访问了 SEQUENTIAL_THRESHOLD 个页面之后认为是顺序访问，提交后面
+   * read_ahead_pages 个页面的预读。之前预读的页面消费掉一半之后再提交下一批。
+   */
+  void read_ahead(ScanRing &scan_ring, PageNum page_num);
+
+  /**
+   * @brief 提交[first, last]范围内页面的预读任务
+   */
+  void submit_read_ahead(PageNum first, PageNum last);
+
+  /**
+   * @brief 在后台线程中加载一个页面
+   * @details 加载的过程中不持有 lock_，其它线程访问这个页面时会等待加载完成
+   */
+  RC prefetch_page(PageNum page_num);
+
+  /**
+   * @brief 等待所有提交的预读任务完成
+   */
+  void wait_read_ahead_done();
+
   /**
    * 如果页面是脏的，就将数据刷新到磁盘
    */
@@ -310,10 +514,42 @@ private:
   common::Mutex lock_;
   common::Mutex wr_lock_;
 
+  static constexpr int SEQUENTIAL_THRESHOLD = 2;  ///< 连续访问多少个页面之后认为是顺序访问
+
+  atomic<int>     pending_read_ahead_{0};  ///< 还没有执行完成的预读任务个数
+  atomic<int64_t> read_ahead_pages_{0};
+  atomic<int64_t> read_ahead_hits_{0};
+
 private:
   friend class BufferPoolIterator;
 };
 
+/**
+ * @brief BufferPool的配置
+ * @ingroup BufferPool
+ */
+struct BufferPoolOptions
+{
+  int memory_size     = 0;  ///< 页帧使用的内存大小，单位字节，不大于0时使用默认值
+  int frame_shard_num = 0;  ///< 页帧的分区个数，不大于0时使用默认值 BPFrameManager::DEFAULT_SHARD_NUM
+
+  FrameReplacerType replacer_type = FrameReplacerType::LRU;  ///< 页帧的淘汰策略
+  int               lru_k         = LruKFrameReplacer::DEFAULT_K;
+
+  int scan_ring_size = ScanRing::DEFAULT_SIZE;  ///< 一次顺序扫描最多占用的页帧个数，不大于0时不限制
+
+  int read_ahead_pages      = 0;  ///< 顺序扫描时每次预读的页面个数，不大于0时不预读
+  int read_ahead_thread_num = 2;  ///< 预读使用的后台线程个数
+
+  /// 后台刷脏页的线程个数，不大于0时不启动，脏页只在淘汰时刷新。没有开启 CONCURRENCY 编译时也不启动
+  int page_cleaner_thread_num  = 1;
+  int page_cleaner_interval_ms = 1000;  ///< 后台刷脏页的时间间隔
+  int page_cleaner_batch_size  = 32;    ///< 每个分区每一轮最多刷新的页面个数
+  int dirty_page_ratio         = 50;    ///< 分区中脏页的百分比超过这个值时，不等淘汰就提前刷新最早的脏页
+  /// 页面变脏之后，最多再写多少条日志就要刷新它。用来推进检查点，限制恢复时回放的日志量，不大于0时不限制
+  int max_dirty_page_age = 10000;
+};
+
 /**
  * @brief BufferPool的管理类
  * @ingroup BufferPool
@@ -321,7 +557,7 @@ private:
 class BufferPoolManager final
 {
 public:
-  BufferPoolManager(int memory_size = 0);
+  explicit BufferPoolManager(const BufferPoolOptions &options = BufferPoolOptions());
   ~BufferPoolManager();
 
   RC init(unique_ptr<DoubleWriteBuffer> dblwr_buffer);
@@ -333,6 +569,48 @@ public:
   RC flush_page(Frame &frame);
 
   BPFrameManager    &get_frame_manager() { return frame_manager_; }
+
+  /**
+   * @brief 设置当前数据库的日志处理器
+   * @details 脏页链表使用日志的LSN排序，后台刷脏页时根据LSN判断页面是否太老了。需要在打开文件之前设置
+   */
+  void set_log_handler(LogHandler &log_handler);
+
+  /**
+   * @brief 启动后台刷脏页的线程
+   * @details 在日志回放完成之后启动，回放日志修改页面时没有加页面的锁
+   */
+  RC   start_page_cleaner();
+  void stop_page_cleaner();
+
+  /**
+   * @brief 后台刷脏页线程的一轮工作，刷新一个页帧分区中的脏页
+   * @details 分区中的脏页太多时刷新最早的一批脏页，否则只刷新变脏之后又写了 max_dirty_page_age 条日志的页面
+   * @return 刷新的页面个数
+   */
+  int clean_dirty_pages(int shard_index);
+
+  /**
+   * @brief 刷新一个页帧分区中最早变脏的一批页面
+   * @param max_recovery_lsn 只刷新 recovery lsn 不大于它的页面
+   * @return 刷新的页面个数
+   */
+  int flush_oldest_pages(int shard_index, int count, LSN max_recovery_lsn);
+
+  /**
+   * @brief 关闭文件时需要加这把锁的写锁
+   * @details 后台刷脏页的线程持有读锁，防止正在刷新的 DiskBufferPool 被关闭
+   */
+  shared_mutex &close_lock() { return close_lock_; }
+
+  /// 后台线程刷新的脏页个数
+  int64_t cleaned_pages() const { return cleaned_pages_.load(); }
+
+  /**
+   * @brief 执行预读任务的后台线程池，没有开启预读时返回空
+   */
+  common::ThreadPoolExecutor *read_ahead_executor() { return read_ahead_executor_.get(); }
+  const BufferPoolOptions &options() const { return options_; }
   DoubleWriteBuffer *get_dblwr_buffer() { return dblwr_buffer_.get(); }
 
   /**
@@ -344,10 +622,27 @@ public:
   RC get_buffer_pool(int32_t id, DiskBufferPool *&bp);
 
 private:
-  BPFrameManager frame_manager_{"BufPool"};
+  BufferPoolOptions options_;
+  BPFrameManager    frame_manager_{"BufPool"};
 
   unique_ptr<DoubleWriteBuffer> dblwr_buffer_;
 
+  unique_ptr<common::ThreadPoolExecutor> read_ahead_executor_;
+
+  LogHandler *log_handler_ = nullptr;
+
+  /**
+   * @brief 后台刷脏页的线程函数，每个线程负责一部分页帧分区
+   */
+  void page_cleaner_func(int index, int thread_num);
+
+  vector<thread>     page_cleaner_threads_;
+  mutex              page_cleaner_lock_;
+  condition_variable page_cleaner_cond_;
+  bool               page_cleaner_stopped_ = false;
+  shared_mutex       close_lock_;
+  atomic<int64_t>    cleaned_pages_{0};  ///< 后台刷新的页面个数
+
   common::Mutex                            lock_;
   unordered_map<string, DiskBufferPool *>  buffer_pools_;
   unordered_map<int32_t, DiskBufferPool *> id_to_buffer_pools_;
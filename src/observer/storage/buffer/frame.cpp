@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/buffer/frame.h"
+#include "storage/buffer/dirty_page_list.h"
 #include "session/session.h"
 #include "session/thread_data.h"
 
@@ -78,6 +79,12 @@ void Frame::write_latch(intptr_t xid)
 
   lock_.lock();
 
+  // 写锁可以递归加，只在最外层修改版本号。先让版本号变成奇数，再修改页面
+  if (write_latch_depth_++ == 0) {
+    version_.store(version_.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+  }
+
 #ifdef DEBUG
   write_locker_ = xid;
   ++write_recursive_count_;
@@ -112,6 +119,10 @@ void Frame::write_unlatch(intptr_t xid)
   }
   debug_lock_.unlock();
 
+  if (--write_latch_depth_ == 0) {
+    version_.store(version_.load(memory_order_relaxed) + 1, memory_order_release);
+  }
+
   lock_.unlock();
 }
 
@@ -260,6 +271,40 @@ unsigned long current_time()
 
 void Frame::access() { acc_time_ = current_time(); }
 
+void Frame::mark_dirty()
+{
+  if (dirty_.load()) {
+    return;
+  }
+
+  if (dirty_list_ != nullptr) {
+    dirty_list_->mark_dirty(this);
+  } else {
+    dirty_.store(true);
+  }
+}
+
+void Frame::clear_dirty()
+{
+  if (!dirty_.load()) {
+    return;
+  }
+
+  if (dirty_list_ != nullptr) {
+    dirty_list_->clear_dirty(this);
+  } else {
+    dirty_.store(false);
+  }
+}
+
+void Frame::set_loading(bool loading)
+{
+  loading_.store(loading);
+  if (!loading) {
+    loading_.notify_all();
+  }
+}
+
 string Frame::to_string() const
 {
   stringstream ss;
@@ -25,6 +25,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/types.h"
 #include "storage/buffer/page.h"
 
+class DirtyPageList;
+
 /**
  * @brief 页帧标识符
  * @ingroup BufferPool
@@ -50,6 +52,16 @@ private:
   PageNum page_num_       = -1;
 };
 
+/**
+ * @brief 页帧标识符的哈希函数，用于各种哈希表
+ * @ingroup BufferPool
+ */
+class FrameIdHasher
+{
+public:
+  size_t operator()(const FrameId &frame_id) const { return frame_id.hash(); }
+};
+
 /**
  * @brief 页帧
  * @ingroup BufferPool
@@ -124,21 +136,53 @@ public:
   /**
    * @brief 标记指定页面为“脏”页。
    * @details 如果修改了页面的内容，则应调用此函数，
-   * 以便该页面被淘汰出缓冲区时系统将新的页面数据写入磁盘文件
+   * 以便该页面被淘汰出缓冲区时系统将新的页面数据写入磁盘文件。
+   * 需要在写修改页面的日志之前调用，参考 DirtyPageList
    */
-  void mark_dirty() { dirty_ = true; }
+  void mark_dirty();
 
   /**
    * @brief 重置“脏”标记
    * @details 如果页面已经被写入磁盘文件，则应调用此函数。
    */
-  void clear_dirty() { dirty_ = false; }
-  bool dirty() const { return dirty_; }
+  void clear_dirty();
+  bool dirty() const { return dirty_.load(); }
+
+  /**
+   * @brief 页面从干净变成脏时的LSN，页面是干净的时候为0
+   * @details 这个LSN之前的日志对当前页面的修改都已经落盘了
+   */
+  LSN recovery_lsn() const { return recovery_lsn_; }
+
+  /**
+   * @brief 页面变脏时放到哪个脏页链表中，页帧管理器分配页帧时设置
+   */
+  void set_dirty_list(DirtyPageList *dirty_list) { dirty_list_ = dirty_list; }
 
   char *data() { return page_.data; }
 
   bool can_purge() { return pin_count_.load() == 0; }
 
+  /**
+   * @brief 页面数据是否正在从磁盘加载
+   * @details 页帧分配出来之后，其它线程就可以在页帧管理器中找到它，但是页面数据可能还在加载中，
+   * 比如后台预读的页面。拿到页帧的线程需要调用 wait_loaded 等待加载完成之后再访问页面数据。
+   * 页帧管理器分配新页帧时会设置这个标识，加载页面的线程在加载完成之后清除它。
+   */
+  bool loading() const { return loading_.load(); }
+  void set_loading(bool loading);
+  void wait_loaded() const { loading_.wait(true); }
+
+  /**
+   * @brief 页面是否由预读加载，并且之后还没有被访问过
+   */
+  void set_prefetched(bool prefetched) { prefetched_.store(prefetched); }
+
+  /**
+   * @brief 第一次访问预读的页面时返回true，并清除预读标识
+   */
+  bool take_prefetched() { return prefetched_.load() && prefetched_.exchange(false); }
+
   /**
    * @brief 给当前页帧增加引用计数
    * pin通常都会加着frame manager锁来访问。
@@ -166,20 +210,42 @@ public:
   void read_unlatch();
   void read_unlatch(intptr_t xid);
 
+  /**
+   * @brief 乐观读使用的页面版本号
+   * @details 加写锁时版本号加1变成奇数，释放写锁时再加1变成新的偶数，版本号是奇数说明有线程正在修改页面。
+   * 读线程不加锁读取页面之前先记下一个偶数版本号，读完之后用 validate_version 确认版本号没有变化，
+   * 就说明读取期间没有其它线程修改过这个页面，读到的内容是一致的。参考 BplusTreeHandler::optimistic_find_leaf
+   */
+  uint64_t read_version() const { return version_.load(memory_order_acquire); }
+  bool     validate_version(uint64_t version) const
+  {
+    atomic_thread_fence(memory_order_acquire);
+    return version_.load(memory_order_relaxed) == version;
+  }
+  static bool version_locked(uint64_t version) { return (version & 1) != 0; }
+
   string to_string() const;
 
 private:
   friend class BufferPool;
-
-  bool          dirty_ = false;
-  atomic<int>   pin_count_{0};
-  unsigned long acc_time_ = 0;
-  FrameId       frame_id_;
-  Page          page_;
+  friend class DirtyPageList;
+
+  atomic<bool>   dirty_{false};
+  LSN            recovery_lsn_ = 0;        ///< 参考 recovery_lsn()
+  DirtyPageList *dirty_list_   = nullptr;  ///< 页面变脏时加入的链表，为空时只修改dirty标识
+  atomic<int>    pin_count_{0};
+  atomic<bool>   loading_{false};
+  atomic<bool>   prefetched_{false};
+  unsigned long  acc_time_ = 0;
+  FrameId        frame_id_;
+  Page           page_;
 
   /// 在非并发编译时，加锁解锁动作将什么都不做
   common::RecursiveSharedMutex lock_;
 
+  atomic<uint64_t> version_{0};            ///< 参考 read_version()
+  int              write_latch_depth_ = 0;  ///< 写锁递归加了几次，只有持有写锁的线程访问
+
   /// 使用一些手段来做测试，提前检测出头疼的死锁问题
   /// 如果编译时没有增加调试选项，这些代码什么都不做
   common::DebugMutex           debug_lock_;
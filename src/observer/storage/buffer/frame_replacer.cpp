@@ -0,0 +1,432 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <strings.h>
+
+#include "storage/buffer/frame_replacer.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+
+static const char *FRAME_REPLACER_TYPE_NAMES[] = {"lru", "lru-k", "clock-pro"};
+
+const char *frame_replacer_type_name(FrameReplacerType type)
+{
+  const int index = static_cast<int>(type);
+  if (index >= 0 && index < static_cast<int>(sizeof(FRAME_REPLACER_TYPE_NAMES) / sizeof(FRAME_REPLACER_TYPE_NAMES[0]))) {
+    return FRAME_REPLACER_TYPE_NAMES[index];
+  }
+  return "unknown";
+}
+
+RC frame_replacer_type_from_string(const char *name, FrameReplacerType &type)
+{
+  if (nullptr == name) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 同时接受 lru_k 和 lru-k 这种写法
+  string normalized(name);
+  for (char &c : normalized) {
+    if (c == '_') {
+      c = '-';
+    }
+  }
+
+  for (int i = 0; i < static_cast<int>(sizeof(FRAME_REPLACER_TYPE_NAMES) / sizeof(FRAME_REPLACER_TYPE_NAMES[0])); i++) {
+    if (0 == strcasecmp(normalized.c_str(), FRAME_REPLACER_TYPE_NAMES[i])) {
+      type = static_cast<FrameReplacerType>(i);
+      return RC::SUCCESS;
+    }
+  }
+  return RC::INVALID_ARGUMENT;
+}
+
+unique_ptr<FrameReplacer> FrameReplacer::create(FrameReplacerType type, int capacity, int lru_k)
+{
+  switch (type) {
+    case FrameReplacerType::LRU: return make_unique<LruFrameReplacer>();
+    case FrameReplacerType::LRU_K: return make_unique<LruKFrameReplacer>(lru_k);
+    case FrameReplacerType::CLOCK_PRO: return make_unique<ClockProFrameReplacer>(capacity);
+    default: {
+      LOG_WARN("unknown frame replacer type %d, use lru instead", static_cast<int>(type));
+      return make_unique<LruFrameReplacer>();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LruFrameReplacer::insert(Frame *frame)
+{
+  lru_list_.push_front(frame);
+  frames_[frame->frame_id()] = lru_list_.begin();
+}
+
+void LruFrameReplacer::access(Frame *frame)
+{
+  auto iter = frames_.find(frame->frame_id());
+  if (iter != frames_.end()) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+  }
+}
+
+Frame *LruFrameReplacer::victim(const function<bool(Frame *)> &evictable)
+{
+  for (auto iter = lru_list_.rbegin(); iter != lru_list_.rend(); ++iter) {
+    if (evictable(*iter)) {
+      return *iter;
+    }
+  }
+  return nullptr;
+}
+
+void LruFrameReplacer::remove(Frame *frame)
+{
+  auto iter = frames_.find(frame->frame_id());
+  if (iter != frames_.end()) {
+    lru_list_.erase(iter->second);
+    frames_.erase(iter);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LruKFrameReplacer::LruKFrameReplacer(int k) : k_(max(k, 1)) {}
+
+void LruKFrameReplacer::record_access(Entry &entry)
+{
+  entry.history.push_front(++current_time_);
+  if (static_cast<int>(entry.history.size()) > k_) {
+    entry.history.pop_back();
+  }
+
+  if (static_cast<int>(entry.history.size()) < k_) {
+    history_list_.push_front(entry.frame);
+    entry.history_pos = history_list_.begin();
+  } else {
+    cache_list_.emplace(entry.history.back(), entry.frame);
+  }
+}
+
+void LruKFrameReplacer::detach(Entry &entry)
+{
+  if (static_cast<int>(entry.history.size()) < k_) {
+    history_list_.erase(entry.history_pos);
+  } else {
+    cache_list_.erase(entry.history.back());
+  }
+}
+
+void LruKFrameReplacer::insert(Frame *frame)
+{
+  Entry &entry = frames_[frame->frame_id()];
+  if (entry.frame != nullptr) {
+    detach(entry);
+    entry.history.clear();
+  }
+  entry.frame = frame;
+  record_access(entry);
+}
+
+void LruKFrameReplacer::access(Frame *frame)
+{
+  auto iter = frames_.find(frame->frame_id());
+  if (iter == frames_.end()) {
+    return;
+  }
+
+  Entry &entry = iter->second;
+  detach(entry);
+  record_access(entry);
+}
+
+Frame *LruKFrameReplacer::victim(const function<bool(Frame *)> &evictable)
+{
+  // 访问次数不足K次的页面，倒数第K次访问的时间是无穷远，先淘汰
+  for (auto iter = history_list_.rbegin(); iter != history_list_.rend(); ++iter) {
+    if (evictable(*iter)) {
+      return *iter;
+    }
+  }
+
+  for (auto &[time, frame] : cache_list_) {
+    if (evictable(frame)) {
+      return frame;
+    }
+  }
+  return nullptr;
+}
+
+void LruKFrameReplacer::remove(Frame *frame)
+{
+  auto iter = frames_.find(frame->frame_id());
+  if (iter != frames_.end()) {
+    detach(iter->second);
+    frames_.erase(iter);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ClockProFrameReplacer::ClockProFrameReplacer(int capacity) : capacity_(max(capacity, 1))
+{
+  // 开始时冷页面使用1/4的页帧，之后根据测试期内是否再次访问来调整
+  cold_target_ = max(capacity_ / 4, 1);
+}
+
+ClockProFrameReplacer::EntryList::iterator ClockProFrameReplacer::next(EntryList::iterator iter)
+{
+  ++iter;
+  if (iter == entries_.end()) {
+    iter = entries_.begin();
+  }
+  return iter;
+}
+
+void ClockProFrameReplacer::skip_hands(EntryList::iterator iter)
+{
+  for (EntryList::iterator *hand : {&hand_hot_, &hand_cold_, &hand_test_}) {
+    if (*hand == iter) {
+      *hand = next(iter);
+      if (*hand == iter) {
+        // 环上只有这一个页面了
+        *hand = entries_.end();
+      }
+    }
+  }
+}
+
+void ClockProFrameReplacer::move_to_head(EntryList::iterator iter)
+{
+  if (entries_.size() <= 1) {
+    return;
+  }
+
+  skip_hands(iter);
+  entries_.splice(hand_hot_, entries_, iter);
+}
+
+void ClockProFrameReplacer::erase(EntryList::iterator iter)
+{
+  skip_hands(iter);
+  index_.erase(iter->frame_id);
+  entries_.erase(iter);
+}
+
+void ClockProFrameReplacer::increase_cold_target() { cold_target_ = min(cold_target_ + 1, max(capacity_ - 1, 1)); }
+
+void ClockProFrameReplacer::decrease_cold_target() { cold_target_ = max(cold_target_ - 1, 1); }
+
+void ClockProFrameReplacer::insert(Frame *frame)
+{
+  Entry entry;
+  entry.frame_id = frame->frame_id();
+  entry.frame    = frame;
+
+  auto iter = index_.find(entry.frame_id);
+  if (iter != index_.end()) {
+    Entry &old_entry = *iter->second;
+    if (old_entry.frame != nullptr) {
+      LOG_WARN("frame has been inserted. frame=%s", frame->to_string().c_str());
+      old_entry.frame = frame;
+      old_entry.ref   = true;
+      return;
+    }
+
+    // 淘汰的冷页面在测试期内又被访问了，说明冷页面的内存太少了
+    increase_cold_target();
+    test_count_--;
+    erase(iter->second);
+
+    entry.hot = true;
+    hot_count_++;
+  } else {
+    entry.test = true;
+    cold_count_++;
+  }
+
+  auto pos = entries_.insert(hand_hot_, entry);
+  index_[entry.frame_id] = pos;
+  if (hand_hot_ == entries_.end()) {
+    hand_hot_ = hand_cold_ = hand_test_ = pos;
+  }
+
+  while (hot_count_ > capacity_ - cold_target_ && run_hand_hot()) {
+  }
+  while (test_count_ > capacity_ && run_hand_test()) {
+  }
+}
+
+void ClockProFrameReplacer::access(Frame *frame)
+{
+  auto iter = index_.find(frame->frame_id());
+  if (iter != index_.end() && iter->second->frame != nullptr) {
+    iter->second->ref = true;
+  }
+}
+
+Frame *ClockProFrameReplacer::run_hand_cold(const function<bool(Frame *)> &evictable)
+{
+  // 走两圈，第一圈清除访问标记的页面，第二圈还可以再检查一遍
+  size_t steps = 2 * entries_.size() + 1;
+  while (cold_count_ > 0 && steps-- > 0) {
+    auto   iter  = hand_cold_;
+    Entry &entry = *iter;
+    if (entry.hot || entry.frame == nullptr || !evictable(entry.frame)) {
+      hand_cold_ = next(iter);
+      continue;
+    }
+
+    if (!entry.ref) {
+      // 淘汰之后 evict 会把指针移走
+      return entry.frame;
+    }
+
+    entry.ref = false;
+    if (entry.test) {
+      // 测试期内再次访问，变成热页面
+      entry.hot  = true;
+      entry.test = false;
+      cold_count_--;
+      hot_count_++;
+      increase_cold_target();
+      move_to_head(iter);
+
+      while (hot_count_ > capacity_ - cold_target_ && run_hand_hot()) {
+      }
+    } else {
+      // 开始一个新的测试期
+      entry.test = true;
+      move_to_head(iter);
+    }
+  }
+  return nullptr;
+}
+
+Frame *ClockProFrameReplacer::victim(const function<bool(Frame *)> &evictable)
+{
+  // 冷页面都不能淘汰时，把热页面变成冷页面再找，最多把每个页面都变成冷页面一次
+  for (size_t rounds = entries_.size() + 1; rounds > 0; rounds--) {
+    Frame *frame = run_hand_cold(evictable);
+    if (frame != nullptr) {
+      return frame;
+    }
+
+    if (!run_hand_hot()) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+bool ClockProFrameReplacer::run_hand_hot()
+{
+  size_t steps = 2 * entries_.size() + 1;
+  while (hot_count_ > 0 && steps-- > 0) {
+    auto   iter  = hand_hot_;
+    Entry &entry = *iter;
+    if (entry.hot) {
+      hand_hot_ = next(iter);
+      if (entry.ref) {
+        entry.ref = false;
+        continue;
+      }
+
+      entry.hot = false;
+      hot_count_--;
+      cold_count_++;
+      return true;
+    }
+
+    if (entry.test) {
+      // 测试期内没有再次访问，冷页面不需要这么多内存
+      entry.test = false;
+      decrease_cold_target();
+      if (entry.frame == nullptr) {
+        test_count_--;
+        erase(iter);
+        continue;
+      }
+    }
+    hand_hot_ = next(iter);
+  }
+  return false;
+}
+
+bool ClockProFrameReplacer::run_hand_test()
+{
+  size_t steps = entries_.size();
+  while (steps-- > 0) {
+    auto   iter  = hand_test_;
+    Entry &entry = *iter;
+    if (!entry.hot && entry.test) {
+      entry.test = false;
+      decrease_cold_target();
+      if (entry.frame == nullptr) {
+        test_count_--;
+        erase(iter);
+      } else {
+        hand_test_ = next(iter);
+      }
+      return true;
+    }
+    hand_test_ = next(iter);
+  }
+  return false;
+}
+
+void ClockProFrameReplacer::evict(Frame *frame)
+{
+  auto iter = index_.find(frame->frame_id());
+  if (iter == index_.end() || iter->second->frame == nullptr) {
+    return;
+  }
+
+  auto   entry_iter = iter->second;
+  Entry &entry      = *entry_iter;
+  if (entry.hot) {
+    hot_count_--;
+    erase(entry_iter);
+    return;
+  }
+
+  cold_count_--;
+  if (!entry.test) {
+    erase(entry_iter);
+    return;
+  }
+
+  // 还在测试期内，保留页面的记录
+  entry.frame = nullptr;
+  entry.ref   = false;
+  test_count_++;
+  if (hand_cold_ == entry_iter) {
+    hand_cold_ = next(entry_iter);
+  }
+
+  while (test_count_ > capacity_ && run_hand_test()) {
+  }
+}
+
+void ClockProFrameReplacer::remove(Frame *frame)
+{
+  auto iter = index_.find(frame->frame_id());
+  if (iter == index_.end() || iter->second->frame == nullptr) {
+    return;
+  }
+
+  if (iter->second->hot) {
+    hot_count_--;
+  } else {
+    cold_count_--;
+  }
+  erase(iter->second);
+}
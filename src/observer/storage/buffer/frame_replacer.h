@@ -0,0 +1,250 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/functional.h"
+#include "common/lang/list.h"
+#include "common/lang/map.h"
+#include "common/lang/memory.h"
+#include "common/lang/unordered_map.h"
+#include "storage/buffer/frame.h"
+
+/**
+ * @brief 页帧的淘汰策略
+ * @ingroup BufferPool
+ */
+enum class FrameReplacerType
+{
+  LRU,        ///< 最近最少使用
+  LRU_K,      ///< 按照倒数第K次访问的时间淘汰
+  CLOCK_PRO,  ///< 区分冷热页面的时钟算法
+};
+
+const char *frame_replacer_type_name(FrameReplacerType type);
+
+/**
+ * @brief 根据名字获取淘汰策略，名字不区分大小写，比如 lru、lru-k、clock-pro
+ */
+RC frame_replacer_type_from_string(const char *name, FrameReplacerType &type);
+
+/**
+ * @brief 页帧淘汰策略
+ * @ingroup BufferPool
+ * @details 记录页帧的访问历史，在没有空闲页帧时挑选一个淘汰的页帧。
+ * 每个页帧分区有一个自己的淘汰策略对象，所有的接口都在分区的锁内调用，不需要再加锁。
+ */
+class FrameReplacer
+{
+public:
+  virtual ~FrameReplacer() = default;
+
+  virtual FrameReplacerType type() const = 0;
+
+  /**
+   * @brief 页面加载到了页帧中
+   */
+  virtual void insert(Frame *frame) = 0;
+
+  /**
+   * @brief 页帧被访问了一次
+   */
+  virtual void access(Frame *frame) = 0;
+
+  /**
+   * @brief 挑选一个淘汰的页帧
+   * @details 不会修改页帧的状态，淘汰成功之后需要调用 evict
+   * @param evictable 判断页帧当前是否可以淘汰，比如是否被pin住
+   * @return 没有可以淘汰的页帧时返回空
+   */
+  virtual Frame *victim(const function<bool(Frame *)> &evictable) = 0;
+
+  /**
+   * @brief 页帧被淘汰了
+   * @details 有些策略会保留被淘汰页面的访问历史，页面再次加载时可以用到
+   */
+  virtual void evict(Frame *frame) { remove(frame); }
+
+  /**
+   * @brief 页帧被释放了，不再保留页面的任何信息
+   */
+  virtual void remove(Frame *frame) = 0;
+
+  /**
+   * @brief 当前记录的驻留在内存中的页帧个数
+   */
+  virtual size_t size() const = 0;
+
+  /**
+   * @brief 创建淘汰策略
+   * @param type 淘汰策略
+   * @param capacity 最多有多少个页帧，即分区中页帧的个数
+   * @param lru_k LRU-K 策略中的K
+   */
+  static unique_ptr<FrameReplacer> create(FrameReplacerType type, int capacity, int lru_k);
+};
+
+/**
+ * @brief 最近最少使用
+ * @ingroup BufferPool
+ */
+class LruFrameReplacer : public FrameReplacer
+{
+public:
+  LruFrameReplacer()          = default;
+  virtual ~LruFrameReplacer() = default;
+
+  FrameReplacerType type() const override { return FrameReplacerType::LRU; }
+
+  void   insert(Frame *frame) override;
+  void   access(Frame *frame) override;
+  Frame *victim(const function<bool(Frame *)> &evictable) override;
+  void   remove(Frame *frame) override;
+  size_t size() const override { return frames_.size(); }
+
+private:
+  list<Frame *>                                                    lru_list_;  ///< 最近访问的在前面
+  unordered_map<FrameId, list<Frame *>::iterator, FrameIdHasher> frames_;
+};
+
+/**
+ * @brief LRU-K 淘汰策略
+ * @ingroup BufferPool
+ * @details 记录每个页面最近K次的访问时间，优先淘汰倒数第K次访问最早的页面。访问次数不足K次的页面，
+ * 认为它的倒数第K次访问时间是无穷远，比访问了K次的页面先淘汰，它们之间按照LRU的顺序淘汰。
+ * 这样，全表扫描时只访问一次的页面，不会把B+树的内部节点这种反复访问的页面挤出去。
+ * 当前不保留已经淘汰的页面的访问历史。
+ */
+class LruKFrameReplacer : public FrameReplacer
+{
+public:
+  static constexpr int DEFAULT_K = 2;
+
+  explicit LruKFrameReplacer(int k = DEFAULT_K);
+  virtual ~LruKFrameReplacer() = default;
+
+  FrameReplacerType type() const override { return FrameReplacerType::LRU_K; }
+
+  void   insert(Frame *frame) override;
+  void   access(Frame *frame) override;
+  Frame *victim(const function<bool(Frame *)> &evictable) override;
+  void   remove(Frame *frame) override;
+  size_t size() const override { return frames_.size(); }
+
+private:
+  struct Entry
+  {
+    Frame         *frame = nullptr;
+    list<uint64_t> history;  ///< 最近K次的访问时间，最近的在前面
+
+    list<Frame *>::iterator history_pos;  ///< 访问次数不足K次时，在 history_list_ 中的位置
+  };
+
+  void record_access(Entry &entry);
+  void detach(Entry &entry);
+
+private:
+  const int k_;
+  uint64_t  current_time_ = 0;  ///< 逻辑时钟，每次访问加1，所以每个访问时间都是唯一的
+
+  list<Frame *>                                    history_list_;  ///< 访问次数不足K次的页帧，最近访问的在前面
+  map<uint64_t, Frame *>                           cache_list_;    ///< 访问了K次的页帧，按照倒数第K次访问时间排序
+  unordered_map<FrameId, Entry, FrameIdHasher>     frames_;
+};
+
+/**
+ * @brief CLOCK-Pro 淘汰策略
+ * @ingroup BufferPool
+ * @details 参考 Song Jiang, Feng Chen, Xiaodong Zhang. CLOCK-Pro: An Effective Improvement of the CLOCK
+ * Replacement. USENIX ATC 2005。
+ * 页面分成冷页面和热页面，所有页面按照访问的先后顺序放在一个环上，由三个指针来维护：
+ * - hand_cold 寻找淘汰的冷页面。冷页面在测试期内被再次访问，就变成热页面；
+ * - hand_hot 把一段时间没有访问的热页面变成冷页面，并结束冷页面的测试期；
+ * - hand_test 结束冷页面的测试期，删掉过多的已经淘汰的冷页面的记录。
+ * 冷页面被淘汰之后，如果还在测试期内，会继续保留它的记录，再次加载时直接变成热页面。
+ * 冷页面占用的页帧个数会根据这些测试的结果自适应地调整。
+ * 只访问一次的页面一直都是冷页面，因此扫描不会把热页面淘汰出去。
+ */
+class ClockProFrameReplacer : public FrameReplacer
+{
+public:
+  explicit ClockProFrameReplacer(int capacity);
+  virtual ~ClockProFrameReplacer() = default;
+
+  FrameReplacerType type() const override { return FrameReplacerType::CLOCK_PRO; }
+
+  void   insert(Frame *frame) override;
+  void   access(Frame *frame) override;
+  Frame *victim(const function<bool(Frame *)> &evictable) override;
+  void   evict(Frame *frame) override;
+  void   remove(Frame *frame) override;
+  size_t size() const override { return hot_count_ + cold_count_; }
+
+  int hot_count() const { return hot_count_; }
+  int cold_count() const { return cold_count_; }
+  int test_count() const { return test_count_; }
+  int cold_target() const { return cold_target_; }
+
+private:
+  struct Entry
+  {
+    FrameId frame_id;
+    Frame  *frame = nullptr;  ///< 已经淘汰的冷页面为空
+    bool    hot   = false;
+    bool    ref   = false;  ///< 上次指针经过之后是否被访问过
+    bool    test  = false;  ///< 冷页面是否在测试期内
+  };
+
+  using EntryList = list<Entry>;
+
+  EntryList::iterator next(EntryList::iterator iter);
+
+  /**
+   * @brief 把页面放到环的头部，也就是 hand_hot 的前面
+   */
+  void move_to_head(EntryList::iterator iter);
+  void erase(EntryList::iterator iter);
+  void skip_hands(EntryList::iterator iter);
+
+  /**
+   * @brief 寻找一个可以淘汰的冷页面
+   */
+  Frame *run_hand_cold(const function<bool(Frame *)> &evictable);
+
+  /**
+   * @brief 把一个热页面变成冷页面
+   * @return 没有热页面时返回false
+   */
+  bool run_hand_hot();
+
+  /**
+   * @brief 结束一个冷页面的测试期
+   * @return 没有在测试期内的冷页面时返回false
+   */
+  bool run_hand_test();
+
+  void increase_cold_target();
+  void decrease_cold_target();
+
+private:
+  const int capacity_;
+  int       cold_target_ = 1;  ///< 冷页面可以使用的页帧个数
+  int       hot_count_   = 0;
+  int       cold_count_  = 0;  ///< 驻留在内存中的冷页面个数
+  int       test_count_  = 0;  ///< 已经淘汰但还在测试期内的冷页面个数
+
+  EntryList                                                   entries_;
+  unordered_map<FrameId, EntryList::iterator, FrameIdHasher> index_;
+
+  EntryList::iterator hand_hot_  = entries_.end();
+  EntryList::iterator hand_cold_ = entries_.end();
+  EntryList::iterator hand_test_ = entries_.end();
+};
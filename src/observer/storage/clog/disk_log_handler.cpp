@@ -25,8 +25,7 @@ using namespace common;
 
 RC DiskLogHandler::init(const char *path)
 {
-  const int max_entry_number_per_file = 1000;
-  return file_manager_.init(path, max_entry_number_per_file);
+  return file_manager_.init(path, options_.segment_size, options_.recycled_segment_num);
 }
 
 RC DiskLogHandler::start()
@@ -50,6 +49,8 @@ RC DiskLogHandler::stop()
   }
 
   running_.store(false);
+  flush_cond_.notify_all();
+  notify_flushed();
 
   LOG_INFO("log handler stopped");
   return RC::SUCCESS;
@@ -149,9 +150,18 @@ RC DiskLogHandler::_append(LSN &lsn, LogModule module, vector<char> &&data)
 
 RC DiskLogHandler::wait_lsn(LSN lsn)
 {
-  // 直接强制等待。在生产系统中，我们可能会使用条件变量来等待。
-  while (running_.load() && current_flushed_lsn() < lsn) {
-    this_thread::sleep_for(chrono::milliseconds(100));
+  if (current_flushed_lsn() >= lsn) {
+    return RC::SUCCESS;
+  }
+
+  {
+    unique_lock<mutex> lock(group_commit_lock_);
+    if (lsn > max_waiting_lsn_) {
+      max_waiting_lsn_ = lsn;
+      flush_cond_.notify_one();
+    }
+
+    flushed_cond_.wait(lock, [this, lsn]() { return !running_.load() || current_flushed_lsn() >= lsn; });
   }
 
   if (current_flushed_lsn() >= lsn) {
@@ -161,12 +171,56 @@ RC DiskLogHandler::wait_lsn(LSN lsn)
   }
 }
 
+RC DiskLogHandler::truncate(LSN lsn)
+{
+  int removed_count = 0;
+  RC  rc            = file_manager_.remove_files_before(lsn, removed_count);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to remove clog files. lsn=%ld, rc=%s", lsn, strrc(rc));
+    return rc;
+  }
+
+  if (removed_count > 0) {
+    LOG_INFO("truncate clog files. lsn=%ld, removed files=%d", lsn, removed_count);
+  }
+  return RC::SUCCESS;
+}
+
+void DiskLogHandler::wait_for_flush_request()
+{
+  // 有事务在等待还没有落盘的日志。等待的LSN可能比当前最大的LSN还要大，这时候没有日志可以刷新
+  auto has_waiter = [this]() {
+    const LSN flushed_lsn = current_flushed_lsn();
+    return max_waiting_lsn_ > flushed_lsn && entry_buffer_.current_lsn() > flushed_lsn;
+  };
+
+  unique_lock<mutex> lock(group_commit_lock_);
+  // 没有事务在等待时，也定期刷新一下
+  flush_cond_.wait_for(lock, chrono::milliseconds(100), [this, &has_waiter]() {
+    return !running_.load() || has_waiter() || entry_buffer_.bytes() >= options_.group_commit_bytes;
+  });
+  if (!running_.load() || !has_waiter() || options_.group_commit_window_us <= 0) {
+    return;
+  }
+
+  // 已经有事务在等待了，再等一会，让后面提交的事务加入同一批
+  flush_cond_.wait_for(lock, chrono::microseconds(options_.group_commit_window_us), [this]() {
+    return !running_.load() || entry_buffer_.bytes() >= options_.group_commit_bytes;
+  });
+}
+
+void DiskLogHandler::notify_flushed()
+{
+  // 等待者在锁内检查条件，这里加一下锁，避免等待者检查完条件之后、开始等待之前错过通知
+  { lock_guard<mutex> guard(group_commit_lock_); }
+  flushed_cond_.notify_all();
+}
+
 void DiskLogHandler::thread_func()
 {
   /*
-  这个线程一直不停的循环，检查日志缓冲区中是否有日志在内存中，如果在内存中就刷新到磁盘。
-  这种做法很粗暴简单，与生产数据库的做法不同。生产数据库通常会在内存达到一定量，或者一定时间
-  之后，会刷新一下磁盘。这样做的好处是减少磁盘的IO次数，提高性能。
+  这个线程一直循环，等待有事务提交或者缓冲区中的日志足够多时，把缓冲区中所有的日志写到磁盘，
+  一批日志只做一次fsync，然后唤醒等待这些日志的事务。fsync期间提交的事务会一起在下一批中刷新。
   */
   thread_set_name("LogHandler");
   LOG_INFO("log handler thread started");
@@ -192,17 +246,25 @@ void DiskLogHandler::thread_func()
       LOG_INFO("open log file success. file=%s", file_writer.to_string().c_str());
     }
 
+    const LSN flushed_lsn = current_flushed_lsn();
+
     int flush_count = 0;
     rc = entry_buffer_.flush(file_writer, flush_count);
     if (OB_FAIL(rc) && RC::LOG_FILE_FULL != rc) {
       LOG_WARN("failed to flush log entry buffer. rc=%s", strrc(rc));
     }
 
-    if (flush_count == 0 && rc == RC::SUCCESS) {
-      this_thread::sleep_for(chrono::milliseconds(100));
-      continue;
+    if (current_flushed_lsn() > flushed_lsn) {
+      flush_group_count_++;
+      notify_flushed();
+    }
+
+    // 日志文件写满时立即切换到下一个文件继续刷新
+    if (rc != RC::LOG_FILE_FULL && running_.load()) {
+      wait_for_flush_request();
     }
   }
 
-  LOG_INFO("log handler thread stopped");
+  notify_flushed();
+  LOG_INFO("log handler thread stopped. flush groups=%ld", flush_group_count_.load());
 }
@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/deque.h"
 #include "common/lang/memory.h"
 #include "common/lang/thread.h"
+#include "common/lang/mutex.h"
+#include "common/lang/atomic.h"
 #include "storage/clog/log_module.h"
 #include "storage/clog/log_file.h"
 #include "storage/clog/log_buffer.h"
@@ -32,7 +34,11 @@ class LogReplayer;
  * @ingroup CLog
  * @details 该模块负责日志的写入、读取、回放等功能。
  * 会在后台开启一个线程，一直尝试刷新内存中的日志到磁盘。
- * 所有的CLog日志文件都存放在指定的目录下，每个日志文件按照日志条数来划分。
+ * 所有的CLog日志文件都存放在指定的目录下，每个日志文件按照字节数来划分，参考 LogFileManager。
+ *
+ * 刷日志使用组提交：后台线程每次把缓冲区中所有的日志写到文件中，只做一次fsync。
+ * 事务提交时调用 wait_lsn 唤醒后台线程，然后在条件变量上等待自己的LSN落盘；后台线程可以再等待
+ * LogHandlerOptions::group_commit_window_us，让更多的事务加入同一批。
  * 调用的顺序应该是：
  * @code {.cpp}
  * DiskLogHandler handler;
@@ -48,7 +54,8 @@ class LogReplayer;
 class DiskLogHandler : public LogHandler
 {
 public:
-  DiskLogHandler()          = default;
+  DiskLogHandler() = default;
+  explicit DiskLogHandler(const LogHandlerOptions &options) : options_(options) {}
   virtual ~DiskLogHandler() = default;
 
   /**
@@ -92,7 +99,7 @@ public:
 
   /**
    * @brief 等待指定的日志刷盘
-   *
+   * @details 会唤醒刷日志的线程，与同时在等待的其它事务一起刷盘
    * @param lsn 想要等待的日志
    */
   RC wait_lsn(LSN lsn) override;
@@ -101,6 +108,14 @@ public:
   LSN current_lsn() const override { return entry_buffer_.current_lsn(); }
   /// @brief 当前刷新到哪个日志
   LSN current_flushed_lsn() const { return entry_buffer_.flushed_lsn(); }
+  /// @brief 刷新了多少批日志，每一批做一次fsync
+  int64_t flush_group_count() const { return flush_group_count_.load(); }
+
+  /**
+   * @brief 删除所有日志都小于 lsn 的日志文件
+   * @details 正在写入的最后一个日志文件不会删除
+   */
+  RC truncate(LSN lsn) override;
 
 private:
   /**
@@ -118,6 +133,15 @@ private:
    */
   void thread_func();
 
+  /**
+   * @brief 刷日志的线程等待下一批日志
+   * @details 有事务在等待日志落盘或者缓冲区中的日志足够多时返回，否则最多等待一小段时间
+   */
+  void wait_for_flush_request();
+
+  /// @brief 通知等待日志落盘的事务
+  void notify_flushed();
+
 private:
   unique_ptr<thread> thread_;          /// 刷新日志的线程
   atomic_bool        running_{false};  /// 是否还要继续运行
@@ -126,4 +150,11 @@ private:
   LogEntryBuffer entry_buffer_;  /// 缓存日志
 
   string path_;  /// 日志文件存放的目录
+
+  LogHandlerOptions  options_;
+  mutex              group_commit_lock_;
+  condition_variable flush_cond_;            /// 唤醒刷日志的线程
+  condition_variable flushed_cond_;          /// 唤醒等待日志落盘的事务
+  LSN                max_waiting_lsn_ = 0;  /// 等待落盘的最大的LSN，受 group_commit_lock_ 保护
+  atomic<int64_t>    flush_group_count_{0};
 };
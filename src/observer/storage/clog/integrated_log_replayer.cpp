@@ -19,6 +19,7 @@ IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm)
     : buffer_pool_log_replayer_(bpm),
       record_log_replayer_(bpm),
       bplus_tree_log_replayer_(bpm),
+      hash_index_log_replayer_(bpm),
       trx_log_replayer_(nullptr)
 {}
 
@@ -26,6 +27,7 @@ IntegratedLogReplayer::IntegratedLogReplayer(BufferPoolManager &bpm, unique_ptr<
     : buffer_pool_log_replayer_(bpm),
       record_log_replayer_(bpm),
       bplus_tree_log_replayer_(bpm),
+      hash_index_log_replayer_(bpm),
       trx_log_replayer_(std::move(trx_log_replayer))
 {}
 
@@ -36,6 +38,7 @@ RC IntegratedLogReplayer::replay(const LogEntry &entry)
     case LogModule::Id::RECORD_MANAGER: return record_log_replayer_.replay(entry);
     case LogModule::Id::BPLUS_TREE: return bplus_tree_log_replayer_.replay(entry);
     case LogModule::Id::TRANSACTION: return trx_log_replayer_->replay(entry);
+    case LogModule::Id::HASH_INDEX: return hash_index_log_replayer_.replay(entry);
     default: return RC::INVALID_ARGUMENT;
   }
 }
@@ -59,6 +62,12 @@ RC IntegratedLogReplayer::on_done()
     return rc;
   }
 
+  rc = hash_index_log_replayer_.on_done();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to do hash index log replay. rc=%s", strrc(rc));
+    return rc;
+  }
+
   rc = trx_log_replayer_->on_done();
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to do mvcc trx log replay. rc=%s", strrc(rc));
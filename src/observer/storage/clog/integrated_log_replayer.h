@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/record/record_log.h"
 #include "storage/index/bplus_tree_log.h"
+#include "storage/index/linear_hash_log.h"
 #include "storage/trx/mvcc_trx_log.h"
 
 class BufferPoolManager;
@@ -56,5 +57,6 @@ private:
   BufferPoolLogReplayer   buffer_pool_log_replayer_;  ///< 缓冲池日志回放器
   RecordLogReplayer       record_log_replayer_;       ///< record manager 日志回放器
   BplusTreeLogReplayer    bplus_tree_log_replayer_;   ///< bplus tree 日志回放器
+  LinearHashLogReplayer   hash_index_log_replayer_;   ///< 哈希索引日志回放器
   unique_ptr<LogReplayer> trx_log_replayer_;          ///< trx 日志回放器
 };
\ No newline at end of file
@@ -22,6 +22,7 @@ RC LogEntryBuffer::init(LSN lsn, int32_t max_bytes /*= 0*/)
 {
   current_lsn_.store(lsn);
   flushed_lsn_.store(lsn);
+  written_lsn_ = lsn;
 
   if (max_bytes > 0) {
     max_bytes_ = max_bytes;
@@ -63,11 +64,15 @@ RC LogEntryBuffer::flush(LogFileWriter &writer, int &count)
 {
   count = 0;
 
+  // 一批只刷新开始时已经在缓冲区中的日志，否则日志不停写入时一直不能fsync
+  const LSN end_lsn = current_lsn();
+
+  RC rc = RC::SUCCESS;
   while (entry_number() > 0) {
     LogEntry entry;
     {
       lock_guard guard(mutex_);
-      if (entries_.empty()) {
+      if (entries_.empty() || entries_.front().lsn() > end_lsn) {
         break;
       }
 
@@ -79,20 +84,30 @@ RC LogEntryBuffer::flush(LogFileWriter &writer, int &count)
       bytes_ -= entry.total_size();
     }
     
-    RC rc = writer.write(entry);
+    rc = writer.write(entry);
     if (OB_FAIL(rc)) {
       lock_guard guard(mutex_);
       entries_.emplace_front(std::move(entry));
       LogEntry &front_entry = entries_.front();
       ASSERT(front_entry.lsn() > 0 && front_entry.payload_size() > 0, "invalid log entry");
-      return rc;
+      break;
     } else {
       ++count;
-      flushed_lsn_ = entry.lsn();
+      written_lsn_ = entry.lsn();
     }
   }
-  
-  return RC::SUCCESS;
+
+  // 写满一个文件时，也要把已经写入的日志刷盘之后再切换文件
+  if (written_lsn_ > flushed_lsn_.load()) {
+    RC sync_rc = writer.sync();
+    if (OB_FAIL(sync_rc)) {
+      LOG_WARN("failed to sync log file. rc=%s", strrc(sync_rc));
+      return sync_rc;
+    }
+    flushed_lsn_ = written_lsn_;
+  }
+
+  return rc;
 }
 
 int64_t LogEntryBuffer::bytes() const
@@ -48,7 +48,7 @@ public:
 
   /**
    * @brief 刷新缓冲区中的日志到磁盘
-   *
+   * @details 把缓冲区中所有的日志写到文件之后，只做一次fsync。fsync成功之后才更新 flushed_lsn
    * @param file_handle 使用它来写文件
    * @param count 刷了多少条日志
    */
@@ -74,6 +74,7 @@ private:
 
   atomic<LSN> current_lsn_{0};
   atomic<LSN> flushed_lsn_{0};
+  LSN         written_lsn_ = 0;  /// 已经写到文件中，但是可能还没有fsync的日志。只有刷日志的线程访问
 
   int32_t max_bytes_ = 4 * 1024 * 1024;  /// 缓冲区最大字节数
 };
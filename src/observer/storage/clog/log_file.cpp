@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "common/lang/string_view.h"
 #include "common/lang/charconv.h"
@@ -25,7 +27,9 @@ using namespace common;
 
 RC LogFileReader::open(const char *filename)
 {
-  filename_ = filename;
+  filename_   = filename;
+  last_lsn_   = 0;
+  end_offset_ = 0;
 
   fd_ = ::open(filename, O_RDONLY);
   if (fd_ < 0) {
@@ -56,29 +60,23 @@ RC LogFileReader::iterate(function<RC(LogEntry &)> callback, LSN start_lsn /*=0*
   }
 
   LogHeader header;
+  bool      end = false;
   while (true) {
-    int ret = readn(fd_, reinterpret_cast<char *>(&header), LogHeader::SIZE);
-    if (0 != ret) {
-      if (-1 == ret) {
-        // EOF
-        break;
-      }
-      LOG_WARN("read file failed. filename=%s, ret = %d, error=%s", filename_.c_str(), ret, strerror(errno));
-      return RC::IOERR_READ;
-    }
-
-    if (header.size < 0 || header.size > LogEntry::max_payload_size()) {
-      LOG_WARN("invalid log entry size. filename=%s, size=%d", filename_.c_str(), header.size);
-      return RC::IOERR_READ;
+    rc = read_header(header, end);
+    if (OB_FAIL(rc) || end) {
+      break;
     }
 
     vector<char> data(header.size);
-    ret = readn(fd_, data.data(), header.size);
+    int          ret = readn(fd_, data.data(), header.size);
     if (0 != ret) {
       LOG_WARN("read file failed. filename=%s, size=%d, ret=%d, error=%s", filename_.c_str(), header.size, ret, strerror(errno));
       return RC::IOERR_READ;
     }
 
+    last_lsn_ = header.lsn;
+    end_offset_ += LogHeader::SIZE + header.size;
+
     LogEntry entry;
     entry.init(header.lsn, LogModule(header.module_id), std::move(data));
     rc = callback(entry);
@@ -89,7 +87,7 @@ RC LogFileReader::iterate(function<RC(LogEntry &)> callback, LSN start_lsn /*=0*
     LOG_TRACE("redo log iterate entry success. entry=%s", entry.to_string().c_str());
   }
 
-  return RC::SUCCESS;
+  return rc;
 }
 
 RC LogFileReader::skip_to(LSN start_lsn)
@@ -98,6 +96,9 @@ RC LogFileReader::skip_to(LSN start_lsn)
     return RC::FILE_NOT_OPENED;
   }
 
+  last_lsn_   = 0;
+  end_offset_ = 0;
+
   off_t pos = lseek(fd_, 0, SEEK_SET);
   if (off_t(-1) == pos) {
     LOG_WARN("seek file failed. seek to the beginning. filename=%s, error=%s", filename_.c_str(), strerror(errno));
@@ -105,30 +106,19 @@ RC LogFileReader::skip_to(LSN start_lsn)
   }
 
   LogHeader header;
+  bool      end = false;
   while (true) {
-    int ret = readn(fd_, reinterpret_cast<char *>(&header), LogHeader::SIZE);
-    if (0 != ret) {
-      if (-1 == ret) {
-        // EOF
-        break;
-      }
-      LOG_WARN("read file failed. filename=%s, ret = %d, error=%s", filename_.c_str(), ret, strerror(errno));
-      return RC::IOERR_READ;
+    RC rc = read_header(header, end);
+    if (OB_FAIL(rc)) {
+      return rc;
     }
 
-    if (header.lsn >= start_lsn) {
-      off_t pos = lseek(fd_, -LogHeader::SIZE, SEEK_CUR);
-      if (off_t(-1) == pos) {
-        LOG_WARN("seek file failed. skip back log header. filename=%s, error=%s", filename_.c_str(), strerror(errno));
-        return RC::IOERR_SEEK;
-      }
+    if (end || header.lsn >= start_lsn) {
       break;
     }
 
-    if (header.size < 0 || header.size > LogEntry::max_payload_size()) {
-      LOG_WARN("invalid log entry size. filename=%s, size=%d", filename_.c_str(), header.size);
-      return RC::IOERR_READ;
-    }
+    last_lsn_ = header.lsn;
+    end_offset_ += LogHeader::SIZE + header.size;
 
     pos = lseek(fd_, header.size, SEEK_CUR);
     if (off_t(-1) == pos) {
@@ -137,8 +127,38 @@ RC LogFileReader::skip_to(LSN start_lsn)
     }
   }
 
+  // 回到第一条需要读取的日志头
+  pos = lseek(fd_, end_offset_, SEEK_SET);
+  if (off_t(-1) == pos) {
+    LOG_WARN("seek file failed. filename=%s, offset=%ld, error=%s", filename_.c_str(), end_offset_, strerror(errno));
+    return RC::IOERR_SEEK;
+  }
   return RC::SUCCESS;
 }
+
+RC LogFileReader::read_header(LogHeader &header, bool &end)
+{
+  end     = false;
+  int ret = readn(fd_, reinterpret_cast<char *>(&header), LogHeader::SIZE);
+  if (0 != ret) {
+    if (-1 == ret) {
+      // EOF
+      end = true;
+      return RC::SUCCESS;
+    }
+    LOG_WARN("read file failed. filename=%s, ret = %d, error=%s", filename_.c_str(), ret, strerror(errno));
+    return RC::IOERR_READ;
+  }
+
+  // 预先分配的空间是全0的，回收的文件中是旧的日志，它们的LSN都不会比前面的日志大
+  if (header.size <= 0 || header.size > LogEntry::max_payload_size() || header.lsn <= last_lsn_) {
+    LOG_TRACE("reach the end of log file. filename=%s, offset=%ld, header=%s",
+              filename_.c_str(), end_offset_, header.to_string().c_str());
+    end = true;
+  }
+  return RC::SUCCESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // LogFileWriter
 LogFileWriter::~LogFileWriter()
@@ -146,22 +166,65 @@ LogFileWriter::~LogFileWriter()
   (void)this->close();
 }
 
-RC LogFileWriter::open(const char *filename, int end_lsn)
+RC LogFileWriter::open(const char *filename, int64_t max_size)
 {
   if (fd_ >= 0) {
     return RC::FILE_OPEN;
   }
 
   filename_ = filename;
-  end_lsn_ = end_lsn;
+  max_size_ = max_size;
+  last_lsn_ = 0;
+  offset_   = 0;
+
+  // 文件中已经有日志，需要找到最后一条日志的位置，接着写
+  if (filesystem::exists(filename)) {
+    LogFileReader reader;
+    RC            rc = reader.open(filename);
+    if (OB_SUCC(rc)) {
+      rc = reader.iterate([](LogEntry &) { return RC::SUCCESS; });
+      reader.close();
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to read log file. filename=%s, rc=%s", filename, strrc(rc));
+      return rc;
+    }
+    last_lsn_ = reader.last_lsn();
+    offset_   = reader.end_offset();
+  }
 
-  fd_ = ::open(filename, O_WRONLY | O_APPEND | O_CREAT | O_SYNC, 0644);
+  fd_ = ::open(filename, O_RDWR | O_CREAT, 0644);
   if (fd_ < 0) {
     LOG_WARN("open file failed. filename=%s, error=%s", filename, strerror(errno));
     return RC::FILE_OPEN;
   }
 
-  LOG_INFO("open file success. filename=%s, fd=%d", filename, fd_);
+  // 预先分配好空间，后面写日志时就不需要再修改文件的元数据了
+  struct stat st;
+  if (fstat(fd_, &st) == 0 && st.st_size < max_size_) {
+#ifdef __linux__
+    int ret = fallocate(fd_, 0, 0, max_size_);
+#else
+    int ret = ftruncate(fd_, max_size_);
+#endif
+    if (ret != 0) {
+      LOG_WARN("failed to preallocate log file. filename=%s, size=%ld, error=%s", filename, max_size_, strerror(errno));
+    }
+  }
+
+  if (lseek(fd_, offset_, SEEK_SET) == off_t(-1)) {
+    LOG_WARN("seek file failed. filename=%s, offset=%ld, error=%s", filename, offset_, strerror(errno));
+    close();
+    return RC::IOERR_SEEK;
+  }
+
+  RC rc = sync();
+  if (OB_FAIL(rc)) {
+    close();
+    return rc;
+  }
+
+  LOG_INFO("open file success. filename=%s, fd=%d, last_lsn=%ld, offset=%ld", filename, fd_, last_lsn_, offset_);
   return RC::SUCCESS;
 }
 
@@ -178,8 +241,8 @@ RC LogFileWriter::close()
 
 RC LogFileWriter::write(LogEntry &entry)
 {
-  // 一个日志文件写的日志条数是有限制的
-  if (entry.lsn() > end_lsn_) {
+  // 一个日志文件的大小是有限制的，还要留出结束标记的位置。空文件总是可以写入一条日志
+  if (offset_ > 0 && offset_ + entry.total_size() + LogHeader::SIZE > max_size_) {
     return RC::LOG_FILE_FULL;
   }
 
@@ -210,10 +273,43 @@ RC LogFileWriter::write(LogEntry &entry)
   }
 
   last_lsn_ = entry.lsn();
+  offset_ += entry.total_size();
   LOG_TRACE("write log entry success. filename=%s, entry=%s", filename_.c_str(), entry.to_string().c_str());
   return RC::SUCCESS;
 }
 
+RC LogFileWriter::write_end_mark()
+{
+  LogHeader end_mark;
+  memset(&end_mark, 0, sizeof(end_mark));
+
+  int ret = pwriten(fd_, &end_mark, LogHeader::SIZE, offset_);
+  if (0 != ret) {
+    LOG_WARN("write log end mark failed. filename=%s, offset=%ld, ret=%d, error=%s",
+             filename_.c_str(), offset_, ret, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC LogFileWriter::sync()
+{
+  if (fd_ < 0) {
+    return RC::FILE_NOT_OPENED;
+  }
+
+  RC rc = write_end_mark();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  if (fdatasync(fd_) != 0) {
+    LOG_WARN("sync log file failed. filename=%s, error=%s", filename_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  return RC::SUCCESS;
+}
+
 bool LogFileWriter::valid() const
 {
   return fd_ >= 0;
@@ -221,7 +317,7 @@ bool LogFileWriter::valid() const
 
 bool LogFileWriter::full() const
 {
-  return last_lsn_ >= end_lsn_;
+  return offset_ + LogHeader::SIZE >= max_size_;
 }
 
 string LogFileWriter::to_string() const
@@ -232,10 +328,11 @@ string LogFileWriter::to_string() const
 ////////////////////////////////////////////////////////////////////////////////
 // LogFileManager
 
-RC LogFileManager::init(const char *directory, int max_entry_number_per_file)
+RC LogFileManager::init(const char *directory, int64_t segment_size, int max_recycled_file_num /*= 0*/)
 {
-  directory_ = filesystem::absolute(filesystem::path(directory));
-  max_entry_number_per_file_ = max_entry_number_per_file;
+  directory_             = filesystem::absolute(filesystem::path(directory));
+  segment_size_          = segment_size;
+  max_recycled_file_num_ = max_recycled_file_num;
 
   filesystem::file_status  directory_status = filesystem::status(directory_);
 
@@ -258,6 +355,11 @@ RC LogFileManager::init(const char *directory, int max_entry_number_per_file)
     }
 
     string filename = dir_entry.path().filename().string();
+    if (filename.starts_with(recycled_file_prefix_)) {
+      recycled_files_.push_back(dir_entry.path());
+      continue;
+    }
+
     LSN lsn = 0;
     RC rc = get_lsn_from_filename(filename, lsn);
     if (OB_FAIL(rc)) {
@@ -274,8 +376,8 @@ RC LogFileManager::init(const char *directory, int max_entry_number_per_file)
     log_files_.emplace(lsn, dir_entry.path());
   }
 
-  LOG_INFO("init log file manager success. directory=%s, log files=%d", 
-           directory_.c_str(), static_cast<int>(log_files_.size()));
+  LOG_INFO("init log file manager success. directory=%s, log files=%d, recycled files=%d", 
+           directory_.c_str(), static_cast<int>(log_files_.size()), static_cast<int>(recycled_files_.size()));
   return RC::SUCCESS;
 }
 
@@ -300,11 +402,12 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 {
   files.clear();
 
-  // 这里的代码是AI自动生成的
-  // 其实写的不好，我们只需要找到比start_lsn相等或者小的第一个日志文件就可以了
-  for (auto &file : log_files_) {
-    if (file.first + max_entry_number_per_file_ - 1 >= start_lsn) {
-      files.emplace_back(file.second.string());
+  lock_guard<mutex> lock_guard(lock_);
+  // 一个日志文件中的日志都比下一个文件的第一个LSN小，所以从下一个文件的LSN大于start_lsn的文件开始
+  for (auto iter = log_files_.begin(); iter != log_files_.end(); ++iter) {
+    auto next_iter = std::next(iter);
+    if (next_iter == log_files_.end() || next_iter->first > start_lsn) {
+      files.emplace_back(iter->second.string());
     }
   }
 
@@ -313,29 +416,125 @@ RC LogFileManager::list_files(vector<string> &files, LSN start_lsn)
 
 RC LogFileManager::last_file(LogFileWriter &file_writer)
 {
+  unique_lock<mutex> lock_guard(lock_);
   if (log_files_.empty()) {
+    lock_guard.unlock();
     return next_file(file_writer);
   }
 
   file_writer.close();
 
   auto last_file_item = log_files_.rbegin();
-  return file_writer.open(last_file_item->second.c_str(), 
-                          last_file_item->first + max_entry_number_per_file_ - 1);
+  return file_writer.open(last_file_item->second.c_str(), segment_size_);
 }
 
 RC LogFileManager::next_file(LogFileWriter &file_writer)
 {
+  // 新文件的第一条日志紧跟着上一个文件的最后一条日志
+  const LSN last_lsn = file_writer.last_lsn();
   file_writer.close();
 
+  lock_guard<mutex> lock_guard(lock_);
   LSN lsn = 0;
   if (!log_files_.empty()) {
-    lsn = log_files_.rbegin()->first + max_entry_number_per_file_;
+    lsn = last_lsn + 1;
+    if (lsn <= log_files_.rbegin()->first) {
+      LOG_WARN("invalid lsn of next log file. lsn=%ld, last file=%s", lsn, log_files_.rbegin()->second.c_str());
+      return RC::INTERNAL;
+    }
   }
 
   string filename = file_prefix_ + std::to_string(lsn) + file_suffix_;
   filesystem::path file_path = directory_ / filename;
+
+  // 复用回收的日志文件，它的空间已经分配好了
+  if (!recycled_files_.empty()) {
+    error_code ec;
+    filesystem::rename(recycled_files_.front(), file_path, ec);
+    if (ec) {
+      LOG_WARN("failed to reuse recycled log file. file=%s, error=%s", 
+               recycled_files_.front().c_str(), ec.message().c_str());
+    } else {
+      LOG_INFO("reuse recycled log file. file=%s, new file=%s", recycled_files_.front().c_str(), file_path.c_str());
+    }
+    recycled_files_.pop_front();
+  }
+
   log_files_.emplace(lsn, file_path);
 
-  return file_writer.open(file_path.c_str(), lsn + max_entry_number_per_file_ - 1);
+  return file_writer.open(file_path.c_str(), segment_size_);
+}
+
+RC LogFileManager::remove_files_before(LSN lsn, int &removed_count)
+{
+  removed_count = 0;
+
+  lock_guard<mutex> lock_guard(lock_);
+  while (log_files_.size() > 1) {
+    auto iter      = log_files_.begin();
+    auto next_iter = std::next(iter);
+    if (next_iter->first > lsn) {
+      break;
+    }
+
+    if (static_cast<int>(recycled_files_.size()) < max_recycled_file_num_) {
+      RC rc = recycle_file(iter->first, iter->second);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    } else {
+      error_code ec;
+      filesystem::remove(iter->second, ec);
+      if (ec) {
+        LOG_WARN("failed to remove log file. file=%s, error=%s", iter->second.c_str(), ec.message().c_str());
+        return RC::IOERR_REMOVE;
+      }
+
+      LOG_INFO("remove log file. file=%s", iter->second.c_str());
+    }
+
+    log_files_.erase(iter);
+    removed_count++;
+  }
+  return RC::SUCCESS;
+}
+
+RC LogFileManager::recycle_file(LSN lsn, const filesystem::path &file_path)
+{
+  int fd = ::open(file_path.c_str(), O_WRONLY);
+  if (fd < 0) {
+    LOG_WARN("failed to open log file. file=%s, error=%s", file_path.c_str(), strerror(errno));
+    return RC::FILE_OPEN;
+  }
+
+  // 第一个日志头写成全0，文件中的旧日志就都读不到了
+  LogHeader end_mark;
+  memset(&end_mark, 0, sizeof(end_mark));
+  int ret = pwriten(fd, &end_mark, LogHeader::SIZE, 0);
+  if (0 == ret && fdatasync(fd) != 0) {
+    ret = errno;
+  }
+  ::close(fd);
+  if (0 != ret) {
+    LOG_WARN("failed to clear log file. file=%s, error=%s", file_path.c_str(), strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+
+  filesystem::path recycled_path = directory_ / (recycled_file_prefix_ + std::to_string(lsn) + file_suffix_);
+  error_code       ec;
+  filesystem::rename(file_path, recycled_path, ec);
+  if (ec) {
+    LOG_WARN("failed to rename log file. file=%s, error=%s", file_path.c_str(), ec.message().c_str());
+    return RC::IOERR_WRITE;
+  }
+
+  recycled_files_.push_back(recycled_path);
+  LOG_INFO("recycle log file. file=%s, recycled file=%s", file_path.c_str(), recycled_path.c_str());
+  return RC::SUCCESS;
+}
+
+int LogFileManager::recycled_file_num()
+{
+  lock_guard<mutex> lock_guard(lock_);
+  return static_cast<int>(recycled_files_.size());
 }
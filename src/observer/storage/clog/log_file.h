@@ -16,18 +16,23 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/rc.h"
 #include "common/types.h"
+#include "common/lang/deque.h"
 #include "common/lang/map.h"
+#include "common/lang/mutex.h"
 #include "common/lang/functional.h"
 #include "common/lang/filesystem.h"
 #include "common/lang/fstream.h"
 #include "common/lang/string.h"
 
 class LogEntry;
+struct LogHeader;
 
 /**
  * @brief 负责处理一个日志文件，包括读取和写入
  * @ingroup CLog
- * @details 日志文件中的日志是按照LSN从小到大排列的
+ * @details 日志文件中的日志是按照LSN从小到大排列的。
+ * 日志文件是预先分配空间的，也可能是回收的旧文件，有效的日志后面可能是全0或者旧的日志。
+ * 所以遇到LSN没有递增或者大小不合法的日志头时，就认为日志结束了。
  */
 class LogFileReader
 {
@@ -40,6 +45,11 @@ public:
 
   RC iterate(function<RC(LogEntry &)> callback, LSN start_lsn = 0);
 
+  /// @brief 读取到的最后一条日志的LSN
+  LSN last_lsn() const { return last_lsn_; }
+  /// @brief 读取到的最后一条日志结束的位置
+  off_t end_offset() const { return end_offset_; }
+
 private:
   /**
    * @brief 跳到第一条不小于start_lsn的日志
@@ -48,9 +58,17 @@ private:
    */
   RC skip_to(LSN start_lsn);
 
+  /**
+   * @brief 读取下一条日志的头
+   * @param[out] end 到达文件末尾或者不是有效的日志，后面没有日志了
+   */
+  RC read_header(LogHeader &header, bool &end);
+
 private:
   int    fd_ = -1;
   string filename_;
+  LSN    last_lsn_   = 0;
+  off_t  end_offset_ = 0;
 };
 
 /**
@@ -65,10 +83,11 @@ public:
 
   /**
    * @brief 打开一个日志文件
+   * @details 文件不存在时创建出来，并预先分配空间。文件中已经有日志时，接着最后一条日志写
    * @param filename 日志文件名
-   * @param end_lsn 当前日志文件允许的最大LSN（包含）
+   * @param max_size 日志文件的最大字节数
    */
-  RC open(const char *filename, int end_lsn);
+  RC open(const char *filename, int64_t max_size);
 
   /// @brief 关闭当前文件
   RC close();
@@ -76,13 +95,16 @@ public:
   /// @brief 写入一条日志
   RC write(LogEntry &entry);
 
+  /// @brief 把写入的日志刷新到磁盘
+  RC sync();
+
   /**
    * @brief 当前文件是否已经打开
    */
   bool valid() const;
 
   /**
-   * @brief 文件是否已经写满。当前是按照日志条数来判断的
+   * @brief 文件是否已经写满，按照字节数判断
    */
   bool full() const;
 
@@ -90,18 +112,31 @@ public:
 
   const char *filename() const { return filename_.c_str(); }
 
+  /// @brief 写入的最后一条日志LSN，没有日志时是0
+  LSN last_lsn() const { return last_lsn_; }
+
 private:
-  string filename_;       /// 日志文件名
-  int    fd_       = -1;  /// 日志文件描述符
-  int    last_lsn_ = 0;   /// 写入的最后一条日志LSN
-  int    end_lsn_  = 0;   /// 当前日志文件中允许写入的最大的LSN，包括这条日志
+  /**
+   * @brief 在最后一条日志后面写一个全0的日志头
+   * @details 文件后面可能是回收的旧日志，读取日志时遇到它就知道日志结束了
+   */
+  RC write_end_mark();
+
+private:
+  string  filename_;       /// 日志文件名
+  int     fd_       = -1;  /// 日志文件描述符
+  LSN     last_lsn_ = 0;   /// 写入的最后一条日志LSN
+  off_t   offset_   = 0;   /// 下一条日志写入的位置
+  int64_t max_size_ = 0;   /// 日志文件的最大字节数
 };
 
 /**
  * @brief 管理所有的日志文件
  * @ingroup CLog
  * @details 日志文件都在某个目录下，使用固定的前缀加上日志文件的第一个LSN作为文件名。
- * 每个日志文件没有最大字节数要求，但是以固定条数的日志为一个文件，这样方便查找。
+ * 每个日志文件按照固定的字节数分段，创建时就分配好空间，避免写日志时频繁地创建文件、扩展文件。
+ * 一个日志文件中日志的LSN都小于下一个日志文件名中的LSN，最后一个日志文件没有上限。
+ * 检查点之前的日志文件不再需要时，会改名保留一部分，下次需要新文件时直接复用，而不是删除再创建。
  */
 class LogFileManager
 {
@@ -113,9 +148,10 @@ public:
    * @brief 初始化
    *
    * @param directory 日志文件目录
-   * @param max_entry_number_per_file 一个文件最多存储多少条日志
+   * @param segment_size 一个日志文件的字节数
+   * @param max_recycled_file_num 最多保留多少个回收的日志文件
    */
-  RC init(const char *directory, int max_entry_number_per_file);
+  RC init(const char *directory, int64_t segment_size, int max_recycled_file_num = 0);
 
   /**
    * @brief 列出所有的日志文件，第一个日志文件包含大于等于start_lsn最小的日志
@@ -133,10 +169,23 @@ public:
 
   /**
    * @brief 获取一个新的日志文件名
-   * @details 获取下一个日志文件名。通常是上一个日志文件写满了，通过这个接口生成下一个日志文件
+   * @details 获取下一个日志文件名。通常是上一个日志文件写满了，通过这个接口生成下一个日志文件。
+   * 新文件的LSN紧跟着 file_writer 中最后一条日志。有回收的日志文件时优先复用
    */
   RC next_file(LogFileWriter &file_writer);
 
+  /**
+   * @brief 删除所有日志的LSN都小于 lsn 的日志文件
+   * @details 最后一个日志文件可能正在写入，不会删除。可以与写日志的线程并发调用。
+   * 回收的文件个数没有达到上限时，文件会改名留下来复用
+   * @param lsn 需要保留的最小的LSN
+   * @param[out] removed_count 删除或回收了多少个文件
+   */
+  RC remove_files_before(LSN lsn, int &removed_count);
+
+  /// @brief 当前有多少个回收的日志文件
+  int recycled_file_num();
+
 private:
   /**
    * @brief 从文件名称中获取LSN
@@ -144,12 +193,22 @@ private:
    */
   static RC get_lsn_from_filename(const string &filename, LSN &lsn);
 
+  /**
+   * @brief 回收一个日志文件
+   * @details 先清除文件中的日志，再改成回收文件的名字，这样即使中途重启，也不会读到旧的日志
+   */
+  RC recycle_file(LSN lsn, const filesystem::path &file_path);
+
 private:
-  static constexpr const char *file_prefix_ = "clog_";
-  static constexpr const char *file_suffix_ = ".log";
+  static constexpr const char *file_prefix_          = "clog_";
+  static constexpr const char *file_suffix_          = ".log";
+  static constexpr const char *recycled_file_prefix_ = "clog_recycled_";
 
   filesystem::path directory_;                  /// 日志文件存放的目录
-  int              max_entry_number_per_file_;  /// 一个文件最大允许存放多少条日志
+  int64_t          segment_size_          = 0;  /// 一个日志文件的字节数
+  int              max_recycled_file_num_ = 0;  /// 最多保留多少个回收的日志文件
 
-  map<LSN, filesystem::path> log_files_;  /// 日志文件名和第一个LSN的映射
+  mutex                      lock_;            /// 保护 log_files_，删除日志文件与写日志文件在不同的线程中
+  map<LSN, filesystem::path> log_files_;       /// 日志文件名和第一个LSN的映射
+  deque<filesystem::path>    recycled_files_;  /// 回收的日志文件，可以直接复用
 };
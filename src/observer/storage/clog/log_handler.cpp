@@ -30,14 +30,14 @@ RC LogHandler::append(LSN &lsn, LogModule::Id module, vector<char> &&data)
   return _append(lsn, LogModule(module), std::move(data));
 }
 
-RC LogHandler::create(const char *name, LogHandler *&log_handler)
+RC LogHandler::create(const char *name, LogHandler *&log_handler, const LogHandlerOptions &options)
 {
   if (name == nullptr || common::is_blank(name)) {
     name = "vacuous";
   }
 
   if (strcasecmp(name, "disk") == 0) {
-    log_handler = new DiskLogHandler();
+    log_handler = new DiskLogHandler(options);
   } else if (strcasecmp(name, "vacuous") == 0) {
     log_handler = new VacuousLogHandler();
   } else {
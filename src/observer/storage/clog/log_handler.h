@@ -29,6 +29,29 @@ See the Mulan PSL v2 for more details. */
 class LogReplayer;
 class LogEntry;
 
+/**
+ * @brief 日志模块的配置项
+ * @ingroup CLog
+ */
+struct LogHandlerOptions
+{
+  /**
+   * @brief 组提交的等待时间，单位微秒
+   * @details 有事务在等待日志落盘时，刷日志的线程最多再等待这么久，让后面提交的事务也加入进来，
+   * 一起写一次文件、做一次fsync。不大于0时不额外等待，此时正在fsync的时候到达的提交仍然会合并到下一批中。
+   */
+  int group_commit_window_us = 0;
+
+  /// 缓冲区中的日志达到这么多字节时，不再等待，立即刷盘
+  int group_commit_bytes = 64 * 1024;
+
+  /// 一个日志文件的字节数，创建日志文件时就分配好空间
+  int segment_size = 64 * 1024 * 1024;
+
+  /// 检查点之后不再需要的日志文件，最多保留这么多个用来复用，多余的会删除
+  int recycled_segment_num = 4;
+};
+
 /**
  * @brief 对外提供服务的CLog模块
  * @ingroup CLog
@@ -96,7 +119,15 @@ public:
 
   virtual LSN current_lsn() const = 0;
 
-  static RC create(const char *name, LogHandler *&handler);
+  /**
+   * @brief 删除不再需要的日志
+   * @details 检查点推进之后，检查点之前的日志就不需要回放了。只会删除LSN小于 lsn 的日志，
+   * 可能因为日志文件的粒度保留一部分
+   * @param lsn 检查点的LSN
+   */
+  virtual RC truncate(LSN lsn) = 0;
+
+  static RC create(const char *name, LogHandler *&handler, const LogHandlerOptions &options = LogHandlerOptions());
 
 private:
   /**
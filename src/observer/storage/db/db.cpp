@@ -19,10 +19,14 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 #include <filesystem>
 
+#include "common/conf/ini.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/os/path.h"
 #include "common/global_context.h"
+#include "common/lang/chrono.h"
+#include "common/thread/thread_util.h"
 #include "common/rc.h"
 #include "storage/common/meta_util.h"
 #include "storage/table/table.h"
@@ -33,8 +37,100 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+namespace {
+
+/**
+ * @brief 读取配置文件中某个段的配置项
+ * @details 单元测试等场景下没有加载配置文件，返回空
+ */
+string section_config(const char *section, const char *key)
+{
+  if (nullptr == get_properties()) {
+    return "";
+  }
+  return get_properties()->get(key, "", section);
+}
+
+/**
+ * @brief 读取配置文件中某个段的整数配置项，没有配置时使用默认值
+ */
+int section_config(const char *section, const char *key, int default_value)
+{
+  int    value = default_value;
+  string str   = section_config(section, key);
+  if (!str.empty() && !str_to_val(str, value)) {
+    LOG_WARN("invalid config. section=%s, key=%s, value=%s", section, key, str.c_str());
+    value = default_value;
+  }
+  return value;
+}
+
+/**
+ * @brief 读取配置文件中 [BUFFER_POOL] 段的配置项
+ */
+string buffer_pool_config(const char *key) { return section_config("BUFFER_POOL", key); }
+
+int buffer_pool_config(const char *key, int default_value) { return section_config("BUFFER_POOL", key, default_value); }
+
+BufferPoolOptions buffer_pool_options()
+{
+  BufferPoolOptions options;
+  options.frame_shard_num = buffer_pool_config("FRAME_SHARD_NUM", BPFrameManager::DEFAULT_SHARD_NUM);
+
+  string replacer = buffer_pool_config("REPLACER");
+  if (!replacer.empty() && OB_FAIL(frame_replacer_type_from_string(replacer.c_str(), options.replacer_type))) {
+    LOG_WARN("invalid buffer pool replacer %s, use %s instead",
+             replacer.c_str(), frame_replacer_type_name(options.replacer_type));
+  }
+  options.lru_k          = buffer_pool_config("LRU_K", LruKFrameReplacer::DEFAULT_K);
+  options.scan_ring_size = buffer_pool_config("SCAN_RING_SIZE", ScanRing::DEFAULT_SIZE);
+
+  options.read_ahead_pages      = buffer_pool_config("READ_AHEAD_PAGES", options.read_ahead_pages);
+  options.read_ahead_thread_num = buffer_pool_config("READ_AHEAD_THREAD_NUM", options.read_ahead_thread_num);
+
+  options.page_cleaner_thread_num  = buffer_pool_config("PAGE_CLEANER_THREAD_NUM", options.page_cleaner_thread_num);
+  options.page_cleaner_interval_ms = buffer_pool_config("PAGE_CLEANER_INTERVAL_MS", options.page_cleaner_interval_ms);
+  options.page_cleaner_batch_size  = buffer_pool_config("PAGE_CLEANER_BATCH_SIZE", options.page_cleaner_batch_size);
+  options.dirty_page_ratio         = buffer_pool_config("DIRTY_PAGE_RATIO", options.dirty_page_ratio);
+  options.max_dirty_page_age       = buffer_pool_config("MAX_DIRTY_PAGE_AGE", options.max_dirty_page_age);
+  return options;
+}
+
+/**
+ * @brief 根据配置文件中 [CLOG] 段的配置项，生成日志模块的配置
+ */
+LogHandlerOptions log_handler_options()
+{
+  LogHandlerOptions options;
+  options.group_commit_window_us = section_config("CLOG", "GROUP_COMMIT_WINDOW_US", options.group_commit_window_us);
+  options.group_commit_bytes     = section_config("CLOG", "GROUP_COMMIT_BYTES", options.group_commit_bytes);
+  options.segment_size           = section_config("CLOG", "SEGMENT_SIZE", options.segment_size);
+  options.recycled_segment_num   = section_config("CLOG", "RECYCLED_SEGMENT_NUM", options.recycled_segment_num);
+  return options;
+}
+
+/**
+ * @brief 根据配置文件中 [INDEX] 段的配置项，生成批量构建索引的配置
+ */
+BplusTreeBulkLoadOptions bplus_tree_bulk_load_options()
+{
+  BplusTreeBulkLoadOptions options;
+  options.enable      = section_config("INDEX", "BULK_LOAD", options.enable ? 1 : 0) != 0;
+  options.fill_factor = section_config("INDEX", "BULK_LOAD_FILL_FACTOR", options.fill_factor);
+  options.sort_memory = section_config("INDEX", "BULK_LOAD_SORT_MEMORY", static_cast<int>(options.sort_memory));
+  options.thread_num  = section_config("INDEX", "BULK_LOAD_THREAD_NUM", options.thread_num);
+  return options;
+}
+
+/// 默认的检查点间隔时间
+constexpr int DEFAULT_CHECKPOINT_INTERVAL_MS = 10 * 1000;
+
+}  // namespace
+
 Db::~Db()
 {
+  stop_checkpoint_thread();
+
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -69,8 +165,11 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
   }
 
   trx_kit_.reset(trx_kit);
+  bulk_load_options_ = bplus_tree_bulk_load_options();
+  index_node_format_ = section_config("INDEX", "KEY_COMPRESSION", 0) != 0 ? BplusTreeNodeFormat::COMPRESSED
+                                                                           : BplusTreeNodeFormat::PLAIN;
 
-  buffer_pool_manager_ = make_unique<BufferPoolManager>();
+  buffer_pool_manager_ = make_unique<BufferPoolManager>(buffer_pool_options());
   auto dblwr_buffer    = make_unique<DiskDoubleWriteBuffer>(*buffer_pool_manager_);
 
   const char      *double_write_buffer_filename  = "dblwr.db";
@@ -90,7 +189,7 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
 
   filesystem::path clog_path       = filesystem::path(dbpath) / "clog";
   LogHandler      *tmp_log_handler = nullptr;
-  rc                               = LogHandler::create(log_handler_name, tmp_log_handler);
+  rc                               = LogHandler::create(log_handler_name, tmp_log_handler, log_handler_options());
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to create log handler: %s", log_handler_name);
     return rc;
@@ -102,6 +201,7 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     LOG_WARN("failed to init log handler. dbpath=%s, rc=%s", dbpath, strrc(rc));
     return rc;
   }
+  buffer_pool_manager_->set_log_handler(*log_handler_);
 
   name_ = name;
   path_ = dbpath;
@@ -134,6 +234,13 @@ RC Db::init(const char *name, const char *dbpath, const char *trx_kit_name, cons
     return rc;
   }
 
+  rc = buffer_pool_manager_->start_page_cleaner();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to start page cleaner. dbpath=%s, rc=%s", dbpath, strrc(rc));
+    return rc;
+  }
+
+  start_checkpoint_thread();
   return rc;
 }
 
@@ -158,6 +265,7 @@ RC Db::create_table(const char *table_name, span<const AttrInfoSqlNode> attribut
   }
 
   opened_tables_[table_name] = table;
+  schema_version_++;
   LOG_INFO("Create table success. table name=%s, table_id:%d", table_name, table_id);
   return RC::SUCCESS;
 }
@@ -176,6 +284,7 @@ RC Db::drop_table(const char *table_name)
       LOG_WARN("failed to drop table:%s", table_name);
     } else {
       opened_tables_.erase(table_name);
+      schema_version_++;
       // delete table;
     }
   }
@@ -257,6 +366,8 @@ void Db::all_tables(vector<string> &table_names) const
 
 RC Db::sync()
 {
+  lock_guard<mutex> checkpoint_guard(checkpoint_lock_);
+
   RC rc = RC::SUCCESS;
   // 调用所有表的sync函数刷新数据到磁盘
   for (const auto &table_pair : opened_tables_) {
@@ -284,16 +395,108 @@ RC Db::sync()
     return rc;
   }
 
-  check_point_lsn_ = current_lsn;
-  rc               = flush_meta();
+  rc = save_checkpoint(current_lsn);
   if (OB_FAIL(rc)) {
-    LOG_ERROR("Failed to flush meta. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
     return rc;
   }
   LOG_INFO("Successfully sync db. db=%s", name_.c_str());
   return rc;
 }
 
+RC Db::checkpoint()
+{
+  lock_guard<mutex> checkpoint_guard(checkpoint_lock_);
+
+  // 先获取当前的LSN，再获取最早的脏页。获取LSN之后才变脏的页面，recovery lsn 一定比这个LSN大
+  const LSN current_lsn      = log_handler_->current_lsn();
+  const LSN min_recovery_lsn = buffer_pool_manager_->get_frame_manager().min_recovery_lsn();
+  const LSN lsn              = (min_recovery_lsn > 0) ? min(current_lsn, min_recovery_lsn) : current_lsn;
+  if (lsn <= check_point_lsn_) {
+    return RC::SUCCESS;
+  }
+
+  // 已经刷新的页面写到了 double write buffer 或者数据文件中，但是可能还在操作系统的缓存里
+  ::sync();
+
+  // 重启时从检查点开始回放，检查点这条日志需要已经落盘，回放之后才能得到正确的最大LSN
+  RC rc = log_handler_->wait_lsn(lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to wait lsn. lsn=%ld, rc=%s", lsn, strrc(rc));
+    return rc;
+  }
+
+  rc = save_checkpoint(lsn);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LOG_INFO("checkpoint done. db=%s, check_point_lsn=%ld, current_lsn=%ld, dirty pages=%d",
+           name_.c_str(), lsn, current_lsn, static_cast<int>(buffer_pool_manager_->get_frame_manager().dirty_frame_num()));
+  return RC::SUCCESS;
+}
+
+RC Db::save_checkpoint(LSN lsn)
+{
+  check_point_lsn_ = lsn;
+  RC rc            = flush_meta();
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to flush meta. db=%s, rc=%d:%s", name_.c_str(), rc, strrc(rc));
+    return rc;
+  }
+
+  // 删除日志失败不影响检查点，下次还会再删除
+  rc = log_handler_->truncate(lsn);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to truncate log. db=%s, lsn=%ld, rc=%s", name_.c_str(), lsn, strrc(rc));
+  }
+  return RC::SUCCESS;
+}
+
+void Db::start_checkpoint_thread()
+{
+  const int interval_ms = buffer_pool_config("CHECKPOINT_INTERVAL_MS", DEFAULT_CHECKPOINT_INTERVAL_MS);
+  if (interval_ms <= 0) {
+    LOG_INFO("checkpoint thread is disabled. db=%s", name_.c_str());
+    return;
+  }
+
+  checkpoint_stopped_ = false;
+  checkpoint_thread_  = make_unique<thread>([this, interval_ms]() {
+    thread_set_name("Checkpoint");
+
+    unique_lock<mutex> lock(checkpoint_thread_lock_);
+    while (!checkpoint_stopped_) {
+      checkpoint_cond_.wait_for(lock, chrono::milliseconds(interval_ms), [this]() { return checkpoint_stopped_; });
+      if (checkpoint_stopped_) {
+        break;
+      }
+
+      lock.unlock();
+      RC rc = checkpoint();
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to do checkpoint. db=%s, rc=%s", name_.c_str(), strrc(rc));
+      }
+      lock.lock();
+    }
+  });
+  LOG_INFO("checkpoint thread started. db=%s, interval=%dms", name_.c_str(), interval_ms);
+}
+
+void Db::stop_checkpoint_thread()
+{
+  if (!checkpoint_thread_) {
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock_guard(checkpoint_thread_lock_);
+    checkpoint_stopped_ = true;
+  }
+  checkpoint_cond_.notify_all();
+  checkpoint_thread_->join();
+  checkpoint_thread_.reset();
+}
+
 RC Db::recover()
 {
   LOG_TRACE("db recover begin. check_point_lsn=%d", check_point_lsn_);
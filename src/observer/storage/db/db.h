@@ -20,10 +20,14 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/unordered_map.h"
 #include "common/lang/memory.h"
 #include "common/lang/span.h"
+#include "common/lang/atomic.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/clog/disk_log_handler.h"
 #include "storage/buffer/double_write_buffer.h"
+#include "storage/index/bplus_tree_bulk_load.h"
 
 class Table;
 class LogHandler;
@@ -83,12 +87,26 @@ public:
   /// @brief 列出所有的表
   void all_tables(vector<string> &table_names) const;
 
+  /// @brief 表结构版本号，创建或删除表时递增。缓存的执行计划依赖它判断是否失效
+  int64_t schema_version() const { return schema_version_.load(); }
+
   /**
    * @brief 将所有内存中的数据，刷新到磁盘中。
    * @details 注意，这里也没有并发控制，需要由上层来保证当前没有正在进行的事务。
    */
   RC sync();
 
+  /**
+   * @brief 做一次模糊检查点
+   * @details 与 sync 不同，不需要停止事务，也不会刷新所有的脏页。取当前的LSN与所有脏页中最小的
+   * recovery lsn 中较小的一个作为检查点，这之前的日志对应的修改都已经落盘了，重启时从检查点开始回放，
+   * 检查点之前的日志文件也可以删除了。脏页由后台线程刷新，检查点随之向前推进，参考 BufferPoolManager::clean_dirty_pages。
+   */
+  RC checkpoint();
+
+  /// @brief 当前的检查点LSN
+  LSN check_point_lsn() const { return check_point_lsn_; }
+
   /// @brief 获取当前数据库的日志处理器
   LogHandler &log_handler();
 
@@ -98,6 +116,12 @@ public:
   /// @brief 获取当前数据库的事务管理器
   TrxKit &trx_kit();
 
+  /// @brief 创建索引时批量构建B+树的参数
+  const BplusTreeBulkLoadOptions &bulk_load_options() const { return bulk_load_options_; }
+
+  /// @brief 新建索引使用的B+树节点格式
+  BplusTreeNodeFormat index_node_format() const { return index_node_format_; }
+
 private:
   /// @brief 打开所有的表。在数据库初始化的时候会执行
   RC open_all_tables();
@@ -112,6 +136,14 @@ private:
   /// @brief 初始化数据库的double buffer pool
   RC init_dblwr_buffer();
 
+  /// @brief 启动定期做检查点的线程
+  void start_checkpoint_thread();
+  void stop_checkpoint_thread();
+  void checkpoint_thread_func();
+
+  /// @brief 记录检查点并删除之前的日志，需要持有 checkpoint_lock_
+  RC save_checkpoint(LSN lsn);
+
 private:
   string                         name_;                 ///< 数据库名称
   string                         path_;                 ///< 数据库文件存放的目录
@@ -119,9 +151,19 @@ private:
   unique_ptr<BufferPoolManager>  buffer_pool_manager_;  ///< 当前数据库的buffer pool管理器
   unique_ptr<LogHandler>         log_handler_;          ///< 当前数据库的日志处理器
   unique_ptr<TrxKit>             trx_kit_;              ///< 当前数据库的事务管理器
+  BplusTreeBulkLoadOptions       bulk_load_options_;    ///< 创建索引时批量构建B+树的参数
+  BplusTreeNodeFormat            index_node_format_ = BplusTreeNodeFormat::PLAIN;  ///< 新建索引使用的节点格式
 
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
 
-  LSN check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  LSN   check_point_lsn_ = 0;  ///< 当前数据库的检查点LSN。会记录到磁盘中。
+  mutex checkpoint_lock_;      ///< 检查点与 sync 互斥
+
+  unique_ptr<thread> checkpoint_thread_;  ///< 定期做检查点的线程
+  mutex              checkpoint_thread_lock_;
+  condition_variable checkpoint_cond_;
+  bool               checkpoint_stopped_ = false;
+
+  atomic<int64_t> schema_version_{0};  ///< 表结构版本号，不持久化
 };
@@ -16,11 +16,13 @@ See the Mulan PSL v2 for more details. */
 #include <span>
 
 #include "storage/index/bplus_tree.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/lower_bound.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree_bulk_load.h"
 #include "bplus_tree.h"
 
 using namespace common;
@@ -32,20 +34,68 @@ using namespace common;
  */
 #define FIRST_INDEX_PAGE 1
 
-int calc_internal_page_capacity(int attr_length)
+/// 乐观查找叶子节点时，版本号校验连续失败这么多次之后就改为加锁查找
+static constexpr int MAX_OPTIMISTIC_READ_TIMES = 3;
+
+/// 压缩格式的节点头之后还有编码信息。节点的最大元素个数按照最坏情况计算，即键值没有公共前缀也没有末尾的0
+static int node_header_size(int header_size, BplusTreeNodeFormat node_format)
+{
+  return node_format == BplusTreeNodeFormat::COMPRESSED ? header_size + CompressedNodeHeader::SIZE : header_size;
+}
+
+int calc_internal_page_capacity(int attr_length, BplusTreeNodeFormat node_format)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / item_size;
+  int capacity =
+      ((int)BP_PAGE_DATA_SIZE - node_header_size(InternalIndexNode::HEADER_SIZE, node_format)) / item_size;
   return capacity;
 }
 
-int calc_leaf_page_capacity(int attr_length)
+int calc_leaf_page_capacity(int attr_length, BplusTreeNodeFormat node_format)
 {
   int item_size = attr_length + sizeof(RID) + sizeof(RID);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
+  int capacity  = ((int)BP_PAGE_DATA_SIZE - node_header_size(LeafIndexNode::HEADER_SIZE, node_format)) / item_size;
   return capacity;
 }
 
+/// 键值去掉末尾连续的0之后的长度
+static int valid_key_length(const char *key, int key_length)
+{
+  while (key_length > 0 && key[key_length - 1] == 0) {
+    key_length--;
+  }
+  return key_length;
+}
+
+static int common_prefix_length(const char *key1, const char *key2, int length)
+{
+  int i = 0;
+  while (i < length && key1[i] == key2[i]) {
+    i++;
+  }
+  return i;
+}
+
+/**
+ * @brief 计算左右两个键值之间最短的分隔键
+ * @details 分隔键要严格大于左边的键值，并且不大于右边的键值。依次尝试右边键值的前缀，后面补0，
+ * 第一个满足条件的就是最短的。键值的比较与类型有关，所以每个候选都用比较器检查，最坏情况下就是右边的键值本身。
+ */
+static void make_shortest_separator(
+    const KeyComparator &comparator, int key_length, const char *left_key, const char *right_key, char *separator)
+{
+  memset(separator, 0, key_length);
+  for (int length = 0; length < key_length; length++) {
+    if (length > 0) {
+      separator[length - 1] = right_key[length - 1];
+    }
+    if (comparator(left_key, separator) < 0 && comparator(separator, right_key) <= 0) {
+      return;
+    }
+  }
+  memcpy(separator, right_key, key_length);
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 IndexNodeHandler::IndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame)
     : mtr_(mtr), header_(header), frame_(frame), node_((IndexNode *)frame->data())
@@ -57,6 +107,10 @@ void IndexNodeHandler::init_empty(bool leaf)
   node_->is_leaf = leaf;
   node_->key_num = 0;
   node_->parent  = BP_INVALID_PAGE_NUM;
+  if (compressed()) {
+    compressed_header()->prefix_length = 0;
+    compressed_header()->stored_length = 0;
+  }
 }
 PageNum IndexNodeHandler::page_num() const { return frame_->page_num(); }
 
@@ -110,6 +164,11 @@ bool IndexNodeHandler::is_safe(BplusTreeOperationType op, bool is_root_node)
       return size() < max_size();
     } break;
     case BplusTreeOperationType::DELETE: {
+      // 压缩格式下，子节点重新分配时替换的键值可能放不下，内部节点需要分裂，这时父节点也要加锁。
+      // 元素个数小于 max_size 时，任何键值都放得下
+      if (compressed() && !node_->is_leaf && size() >= max_size()) {
+        return false;
+      }
       if (is_root_node) {  // 参考adjust_root
         if (node_->is_leaf) {
           return size() > 1;  // 根节点如果空的话，就需要删除整棵树
@@ -159,6 +218,40 @@ bool IndexNodeHandler::validate() const
 
 RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
 {
+  if (compressed()) {
+    const int    item_size = key_size() + stored_value_size();
+    vector<char> first_key;
+    KeySummary   summary = this->summary(first_key);
+    for (int i = 0; i < num; i++) {
+      summary.add(items + i * item_size, key_size());
+    }
+
+    const KeyEncoding encoding = summary.encoding();
+    const KeyEncoding current{compressed_header()->prefix_length, compressed_header()->stored_length};
+    if (size() > 0 && encoding == current) {
+      // 新的键值符合当前的编码，只需要移动后面的槽位
+      const int slot_size = encoding.stored_length + stored_value_size();
+      if (index < size()) {
+        memmove(slot_at(index + num), slot_at(index), (static_cast<size_t>(size()) - index) * slot_size);
+      }
+      for (int i = 0; i < num; i++) {
+        encode_item(items + i * item_size, encoding, slot_at(index + i));
+      }
+    } else {
+      vector<char> all_items(static_cast<size_t>(size() + num) * item_size);
+      decode_items(0, index, all_items.data());
+      memcpy(all_items.data() + static_cast<size_t>(index) * item_size, items, static_cast<size_t>(num) * item_size);
+      decode_items(index, size() - index, all_items.data() + static_cast<size_t>(index + num) * item_size);
+      write_items(all_items.data(), size() + num);
+    }
+
+    increase_size(num);
+    ASSERT(encoded_size(encoding, size()) <= capacity(),
+        "compressed node overflow. page=%d, size=%d, prefix=%d, stored=%d",
+        page_num(), size(), encoding.prefix_length, encoding.stored_length);
+    return RC::SUCCESS;
+  }
+
   const int item_size = this->item_size();
   if (index < size()) {
     memmove(__item_at(index + num), __item_at(index), (static_cast<size_t>(size()) - index) * item_size);
@@ -171,6 +264,18 @@ RC IndexNodeHandler::recover_insert_items(int index, const char *items, int num)
 
 RC IndexNodeHandler::recover_remove_items(int index, int num)
 {
+  if (compressed()) {
+    // 删除之后公共前缀可能变长，有效长度可能变短，重新编码
+    const int    item_size = key_size() + stored_value_size();
+    const int    left_num  = size() - num;
+    vector<char> left_items(static_cast<size_t>(left_num) * item_size);
+    decode_items(0, index, left_items.data());
+    decode_items(index + num, size() - index - num, left_items.data() + static_cast<size_t>(index) * item_size);
+    write_items(left_items.data(), left_num);
+    increase_size(-num);
+    return RC::SUCCESS;
+  }
+
   const int item_size = this->item_size();
   if (index < size() - num) {
     memmove(__item_at(index), __item_at(index + num), (static_cast<size_t>(size()) - index - num) * item_size);
@@ -180,6 +285,245 @@ RC IndexNodeHandler::recover_remove_items(int index, int num)
   return RC::SUCCESS;
 }
 
+bool IndexNodeHandler::can_insert(const char *key, int fill_factor /* = 100 */) const
+{
+  if (!compressed()) {
+    return size() < max_size();
+  }
+
+  if (size() + 1 > max(1, compressed_max_size() * fill_factor / 100)) {
+    return false;
+  }
+
+  vector<char> first_key;
+  KeySummary   summary = this->summary(first_key);
+  summary.add(key, key_size());
+  return encoded_size(summary.encoding(), size() + 1) <= capacity() * fill_factor / 100;
+}
+
+bool IndexNodeHandler::can_merge(const IndexNodeHandler &other) const
+{
+  if (!compressed()) {
+    return size() + other.size() <= max_size();
+  }
+
+  if (size() + other.size() > compressed_max_size()) {
+    return false;
+  }
+
+  vector<char> first_key;
+  vector<char> other_first_key;
+  KeySummary   summary = this->summary(first_key);
+  summary.merge(other.summary(other_first_key), key_size());
+  return encoded_size(summary.encoding(), size() + other.size()) <= capacity();
+}
+
+const char *IndexNodeHandler::items_at(int index, int num, vector<char> &buffer) const
+{
+  if (!compressed()) {
+    return __item_at(index);
+  }
+
+  buffer.resize(static_cast<size_t>(num) * (key_size() + stored_value_size()));
+  decode_items(index, num, buffer.data());
+  return buffer.data();
+}
+
+void IndexNodeHandler::KeySummary::add(const char *key, int key_length)
+{
+  if (common_length < 0) {
+    common_length = key_length;
+    first_key     = key;
+  } else {
+    common_length = common_prefix_length(first_key, key, common_length);
+  }
+  valid_length = max(valid_length, valid_key_length(key, key_length));
+}
+
+void IndexNodeHandler::KeySummary::merge(const KeySummary &other, int key_length)
+{
+  if (other.common_length < 0) {
+    return;
+  }
+  if (common_length < 0) {
+    *this = other;
+    return;
+  }
+
+  common_length = min(common_length, other.common_length);
+  common_length = common_prefix_length(first_key, other.first_key, common_length);
+  valid_length  = max(valid_length, other.valid_length);
+}
+
+IndexNodeHandler::KeyEncoding IndexNodeHandler::KeySummary::encoding() const
+{
+  if (common_length < 0) {
+    return KeyEncoding();
+  }
+  const int prefix_length = min(common_length, valid_length);
+  return KeyEncoding{prefix_length, valid_length - prefix_length};
+}
+
+IndexNodeHandler::KeySummary IndexNodeHandler::summary(vector<char> &buffer) const
+{
+  KeySummary summary;
+  if (size() == 0) {
+    return summary;
+  }
+
+  // 编码是规范的：stored_length 为0说明所有的键值都相同，否则公共前缀就是 prefix_length
+  const CompressedNodeHeader *header = compressed_header();
+  buffer.resize(key_size());
+  decode_key(0, buffer.data());
+  summary.common_length = header->stored_length == 0 ? key_size() : header->prefix_length;
+  summary.valid_length  = header->prefix_length + header->stored_length;
+  summary.first_key     = buffer.data();
+  return summary;
+}
+
+int IndexNodeHandler::encoded_size(const KeyEncoding &encoding, int item_num) const
+{
+  return CompressedNodeHeader::SIZE + encoding.prefix_length +
+         item_num * (encoding.stored_length + stored_value_size());
+}
+
+int IndexNodeHandler::capacity() const
+{
+  const int header_size = is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  return static_cast<int>(BP_PAGE_DATA_SIZE) - header_size;
+}
+
+int IndexNodeHandler::used_size() const
+{
+  if (compressed()) {
+    return static_cast<int>(BP_PAGE_DATA_SIZE);
+  }
+
+  const int64_t header_size = node_->is_leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  const int64_t used_size   = header_size + static_cast<int64_t>(node_->key_num) * item_size();
+  return static_cast<int>(std::clamp(used_size, header_size, static_cast<int64_t>(BP_PAGE_DATA_SIZE)));
+}
+
+int IndexNodeHandler::compressed_max_size() const
+{
+  // 分裂之后的两个节点都不超过 max_size - 1 个元素，保证分裂一次之后一定能插入新的元素
+  const int max = max_size();
+  return std::max(max, 2 * max - 2);
+}
+
+CompressedNodeHeader *IndexNodeHandler::compressed_header() const
+{
+  const int header_size = node_->is_leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  return reinterpret_cast<CompressedNodeHeader *>(reinterpret_cast<char *>(node_) + header_size);
+}
+
+char *IndexNodeHandler::slot_at(int index) const
+{
+  const CompressedNodeHeader *header = compressed_header();
+  return prefix() + header->prefix_length + index * (header->stored_length + stored_value_size());
+}
+
+int IndexNodeHandler::stored_value_size() const
+{
+  return node_->is_leaf ? static_cast<int>(sizeof(RID)) : static_cast<int>(sizeof(PageNum));
+}
+
+char *IndexNodeHandler::decode_key(int index) const
+{
+  if (key_buffer_.empty()) {
+    key_buffer_.resize(3 * key_size());
+  }
+  char *key         = key_buffer_.data() + key_buffer_index_ * key_size();
+  key_buffer_index_ = (key_buffer_index_ + 1) % 2;
+  decode_key(index, key);
+  return key;
+}
+
+void IndexNodeHandler::decode_key(int index, char *key) const
+{
+  const CompressedNodeHeader *header = compressed_header();
+  memcpy(key, prefix(), header->prefix_length);
+  memcpy(key + header->prefix_length, slot_at(index), header->stored_length);
+  memset(key + header->prefix_length + header->stored_length,
+      0,
+      key_size() - header->prefix_length - header->stored_length);
+}
+
+void IndexNodeHandler::decode_items(int index, int num, char *items) const
+{
+  const int stored_length = compressed_header()->stored_length;
+  const int item_size     = key_size() + stored_value_size();
+  for (int i = 0; i < num; i++) {
+    char *item = items + static_cast<size_t>(i) * item_size;
+    decode_key(index + i, item);
+    memcpy(item + key_size(), slot_at(index + i) + stored_length, stored_value_size());
+  }
+}
+
+void IndexNodeHandler::encode_item(const char *item, const KeyEncoding &encoding, char *slot) const
+{
+  memcpy(slot, item + encoding.prefix_length, encoding.stored_length);
+  memcpy(slot + encoding.stored_length, item + key_size(), stored_value_size());
+}
+
+void IndexNodeHandler::write_items(const char *items, int num)
+{
+  const int  item_size = key_size() + stored_value_size();
+  KeySummary summary;
+  for (int i = 0; i < num; i++) {
+    summary.add(items + static_cast<size_t>(i) * item_size, key_size());
+  }
+
+  const KeyEncoding encoding = summary.encoding();
+  CompressedNodeHeader *header = compressed_header();
+  header->prefix_length        = static_cast<uint16_t>(encoding.prefix_length);
+  header->stored_length        = static_cast<uint16_t>(encoding.stored_length);
+  if (num > 0) {
+    memcpy(prefix(), items, encoding.prefix_length);
+  }
+  for (int i = 0; i < num; i++) {
+    encode_item(items + static_cast<size_t>(i) * item_size, encoding, slot_at(i));
+  }
+}
+
+int IndexNodeHandler::compressed_lower_bound(
+    const KeyComparator &comparator, const char *key, int first, int last, bool *found) const
+{
+  const CompressedNodeHeader *header = compressed_header();
+  if (key_buffer_.empty()) {
+    key_buffer_.resize(3 * key_size());
+  }
+
+  // 最后一段缓存给查找使用，前缀和末尾的0只需要准备一次
+  char *probe = key_buffer_.data() + 2 * key_size();
+  memcpy(probe, prefix(), header->prefix_length);
+  memset(probe + header->prefix_length, 0, key_size() - header->prefix_length);
+
+  if (found != nullptr) {
+    *found = false;
+  }
+  int count = last - first;
+  while (count > 0) {
+    const int step = count / 2;
+    const int mid  = first + step;
+    memcpy(probe + header->prefix_length, slot_at(mid), header->stored_length);
+    const int result = comparator(probe, key);
+    if (result == 0) {
+      if (found != nullptr) {
+        *found = true;
+      }
+      return mid;
+    }
+    if (result < 0) {
+      first = mid + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
 /////////////////////////////////////////////////////////////////////////////////
 LeafIndexNodeHandler::LeafIndexNodeHandler(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, Frame *frame)
     : IndexNodeHandler(mtr, header, frame), leaf_node_((LeafIndexNode *)frame->data())
@@ -226,6 +570,14 @@ char *LeafIndexNodeHandler::value_at(int index)
 int LeafIndexNodeHandler::lookup_unique(
     const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
+  if (compressed()) {
+    const int index = compressed_lower_bound(comparator, key, 0, size(), found);
+    if (*found && comparator.attr_comparator()(key, __key_at(index)) != 0) {
+      *found = false;
+    }
+    return index;
+  }
+
   const int                    size = this->size();
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
@@ -239,6 +591,10 @@ int LeafIndexNodeHandler::lookup_unique(
 
 int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
 {
+  if (compressed()) {
+    return compressed_lower_bound(comparator, key, 0, size(), found);
+  }
+
   const int                    size = this->size();
   common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
   common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
@@ -266,7 +622,8 @@ RC LeafIndexNodeHandler::remove(int index)
 {
   assert(index >= 0 && index < size());
 
-  RC rc = mtr_.logger().node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char> buffer;
+  RC rc = mtr_.logger().node_remove_items(*this, index, span<const char>(items_at(index, 1, buffer), item_size()), 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s", strrc(rc));
     return rc;
@@ -293,10 +650,12 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
   const int move_index    = size / 2;
   const int move_item_num = size - move_index;
 
-  other.append(__item_at(move_index), move_item_num);
+  vector<char> buffer;
+  const char  *items = items_at(move_index, move_item_num, buffer);
+  other.append(items, move_item_num);
 
   RC rc = mtr_.logger().node_remove_items(
-      *this, move_index, span<const char>(__item_at(move_index), move_item_num * item_size()), move_item_num);
+      *this, move_index, span<const char>(items, move_item_num * item_size()), move_item_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
     return rc;
@@ -307,14 +666,16 @@ RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 }
 RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0));
+  vector<char> buffer;
+  other.append(items_at(0, 1, buffer));
 
   return this->remove(0);
 }
 
 RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
 {
-  other.preappend(__item_at(size() - 1));
+  vector<char> buffer;
+  other.preappend(items_at(size() - 1, 1, buffer));
 
   this->remove(size() - 1);
   return RC::SUCCESS;
@@ -324,15 +685,16 @@ RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
  */
 RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0), this->size());
+  vector<char> buffer;
+  const char  *items = items_at(0, this->size(), buffer);
+  other.append(items, this->size());
   other.set_next_page(this->next_page());
 
-  RC rc = mtr_.logger().node_remove_items(
-      *this, 0, span<const char>(__item_at(0), this->size() * item_size()), this->size());
+  RC rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(items, this->size() * item_size()), this->size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink leaf node. rc=%s", strrc(rc));
   }
-  this->increase_size(-this->size());
+  this->recover_remove_items(0, this->size());
 
   return RC::SUCCESS;
 }
@@ -466,6 +828,14 @@ RC InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char
     LOG_WARN("failed to log create new root. rc=%s", strrc(rc));
   }
 
+  if (compressed()) {
+    vector<char> items(2 * item_size(), 0);
+    memcpy(items.data() + key_size(), &first_page_num, value_size());
+    memcpy(items.data() + item_size(), key, key_size());
+    memcpy(items.data() + item_size() + key_size(), &page_num, value_size());
+    return recover_insert_items(0, items.data(), 2);
+  }
+
   memset(__key_at(0), 0, key_size());
   memcpy(__value_at(0), &first_page_num, value_size());
   memcpy(__item_at(1), key, key_size());
@@ -505,15 +875,17 @@ RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other)
   const int size       = this->size();
   const int move_index = size / 2;
   const int move_num   = size - move_index;
-  RC        rc         = other.append(this->__item_at(move_index), size - move_index);
+
+  vector<char> buffer;
+  const char  *items = items_at(move_index, move_num, buffer);
+  RC           rc    = other.append(items, move_num);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy item to new node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  mtr_.logger().node_remove_items(
-      *this, move_index, span<const char>(__item_at(move_index), move_num * item_size()), move_num);
-  increase_size(-(size - move_index));
+  mtr_.logger().node_remove_items(*this, move_index, span<const char>(items, move_num * item_size()), move_num);
+  recover_remove_items(move_index, move_num);
   return rc;
 }
 
@@ -536,10 +908,15 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  int                          ret  = static_cast<int>(iter - iter_begin) + 1;
+  int ret = 0;
+  if (compressed()) {
+    ret = compressed_lower_bound(comparator, key, 1, size, found);
+  } else {
+    common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
+    common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
+    common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
+    ret                               = static_cast<int>(iter - iter_begin) + 1;
+  }
   if (insert_position) {
     *insert_position = ret;
   }
@@ -562,9 +939,29 @@ void InternalIndexNodeHandler::set_key_at(int index, const char *key)
 
   mtr_.logger().internal_update_key(
       *this, index, span<const char>(key, key_size()), span<const char>(__key_at(index), key_size()));
+  if (compressed()) {
+    vector<char> items(static_cast<size_t>(size()) * item_size());
+    decode_items(0, size(), items.data());
+    memcpy(items.data() + static_cast<size_t>(index) * item_size(), key, key_size());
+    write_items(items.data(), size());
+    return;
+  }
   memcpy(__key_at(index), key, key_size());
 }
 
+bool InternalIndexNodeHandler::can_set_key_at(int index, const char *key) const
+{
+  if (!compressed()) {
+    return true;
+  }
+
+  // 把新的键值加到当前的键值中计算编码，比实际需要的空间大，但不会小
+  vector<char> first_key;
+  KeySummary   summary = this->summary(first_key);
+  summary.add(key, key_size());
+  return encoded_size(summary.encoding(), size()) <= capacity();
+}
+
 PageNum InternalIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
@@ -586,7 +983,8 @@ void InternalIndexNodeHandler::remove(int index)
   assert(index >= 0 && index < size());
 
   BplusTreeLogger &logger = mtr_.logger();
-  RC               rc     = logger.node_remove_items(*this, index, span<const char>(__item_at(index), item_size()), 1);
+  vector<char>     buffer;
+  RC rc = logger.node_remove_items(*this, index, span<const char>(items_at(index, 1, buffer), item_size()), 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log remove item. rc=%s. node=%s", strrc(rc), to_string(*this).c_str());
   }
@@ -596,13 +994,15 @@ void InternalIndexNodeHandler::remove(int index)
 
 RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0), size());
+  vector<char> buffer;
+  const char  *items = items_at(0, size(), buffer);
+  RC           rc    = other.append(items, size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to copy items to other node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(__item_at(0), size() * item_size()), size());
+  rc = mtr_.logger().node_remove_items(*this, 0, span<const char>(items, size() * item_size()), size());
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -613,7 +1013,8 @@ RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0));
+  vector<char> buffer;
+  RC           rc = other.append(items_at(0, 1, buffer));
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to append item to others.");
     return rc;
@@ -625,18 +1026,20 @@ RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 
 RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other)
 {
-  RC rc = other.preappend(__item_at(size() - 1));
+  vector<char> buffer;
+  const char  *item = items_at(size() - 1, 1, buffer);
+  RC           rc   = other.preappend(item);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to preappend to others");
     return rc;
   }
 
-  rc = mtr_.logger().node_remove_items(*this, size() - 1, span<const char>(__item_at(size() - 1), item_size()), 1);
+  rc = mtr_.logger().node_remove_items(*this, size() - 1, span<const char>(item, item_size()), 1);
   if (OB_FAIL(rc)) {
     LOG_WARN("failed to log shrink internal node. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
-  increase_size(-1);
+  recover_remove_items(size() - 1, 1);
   return rc;
 }
 
@@ -800,7 +1203,8 @@ RC BplusTreeHandler::sync()
 }
 
 RC BplusTreeHandler::create(const bool unique, LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
-    const std::vector<const FieldMeta *> &field_metas, int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */)
+    const std::vector<const FieldMeta *> &field_metas, int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */,
+    BplusTreeNodeFormat node_format /* = BplusTreeNodeFormat::PLAIN */)
 {
   RC rc = bpm.create_file(file_name);
   if (OB_FAIL(rc)) {
@@ -818,7 +1222,7 @@ RC BplusTreeHandler::create(const bool unique, LogHandler &log_handler, BufferPo
   }
   LOG_INFO("Successfully open index file %s.", file_name);
 
-  rc = this->create(unique, log_handler, *bp, field_metas, internal_max_size, leaf_max_size);
+  rc = this->create(unique, log_handler, *bp, field_metas, internal_max_size, leaf_max_size, node_format);
   if (OB_FAIL(rc)) {
     bpm.close_file(file_name);
     return rc;
@@ -829,7 +1233,8 @@ RC BplusTreeHandler::create(const bool unique, LogHandler &log_handler, BufferPo
 }
 
 RC BplusTreeHandler::create(const bool unique, LogHandler &log_handler, DiskBufferPool &buffer_pool,
-    const std::vector<const FieldMeta *> &field_metas, int internal_max_size /* = -1 */, int leaf_max_size /* = -1 */)
+    const std::vector<const FieldMeta *> &field_metas, int internal_max_size /* = -1 */, int leaf_max_size /* = -1 */,
+    BplusTreeNodeFormat node_format /* = BplusTreeNodeFormat::PLAIN */)
 {
   unique_         = unique;
   int attr_length = 0;
@@ -837,10 +1242,15 @@ RC BplusTreeHandler::create(const bool unique, LogHandler &log_handler, DiskBuff
     attr_length += field_meta->len();
   }
   if (internal_max_size < 0) {
-    internal_max_size = calc_internal_page_capacity(attr_length);
+    internal_max_size = calc_internal_page_capacity(attr_length, node_format);
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(attr_length);
+    leaf_max_size = calc_leaf_page_capacity(attr_length, node_format);
+  }
+  if (node_format == BplusTreeNodeFormat::COMPRESSED) {
+    // 压缩格式按照 max_size 判断节点在最坏情况下是否放得下，不能超过页面的实际容量
+    internal_max_size = min(internal_max_size, calc_internal_page_capacity(attr_length, node_format));
+    leaf_max_size     = min(leaf_max_size, calc_leaf_page_capacity(attr_length, node_format));
   }
 
   log_handler_      = &log_handler;
@@ -872,6 +1282,7 @@ RC BplusTreeHandler::create(const bool unique, LogHandler &log_handler, DiskBuff
   file_header->root_page         = BP_INVALID_PAGE_NUM;
   file_header->attr_num          = field_metas.size();
   file_header->unique            = unique;
+  file_header->node_format       = node_format;
   for (size_t i = 0; i < field_metas.size(); i++) {
     file_header->attr_type[i]   = field_metas[i]->type();
     file_header->attr_offset[i] = field_metas[i]->offset();
@@ -1210,6 +1621,16 @@ RC BplusTreeHandler::left_most_page(BplusTreeMiniTransaction &mtr, Frame *&frame
 RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
     const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame)
 {
+  if (op == BplusTreeOperationType::READ && optimistic_read_) {
+    for (int i = 0; i < MAX_OPTIMISTIC_READ_TIMES; i++) {
+      RC rc = optimistic_find_leaf(mtr, child_page_getter, frame);
+      if (rc != RC::LOCKED_CONCURRENCY_CONFLICT) {
+        return rc;
+      }
+    }
+    // 有写线程一直在修改这条路径上的页面，改为加锁查找
+  }
+
   LatchMemo &latch_memo = mtr.latch_memo();
   // root locked
   if (op != BplusTreeOperationType::READ) {
@@ -1244,6 +1665,80 @@ RC BplusTreeHandler::find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTree
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::optimistic_find_leaf(BplusTreeMiniTransaction &mtr,
+    const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+  const int  memo_point = latch_memo.memo_point();
+
+  const PageNum root_page_num = load_root_page_num();
+  if (root_page_num == BP_INVALID_PAGE_NUM) {
+    return RC::EMPTY;
+  }
+
+  RC rc = latch_memo.get_page(root_page_num, frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch root page. page id=%d, rc=%d:%s", root_page_num, rc, strrc(rc));
+    latch_memo.release_from(memo_point);
+    return rc;
+  }
+
+  // 拿到版本号之后根节点仍然没有换掉，才能从这个页面开始查找
+  uint64_t version = frame->read_version();
+  if (Frame::version_locked(version) || load_root_page_num() != root_page_num) {
+    latch_memo.release_from(memo_point);
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  // 每个线程一个快照页面，避免每次都分配
+  static thread_local Frame snapshot;
+
+  while (!reinterpret_cast<IndexNode *>(frame->data())->is_leaf) {
+    InternalIndexNodeHandler node(mtr, file_header_, frame);
+    memcpy(snapshot.data(), frame->data(), node.used_size());
+    if (!frame->validate_version(version)) {
+      latch_memo.release_from(memo_point);
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+
+    InternalIndexNodeHandler snapshot_node(mtr, file_header_, &snapshot);
+    const PageNum            child_page_num = child_page_getter(snapshot_node);
+
+    Frame *child_frame = nullptr;
+    rc                 = latch_memo.get_page(child_page_num, child_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to load page. page num=%d, rc=%s", child_page_num, strrc(rc));
+      latch_memo.release_from(memo_point);
+      return rc;
+    }
+
+    const uint64_t child_version = child_frame->read_version();
+    if (Frame::version_locked(child_version) || !frame->validate_version(version)) {
+      latch_memo.release_from(memo_point);
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+
+    frame   = child_frame;
+    version = child_version;
+  }
+
+  // 叶子节点加上读锁之后就不会再变化，版本号没变说明它就是从父节点找到它时的样子
+  latch_memo.slatch(frame);
+  if (!frame->validate_version(version)) {
+    latch_memo.release_from(memo_point);
+    return RC::LOCKED_CONCURRENCY_CONFLICT;
+  }
+
+  // 只保留叶子节点的 pin 和读锁
+  latch_memo.release_to(latch_memo.memo_point() - 2);
+  return RC::SUCCESS;
+}
+
+PageNum BplusTreeHandler::load_root_page_num() const
+{
+  return atomic_ref<PageNum>(const_cast<PageNum &>(file_header_.root_page)).load(memory_order_acquire);
+}
+
 RC BplusTreeHandler::crabing_protocal_fetch_page(
     BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, PageNum page_num, bool is_root_node, Frame *&frame)
 {
@@ -1284,7 +1779,7 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(
     return RC::RECORD_DUPLICATE_KEY;
   }
 
-  if (leaf_node.size() < leaf_node.max_size()) {
+  if (leaf_node.can_insert(key)) {
     leaf_node.insert(insert_position, key, (const char *)rid);
     frame->mark_dirty();
     // disk_buffer_pool_->unpin_page(frame); // unpin pages 由latch memo 来操作
@@ -1309,7 +1804,18 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(
     new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
   }
 
-  return insert_entry_into_parent(mtr, frame, new_frame, new_index_node.key_at(0));
+  if (!file_header_.compressed()) {
+    return insert_entry_into_parent(mtr, frame, new_frame, new_index_node.key_at(0));
+  }
+
+  // 压缩格式下，父节点中只需要一个能区分左右两个节点的最短键值
+  vector<char> separator(file_header_.key_length);
+  make_shortest_separator(key_comparator_,
+      file_header_.key_length,
+      leaf_node.key_at(leaf_node.size() - 1),
+      new_index_node.key_at(0),
+      separator.data());
+  return insert_entry_into_parent(mtr, frame, new_frame, separator.data());
 }
 
 RC BplusTreeHandler::insert_entry_into_parent(
@@ -1365,7 +1871,7 @@ RC BplusTreeHandler::insert_entry_into_parent(
     InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
 
     /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
-    if (parent_node.size() < parent_node.max_size()) {
+    if (parent_node.can_insert(key)) {
       parent_node.insert(key, new_frame->page_num(), key_comparator_);
       new_node_handler.set_parent_page_num(parent_page_num);
 
@@ -1468,8 +1974,9 @@ void BplusTreeHandler::update_root_page_num_locked(BplusTreeMiniTransaction &mtr
   IndexFileHeader *file_header = reinterpret_cast<IndexFileHeader *>(frame->data());
   mtr.logger().update_root_page(frame, root_page_num, file_header->root_page);
   file_header->root_page = root_page_num;
-  file_header_.root_page = root_page_num;
-  header_dirty_          = true;
+  // 乐观读的线程不加 root_lock_ 读取根节点页号，参考 load_root_page_num
+  atomic_ref<PageNum>(file_header_.root_page).store(root_page_num, memory_order_release);
+  header_dirty_ = true;
   frame->mark_dirty();
   LOG_DEBUG("set root page to %d", root_page_num);
 }
@@ -1509,14 +2016,18 @@ MemPoolItem::item_unique_ptr BplusTreeHandler::make_key(const char *user_key, co
     return nullptr;
   }
 
+  make_key(user_key, rid, static_cast<char *>(key.get()));
+  return key;
+}
+
+void BplusTreeHandler::make_key(const char *user_key, const RID &rid, char *key) const
+{
   int offset = 0;
   for (int i = 0; i < file_header_.attr_num; i++) {
-    memcpy(
-        static_cast<char *>(key.get()) + offset, user_key + file_header_.attr_offset[i], file_header_.attr_length[i]);
+    memcpy(key + offset, user_key + file_header_.attr_offset[i], file_header_.attr_length[i]);
     offset += file_header_.attr_length[i];
   }
-  memcpy(static_cast<char *>(key.get()) + offset, &rid, sizeof(rid));
-  return key;
+  memcpy(key + offset, &rid, sizeof(rid));
 }
 
 RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
@@ -1566,40 +2077,653 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
   return RC::SUCCESS;
 }
 
-RC BplusTreeHandler::get_entry(const char *user_key, int key_len, list<RID> &rids)
-{
-  BplusTreeScanner scanner(*this);
-  RC rc = scanner.open(user_key, key_len, true /*left_inclusive*/, user_key, key_len, true /*right_inclusive*/);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to open scanner. rc=%s", strrc(rc));
-    return rc;
+/**
+ * @brief 自底向上批量构建B+树
+ * @ingroup BPlusTree
+ * @details 键值已经排好序。先按照填充率算出每一层的节点个数，同一层的元素平均分配到各个节点中，
+ * 这样每个节点包含哪些元素、父节点是谁都是确定的。内部节点的页面预先分配好，写叶子节点时就能填上父节点，
+ * 每一层只需要一个正在写的页面，写满就释放，每个页面只写一次。
+ * 压缩格式的叶子节点能放多少个键值取决于键值本身，叶子节点按照页面空间写满，同时记下每个叶子节点的最短分隔键，
+ * 所有叶子写完之后再按照叶子的个数分配内部节点，回填叶子节点的父节点。
+ * 构建过程中不记录日志，参考 BplusTreeHandler::bulk_load。
+ */
+class BplusTreeBulkBuilder
+{
+public:
+  BplusTreeBulkBuilder(BplusTreeMiniTransaction &mtr, const IndexFileHeader &header, const KeyComparator &comparator,
+      DiskBufferPool &buffer_pool)
+      : mtr_(mtr), header_(header), comparator_(comparator), buffer_pool_(buffer_pool)
+  {}
+
+  ~BplusTreeBulkBuilder()
+  {
+    for (Level &level : levels_) {
+      if (level.frame != nullptr) {
+        buffer_pool_.unpin_page(level.frame);
+      }
+    }
+    if (next_leaf_frame_ != nullptr) {
+      buffer_pool_.unpin_page(next_leaf_frame_);
+    }
   }
 
-  RID rid;
-  while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
-    rids.push_back(rid);
-  }
+  /**
+   * @brief 计算每一层的节点个数并分配内部节点的页面
+   * @param key_num 键值的总数
+   * @param fill_factor 节点的填充率(百分比)
+   */
+  RC init(int64_t key_num, int fill_factor)
+  {
+    fill_factor_ = clamp(fill_factor, 50, 100);
+
+    // 第0层是叶子节点，最上面一层只有一个节点，就是根节点
+    levels_.emplace_back();
+    levels_.back().item_num = key_num;
+    if (header_.compressed()) {
+      return RC::SUCCESS;
+    }
 
-  scanner.close();
-  if (rc != RC::RECORD_EOF) {
-    LOG_WARN("scanner return error. rc=%s", strrc(rc));
-  } else {
-    rc = RC::SUCCESS;
+    const int64_t leaf_fill = max(1, header_.leaf_max_size * fill_factor_ / 100);
+    levels_.back().node_num = (key_num + leaf_fill - 1) / leaf_fill;
+    return init_internal_levels();
   }
-  return rc;
-}
 
-RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame)
-{
-  LatchMemo &latch_memo = mtr.latch_memo();
+  /// @brief 按顺序追加一个键值到叶子节点
+  RC add(const char *key)
+  {
+    if (header_.compressed()) {
+      return add_compressed(key);
+    }
 
-  IndexNodeHandler root_node(mtr, file_header_, root_frame);
-  if (root_node.is_leaf() && root_node.size() > 0) {
-    root_frame->mark_dirty();
+    Level &leaf_level = levels_[0];
+    RC     rc         = RC::SUCCESS;
+    if (leaf_level.frame == nullptr) {
+      rc = buffer_pool_.allocate_page(&leaf_level.frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to allocate leaf page. rc=%s", strrc(rc));
+        return rc;
+      }
+      first_leaf_page_ = leaf_level.frame->page_num();
+      init_node(0, leaf_level.frame);
+    }
+
+    LeafIndexNodeHandler leaf_node(mtr_, header_, leaf_level.frame);
+    append_key(leaf_node, key);
+    leaf_level.filled++;
+    if (leaf_level.filled < node_item_num(0, leaf_level.node_index)) {
+      return RC::SUCCESS;
+    }
+
+    // 叶子节点写满了，先分配下一个叶子节点，才能设置兄弟节点的页面编号
+    LeafIndexNode *leaf = reinterpret_cast<LeafIndexNode *>(leaf_level.frame->data());
+    if (leaf_level.node_index + 1 < leaf_level.node_num) {
+      rc = buffer_pool_.allocate_page(&next_leaf_frame_);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to allocate leaf page. rc=%s", strrc(rc));
+        return rc;
+      }
+      leaf->next_brother = next_leaf_frame_->page_num();
+    }
+
+    rc = finish_node(0);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (next_leaf_frame_ != nullptr) {
+      leaf_level.frame = next_leaf_frame_;
+      next_leaf_frame_ = nullptr;
+      init_node(0, leaf_level.frame);
+    }
     return RC::SUCCESS;
   }
 
-  PageNum new_root_page_num = BP_INVALID_PAGE_NUM;
+  /// @brief 所有的键值都已经写入，返回根节点
+  RC finish(PageNum &root_page)
+  {
+    if (header_.compressed()) {
+      RC rc = finish_compressed_leaves();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    for (const Level &level : levels_) {
+      if (level.node_index != level.node_num || level.frame != nullptr) {
+        LOG_WARN("bulk load is not finished. node index=%ld, node num=%ld", level.node_index, level.node_num);
+        return RC::INTERNAL;
+      }
+    }
+
+    root_page = levels_.size() == 1 ? first_leaf_page_ : levels_.back().pages[0];
+    return RC::SUCCESS;
+  }
+
+private:
+  /**
+   * @brief 按照叶子节点的个数计算上面每一层的节点个数，并分配内部节点的页面
+   */
+  RC init_internal_levels()
+  {
+    const int64_t internal_fill =
+        min(header_.internal_max_size, max(3, header_.internal_max_size * fill_factor_ / 100));
+    while (levels_.back().node_num > 1) {
+      const int64_t child_num = levels_.back().node_num;
+      levels_.emplace_back();
+      levels_.back().item_num = child_num;
+      levels_.back().node_num = (child_num + internal_fill - 1) / internal_fill;
+    }
+
+    // 从根节点开始分配内部节点的页面
+    for (size_t level = levels_.size() - 1; level > 0; level--) {
+      vector<PageNum> &pages = levels_[level].pages;
+      pages.reserve(levels_[level].node_num);
+      for (int64_t i = 0; i < levels_[level].node_num; i++) {
+        Frame *frame = nullptr;
+        RC     rc    = buffer_pool_.allocate_page(&frame);
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to allocate internal page. rc=%s", strrc(rc));
+          return rc;
+        }
+        pages.push_back(frame->page_num());
+        buffer_pool_.unpin_page(frame);
+      }
+    }
+
+    LOG_INFO("begin to bulk load b+tree. keys=%ld, leaves=%ld, height=%d",
+             levels_[0].item_num, levels_[0].node_num, static_cast<int>(levels_.size()));
+    return RC::SUCCESS;
+  }
+
+  void append_key(LeafIndexNodeHandler &leaf_node, const char *key)
+  {
+    vector<char> item(leaf_node.item_size());
+    memcpy(item.data(), key, header_.key_length);
+    memcpy(item.data() + header_.key_length, key + header_.key_length - sizeof(RID), sizeof(RID));
+    leaf_node.recover_insert_items(leaf_node.size(), item.data(), 1);
+  }
+
+  /**
+   * @brief 压缩格式下追加一个键值，当前叶子节点按照填充率放不下时换一个新的叶子节点
+   * @details 新叶子节点的分隔键是上一个叶子节点的最后一个键值与它的第一个键值之间最短的键值
+   */
+  RC add_compressed(const char *key)
+  {
+    Level &leaf_level = levels_[0];
+    RC     rc         = RC::SUCCESS;
+    Frame *last_frame = leaf_level.frame;
+    if (last_frame != nullptr && LeafIndexNodeHandler(mtr_, header_, last_frame).can_insert(key, fill_factor_)) {
+      LeafIndexNodeHandler leaf_node(mtr_, header_, last_frame);
+      append_key(leaf_node, key);
+      last_key_.assign(key, key + header_.key_length);
+      return RC::SUCCESS;
+    }
+
+    rc = buffer_pool_.allocate_page(&leaf_level.frame);
+    if (OB_FAIL(rc)) {
+      leaf_level.frame = last_frame;
+      LOG_WARN("failed to allocate leaf page. rc=%s", strrc(rc));
+      return rc;
+    }
+    init_node(0, leaf_level.frame);
+
+    const size_t separator_offset = separators_.size();
+    separators_.resize(separator_offset + header_.key_length);
+    if (last_frame == nullptr) {
+      first_leaf_page_ = leaf_level.frame->page_num();
+      memcpy(separators_.data() + separator_offset, key, header_.key_length);
+    } else {
+      reinterpret_cast<LeafIndexNode *>(last_frame->data())->next_brother = leaf_level.frame->page_num();
+      last_frame->mark_dirty();
+      buffer_pool_.unpin_page(last_frame);
+      make_shortest_separator(
+          comparator_, header_.key_length, last_key_.data(), key, separators_.data() + separator_offset);
+    }
+    leaf_pages_.push_back(leaf_level.frame->page_num());
+
+    LeafIndexNodeHandler leaf_node(mtr_, header_, leaf_level.frame);
+    append_key(leaf_node, key);
+    last_key_.assign(key, key + header_.key_length);
+    return RC::SUCCESS;
+  }
+
+  /**
+   * @brief 压缩格式的叶子节点都写完了，分配内部节点，回填叶子节点的父节点并把叶子加到父节点中
+   */
+  RC finish_compressed_leaves()
+  {
+    Level &leaf_level = levels_[0];
+    if (leaf_level.frame != nullptr) {
+      leaf_level.frame->mark_dirty();
+      buffer_pool_.unpin_page(leaf_level.frame);
+      leaf_level.frame = nullptr;
+    }
+
+    leaf_level.node_num = static_cast<int64_t>(leaf_pages_.size());
+    RC rc               = init_internal_levels();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    // 分配内部节点时 levels_ 可能重新分配了内存
+    for (size_t i = 0; i < leaf_pages_.size(); i++) {
+      if (levels_.size() > 1) {
+        Frame *frame = nullptr;
+        rc           = buffer_pool_.get_this_page(leaf_pages_[i], &frame);
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to get leaf page. page num=%d, rc=%s", leaf_pages_[i], strrc(rc));
+          return rc;
+        }
+        reinterpret_cast<IndexNode *>(frame->data())->parent = parent_page(0, levels_[0].node_index);
+        frame->mark_dirty();
+        buffer_pool_.unpin_page(frame);
+
+        rc = append_child(1, separators_.data() + i * header_.key_length, leaf_pages_[i]);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+      }
+      levels_[0].node_index++;
+    }
+    return RC::SUCCESS;
+  }
+
+  /**
+   * @brief 某一层正在写的节点
+   */
+  struct Level
+  {
+    int64_t         node_num   = 0;        ///< 这一层的节点个数
+    int64_t         item_num   = 0;        ///< 这一层的元素个数，内部节点的元素个数就是下一层的节点个数
+    vector<PageNum> pages;                 ///< 内部节点预先分配的页面
+    int64_t         node_index = 0;        ///< 正在写的节点
+    int64_t         filled     = 0;        ///< 正在写的节点已经有多少个元素
+    Frame          *frame      = nullptr;  ///< 正在写的节点的页帧
+  };
+
+  /// @brief 元素平均分配到各个节点时，某个节点的元素个数
+  int64_t node_item_num(size_t level, int64_t node_index) const
+  {
+    const Level &l = levels_[level];
+    return l.item_num * (node_index + 1) / l.node_num - l.item_num * node_index / l.node_num;
+  }
+
+  /// @brief 父节点的页面编号。与 node_item_num 的分配方式对应
+  PageNum parent_page(size_t level, int64_t node_index) const
+  {
+    if (level + 1 >= levels_.size()) {
+      return BP_INVALID_PAGE_NUM;
+    }
+    const Level  &parent       = levels_[level + 1];
+    const int64_t parent_index = (parent.node_num * (node_index + 1) - 1) / parent.item_num;
+    return parent.pages[parent_index];
+  }
+
+  void init_node(size_t level, Frame *frame)
+  {
+    IndexNodeHandler node(mtr_, header_, frame);
+    node.init_empty(level == 0);
+    if (level == 0) {
+      reinterpret_cast<LeafIndexNode *>(frame->data())->next_brother = BP_INVALID_PAGE_NUM;
+    }
+    reinterpret_cast<IndexNode *>(frame->data())->parent = parent_page(level, levels_[level].node_index);
+  }
+
+  /// @brief 当前节点写满了，把它的第一个键值和页面编号加到父节点中
+  RC finish_node(size_t level)
+  {
+    Level &l     = levels_[level];
+    Frame *frame = l.frame;
+    frame->mark_dirty();
+
+    RC rc = RC::SUCCESS;
+    if (level + 1 < levels_.size()) {
+      // 内部节点的第一个键值没有用到，这里也存放子树中最小的键值，方便上层节点使用。
+      // 压缩格式的键值解码在节点操作对象中，所以两个对象都要在这里定义
+      LeafIndexNodeHandler     leaf_node(mtr_, header_, frame);
+      InternalIndexNodeHandler internal_node(mtr_, header_, frame);
+      const char              *first_key = level == 0 ? leaf_node.key_at(0) : internal_node.key_at(0);
+      rc                                 = append_child(level + 1, first_key, frame->page_num());
+    }
+
+    buffer_pool_.unpin_page(frame);
+    l.frame  = nullptr;
+    l.filled = 0;
+    l.node_index++;
+    return rc;
+  }
+
+  RC append_child(size_t level, const char *key, PageNum page_num)
+  {
+    Level &l = levels_[level];
+    if (l.frame == nullptr) {
+      RC rc = buffer_pool_.get_this_page(l.pages[l.node_index], &l.frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get internal page. page num=%d, rc=%s", l.pages[l.node_index], strrc(rc));
+        return rc;
+      }
+      init_node(level, l.frame);
+    }
+
+    InternalIndexNodeHandler node(mtr_, header_, l.frame);
+    vector<char>             item(header_.key_length + sizeof(PageNum));
+    memcpy(item.data(), key, header_.key_length);
+    memcpy(item.data() + header_.key_length, &page_num, sizeof(PageNum));
+    node.recover_insert_items(node.size(), item.data(), 1);
+    l.filled++;
+    if (l.filled < node_item_num(level, l.node_index)) {
+      return RC::SUCCESS;
+    }
+    return finish_node(level);
+  }
+
+private:
+  BplusTreeMiniTransaction &mtr_;
+  const IndexFileHeader    &header_;
+  const KeyComparator      &comparator_;
+  DiskBufferPool           &buffer_pool_;
+
+  int           fill_factor_ = 100;
+  vector<Level> levels_;
+  Frame        *next_leaf_frame_ = nullptr;
+  PageNum       first_leaf_page_ = BP_INVALID_PAGE_NUM;
+
+  /// 压缩格式下已经写完的叶子节点、它们的分隔键，以及最后一个写入的键值
+  vector<PageNum> leaf_pages_;
+  vector<char>    separators_;
+  vector<char>    last_key_;
+};
+
+RC BplusTreeHandler::bulk_load(BplusTreeKeyReader &reader, int fill_factor)
+{
+  if (!is_empty()) {
+    LOG_WARN("cannot bulk load a non-empty tree. root page=%d", file_header_.root_page);
+    return RC::INTERNAL;
+  }
+
+  if (reader.key_count() == 0) {
+    return RC::SUCCESS;
+  }
+
+  RC                       rc = RC::SUCCESS;
+  BplusTreeMiniTransaction mtr(*this);
+  PageNum                  root_page = BP_INVALID_PAGE_NUM;
+  {
+    BplusTreeBulkBuilder builder(mtr, file_header_, key_comparator_, *disk_buffer_pool_);
+    rc = builder.init(reader.key_count(), fill_factor);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    vector<char> last_key;
+    const char  *key = nullptr;
+    while (OB_SUCC(rc = reader.next(key))) {
+      if (unique_ && !last_key.empty() && key_comparator_.attr_comparator()(last_key.data(), key) == 0) {
+        LOG_WARN("duplicate key while bulk loading unique index. key=%s", key_printer_(key).c_str());
+        return RC::RECORD_DUPLICATE_KEY;
+      }
+      if (unique_) {
+        last_key.assign(key, key + file_header_.key_length);
+      }
+
+      rc = builder.add(key);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    if (rc != RC::RECORD_EOF) {
+      LOG_WARN("failed to read sorted keys. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    rc = builder.finish(root_page);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  // 先把所有页面刷到磁盘，再记录唯一的一条日志更新根节点。
+  // 重启时如果没有这条日志，根节点仍然是空的，已经写入的页面不会被访问到
+  rc = disk_buffer_pool_->flush_all_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush pages after bulk load. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  update_root_page_num_locked(mtr, root_page);
+  rc = mtr.commit();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to log the new root page after bulk load. rc=%s", strrc(rc));
+    return rc;
+  }
+  mtr.latch_memo().release();
+
+  // 刷新头页面时会等待日志落盘
+  rc = sync();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sync index after bulk load. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("bulk load b+tree done. keys=%ld, root page=%d", reader.key_count(), root_page);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::get_entry(const char *user_key, int key_len, list<RID> &rids)
+{
+  BplusTreeScanner scanner(*this);
+  RC rc = scanner.open(user_key, key_len, true /*left_inclusive*/, user_key, key_len, true /*right_inclusive*/);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open scanner. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  RID rid;
+  while ((rc = scanner.next_entry(rid)) == RC::SUCCESS) {
+    rids.push_back(rid);
+  }
+
+  scanner.close();
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("scanner return error. rc=%s", strrc(rc));
+  } else {
+    rc = RC::SUCCESS;
+  }
+  return rc;
+}
+
+RC BplusTreeHandler::get_entries(const vector<const char *> &user_keys, vector<RID> &rids, vector<int> *offsets)
+{
+  const int key_num    = static_cast<int>(user_keys.size());
+  const int key_length = file_header_.key_length;
+
+  const AttrComparator &attr_comparator = key_comparator_.attr_comparator();
+
+  // 先把所有的键值转换成B+树中的格式，RID取最小值，这样 lookup 返回的就是第一个匹配的位置
+  vector<char> keys(static_cast<size_t>(key_num) * key_length);
+  for (int i = 0; i < key_num; i++) {
+    char *key = keys.data() + static_cast<size_t>(i) * key_length;
+    make_key(user_keys[i], *RID::min(), key);
+    if (i > 0 && attr_comparator(key - key_length, key) > 0) {
+      LOG_WARN("keys are not sorted. index=%d", i);
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  if (offsets != nullptr) {
+    offsets->clear();
+    offsets->reserve(key_num + 1);
+  }
+
+  RC rc = RC::SUCCESS;
+
+  BplusTreeMiniTransaction mtr(*this, &rc);
+  LatchMemo               &latch_memo = mtr.latch_memo();
+
+  Frame       *frame      = nullptr;
+  int          index      = 0;
+  int          prev_first = 0;
+  vector<char> last_key(key_length);  // 最后一个找到的键值，换页失败时用来重新定位
+  for (int i = 0; i < key_num; i++) {
+    const int first = static_cast<int>(rids.size());
+    if (offsets != nullptr) {
+      offsets->push_back(first);
+    }
+
+    const char *key = keys.data() + static_cast<size_t>(i) * key_length;
+    if (i > 0 && attr_comparator(key - key_length, key) == 0) {
+      // 与上一个键值相同，直接复制上一个键值的结果
+      for (int j = prev_first; j < first; j++) {
+        rids.push_back(rids[j]);
+      }
+      prev_first = first;
+      continue;
+    }
+    prev_first = first;
+
+    rc = seek_leaf_for_batch(mtr, key, frame, index);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to seek leaf. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (nullptr == frame) {
+      continue;
+    }
+
+    while (true) {
+      LeafIndexNodeHandler node(mtr, file_header_, frame);
+      if (index < node.size()) {
+        const char *this_key = node.key_at(index);
+        if (attr_comparator(this_key, key) != 0) {
+          break;
+        }
+
+        memcpy(last_key.data(), this_key, key_length);
+        rids.push_back(*reinterpret_cast<const RID *>(node.value_at(index)));
+        index++;
+        continue;
+      }
+
+      const PageNum next_page_num = node.next_page();
+      if (BP_INVALID_PAGE_NUM == next_page_num) {
+        break;
+      }
+
+      // 与 BplusTreeScanner 一样，向右加锁的顺序与修改操作相反，只能尝试加锁
+      const int memo_point = latch_memo.memo_point();
+      rc                   = latch_memo.get_page(next_page_num, frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+        return rc;
+      }
+
+      if (latch_memo.try_slatch(frame)) {
+        latch_memo.release_to(memo_point);
+        index = 0;
+        continue;
+      }
+
+      // 加锁失败就放掉所有的锁，从根节点查找最后一个找到的键值，从它的下一个位置继续
+      latch_memo.release();
+      if (static_cast<int>(rids.size()) == first) {
+        rc = find_leaf(mtr, BplusTreeOperationType::READ, key, frame);
+      } else {
+        rc = find_leaf(mtr, BplusTreeOperationType::READ, last_key.data(), frame);
+      }
+      if (OB_FAIL(rc)) {
+        frame = nullptr;
+        if (rc == RC::EMPTY) {
+          rc = RC::SUCCESS;
+          break;
+        }
+        LOG_WARN("failed to find leaf. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      LeafIndexNodeHandler new_node(mtr, file_header_, frame);
+      bool                 found = false;
+      if (static_cast<int>(rids.size()) == first) {
+        index = new_node.lookup(key_comparator_, key);
+      } else {
+        index = new_node.lookup(key_comparator_, last_key.data(), &found);
+        if (found) {
+          index++;
+        }
+      }
+    }
+  }
+
+  if (offsets != nullptr) {
+    offsets->push_back(static_cast<int>(rids.size()));
+  }
+  return rc;
+}
+
+RC BplusTreeHandler::seek_leaf_for_batch(BplusTreeMiniTransaction &mtr, const char *key, Frame *&frame, int &index)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  if (frame != nullptr) {
+    LeafIndexNodeHandler node(mtr, file_header_, frame);
+    if (node.size() > 0 && key_comparator_(key, node.key_at(node.size() - 1)) <= 0) {
+      index = node.lookup(key_comparator_, key);
+      return RC::SUCCESS;
+    }
+
+    // 键值比当前叶子节点中所有的键值都大，先看看下一个叶子节点
+    const PageNum next_page_num = node.next_page();
+    if (next_page_num != BP_INVALID_PAGE_NUM) {
+      const int memo_point = latch_memo.memo_point();
+      Frame    *next_frame = nullptr;
+      RC        rc         = latch_memo.get_page(next_page_num, next_frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+        return rc;
+      }
+
+      if (latch_memo.try_slatch(next_frame)) {
+        latch_memo.release_to(memo_point);
+        frame = next_frame;
+
+        LeafIndexNodeHandler next_node(mtr, file_header_, frame);
+        if (next_node.size() > 0 && key_comparator_(key, next_node.key_at(next_node.size() - 1)) <= 0) {
+          index = next_node.lookup(key_comparator_, key);
+          return RC::SUCCESS;
+        }
+      }
+    }
+
+    latch_memo.release();
+    frame = nullptr;
+  }
+
+  RC rc = find_leaf(mtr, BplusTreeOperationType::READ, key, frame);
+  if (OB_FAIL(rc)) {
+    frame = nullptr;
+    if (rc == RC::EMPTY) {
+      return RC::SUCCESS;
+    }
+    LOG_WARN("failed to find leaf. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LeafIndexNodeHandler node(mtr, file_header_, frame);
+  index = node.lookup(key_comparator_, key);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::adjust_root(BplusTreeMiniTransaction &mtr, Frame *root_frame)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  IndexNodeHandler root_node(mtr, file_header_, root_frame);
+  if (root_node.is_leaf() && root_node.size() > 0) {
+    root_frame->mark_dirty();
+    return RC::SUCCESS;
+  }
+
+  PageNum new_root_page_num = BP_INVALID_PAGE_NUM;
   if (root_node.is_leaf()) {
     ASSERT(root_node.size() == 0, "");
     // file_header_.root_page = BP_INVALID_PAGE_NUM;
@@ -1686,7 +2810,7 @@ RC BplusTreeHandler::coalesce_or_redistribute(BplusTreeMiniTransaction &mtr, Fra
   latch_memo.xlatch(neighbor_frame);
 
   IndexNodeHandlerType neighbor_node(mtr, file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  if (!index_node.can_merge(neighbor_node)) {
     rc = redistribute<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
   } else {
     rc = coalesce<IndexNodeHandlerType>(mtr, neighbor_frame, frame, parent_frame, index);
@@ -1757,9 +2881,9 @@ template <typename IndexNodeHandlerType>
 RC BplusTreeHandler::redistribute(
     BplusTreeMiniTransaction &mtr, Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index)
 {
-  InternalIndexNodeHandler parent_node(mtr, file_header_, parent_frame);
-  IndexNodeHandlerType     neighbor_node(mtr, file_header_, neighbor_frame);
-  IndexNodeHandlerType     node(mtr, file_header_, frame);
+  IndexNodeHandlerType neighbor_node(mtr, file_header_, neighbor_frame);
+  IndexNodeHandlerType node(mtr, file_header_, frame);
+  RC                   rc = RC::SUCCESS;
   if (neighbor_node.size() < node.size()) {
     LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
   }
@@ -1768,14 +2892,14 @@ RC BplusTreeHandler::redistribute(
     neighbor_node.move_first_to_end(node);
     // neighbor_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
     // node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    parent_node.set_key_at(index + 1, neighbor_node.key_at(0));
+    rc = update_internal_key(mtr, parent_frame, index + 1, neighbor_node.key_at(0));
     // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
   } else {
     // the neighbor is at left
     neighbor_node.move_last_to_front(node);
     // neighbor_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
     // node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    parent_node.set_key_at(index, node.key_at(0));
+    rc = update_internal_key(mtr, parent_frame, index, node.key_at(0));
     // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
   }
 
@@ -1783,7 +2907,35 @@ RC BplusTreeHandler::redistribute(
   frame->mark_dirty();
   parent_frame->mark_dirty();
 
-  return RC::SUCCESS;
+  return rc;
+}
+
+RC BplusTreeHandler::update_internal_key(BplusTreeMiniTransaction &mtr, Frame *frame, int index, const char *key)
+{
+  InternalIndexNodeHandler node(mtr, file_header_, frame);
+  if (node.can_set_key_at(index, key)) {
+    node.set_key_at(index, key);
+    frame->mark_dirty();
+    return RC::SUCCESS;
+  }
+
+  Frame *new_frame = nullptr;
+  RC     rc        = split<InternalIndexNodeHandler>(mtr, frame, new_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to split internal node. rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  // 分裂后的两个节点元素个数都小于 max_size，替换键值之后一定放得下
+  InternalIndexNodeHandler new_node(mtr, file_header_, new_frame);
+  if (index < node.size()) {
+    node.set_key_at(index, key);
+  } else {
+    new_node.set_key_at(index - node.size(), key);
+  }
+  frame->mark_dirty();
+  new_frame->mark_dirty();
+  return insert_entry_into_parent(mtr, frame, new_frame, new_node.key_at(0));
 }
 
 RC BplusTreeHandler::delete_entry_internal(BplusTreeMiniTransaction &mtr, Frame *leaf_frame, const char *key)
@@ -1864,6 +3016,7 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   inited_        = true;
   first_emitted_ = false;
+  ranges_.clear();
 
   LatchMemo &latch_memo = mtr_.latch_memo();
 
@@ -1986,6 +3139,8 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
 
   if (touch_end()) {
     current_frame_ = nullptr;
+  } else {
+    read_ahead_next_leaf();
   }
 
   return RC::SUCCESS;
@@ -1997,20 +3152,84 @@ void BplusTreeScanner::fetch_item(RID &rid)
   memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
 }
 
+const char *BplusTreeScanner::current_key()
+{
+  if (nullptr == current_frame_) {
+    return nullptr;
+  }
+
+  const int key_length = tree_handler_.file_header_.key_length;
+  if (current_key_.size() != static_cast<size_t>(key_length)) {
+    current_key_.resize(key_length);
+  }
+
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  memcpy(current_key_.data(), node.key_at(iter_index_), key_length);
+  return current_key_.data();
+}
+
+void BplusTreeScanner::read_ahead_next_leaf()
+{
+  if (nullptr == current_frame_) {
+    return;
+  }
+
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  if (node.size() <= 0) {
+    return;
+  }
+
+  // 扫描范围在当前叶子节点内就结束了，就不需要预读
+  const char *end_key = right_key();
+  if (end_key != nullptr) {
+    const char *last_key = node.key_at(node.size() - 1);
+    if (tree_handler_.key_comparator_(last_key, end_key) > 0) {
+      return;
+    }
+  }
+
+  tree_handler_.buffer_pool().read_ahead_page(node.next_page());
+}
+
+const char *BplusTreeScanner::right_key() const
+{
+  if (ranges_.empty()) {
+    return static_cast<const char *>(right_key_.get());
+  }
+
+  const int key_length = tree_handler_.file_header_.key_length;
+  return ranges_[range_index_].has_right ? range_keys_.data() + (2 * range_index_ + 1) * key_length : nullptr;
+}
+
 bool BplusTreeScanner::touch_end()
 {
-  if (right_key_ == nullptr) {
+  const char *end_key = right_key();
+  if (end_key == nullptr) {
     return false;
   }
 
   LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
 
   const char *this_key       = node.key_at(iter_index_);
-  int         compare_result = tree_handler_.key_comparator_(this_key, static_cast<char *>(right_key_.get()));
+  int         compare_result = tree_handler_.key_comparator_(this_key, end_key);
   return compare_result > 0;
 }
 
 RC BplusTreeScanner::next_entry(RID &rid)
+{
+  RC rc = next_entry_in_range(rid);
+
+  // 当前范围扫描完了，继续扫描下一个范围
+  while (rc == RC::RECORD_EOF && range_index_ + 1 < static_cast<int>(ranges_.size())) {
+    rc = seek_next_range();
+    if (OB_SUCC(rc)) {
+      rc = next_entry_in_range(rid);
+    }
+  }
+  return rc;
+}
+
+RC BplusTreeScanner::next_entry_in_range(RID &rid)
 {
   if (nullptr == current_frame_) {
     return RC::RECORD_EOF;
@@ -2061,7 +3280,169 @@ RC BplusTreeScanner::next_entry(RID &rid)
 
   latch_memo.release_to(memo_point);
   iter_index_ = -1;  // `next` will add 1
-  return next_entry(rid);
+  read_ahead_next_leaf();
+  return next_entry_in_range(rid);
+}
+
+RC BplusTreeScanner::open(const vector<BplusTreeScanRange> &ranges)
+{
+  if (inited_) {
+    LOG_WARN("tree scanner has been inited");
+    return RC::INTERNAL;
+  }
+
+  inited_        = true;
+  first_emitted_ = false;
+  current_frame_ = nullptr;
+
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+  const int            key_length = tree_handler_.file_header_.key_length;
+
+  ranges_.clear();
+  range_keys_.assign(ranges.size() * 2 * key_length, 0);
+  for (size_t i = 0; i < ranges.size(); i++) {
+    const BplusTreeScanRange &range     = ranges[i];
+    char                     *left_key  = range_keys_.data() + 2 * i * key_length;
+    char                     *right_key = left_key + key_length;
+
+    const bool has_left  = range.left_user_key != nullptr;
+    const bool has_right = range.right_user_key != nullptr;
+    if (has_left) {
+      tree_handler_.make_key(range.left_user_key, range.left_inclusive ? *RID::min() : *RID::max(), left_key);
+    }
+    if (has_right) {
+      tree_handler_.make_key(range.right_user_key, range.right_inclusive ? *RID::max() : *RID::min(), right_key);
+    }
+
+    if (has_left && has_right && comparator(left_key, right_key) > 0) {
+      LOG_WARN("invalid scan range. left key is greater than right key. range index=%d", static_cast<int>(i));
+      return RC::INVALID_ARGUMENT;
+    }
+
+    // 范围需要从小到大排列并且不能重叠
+    if (i > 0 && (!has_left || !ranges_.back().has_right || comparator(left_key - key_length, left_key) > 0)) {
+      LOG_WARN("scan ranges are not sorted or overlapped. range index=%d", static_cast<int>(i));
+      return RC::INVALID_ARGUMENT;
+    }
+
+    ranges_.push_back(RangeBound{has_left, has_right});
+  }
+
+  range_index_ = -1;
+  return seek_next_range();
+}
+
+RC BplusTreeScanner::seek_next_range()
+{
+  const int key_length = tree_handler_.file_header_.key_length;
+  const int range_num  = static_cast<int>(ranges_.size());
+  for (range_index_++; range_index_ < range_num; range_index_++) {
+    const char *left_key = ranges_[range_index_].has_left ? range_keys_.data() + 2 * range_index_ * key_length : nullptr;
+
+    RC rc = seek(left_key);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (nullptr == current_frame_) {
+      // 后面已经没有数据了，剩下的范围都不用再找
+      range_index_ = range_num - 1;
+      return RC::SUCCESS;
+    }
+
+    if (!touch_end()) {
+      first_emitted_ = false;
+      read_ahead_next_leaf();
+      return RC::SUCCESS;
+    }
+  }
+
+  // 所有的范围都是空的
+  range_index_ = range_num - 1;
+  mtr_.latch_memo().release();
+  current_frame_ = nullptr;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeScanner::seek(const char *key)
+{
+  LatchMemo           &latch_memo = mtr_.latch_memo();
+  const KeyComparator &comparator = tree_handler_.key_comparator_;
+
+  if (key != nullptr && current_frame_ != nullptr) {
+    LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+    if (node.size() > 0 && comparator(key, node.key_at(node.size() - 1)) <= 0) {
+      iter_index_ = node.lookup(comparator, key);
+      return RC::SUCCESS;
+    }
+
+    // 与 next_entry 一样，向右加锁只能尝试加锁
+    const PageNum next_page_num = node.next_page();
+    if (next_page_num != BP_INVALID_PAGE_NUM) {
+      const int memo_point = latch_memo.memo_point();
+      Frame    *next_frame = nullptr;
+      RC        rc         = latch_memo.get_page(next_page_num, next_frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+        return rc;
+      }
+
+      if (latch_memo.try_slatch(next_frame)) {
+        latch_memo.release_to(memo_point);
+        current_frame_ = next_frame;
+
+        LeafIndexNodeHandler next_node(mtr_, tree_handler_.file_header_, current_frame_);
+        if (next_node.size() > 0 && comparator(key, next_node.key_at(next_node.size() - 1)) <= 0) {
+          iter_index_ = next_node.lookup(comparator, key);
+          return RC::SUCCESS;
+        }
+      }
+    }
+  }
+
+  latch_memo.release();
+  current_frame_ = nullptr;
+
+  RC rc = RC::SUCCESS;
+  if (key == nullptr) {
+    rc = tree_handler_.left_most_page(mtr_, current_frame_);
+  } else {
+    rc = tree_handler_.find_leaf(mtr_, BplusTreeOperationType::READ, key, current_frame_);
+  }
+  if (rc == RC::EMPTY) {
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find leaf page. rc=%s", strrc(rc));
+    current_frame_ = nullptr;
+    return rc;
+  }
+
+  LeafIndexNodeHandler node(mtr_, tree_handler_.file_header_, current_frame_);
+  iter_index_ = (key == nullptr) ? 0 : node.lookup(comparator, key);
+  if (iter_index_ < node.size()) {
+    return RC::SUCCESS;
+  }
+
+  // 起点在下一个叶子节点中，与 open 一样加锁
+  const PageNum next_page_num = node.next_page();
+  if (next_page_num == BP_INVALID_PAGE_NUM) {
+    latch_memo.release();
+    current_frame_ = nullptr;
+    return RC::SUCCESS;
+  }
+
+  const int memo_point = latch_memo.memo_point();
+  rc                   = latch_memo.get_page(next_page_num, current_frame_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
+    current_frame_ = nullptr;
+    return rc;
+  }
+  latch_memo.slatch(current_frame_);
+  latch_memo.release_to(memo_point);
+  iter_index_ = 0;
+  return RC::SUCCESS;
 }
 
 RC BplusTreeScanner::close()
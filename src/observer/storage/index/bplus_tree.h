@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <string.h>
 
+#include "common/defs.h"
 #include "common/lang/comparator.h"
 #include "common/lang/memory.h"
 #include "common/lang/sstream.h"
@@ -34,6 +35,7 @@ See the Mulan PSL v2 for more details. */
 
 class BplusTreeHandler;
 class BplusTreeMiniTransaction;
+class BplusTreeKeyReader;
 
 /**
  * @brief B+树的实现
@@ -51,9 +53,23 @@ enum class BplusTreeOperationType
   DELETE,
 };
 
+/**
+ * @brief B+树节点页面的存储格式
+ * @ingroup BPlusTree
+ * @details 创建索引时选定，记录在 IndexFileHeader 中，之后不再改变
+ */
+enum class BplusTreeNodeFormat : int32_t
+{
+  PLAIN      = 0,  ///< 每个槽位存放完整的键值
+  COMPRESSED = 1,  ///< 页内键值的公共前缀只存一份，末尾的0不存。叶子分裂时提升到父节点的分隔键会截断到最短
+};
+
 /**
  * @brief 属性比较(BplusTree)
  * @ingroup BPlusTree
+ * @details 比较操作是B+树节点内二分查找的热点。初始化时按照每个属性的类型选好比较函数，比较时直接解释键值中的字节，
+ * 不再构造 Value 对象、也不再通过 DataType 虚函数分发。只有一个属性时(最常见的情况)，直接在 switch 中内联比较。
+ * 比较的结果与 DataType::compare 保持一致，所以已有的索引文件不受影响。
  */
 class AttrComparator
 {
@@ -64,28 +80,32 @@ public:
     for (int i = 0; i < attr_num; i++) {
       attr_type_.emplace_back(type[i]);
       attr_length_.emplace_back(length[i]);
+      compare_funcs_.emplace_back(compare_func(type[i]));
       l += length[i];
     }
 
-    length_ = l;
+    length_      = l;
+    single_type_ = (attr_num == 1) ? type[0] : AttrType::UNDEFINED;
   }
 
   int attr_length() const { return length_; }
 
   int operator()(const char *v1, const char *v2) const
   {
+    switch (single_type_) {
+      case AttrType::INTS:
+      case AttrType::DATES: return compare_int(v1, v2, length_);
+      case AttrType::FLOATS: return compare_float(v1, v2, length_);
+      case AttrType::CHARS: return compare_chars(v1, v2, length_);
+      default: break;
+    }
+
     int comp_res = 0;
-    // int offset   = attr_length_[0];
-    int offset = 0;
-    // TODO: optimized the comparison
+    int offset   = 0;
     for (size_t i = 0; i < attr_type_.size(); i++) {
-      Value left;
-      left.set_type(attr_type_[i]);
-      left.set_data(v1 + offset, attr_length_[i]);
-      Value right;
-      right.set_type(attr_type_[i]);
-      right.set_data(v2 + offset, attr_length_[i]);
-      comp_res = DataType::type_instance(attr_type_[i])->compare(left, right);
+      comp_res = compare_funcs_[i] != nullptr
+                     ? compare_funcs_[i](v1 + offset, v2 + offset, attr_length_[i])
+                     : compare_value(attr_type_[i], v1 + offset, v2 + offset, attr_length_[i]);
       if (comp_res == 0) {
         offset += attr_length_[i];
       } else {
@@ -97,9 +117,64 @@ public:
   }
 
 private:
-  std::vector<AttrType> attr_type_;
-  std::vector<int>      attr_length_;
-  int                   length_;
+  using CompareFunc = int (*)(const char *v1, const char *v2, int length);
+
+  static int compare_int(const char *v1, const char *v2, int /*length*/)
+  {
+    int32_t i1;
+    int32_t i2;
+    memcpy(&i1, v1, sizeof(i1));
+    memcpy(&i2, v2, sizeof(i2));
+    return (i1 > i2) - (i1 < i2);
+  }
+
+  /// 与 common::compare_float 一致，差值在 EPSILON 之内认为相等
+  static int compare_float(const char *v1, const char *v2, int /*length*/)
+  {
+    float f1;
+    float f2;
+    memcpy(&f1, v1, sizeof(f1));
+    memcpy(&f2, v2, sizeof(f2));
+    const float cmp = f1 - f2;
+    return (cmp > EPSILON) - (cmp < -EPSILON);
+  }
+
+  /// 与 common::compare_string 一致，字符串在第一个'\0'或者字段长度处结束，较短的字符串更小
+  static int compare_chars(const char *v1, const char *v2, int length)
+  {
+    int result = strncmp(v1, v2, length);
+    return (result > 0) - (result < 0);
+  }
+
+  /// 没有专门比较函数的类型，转换成 Value 再比较
+  static int compare_value(AttrType type, const char *v1, const char *v2, int length)
+  {
+    Value left;
+    left.set_type(type);
+    left.set_data(v1, length);
+    Value right;
+    right.set_type(type);
+    right.set_data(v2, length);
+    return DataType::type_instance(type)->compare(left, right);
+  }
+
+  static CompareFunc compare_func(AttrType type)
+  {
+    switch (type) {
+      case AttrType::INTS:
+      case AttrType::DATES: return compare_int;
+      case AttrType::FLOATS: return compare_float;
+      case AttrType::CHARS: return compare_chars;
+      default: return nullptr;
+    }
+  }
+
+private:
+  std::vector<AttrType>    attr_type_;
+  std::vector<int>         attr_length_;
+  std::vector<CompareFunc> compare_funcs_;
+  int                      length_      = 0;
+  AttrType                 single_type_ = AttrType::UNDEFINED;  ///< 只有一个属性时的类型，否则是 UNDEFINED
 };
 
 /**
@@ -231,6 +306,9 @@ struct IndexFileHeader
   int32_t  attr_length[MAX_INDEX_FIELD_SIZE];  ///< 键值的长度
   int32_t  attr_offset[MAX_INDEX_FIELD_SIZE];  ///< 键值在record中的offset
   AttrType attr_type[MAX_INDEX_FIELD_SIZE];    ///< 键值的类型
+  BplusTreeNodeFormat node_format;             ///< 节点页面的存储格式。旧的索引文件这里是0，即 PLAIN
+
+  bool compressed() const { return node_format == BplusTreeNodeFormat::COMPRESSED; }
 
   const string to_string() const
   {
@@ -241,7 +319,8 @@ struct IndexFileHeader
        << "attr_type:" << attr_type << ","
        << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
-       << "leaf_max_size:" << leaf_max_size << ";";
+       << "leaf_max_size:" << leaf_max_size << ","
+       << "node_format:" << static_cast<int>(node_format) << ";";
 
     return ss.str();
   }
@@ -309,6 +388,26 @@ struct InternalIndexNode : public IndexNode
   char array[0];
 };
 
+/**
+ * @brief 压缩格式的节点在节点头之后存放的编码信息
+ * @ingroup BPlusTree
+ * @code
+ * storage format:
+ * | prefix length | stored length | prefix | stored key0, value0 | stored key1, value1 | ... |
+ * @endcode
+ * 完整的键值是 prefix + stored key，再用0补齐到 key_length。所有槽位的大小仍然相同，依然可以二分查找。
+ * 编码由页面中的键值唯一确定：有效长度是所有键值去掉末尾的0之后的最大长度，前缀是所有键值的公共前缀，
+ * 但不超过有效长度。插入的键值不符合当前编码或者删除键值之后，整个页面重新编码。
+ * 内部节点的 key0 也参与编码，最左边一列节点的 key0 全是0，前缀为空。
+ */
+struct CompressedNodeHeader
+{
+  static constexpr int SIZE = 4;
+
+  uint16_t prefix_length;  ///< 公共前缀的长度
+  uint16_t stored_length;  ///< 每个槽位中存放的键值字节数
+};
+
 /**
  * @brief IndexNode 仅作为数据在内存或磁盘中的表示
  * @ingroup BPlusTree
@@ -358,6 +457,24 @@ public:
 
   Frame *frame() const { return frame_; }
 
+  /**
+   * @brief 页面开头有效数据的字节数，不加锁读取时用来复制页面的快照
+   * @details 页面可能正在被其它线程修改，读到的元素个数不一定正确，返回值会限制在页面大小之内
+   */
+  int used_size() const;
+
+  /**
+   * @brief 插入一个键值之后是否还放得下，即不需要分裂
+   * @details 普通格式只看元素个数。压缩格式能放多少个元素取决于键值本身，要按照插入之后的编码计算页面空间。
+   * @param fill_factor 只使用页面的这个百分比，批量构建时给后续的插入留一些空间
+   */
+  bool can_insert(const char *key, int fill_factor = 100) const;
+
+  /**
+   * @brief 另一个节点的元素全部合并过来之后是否放得下
+   */
+  bool can_merge(const IndexNodeHandler &other) const;
+
   friend string to_string(const IndexNodeHandler &handler);
 
   RC recover_insert_items(int index, const char *items, int num);
@@ -368,16 +485,89 @@ protected:
    * @brief 获取指定元素的开始内存位置
    * @note 这并不是一个纯虚函数，是为了可以直接使用 IndexNodeHandler 类。
    * 但是使用这个类时，注意不能使用与这个函数相关的函数。
+   * 压缩格式的节点中没有完整的元素，不能使用这个函数，要使用 items_at。
    */
   virtual char *__item_at(int index) const { return nullptr; }
-  char         *__key_at(int index) const { return __item_at(index); }
-  char         *__value_at(int index) const { return __item_at(index) + key_size(); };
+  char         *__key_at(int index) const { return compressed() ? decode_key(index) : __item_at(index); }
+  char         *__value_at(int index) const
+  {
+    return compressed() ? slot_at(index) + compressed_header()->stored_length : __item_at(index) + key_size();
+  }
+
+  /**
+   * @brief 获取从 index 开始的 num 个完整格式的元素，用于移动元素和记录日志
+   * @details 普通格式直接返回页面中的内存，压缩格式解码到 buffer 中
+   */
+  const char *items_at(int index, int num, vector<char> &buffer) const;
+
+  bool compressed() const { return header_.compressed(); }
+
+  /**
+   * @brief 压缩格式下的二分查找，与 common::lower_bound 的语义相同
+   * @details 查找用的键值先放好前缀并补好0，每次比较只需要复制槽位中存放的部分
+   */
+  int compressed_lower_bound(const KeyComparator &comparator, const char *key, int first, int last, bool *found) const;
+
+  /**
+   * @brief 压缩格式的编码参数
+   */
+  struct KeyEncoding
+  {
+    int prefix_length = 0;
+    int stored_length = 0;
+
+    bool operator==(const KeyEncoding &other) const
+    {
+      return prefix_length == other.prefix_length && stored_length == other.stored_length;
+    }
+  };
+
+  /**
+   * @brief 一组键值的统计信息，用来计算编码
+   * @details common_length 为-1表示还没有键值。first_key 用来计算与其它键值的公共前缀
+   */
+  struct KeySummary
+  {
+    int         common_length = -1;
+    int         valid_length  = 0;
+    const char *first_key     = nullptr;
+
+    void        add(const char *key, int key_length);
+    void        merge(const KeySummary &other, int key_length);
+    KeyEncoding encoding() const;
+  };
+
+  /// @brief 当前节点中所有键值的统计信息，first_key 指向 buffer
+  KeySummary summary(vector<char> &buffer) const;
+  /// @brief 按照指定编码存放 item_num 个元素需要的字节数，包括编码信息
+  int encoded_size(const KeyEncoding &encoding, int item_num) const;
+  /// @brief 节点头之后可以存放元素的字节数
+  int capacity() const;
+  /// @brief 压缩格式下最多存放的元素个数，键值相同时只受页面空间的限制，但不超过普通格式的两倍左右
+  int compressed_max_size() const;
+
+  CompressedNodeHeader *compressed_header() const;
+  char                 *prefix() const { return reinterpret_cast<char *>(compressed_header()) + CompressedNodeHeader::SIZE; }
+  char                 *slot_at(int index) const;
+  /// @brief 压缩格式中值的大小。不使用虚函数，这样 IndexNodeHandler 重做日志时也可以使用
+  int                   stored_value_size() const;
+
+  /// @brief 把指定位置的键值解码到内部的缓存中，缓存轮流使用，最近两次返回的键值同时有效
+  char *decode_key(int index) const;
+  void  decode_key(int index, char *key) const;
+  void  decode_items(int index, int num, char *items) const;
+  /// @brief 把完整格式的元素按照规范的编码写到页面中，不修改元素个数
+  void  write_items(const char *items, int num);
+  void  encode_item(const char *item, const KeyEncoding &encoding, char *slot) const;
 
 protected:
   BplusTreeMiniTransaction &mtr_;
   const IndexFileHeader    &header_;
   Frame                    *frame_ = nullptr;
   IndexNode                *node_  = nullptr;
+
+  mutable vector<char> key_buffer_;            ///< 压缩格式解码键值用的缓存，最后一段给二分查找使用
+  mutable int          key_buffer_index_ = 0;  ///< 下一次解码使用哪一段缓存
 };
 
 /**
@@ -452,6 +642,8 @@ public:
    */
   int  value_index(PageNum page_num);
   void set_key_at(int index, const char *key);
+  /// @brief 替换指定位置的键值之后是否还放得下。普通格式总是可以
+  bool can_set_key_at(int index, const char *key) const;
   void remove(int index);
 
   /**
@@ -511,11 +703,14 @@ public:
    * @param attr_length 属性长度
    * @param internal_max_size 内部节点最大大小
    * @param leaf_max_size 叶子节点最大大小
+   * @param node_format 节点页面的存储格式
    */
   RC create(const bool unique, LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
-      const std::vector<const FieldMeta *> &field_metas, int internal_max_size = -1, int leaf_max_size = -1);
+      const std::vector<const FieldMeta *> &field_metas, int internal_max_size = -1, int leaf_max_size = -1,
+      BplusTreeNodeFormat node_format = BplusTreeNodeFormat::PLAIN);
   RC create(const bool unique, LogHandler &log_handler, DiskBufferPool &buffer_pool,
-      const std::vector<const FieldMeta *> &field_metas, int internal_max_size = -1, int leaf_max_size = -1);
+      const std::vector<const FieldMeta *> &field_metas, int internal_max_size = -1, int leaf_max_size = -1,
+      BplusTreeNodeFormat node_format = BplusTreeNodeFormat::PLAIN);
 
   /**
    * @brief 打开一个B+树
@@ -546,6 +741,21 @@ public:
    */
   RC delete_entry(const char *user_key, const RID *rid);
 
+  /**
+   * @brief 使用排好序的键值批量构建B+树
+   * @details 只能在空树上执行。键值按照填充率从下往上逐层写满页面，构建过程中不记录日志。
+   * 所有页面刷到磁盘后，再用一条更新根节点的日志让整棵树生效，中途失败或重启时这棵树仍然是空的。
+   * @param reader 按顺序输出所有键值，比如已经调用过finish的排序器
+   * @param fill_factor 节点的填充率(百分比)
+   */
+  RC bulk_load(BplusTreeKeyReader &reader, int fill_factor);
+
+  /**
+   * @brief 从记录中取出索引字段，加上RID组成B+树中的键值
+   * @param key 键值的内存大小是 file_header().key_length
+   */
+  void make_key(const char *user_key, const RID &rid, char *key) const;
+
   bool is_empty() const;
 
   /**
@@ -555,6 +765,18 @@ public:
    */
   RC get_entry(const char *user_key, int key_len, list<RID> &rids);
 
+  /**
+   * @brief 批量查找多个键值对应的record
+   * @details 键值必须按照从小到大的顺序排列，可以重复。查找时一直持有当前叶子节点的读锁，下一个键值如果还在这个
+   * 叶子节点或者紧邻的下一个叶子节点中，就不再从根节点开始查找，相邻的键值可以共用同一次查找的路径。
+   * 适合 IN 列表或者索引嵌套循环连接这种一次探测很多个键值的场景。
+   * @param user_keys 要查找的键值，与 insert_entry 一样是记录的格式
+   * @param[out] rids 追加每个键值找到的record，按照键值的顺序连续存放
+   * @param[out] offsets 可以为空。第i个键值找到的record是 rids[offsets[i], offsets[i+1])，一共 user_keys.size()+1 个元素
+   * @return 键值没有排好序时返回 INVALID_ARGUMENT
+   */
+  RC get_entries(const vector<const char *> &user_keys, vector<RID> &rids, vector<int> *offsets = nullptr);
+
   RC sync();
 
   /**
@@ -564,10 +786,16 @@ public:
    */
   bool validate_tree();
 
+  /**
+   * @brief 是否使用乐观的方式查找读操作的叶子节点，默认打开。参考 optimistic_find_leaf
+   */
+  void set_optimistic_read(bool enable) { optimistic_read_ = enable; }
+
 public:
   const IndexFileHeader &file_header() const { return file_header_; }
   DiskBufferPool        &buffer_pool() const { return *disk_buffer_pool_; }
   LogHandler            &log_handler() const { return *log_handler_; }
+  const KeyComparator   &key_comparator() const { return key_comparator_; }
 
 public:
   /**
@@ -607,6 +835,15 @@ protected:
    */
   RC find_leaf(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op, const char *key, Frame *&frame);
 
+  /**
+   * @brief 批量查找时定位键值所在的叶子节点
+   * @details frame 是上一个键值最后停留的叶子节点，已经加了读锁，键值比它前面所有叶子节点中的键值都大。
+   * 如果键值还在这个叶子节点或者下一个叶子节点中，就直接使用，否则释放所有的锁，从根节点重新查找
+   * @param[in,out] frame 返回键值所在的叶子节点，为空表示树是空的
+   * @param[out] index 返回键值在叶子节点中的位置
+   */
+  RC seek_leaf_for_batch(BplusTreeMiniTransaction &mtr, const char *key, Frame *&frame, int &index);
+
   /**
    * @brief 找到最左边的叶子节点
    */
@@ -621,6 +858,22 @@ protected:
   RC find_leaf_internal(BplusTreeMiniTransaction &mtr, BplusTreeOperationType op,
       const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
 
+  /**
+   * @brief 不加锁查找叶子节点，只用于读操作
+   * @details 从根节点向下查找时只 pin 住页面，不加锁。内部节点先复制一份快照，用页面版本号确认快照是一致的，
+   * 再在快照上查找子节点；拿到子节点的版本号之后，再确认父节点没有变化，保证这时它仍然是要找的子节点。
+   * 最后给叶子节点加上读锁，再确认叶子节点的版本号没有变化，与 crabing protocol 返回的结果一样。
+   * 读线程不再修改内部节点的锁，根节点的锁不会成为热点。
+   * @return 页面版本号校验失败时返回 LOCKED_CONCURRENCY_CONFLICT，这次 pin 住的页面都已经释放
+   */
+  RC optimistic_find_leaf(BplusTreeMiniTransaction &mtr,
+      const function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
+
+  /**
+   * @brief 不加 root_lock_ 读取根节点的页号，与 update_root_page_num_locked 配合使用
+   */
+  PageNum load_root_page_num() const;
+
   /**
    * @brief 使用crabing protocol 获取页面
    */
@@ -660,6 +913,13 @@ protected:
   template <typename IndexNodeHandlerType>
   RC redistribute(BplusTreeMiniTransaction &mtr, Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index);
 
+  /**
+   * @brief 修改内部节点中指定位置的键值
+   * @details 压缩格式下替换键值之后页面可能放不下，这时先分裂节点再修改。
+   * 删除时只有元素个数小于 max_size 的内部节点才认为是安全的，所以需要分裂时它的父节点一定也加了锁
+   */
+  RC update_internal_key(BplusTreeMiniTransaction &mtr, Frame *frame, int index, const char *key);
+
   /**
    * @brief 在父节点插入一个元素
    */
@@ -707,7 +967,21 @@ private:
   friend class BplusTreeScanner;
   friend class BplusTreeTester;
 
-  bool unique_ = false;
+  bool unique_          = false;
+  bool optimistic_read_ = true;
+};
+
+/**
+ * @brief B+树扫描的一个键值范围
+ * @details 键值与 insert_entry 一样是记录的格式，为空表示这一边没有边界
+ * @ingroup BPlusTree
+ */
+struct BplusTreeScanRange
+{
+  const char *left_user_key   = nullptr;
+  bool        left_inclusive  = true;
+  const char *right_user_key  = nullptr;
+  bool        right_inclusive = true;
 };
 
 /**
@@ -733,17 +1007,30 @@ public:
   RC open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key, int right_len,
       bool right_inclusive);
 
+  /**
+   * @brief 依次扫描多个范围的数据
+   * @details 一个范围扫描完以后，如果下一个范围的起点还在当前叶子节点或者下一个叶子节点中，就直接跳过去，
+   * 否则再从根节点开始查找。IN 列表或者多个区间的查询只需要一个扫描器
+   * @param ranges 按照从小到大的顺序排列并且互不重叠的范围，只有第一个范围可以没有左边界，只有最后一个范围可以没有右边界
+   */
+  RC open(const vector<BplusTreeScanRange> &ranges);
+
   /**
    * @brief 获取下一条记录
    *
    * @param rid 当前默认所有值都是RID类型。对B+树来说并不是一个好的抽象
    * @return RC RECORD_EOF 表示遍历完成
-   * TODO 需要增加返回 key 的接口
    * @warning 不要在遍历时删除数据。删除数据会导致遍历器失效。
    * 当前默认的走索引删除的逻辑就是这样做的，所以删除逻辑有BUG。
    */
   RC next_entry(RID &rid);
 
+  /**
+   * @brief 最近一次 next_entry 返回的数据对应的键值
+   * @details 返回的是完整的键值，前面是各个索引字段的值依次存放，后面是RID。只在下一次调用 next_entry 之前有效
+   */
+  const char *current_key();
+
   /**
    * @brief 关闭当前扫描器
    * @details 可以不调用，在析构函数时会自动执行
@@ -758,11 +1045,41 @@ private:
 
   void fetch_item(RID &rid);
 
+  /**
+   * @brief 获取当前范围内的下一条记录
+   */
+  RC next_entry_in_range(RID &rid);
+
+  /**
+   * @brief 定位到下一个不为空的范围的起点
+   * @details 没有更多的数据时 current_frame_ 为空
+   */
+  RC seek_next_range();
+
+  /**
+   * @brief 定位到第一个不小于 key 的位置
+   * @details 前面扫描过的数据都比 key 小，所以 key 不大于当前叶子节点最后一个键值时可以直接在当前节点中查找，
+   * 不大于下一个叶子节点最后一个键值时就在下一个节点中查找，否则从根节点开始查找
+   * @param key 完整的键值，为空表示从最左边开始
+   */
+  RC seek(const char *key);
+
+  /**
+   * @brief 当前范围右边界的完整键值，没有右边界时返回空
+   */
+  const char *right_key() const;
+
   /**
    * @brief 判断是否到了扫描的结束位置
    */
   bool touch_end();
 
+  /**
+   * @brief 在后台预读下一个叶子节点
+   * @details 叶子节点在文件中不一定是连续的，不能按照页面编号顺序预读，只能沿着兄弟指针一次预读一个
+   */
+  void read_ahead_next_leaf();
+
 private:
   bool                     inited_ = false;
   BplusTreeHandler        &tree_handler_;
@@ -775,4 +1092,16 @@ private:
   common::MemPoolItem::item_unique_ptr right_key_;
   int                                  iter_index_    = -1;
   bool                                 first_emitted_ = false;
+
+  /// 多个范围扫描时，每个范围是否有左右边界
+  struct RangeBound
+  {
+    bool has_left;
+    bool has_right;
+  };
+  vector<RangeBound> ranges_;
+  vector<char>       range_keys_;       ///< 每个范围左右边界的完整键值，依次存放
+  int                range_index_ = 0;  ///< 当前正在扫描的范围
+
+  vector<char> current_key_;  ///< current_key 返回的键值，压缩格式的节点需要解码
 };
@@ -0,0 +1,293 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "storage/index/bplus_tree_bulk_load.h"
+#include "common/io/io.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/thread.h"
+#include "common/log/log.h"
+
+using namespace common;
+
+/// 归并时每个有序段的读缓存最大字节数
+static constexpr int64_t MAX_RUN_BUFFER_SIZE = 1024 * 1024;
+
+/// 先比较属性值，属性值相同时再比较RID
+static int compare_keys(const AttrComparator &comparator, const char *key1, const char *key2)
+{
+  int result = comparator(key1, key2);
+  if (result != 0) {
+    return result;
+  }
+
+  const RID *rid1 = reinterpret_cast<const RID *>(key1 + comparator.attr_length());
+  const RID *rid2 = reinterpret_cast<const RID *>(key2 + comparator.attr_length());
+  return RID::compare(rid1, rid2);
+}
+
+int BplusTreeBulkLoadOptions::scan_thread_num() const
+{
+#ifdef CONCURRENCY
+  if (thread_num > 0) {
+    return thread_num;
+  }
+  return max(static_cast<int>(thread::hardware_concurrency()), 1);
+#else
+  // 没有开启并发编译时，缓冲池的锁什么都不做，不能多个线程同时扫描
+  return 1;
+#endif
+}
+
+BplusTreeKeySorter::BplusTreeKeySorter(
+    const AttrComparator &comparator, int key_length, int64_t memory_limit, const char *temp_file)
+    : comparator_(comparator), key_length_(key_length), memory_limit_(memory_limit), temp_file_(temp_file)
+{}
+
+BplusTreeKeySorter::~BplusTreeKeySorter()
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+int BplusTreeKeySorter::compare(const char *key1, const char *key2) const
+{
+  return compare_keys(comparator_, key1, key2);
+}
+
+RC BplusTreeKeySorter::add(const char *key)
+{
+  ASSERT(!finished_, "cannot add keys after the sorter finished");
+
+  buffer_.insert(buffer_.end(), key, key + key_length_);
+  key_count_++;
+
+  // 排序时每个键值还需要一个指针
+  const int64_t used_memory = static_cast<int64_t>(buffer_.size() / key_length_) * (key_length_ + sizeof(char *));
+  if (used_memory >= memory_limit_) {
+    return spill();
+  }
+  return RC::SUCCESS;
+}
+
+void BplusTreeKeySorter::sort_buffer()
+{
+  const size_t key_num = buffer_.size() / key_length_;
+  sorted_keys_.resize(key_num);
+  for (size_t i = 0; i < key_num; i++) {
+    sorted_keys_[i] = buffer_.data() + i * key_length_;
+  }
+
+  sort(sorted_keys_.begin(), sorted_keys_.end(), [this](const char *key1, const char *key2) {
+    return compare(key1, key2) < 0;
+  });
+}
+
+RC BplusTreeKeySorter::spill()
+{
+  if (buffer_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  if (fd_ < 0) {
+    fd_ = ::open(temp_file_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd_ < 0) {
+      LOG_WARN("failed to open sort file. file=%s, error=%s", temp_file_.c_str(), strerror(errno));
+      return RC::IOERR_OPEN;
+    }
+
+    // 文件打开后就删掉，关闭时自动回收空间，中途重启也不会留下临时文件
+    ::unlink(temp_file_.c_str());
+  }
+
+  sort_buffer();
+
+  Run run;
+  if (!runs_.empty()) {
+    const Run &last_run = runs_.back();
+    run.offset          = last_run.offset + last_run.key_num * key_length_;
+  }
+  run.key_num = static_cast<int64_t>(sorted_keys_.size());
+
+  vector<char> write_buffer;
+  write_buffer.reserve(MAX_RUN_BUFFER_SIZE);
+  off_t offset = run.offset;
+  for (size_t i = 0; i < sorted_keys_.size(); i++) {
+    write_buffer.insert(write_buffer.end(), sorted_keys_[i], sorted_keys_[i] + key_length_);
+    if (static_cast<int64_t>(write_buffer.size()) + key_length_ > MAX_RUN_BUFFER_SIZE || i + 1 == sorted_keys_.size()) {
+      int ret = pwriten(fd_, write_buffer.data(), static_cast<int>(write_buffer.size()), offset);
+      if (ret != 0) {
+        LOG_WARN("failed to write sort file. file=%s, error=%s", temp_file_.c_str(), strerror(ret));
+        return RC::IOERR_WRITE;
+      }
+      offset += write_buffer.size();
+      write_buffer.clear();
+    }
+  }
+
+  LOG_DEBUG("spill a sorted run. file=%s, run=%d, keys=%ld", temp_file_.c_str(), runs_.size(), run.key_num);
+  runs_.push_back(std::move(run));
+  buffer_.clear();
+  sorted_keys_.clear();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::finish()
+{
+  finished_ = true;
+  if (runs_.empty()) {
+    sort_buffer();
+    output_pos_ = 0;
+    return RC::SUCCESS;
+  }
+
+  RC rc = spill();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  vector<char>().swap(buffer_);
+  vector<const char *>().swap(sorted_keys_);
+
+  // 内存平均分给每个有序段做读缓存
+  int64_t run_buffer_size = min(memory_limit_ / static_cast<int64_t>(runs_.size()), MAX_RUN_BUFFER_SIZE);
+  run_buffer_size         = max(run_buffer_size / key_length_, static_cast<int64_t>(1)) * key_length_;
+
+  heap_ = decltype(heap_)([this](int run1, int run2) {
+    return compare(runs_[run1].current(key_length_), runs_[run2].current(key_length_)) > 0;
+  });
+  for (int i = 0; i < static_cast<int>(runs_.size()); i++) {
+    runs_[i].buffer.resize(run_buffer_size);
+    rc = load_run(runs_[i]);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    heap_.push(i);
+  }
+
+  LOG_INFO("sorter begin to merge runs. file=%s, keys=%ld, runs=%d", temp_file_.c_str(), key_count_, runs_.size());
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::load_run(Run &run)
+{
+  const int64_t key_num = min(static_cast<int64_t>(run.buffer.size() / key_length_), run.key_num - run.read_num);
+  const off_t   offset  = run.offset + run.read_num * key_length_;
+
+  int ret = preadn(fd_, run.buffer.data(), static_cast<int>(key_num * key_length_), offset);
+  if (ret != 0) {
+    LOG_WARN("failed to read sort file. file=%s, offset=%ld, ret=%d", temp_file_.c_str(), offset, ret);
+    return RC::IOERR_READ;
+  }
+
+  run.read_num += key_num;
+  run.buffer_pos = 0;
+  run.buffer_num = static_cast<int>(key_num);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::advance_run(Run &run, bool &has_more)
+{
+  run.buffer_pos++;
+  has_more = true;
+  if (run.buffer_pos < run.buffer_num) {
+    return RC::SUCCESS;
+  }
+
+  if (run.read_num >= run.key_num) {
+    has_more = false;
+    return RC::SUCCESS;
+  }
+  return load_run(run);
+}
+
+RC BplusTreeKeySorter::next(const char *&key)
+{
+  ASSERT(finished_, "sorter should be finished before reading keys");
+
+  if (runs_.empty()) {
+    if (output_pos_ >= sorted_keys_.size()) {
+      return RC::RECORD_EOF;
+    }
+    key = sorted_keys_[output_pos_++];
+    return RC::SUCCESS;
+  }
+
+  if (current_run_ >= 0) {
+    bool has_more = false;
+    RC   rc       = advance_run(runs_[current_run_], has_more);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (has_more) {
+      heap_.push(current_run_);
+    }
+    current_run_ = -1;
+  }
+
+  if (heap_.empty()) {
+    return RC::RECORD_EOF;
+  }
+
+  current_run_ = heap_.top();
+  heap_.pop();
+  key = runs_[current_run_].current(key_length_);
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BplusTreeKeyMerger::BplusTreeKeyMerger(const AttrComparator &comparator, vector<BplusTreeKeyReader *> readers)
+    : comparator_(comparator), readers_(std::move(readers)), current_keys_(readers_.size(), nullptr)
+{
+  for (BplusTreeKeyReader *reader : readers_) {
+    key_count_ += reader->key_count();
+  }
+
+  heap_ = decltype(heap_)([this](int reader1, int reader2) {
+    return compare_keys(comparator_, current_keys_[reader1], current_keys_[reader2]) > 0;
+  });
+}
+
+RC BplusTreeKeyMerger::next(const char *&key)
+{
+  RC rc = RC::SUCCESS;
+  if (!started_) {
+    started_ = true;
+    for (int i = 0; i < static_cast<int>(readers_.size()); i++) {
+      rc = readers_[i]->next(current_keys_[i]);
+      if (OB_SUCC(rc)) {
+        heap_.push(i);
+      } else if (rc != RC::RECORD_EOF) {
+        return rc;
+      }
+    }
+  } else if (current_reader_ >= 0) {
+    // 上次输出的键值所在的输入前进一步，再放回堆中
+    rc = readers_[current_reader_]->next(current_keys_[current_reader_]);
+    if (OB_SUCC(rc)) {
+      heap_.push(current_reader_);
+    } else if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    current_reader_ = -1;
+  }
+
+  if (heap_.empty()) {
+    return RC::RECORD_EOF;
+  }
+
+  current_reader_ = heap_.top();
+  heap_.pop();
+  key = current_keys_[current_reader_];
+  return RC::SUCCESS;
+}
@@ -0,0 +1,164 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/rc.h"
+#include "common/lang/functional.h"
+#include "common/lang/queue.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/index/bplus_tree.h"
+
+/**
+ * @brief 批量构建B+树的参数
+ * @ingroup BPlusTree
+ */
+struct BplusTreeBulkLoadOptions
+{
+  bool    enable      = true;              ///< 创建索引时是否使用批量构建，否则逐条插入
+  int     fill_factor = 90;                ///< 节点的填充率(百分比)，给后续的插入留一些空间，取值范围 [50, 100]
+  int64_t sort_memory = 64 * 1024 * 1024;  ///< 排序时内存中最多缓存多少字节的键值，超过后写到临时文件，由所有扫描线程平分
+  int     thread_num  = 0;                 ///< 并行扫描和排序的线程数，不大于0时使用CPU核数。没有开启 CONCURRENCY 编译时只使用一个线程
+
+  /// @brief 实际使用的扫描线程数
+  int scan_thread_num() const;
+};
+
+/**
+ * @brief 按照从小到大的顺序输出B+树键值
+ * @ingroup BPlusTree
+ */
+class BplusTreeKeyReader
+{
+public:
+  virtual ~BplusTreeKeyReader() = default;
+
+  /**
+   * @brief 按照从小到大的顺序获取下一个键值
+   * @details 返回的内存在下一次调用之前有效
+   * @return RC RECORD_EOF 表示没有更多的键值了
+   */
+  virtual RC next(const char *&key) = 0;
+
+  /// @brief 一共有多少个键值
+  virtual int64_t key_count() const = 0;
+};
+
+/**
+ * @brief 批量构建B+树时使用的排序器
+ * @ingroup BPlusTree
+ * @details 键值是B+树中的格式，即属性值加上RID。键值先缓存在内存中，超过内存限制就排好序写到临时文件中，
+ * 成为一个有序段(run)。所有的键值都加入后，对所有的有序段做多路归并，按照从小到大的顺序输出。
+ * 如果数据量没有超过内存限制，就不会写临时文件。
+ */
+class BplusTreeKeySorter : public BplusTreeKeyReader
+{
+public:
+  /**
+   * @brief 构造函数
+   * @param comparator 属性值的比较器，属性值相同时再按照RID比较
+   * @param key_length 键值的长度，包括RID
+   * @param memory_limit 内存中最多缓存多少字节的键值
+   * @param temp_file 有序段写入的临时文件
+   */
+  BplusTreeKeySorter(const AttrComparator &comparator, int key_length, int64_t memory_limit, const char *temp_file);
+  virtual ~BplusTreeKeySorter();
+
+  /// @brief 增加一个键值，会复制一份数据
+  RC add(const char *key);
+
+  /// @brief 所有的键值都加入了，准备按顺序输出
+  RC finish();
+
+  /// @brief 所有的键值都加入并且调用finish之后，按照从小到大的顺序获取下一个键值
+  RC next(const char *&key) override;
+
+  int64_t key_count() const override { return key_count_; }
+  /// @brief 写到临时文件中的有序段个数
+  int run_count() const { return static_cast<int>(runs_.size()); }
+
+private:
+  /**
+   * @brief 临时文件中的一个有序段
+   * @details 归并时每个有序段有一个读缓存，每次从文件中读取一批键值
+   */
+  struct Run
+  {
+    off_t        offset     = 0;  ///< 有序段在临时文件中的位置
+    int64_t      key_num    = 0;  ///< 有序段中键值的个数
+    int64_t      read_num   = 0;  ///< 已经从文件中读取了多少个键值
+    vector<char> buffer;          ///< 读缓存
+    int          buffer_pos = 0;  ///< 当前键值在读缓存中的下标
+    int          buffer_num = 0;  ///< 读缓存中有多少个键值
+
+    const char *current(int key_length) const { return buffer.data() + static_cast<size_t>(buffer_pos) * key_length; }
+  };
+
+  int compare(const char *key1, const char *key2) const;
+
+  /// @brief 对内存中的键值排序
+  void sort_buffer();
+  /// @brief 把内存中的键值排好序写到临时文件中
+  RC spill();
+  /// @brief 从临时文件中读取有序段的下一批键值
+  RC load_run(Run &run);
+  /// @brief 有序段跳到下一个键值，返回是否还有键值
+  RC advance_run(Run &run, bool &has_more);
+
+private:
+  AttrComparator comparator_;
+  int            key_length_   = 0;
+  int64_t        memory_limit_ = 0;
+  string         temp_file_;
+  int            fd_ = -1;
+
+  int64_t key_count_ = 0;
+  bool    finished_  = false;
+
+  vector<char>         buffer_;          ///< 内存中缓存的键值
+  vector<const char *> sorted_keys_;     ///< 排好序的键值，指向 buffer_
+  size_t               output_pos_ = 0;  ///< 没有写临时文件时，下一个输出的键值下标
+
+  vector<Run>                                                runs_;              ///< 临时文件中的有序段
+  priority_queue<int, vector<int>, function<bool(int, int)>> heap_;              ///< 各有序段当前键值组成的小根堆
+  int                                                        current_run_ = -1;  ///< 上次输出的键值来自哪个有序段
+};
+
+/**
+ * @brief 对多个有序的键值输入做多路归并
+ * @ingroup BPlusTree
+ * @details 并行构建索引时，每个扫描线程各自排序一段页面上的键值，最后用它把所有线程的结果合并起来
+ */
+class BplusTreeKeyMerger : public BplusTreeKeyReader
+{
+public:
+  /**
+   * @brief 构造函数
+   * @param comparator 属性值的比较器，属性值相同时再按照RID比较
+   * @param readers 参与归并的输入，需要已经可以按顺序输出键值
+   */
+  BplusTreeKeyMerger(const AttrComparator &comparator, vector<BplusTreeKeyReader *> readers);
+  virtual ~BplusTreeKeyMerger() = default;
+
+  RC next(const char *&key) override;
+
+  int64_t key_count() const override { return key_count_; }
+
+private:
+  AttrComparator               comparator_;
+  vector<BplusTreeKeyReader *> readers_;
+  vector<const char *>         current_keys_;  ///< 每个输入当前的键值
+  int64_t                      key_count_ = 0;
+  bool                         started_   = false;
+
+  priority_queue<int, vector<int>, function<bool(int, int)>> heap_;              ///< 各输入当前键值组成的小根堆
+  int                                                        current_reader_ = -1;  ///< 上次输出的键值来自哪个输入
+};
@@ -13,7 +13,10 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "storage/index/bplus_tree_index.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/thread.h"
 #include "common/log/log.h"
+#include "common/thread/thread_util.h"
 #include "common/rc.h"
 #include "storage/table/table.h"
 #include "storage/db/db.h"
@@ -32,7 +35,14 @@ RC BplusTreeIndex::create(Table *table, const char *file_name, const IndexMeta &
   Index::init(index_meta, field_metas);
 
   BufferPoolManager &bpm = table->db()->buffer_pool_manager();
-  RC                 rc  = index_handler_.create(unique, table->db()->log_handler(), bpm, file_name, field_metas);
+  RC                 rc  = index_handler_.create(unique,
+      table->db()->log_handler(),
+      bpm,
+      file_name,
+      field_metas,
+      -1 /*internal_max_size*/,
+      -1 /*leaf_max_size*/,
+      table->db()->index_node_format());
   if (RC::SUCCESS != rc) {
     LOG_WARN("Failed to create index_handler, file_name:%s, index:%s, field:%s, rc:%s",
         file_name, index_meta.name(), index_meta.fields().data()->c_str(), strrc(rc));
@@ -125,6 +135,91 @@ RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
   return index_handler_.delete_entry(record, rid);
 }
 
+RC BplusTreeIndex::sort_keys(RecordFileScanner &scanner, BplusTreeKeySorter &sorter)
+{
+  RC           rc = RC::SUCCESS;
+  vector<char> key(index_handler_.file_header().key_length);
+  Record       record;
+  while (OB_SUCC(rc = scanner.next(record))) {
+    index_handler_.make_key(record.data(), record.rid(), key.data());
+    rc = sorter.add(key.data());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to add key into sorter. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to scan records while bulk loading index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+
+  rc = sorter.finish();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sort keys. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeIndex::bulk_load(
+    const vector<RecordFileScanner *> &scanners, const BplusTreeBulkLoadOptions &options, int64_t &key_count)
+{
+  const int     key_length  = index_handler_.file_header().key_length;
+  const string  temp_file   = string(index_handler_.buffer_pool().filename()) + ".sort";
+  const int     scanner_num = static_cast<int>(scanners.size());
+  const int64_t sort_memory = options.sort_memory / max(scanner_num, 1);
+
+  vector<unique_ptr<BplusTreeKeySorter>> sorters;
+  vector<BplusTreeKeyReader *>           readers;
+  for (int i = 0; i < scanner_num; i++) {
+    sorters.push_back(make_unique<BplusTreeKeySorter>(index_handler_.key_comparator().attr_comparator(),
+        key_length, sort_memory, (temp_file + "." + std::to_string(i)).c_str()));
+    readers.push_back(sorters.back().get());
+  }
+
+  vector<RC> rcs(scanner_num, RC::SUCCESS);
+#ifdef CONCURRENCY
+  // 第一个扫描器在当前线程中执行，其它的每个扫描器启动一个线程
+  vector<thread> threads;
+  for (int i = 1; i < scanner_num; i++) {
+    threads.emplace_back([this, i, &scanners, &sorters, &rcs]() {
+      common::thread_set_name("IndexBuild");
+      rcs[i] = sort_keys(*scanners[i], *sorters[i]);
+    });
+  }
+  if (scanner_num > 0) {
+    rcs[0] = sort_keys(*scanners[0], *sorters[0]);
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+#else
+  // 没有开启并发编译时，缓冲池不能被多个线程同时访问，依次执行
+  for (int i = 0; i < scanner_num; i++) {
+    rcs[i] = sort_keys(*scanners[i], *sorters[i]);
+  }
+#endif
+
+  int run_count = 0;
+  for (int i = 0; i < scanner_num; i++) {
+    if (OB_FAIL(rcs[i])) {
+      return rcs[i];
+    }
+    run_count += sorters[i]->run_count();
+  }
+
+  BplusTreeKeyMerger merger(index_handler_.key_comparator().attr_comparator(), std::move(readers));
+  LOG_INFO("sorted all keys of index. index=%s, keys=%ld, threads=%d, runs=%d",
+           index_meta_.name(), merger.key_count(), scanner_num, run_count);
+
+  key_count = merger.key_count();
+  if (scanner_num == 1) {
+    return index_handler_.bulk_load(*sorters[0], options.fill_factor);
+  }
+  return index_handler_.bulk_load(merger, options.fill_factor);
+}
+
 IndexScanner *BplusTreeIndex::create_scanner(
     const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
 {
@@ -138,6 +233,23 @@ IndexScanner *BplusTreeIndex::create_scanner(
   return index_scanner;
 }
 
+IndexScanner *BplusTreeIndex::create_scanner(const std::vector<IndexKeyRange> &ranges)
+{
+  BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(index_handler_);
+  RC                     rc            = index_scanner->open(ranges);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+    delete index_scanner;
+    return nullptr;
+  }
+  return index_scanner;
+}
+
+RC BplusTreeIndex::get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids, std::vector<int> *offsets)
+{
+  return index_handler_.get_entries(keys, rids, offsets);
+}
+
 RC BplusTreeIndex::sync() { return index_handler_.sync(); }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +263,16 @@ RC BplusTreeIndexScanner::open(
   return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
 }
 
+RC BplusTreeIndexScanner::open(const std::vector<IndexKeyRange> &ranges)
+{
+  std::vector<BplusTreeScanRange> tree_ranges;
+  tree_ranges.reserve(ranges.size());
+  for (const IndexKeyRange &range : ranges) {
+    tree_ranges.push_back(BplusTreeScanRange{range.left_key, range.left_inclusive, range.right_key, range.right_inclusive});
+  }
+  return tree_scanner_.open(tree_ranges);
+}
+
 RC BplusTreeIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
 
 RC BplusTreeIndexScanner::destroy()
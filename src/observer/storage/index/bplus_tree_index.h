@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_load.h"
 #include "storage/index/index.h"
 
 /**
@@ -29,21 +30,38 @@ public:
 
   RC create(Table *table, const char *file_name, const IndexMeta &index_meta, const std::vector<const FieldMeta *> &field_metas, const bool unique);
   RC open(Table *table, const char *file_name, const IndexMeta &index_meta, const std::vector<const FieldMeta *> &field_metas);
-  RC close();
+  RC close() override;
 
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 使用扫描到的所有记录批量构建索引
+   * @details 先对所有的键值做外部排序，再从下往上逐层写满B+树的页面，比逐条插入快很多。只能用于新创建的索引。
+   * 每个扫描器遍历文件中的一段页面，各自在一个线程中提取和排序键值，最后多路归并后写入B+树
+   * @param scanners 扫描器，每个扫描器使用一个线程
+   * @param key_count 返回一共加载了多少个键值
+   */
+  RC bulk_load(const vector<RecordFileScanner *> &scanners, const BplusTreeBulkLoadOptions &options, int64_t &key_count);
+
   /**
    * 扫描指定范围的数据
    */
   IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
       int right_len, bool right_inclusive) override;
 
+  IndexScanner *create_scanner(const std::vector<IndexKeyRange> &ranges) override;
+
+  RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids, std::vector<int> *offsets) override;
+
   RC sync() override;
 
   char *make_key(const char *record);
 
+private:
+  /// @brief 把一个扫描器遍历到的所有记录的键值加入排序器，然后排序
+  RC sort_keys(RecordFileScanner &scanner, BplusTreeKeySorter &sorter);
+
 private:
   bool             inited_ = false;
   Table           *table_  = nullptr;
@@ -63,8 +81,11 @@ public:
   RC next_entry(RID *rid) override;
   RC destroy() override;
 
+  const char *current_key() override { return tree_scanner_.current_key(); }
+
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
       bool right_inclusive);
+  RC open(const std::vector<IndexKeyRange> &ranges);
 
 private:
   BplusTreeScanner tree_scanner_;
@@ -0,0 +1,223 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/hash_index.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+HashIndex::~HashIndex() noexcept { close(); }
+
+RC HashIndex::create(Table *table, const char *file_name, const IndexMeta &index_meta,
+    const std::vector<const FieldMeta *> &field_metas, const bool unique)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s",
+        file_name, index_meta.name());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_metas);
+
+  BufferPoolManager &bpm = table->db()->buffer_pool_manager();
+  RC rc = index_handler_.create(unique, table->db()->log_handler(), bpm, file_name, field_metas);
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to create hash index handler, file_name:%s, index:%s, rc:%s",
+        file_name, index_meta.name(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  table_  = table;
+  LOG_INFO("Successfully create hash index, file_name:%s, index:%s", file_name, index_meta.name());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::open(
+    Table *table, const char *file_name, const IndexMeta &index_meta, const std::vector<const FieldMeta *> &field_metas)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s",
+        file_name, index_meta.name());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_metas);
+
+  BufferPoolManager &bpm = table->db()->buffer_pool_manager();
+  RC                 rc  = index_handler_.open(table->db()->log_handler(), bpm, file_name);
+  if (RC::SUCCESS != rc) {
+    LOG_WARN("Failed to open hash index handler, file_name:%s, index:%s, rc:%s",
+        file_name, index_meta.name(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  table_  = table;
+  LOG_INFO("Successfully open hash index, file_name:%s, index:%s", file_name, index_meta.name());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close hash index, index:%s", index_meta_.name());
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::insert_entry(const char *record, const RID *rid) { return index_handler_.insert_entry(record, rid); }
+
+RC HashIndex::delete_entry(const char *record, const RID *rid) { return index_handler_.delete_entry(record, rid); }
+
+IndexScanner *HashIndex::create_scanner(
+    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+{
+  return create_scanner(std::vector<IndexKeyRange>{IndexKeyRange{left_key, left_inclusive, right_key, right_inclusive}});
+}
+
+IndexScanner *HashIndex::create_scanner(const std::vector<IndexKeyRange> &ranges)
+{
+  HashIndexScanner *index_scanner = new HashIndexScanner(index_handler_);
+  RC                rc            = index_scanner->open(ranges);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+    delete index_scanner;
+    return nullptr;
+  }
+  return index_scanner;
+}
+
+RC HashIndex::get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids, std::vector<int> *offsets)
+{
+  if (offsets != nullptr) {
+    offsets->clear();
+    offsets->reserve(keys.size() + 1);
+  }
+
+  for (const char *key : keys) {
+    const int first = static_cast<int>(rids.size());
+    if (offsets != nullptr) {
+      offsets->push_back(first);
+    }
+
+    RC rc = index_handler_.get_entry(key, rids);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get entries from hash index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+
+    // 与B+树一样，同一个键值的数据按照RID排列
+    sort(rids.begin() + first, rids.end(), [](const RID &a, const RID &b) { return RID::compare(&a, &b) < 0; });
+  }
+
+  if (offsets != nullptr) {
+    offsets->push_back(static_cast<int>(rids.size()));
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::sync() { return index_handler_.sync(); }
+
+////////////////////////////////////////////////////////////////////////////////
+HashIndexScanner::HashIndexScanner(LinearHashHandler &handler) : handler_(handler) {}
+
+RC HashIndexScanner::open(const std::vector<IndexKeyRange> &ranges)
+{
+  const AttrComparator &attr_comparator = handler_.attr_comparator();
+  const int             key_length      = handler_.file_header().key_length;
+
+  ranges_ = ranges;
+  range_keys_.assign(ranges.size() * 2 * key_length, 0);
+
+  bool all_points = true;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    const IndexKeyRange &range     = ranges[i];
+    char                *left_key  = range_keys_.data() + 2 * i * key_length;
+    char                *right_key = left_key + key_length;
+    if (range.left_key != nullptr) {
+      handler_.make_key(range.left_key, RID(0, 0), left_key);
+    }
+    if (range.right_key != nullptr) {
+      handler_.make_key(range.right_key, RID(0, 0), right_key);
+    }
+
+    const bool point = range.left_key != nullptr && range.right_key != nullptr && range.left_inclusive &&
+                       range.right_inclusive && attr_comparator(left_key, right_key) == 0;
+    all_points = all_points && point;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (all_points) {
+    for (size_t i = 0; OB_SUCC(rc) && i < ranges.size(); i++) {
+      rc = handler_.get_items(ranges[i].left_key, items_);
+    }
+  } else {
+    // 哈希表中的数据没有顺序，只能全部遍历一遍
+    rc = handler_.scan([this, key_length](const char *item) {
+      if (in_ranges(item)) {
+        items_.insert(items_.end(), item, item + key_length);
+      }
+      return RC::SUCCESS;
+    });
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open hash index scanner. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+bool HashIndexScanner::in_ranges(const char *item) const
+{
+  const AttrComparator &attr_comparator = handler_.attr_comparator();
+  const int             key_length      = handler_.file_header().key_length;
+  for (size_t i = 0; i < ranges_.size(); i++) {
+    const IndexKeyRange &range     = ranges_[i];
+    const char          *left_key  = range_keys_.data() + 2 * i * key_length;
+    const char          *right_key = left_key + key_length;
+    if (range.left_key != nullptr) {
+      const int result = attr_comparator(item, left_key);
+      if (result < 0 || (result == 0 && !range.left_inclusive)) {
+        continue;
+      }
+    }
+    if (range.right_key != nullptr) {
+      const int result = attr_comparator(item, right_key);
+      if (result > 0 || (result == 0 && !range.right_inclusive)) {
+        continue;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+RC HashIndexScanner::next_entry(RID *rid)
+{
+  const int key_length = handler_.file_header().key_length;
+  if (next_offset_ >= items_.size()) {
+    current_item_ = nullptr;
+    return RC::RECORD_EOF;
+  }
+
+  current_item_ = items_.data() + next_offset_;
+  memcpy(rid, current_item_ + handler_.attr_comparator().attr_length(), sizeof(RID));
+  next_offset_ += key_length;
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
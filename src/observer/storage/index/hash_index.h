@@ -0,0 +1,83 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "storage/index/index.h"
+#include "storage/index/linear_hash.h"
+
+/**
+ * @brief 哈希索引
+ * @ingroup Index
+ * @details 使用线性哈希表实现，等值查找只需要访问一个桶。范围查找需要遍历整个哈希表，优化器只会在所有索引字段都是
+ * 等值条件时选择哈希索引
+ */
+class HashIndex : public Index
+{
+public:
+  HashIndex() = default;
+  virtual ~HashIndex() noexcept;
+
+  RC create(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &field_metas, const bool unique);
+  RC open(Table *table, const char *file_name, const IndexMeta &index_meta,
+      const std::vector<const FieldMeta *> &field_metas);
+  RC close() override;
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+      int right_len, bool right_inclusive) override;
+
+  IndexScanner *create_scanner(const std::vector<IndexKeyRange> &ranges) override;
+
+  RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids, std::vector<int> *offsets) override;
+
+  RC sync() override;
+
+private:
+  bool              inited_ = false;
+  Table            *table_  = nullptr;
+  LinearHashHandler index_handler_;
+};
+
+/**
+ * @brief 哈希索引扫描器
+ * @ingroup Index
+ * @details 打开时就把所有满足条件的键值对取出来。每个范围的左右边界相同时按照等值查找，否则遍历整个哈希表再过滤
+ */
+class HashIndexScanner : public IndexScanner
+{
+public:
+  HashIndexScanner(LinearHashHandler &handler);
+  ~HashIndexScanner() noexcept override = default;
+
+  RC next_entry(RID *rid) override;
+  RC destroy() override;
+
+  const char *current_key() override { return current_item_; }
+
+  RC open(const std::vector<IndexKeyRange> &ranges);
+
+private:
+  /// 键值对中的索引字段是否在某个范围中
+  bool in_ranges(const char *item) const;
+
+private:
+  LinearHashHandler &handler_;
+
+  vector<char> range_keys_;  ///< 每个范围的左右边界，只有索引字段部分，没有边界的位置不使用
+  vector<IndexKeyRange> ranges_;
+
+  vector<char> items_;  ///< 满足条件的所有键值对
+  size_t       next_offset_  = 0;
+  const char  *current_item_ = nullptr;
+};
@@ -30,6 +30,19 @@ class IndexScanner;
  * @details 索引可能会有很多种实现，比如B+树、哈希表等，这里定义了一个基类，用于描述索引的基本操作。
  */
 
+/**
+ * @brief 索引扫描的一个键值范围
+ * @ingroup Index
+ * @details 键值与 insert_entry 一样是记录的格式，为空表示这一边没有边界
+ */
+struct IndexKeyRange
+{
+  const char *left_key        = nullptr;
+  bool        left_inclusive  = true;
+  const char *right_key       = nullptr;
+  bool        right_inclusive = true;
+};
+
 /**
  * @brief 索引基类
  * @ingroup Index
@@ -73,12 +86,34 @@ public:
   virtual IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
       int right_len, bool right_inclusive) = 0;
 
+  /**
+   * @brief 创建一个依次扫描多个范围的扫描器
+   * @details 用于 IN 列表、多个区间 OR 起来之类的查询，一个扫描器就可以返回所有范围内的数据
+   * @param ranges 按照从小到大的顺序排列并且互不重叠的范围
+   */
+  virtual IndexScanner *create_scanner(const std::vector<IndexKeyRange> &ranges) = 0;
+
+  /**
+   * @brief 批量查找多个键值对应的数据
+   * @details 相邻的键值可以共用一次查找，比逐个创建扫描器查找快，适合 IN 列表或者索引嵌套循环连接
+   * @param keys 按照从小到大排好序的键值，与 insert_entry 一样是记录的格式
+   * @param[out] rids 按照键值的顺序追加找到的数据
+   * @param[out] offsets 可以为空。第i个键值找到的数据是 rids[offsets[i], offsets[i+1])
+   */
+  virtual RC get_entries(const std::vector<const char *> &keys, std::vector<RID> &rids, std::vector<int> *offsets) = 0;
+
   /**
    * @brief 同步索引数据到磁盘
    *
    */
   virtual RC sync() = 0;
 
+  /**
+   * @brief 关闭索引文件
+   *
+   */
+  virtual RC close() = 0;
+
 protected:
   RC init(const IndexMeta &index_meta, const std::vector<const FieldMeta *> &field_meta);
 
@@ -104,4 +139,10 @@ public:
    */
   virtual RC next_entry(RID *rid) = 0;
   virtual RC destroy()            = 0;
+
+  /**
+   * 最近一次 next_entry 返回的数据对应的键值，各个索引字段的值按照字段长度依次存放
+   * 只在下一次调用 next_entry 之前有效
+   */
+  virtual const char *current_key() = 0;
 };
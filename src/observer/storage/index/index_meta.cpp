@@ -23,8 +23,12 @@ const static Json::StaticString FIELD_NAME("name");
 const static Json::StaticString FIELD_FIELD_NAME("field_name");
 const static Json::StaticString FIELD_FIELD_SIZE("field_size");
 const static Json::StaticString FIELD_UNIQUE("unique");
+const static Json::StaticString FIELD_TYPE("type");
 
-RC IndexMeta::init(const char *name, const std::vector<const FieldMeta *> &fields, bool unique)
+static const char *index_type_name(IndexType type) { return type == IndexType::HASH ? "hash" : "btree"; }
+
+RC IndexMeta::init(const char *name, const std::vector<const FieldMeta *> &fields, bool unique,
+    IndexType type /* = IndexType::BPLUS_TREE */)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
@@ -38,6 +42,7 @@ RC IndexMeta::init(const char *name, const std::vector<const FieldMeta *> &field
 
   field_metas_ = fields;
   unique_ = unique;
+  type_   = type;
   return RC::SUCCESS;
 }
 
@@ -46,6 +51,7 @@ void IndexMeta::to_json(Json::Value &json_value) const
   json_value[FIELD_NAME]       = name_;
   json_value[FIELD_FIELD_SIZE] = fields_.size();
   json_value[FIELD_UNIQUE]     = unique_;
+  json_value[FIELD_TYPE]       = index_type_name(type_);
 
   Json::Value fields;
   for (int i = 0; i < fields_.size(); i++) {
@@ -60,6 +66,7 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
   const Json::Value &field_size  = json_value[FIELD_FIELD_SIZE];
   const Json::Value &field_value = json_value[FIELD_FIELD_NAME];
   const Json::Value &unique      = json_value[FIELD_UNIQUE];
+  const Json::Value &type_value  = json_value[FIELD_TYPE];
 
   if (!name_value.isString()) {
     LOG_ERROR("Index name is not a string. json value=%s", name_value.toStyledString().c_str());
@@ -87,6 +94,21 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     }
   }
 
+  // 以前的元数据中没有索引类型，都是B+树
+  IndexType type = IndexType::BPLUS_TREE;
+  if (!type_value.isNull()) {
+    if (!type_value.isString()) {
+      LOG_ERROR("Index type is not a string. json value=%s", type_value.toStyledString().c_str());
+      return RC::INTERNAL;
+    }
+    if (0 == strcmp(type_value.asCString(), index_type_name(IndexType::HASH))) {
+      type = IndexType::HASH;
+    } else if (0 != strcmp(type_value.asCString(), index_type_name(IndexType::BPLUS_TREE))) {
+      LOG_ERROR("Unknown index type. json value=%s", type_value.toStyledString().c_str());
+      return RC::INTERNAL;
+    }
+  }
+
   std::vector<const FieldMeta *> fields;
   for (int i = 0; i < field_value.size(); i++) {
     const FieldMeta *field = table.field(field_value[i].asCString());
@@ -97,7 +119,7 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     fields.emplace_back(field);
   }
 
-  return index.init(name_value.asCString(), fields, unique.asBool());
+  return index.init(name_value.asCString(), fields, unique.asBool(), type);
 }
 
 const char                     *IndexMeta::name() const { return name_.c_str(); }
@@ -111,5 +133,5 @@ void IndexMeta::desc(ostream &os) const
     fields += field;
     fields += " ";
   }
-  os << "index name=" << name_ << ", field=" << fields;
+  os << "index name=" << name_ << ", field=" << fields << ", type=" << index_type_name(type_);
 }
\ No newline at end of file
@@ -24,23 +24,34 @@ namespace Json {
 class Value;
 }  // namespace Json
 
+/**
+ * @brief 索引的类型
+ * @ingroup Index
+ */
+enum class IndexType
+{
+  BPLUS_TREE,  ///< B+树，可以做范围查找
+  HASH,        ///< 线性哈希表，只能做等值查找
+};
+
 /**
  * @brief 描述一个索引
  * @ingroup Index
- * @details 一个索引包含了表的哪些字段，索引的名称等。
- * 如果以后实现了多种类型的索引，还需要记录索引的类型，对应类型的一些元数据等
+ * @details 一个索引包含了表的哪些字段，索引的名称、类型等。
  */
 class IndexMeta
 {
 public:
   IndexMeta() = default;
 
-  RC init(const char *name, const std::vector<const FieldMeta *> &fields, bool unique);
+  RC init(const char *name, const std::vector<const FieldMeta *> &fields, bool unique,
+      IndexType type = IndexType::BPLUS_TREE);
 
 public:
   const char                     *name() const;
   const std::vector<std::string> &fields() const;
   const bool                      unique() const;
+  IndexType                       type() const { return type_; }
 
   void desc(ostream &os) const;
 
@@ -54,4 +65,5 @@ protected:
   std::vector<string> fields_;  // field's name
   std::vector<const FieldMeta *> field_metas_;
   bool                unique_;
+  IndexType           type_ = IndexType::BPLUS_TREE;
 };
@@ -78,6 +78,9 @@ public:
 
   void release_to(int point);
 
+  /// @brief 释放 point 之后加入的所有锁和页面，与 release_to 相反
+  void release_from(int point);
+
   int memo_point() const { return static_cast<int>(items_.size()); }
 
 private:
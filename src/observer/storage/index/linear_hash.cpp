@@ -0,0 +1,812 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/linear_hash.h"
+#include "common/lang/sstream.h"
+#include "common/log/log.h"
+#include "common/math/crc.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/linear_hash_log.h"
+
+#define FIRST_INDEX_PAGE 1
+
+string LinearHashFileHeader::to_string() const
+{
+  stringstream ss;
+  ss << "unique:" << unique << ",key_length:" << key_length << ",attr_num:" << attr_num
+     << ",bucket_capacity:" << bucket_capacity << ",initial_bucket_num:" << initial_bucket_num << ",level:" << level
+     << ",next_split:" << next_split << ",directory_page_num:" << directory_page_num;
+  return ss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashBucketPage
+void LinearHashBucketPage::init_empty()
+{
+  set_item_num(0);
+  set_next_page(BP_INVALID_PAGE_NUM);
+}
+
+int LinearHashBucketPage::item_num() const
+{
+  int32_t num = 0;
+  memcpy(&num, data_, sizeof(num));
+  return num;
+}
+
+PageNum LinearHashBucketPage::next_page() const
+{
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  memcpy(&page_num, data_ + sizeof(int32_t), sizeof(page_num));
+  return page_num;
+}
+
+void LinearHashBucketPage::set_next_page(PageNum page_num) { memcpy(data_ + sizeof(int32_t), &page_num, sizeof(page_num)); }
+
+void LinearHashBucketPage::set_item_num(int num)
+{
+  int32_t value = num;
+  memcpy(data_, &value, sizeof(value));
+}
+
+void LinearHashBucketPage::insert_items(int index, const char *items, int num)
+{
+  const int old_num = item_num();
+  if (index < old_num) {
+    memmove(item_at(index + num), item_at(index), static_cast<size_t>(old_num - index) * item_size_);
+  }
+  memcpy(item_at(index), items, static_cast<size_t>(num) * item_size_);
+  set_item_num(old_num + num);
+}
+
+void LinearHashBucketPage::remove_items(int index, int num)
+{
+  const int old_num = item_num();
+  if (index + num < old_num) {
+    memmove(item_at(index), item_at(index + num), static_cast<size_t>(old_num - index - num) * item_size_);
+  }
+  set_item_num(old_num - num);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashDirectoryPage
+void LinearHashDirectoryPage::init_empty()
+{
+  for (int i = 0; i < SLOT_NUM; i++) {
+    set_page(i, BP_INVALID_PAGE_NUM);
+  }
+}
+
+PageNum LinearHashDirectoryPage::page_at(int slot) const
+{
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  memcpy(&page_num, data_ + slot * sizeof(PageNum), sizeof(page_num));
+  return page_num;
+}
+
+void LinearHashDirectoryPage::set_page(int slot, PageNum page_num)
+{
+  memcpy(data_ + slot * sizeof(PageNum), &page_num, sizeof(page_num));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashHandler
+LinearHashHandler::~LinearHashHandler() { close(); }
+
+RC LinearHashHandler::create(bool unique, LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+    const vector<const FieldMeta *> &field_metas, int bucket_capacity /* = -1 */,
+    int initial_bucket_num /* = DEFAULT_INITIAL_BUCKET_NUM */)
+{
+  RC rc = bpm.create_file(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to create file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  DiskBufferPool *bp = nullptr;
+
+  rc = bpm.open_file(log_handler, file_name, bp);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file. file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  rc = this->create(unique, log_handler, *bp, field_metas, bucket_capacity, initial_bucket_num);
+  if (OB_FAIL(rc)) {
+    bpm.close_file(file_name);
+    return rc;
+  }
+
+  LOG_INFO("Successfully create hash index file %s.", file_name);
+  return rc;
+}
+
+RC LinearHashHandler::create(bool unique, LogHandler &log_handler, DiskBufferPool &buffer_pool,
+    const vector<const FieldMeta *> &field_metas, int bucket_capacity /* = -1 */,
+    int initial_bucket_num /* = DEFAULT_INITIAL_BUCKET_NUM */)
+{
+  if (field_metas.empty() || static_cast<int>(field_metas.size()) > MAX_INDEX_FIELD_SIZE) {
+    LOG_WARN("invalid field number of hash index. field number=%d", static_cast<int>(field_metas.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+  if (initial_bucket_num <= 0 || initial_bucket_num > LinearHashDirectoryPage::SLOT_NUM) {
+    LOG_WARN("invalid initial bucket number of hash index. initial_bucket_num=%d", initial_bucket_num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  int attr_length = 0;
+  for (const FieldMeta *field_meta : field_metas) {
+    attr_length += field_meta->len();
+  }
+  const int key_length   = attr_length + static_cast<int>(sizeof(RID));
+  const int max_capacity = LinearHashBucketPage::capacity(key_length);
+  if (max_capacity <= 0) {
+    LOG_WARN("hash index key is too long. key_length=%d", key_length);
+    return RC::INVALID_ARGUMENT;
+  }
+  if (bucket_capacity <= 0 || bucket_capacity > max_capacity) {
+    bucket_capacity = max_capacity;
+  }
+
+  log_handler_      = &log_handler;
+  disk_buffer_pool_ = &buffer_pool;
+
+  // 刚创建的文件还没有别的地方可以访问，与B+树一样，这里不记录日志，直接把所有页面刷到磁盘
+  LatchMemo latch_memo(&buffer_pool);
+
+  Frame *header_frame = nullptr;
+
+  RC rc = latch_memo.allocate_page(header_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate header page for hash index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (header_frame->page_num() != FIRST_INDEX_PAGE) {
+    LOG_WARN("header page num should be %d but got %d. is it a new file", FIRST_INDEX_PAGE, header_frame->page_num());
+    return RC::INTERNAL;
+  }
+
+  auto *header = reinterpret_cast<LinearHashFileHeader *>(header_frame->data());
+  memset(header, 0, sizeof(LinearHashFileHeader));
+  header->unique             = unique;
+  header->key_length         = key_length;
+  header->attr_num           = static_cast<int32_t>(field_metas.size());
+  header->bucket_capacity    = bucket_capacity;
+  header->initial_bucket_num = initial_bucket_num;
+  header->level              = 0;
+  header->next_split         = 0;
+  for (size_t i = 0; i < field_metas.size(); i++) {
+    header->attr_type[i]   = field_metas[i]->type();
+    header->attr_offset[i] = field_metas[i]->offset();
+    header->attr_length[i] = field_metas[i]->len();
+  }
+  for (PageNum &page_num : header->directory_pages) {
+    page_num = BP_INVALID_PAGE_NUM;
+  }
+
+  Frame *directory_frame = nullptr;
+  rc                     = latch_memo.allocate_page(directory_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate directory page for hash index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LinearHashDirectoryPage directory_page(directory_frame->data());
+  directory_page.init_empty();
+  header->directory_pages[0]  = directory_frame->page_num();
+  header->directory_page_num  = 1;
+
+  for (int i = 0; i < initial_bucket_num; i++) {
+    Frame *bucket_frame = nullptr;
+    rc                  = latch_memo.allocate_page(bucket_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate bucket page for hash index. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    LinearHashBucketPage(bucket_frame->data(), key_length).init_empty();
+    bucket_frame->mark_dirty();
+    directory_page.set_page(i, bucket_frame->page_num());
+  }
+  directory_frame->mark_dirty();
+  header_frame->mark_dirty();
+
+  rc = buffer_pool.get_this_page(FIRST_INDEX_PAGE, &header_frame_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to pin header page of hash index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  attr_comparator_.init(header->attr_num, header->attr_type, header->attr_length);
+
+  rc = this->sync();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sync hash index. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("Successfully create hash index. header=%s", header->to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("%s has been opened before index.open.", file_name);
+    return RC::RECORD_OPENNED;
+  }
+
+  DiskBufferPool *disk_buffer_pool = nullptr;
+
+  RC rc = bpm.open_file(log_handler, file_name, disk_buffer_pool);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open file name=%s, rc=%d:%s", file_name, rc, strrc(rc));
+    return rc;
+  }
+
+  rc = this->open(log_handler, *disk_buffer_pool);
+  if (OB_SUCC(rc)) {
+    LOG_INFO("open hash index success. filename=%s", file_name);
+  }
+  return rc;
+}
+
+RC LinearHashHandler::open(LogHandler &log_handler, DiskBufferPool &buffer_pool)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("hash index has been opened before index.open.");
+    return RC::RECORD_OPENNED;
+  }
+
+  RC rc = buffer_pool.get_this_page(FIRST_INDEX_PAGE, &header_frame_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to get first page, rc=%d:%s", rc, strrc(rc));
+    return rc;
+  }
+
+  disk_buffer_pool_ = &buffer_pool;
+  log_handler_      = &log_handler;
+
+  auto *header = reinterpret_cast<LinearHashFileHeader *>(header_frame_->data());
+  attr_comparator_.init(header->attr_num, header->attr_type, header->attr_length);
+  LOG_INFO("Successfully open hash index. header=%s", header->to_string().c_str());
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::close()
+{
+  if (disk_buffer_pool_ != nullptr) {
+    if (header_frame_ != nullptr) {
+      disk_buffer_pool_->unpin_page(header_frame_);
+      header_frame_ = nullptr;
+    }
+    disk_buffer_pool_->close_file();
+  }
+
+  disk_buffer_pool_ = nullptr;
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::sync() { return disk_buffer_pool_->flush_all_pages(); }
+
+void LinearHashHandler::make_key(const char *user_key, const RID &rid, char *key) const
+{
+  const LinearHashFileHeader &header = file_header();
+
+  int offset = 0;
+  for (int i = 0; i < header.attr_num; i++) {
+    memcpy(key + offset, user_key + header.attr_offset[i], header.attr_length[i]);
+    offset += header.attr_length[i];
+  }
+  memcpy(key + offset, &rid, sizeof(rid));
+}
+
+uint32_t LinearHashHandler::hash(const char *key) const
+{
+  const LinearHashFileHeader &header = file_header();
+
+  uint32_t hash_value = 0;
+  int      offset     = 0;
+  for (int i = 0; i < header.attr_num; i++) {
+    const char *attr   = key + offset;
+    const int   length = header.attr_length[i];
+
+    uint32_t attr_hash = 0;
+    switch (header.attr_type[i]) {
+      case AttrType::CHARS: {
+        attr_hash = crc32(attr, static_cast<unsigned int>(strnlen(attr, length)));
+      } break;
+      case AttrType::FLOATS: {
+        float value = 0;
+        memcpy(&value, attr, sizeof(value));
+        if (value == 0) {
+          value = 0;  // -0 与 +0 比较时相等，哈希值也要相同
+        }
+        attr_hash = crc32(reinterpret_cast<const char *>(&value), sizeof(value));
+      } break;
+      default: {
+        attr_hash = crc32(attr, static_cast<unsigned int>(length));
+      } break;
+    }
+    hash_value = hash_value * 31 + attr_hash;
+    offset += length;
+  }
+  return hash_value;
+}
+
+int32_t LinearHashHandler::bucket_of(uint32_t hash_value) const
+{
+  const LinearHashFileHeader &header = file_header();
+
+  const uint32_t round_bucket_num = static_cast<uint32_t>(header.round_bucket_num());
+  uint32_t       bucket           = hash_value % round_bucket_num;
+  if (bucket < static_cast<uint32_t>(header.next_split)) {
+    bucket = hash_value % (round_bucket_num * 2);
+  }
+  return static_cast<int32_t>(bucket);
+}
+
+bool LinearHashHandler::same_key(const char *item1, const char *item2) const
+{
+  if (attr_comparator_(item1, item2) != 0) {
+    return false;
+  }
+  if (file_header().unique) {
+    return true;
+  }
+
+  const int attr_length = attr_comparator_.attr_length();
+  return RID::compare(reinterpret_cast<const RID *>(item1 + attr_length),
+                      reinterpret_cast<const RID *>(item2 + attr_length)) == 0;
+}
+
+RC LinearHashHandler::get_bucket_frame(
+    LatchMemo &latch_memo, const LinearHashFileHeader &header, int32_t bucket, Frame *&frame)
+{
+  const int directory_index = bucket / LinearHashDirectoryPage::SLOT_NUM;
+  if (directory_index >= header.directory_page_num) {
+    LOG_WARN("invalid bucket. bucket=%d, header=%s", bucket, header.to_string().c_str());
+    return RC::INTERNAL;
+  }
+
+  Frame *directory_frame = nullptr;
+
+  RC rc = latch_memo.get_page(header.directory_pages[directory_index], directory_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get directory page. page_num=%d, rc=%s", header.directory_pages[directory_index], strrc(rc));
+    return rc;
+  }
+
+  PageNum page_num =
+      LinearHashDirectoryPage(directory_frame->data()).page_at(bucket % LinearHashDirectoryPage::SLOT_NUM);
+  if (page_num == BP_INVALID_PAGE_NUM) {
+    LOG_WARN("bucket has no page. bucket=%d, header=%s", bucket, header.to_string().c_str());
+    return RC::INTERNAL;
+  }
+
+  rc = latch_memo.get_page(page_num, frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get bucket page. page_num=%d, rc=%s", page_num, strrc(rc));
+  }
+  return rc;
+}
+
+RC LinearHashHandler::allocate_bucket_page(LinearHashMiniTransaction &mtr, Frame *&frame)
+{
+  RC rc = mtr.latch_memo().allocate_page(frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate bucket page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LinearHashBucketPage(frame->data(), file_header().key_length).init_empty();
+  frame->mark_dirty();
+  return mtr.logger().bucket_init_empty(frame);
+}
+
+RC LinearHashHandler::append_overflow_page(LinearHashMiniTransaction &mtr, Frame *last_frame, Frame *&frame)
+{
+  RC rc = allocate_bucket_page(mtr, frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  LinearHashBucketPage last_page(last_frame->data(), file_header().key_length);
+  PageNum              old_page_num = last_page.next_page();
+  last_page.set_next_page(frame->page_num());
+  last_frame->mark_dirty();
+  return mtr.logger().bucket_set_next_page(last_frame, frame->page_num(), old_page_num);
+}
+
+RC LinearHashHandler::insert_items(
+    LinearHashMiniTransaction &mtr, Frame *frame, int index, const char *items, int item_num)
+{
+  const int key_length = file_header().key_length;
+  LinearHashBucketPage(frame->data(), key_length).insert_items(index, items, item_num);
+  frame->mark_dirty();
+  return mtr.logger().bucket_insert(
+      frame, index, span<const char>(items, static_cast<size_t>(item_num) * key_length), item_num);
+}
+
+RC LinearHashHandler::remove_items(LinearHashMiniTransaction &mtr, Frame *frame, int index, int item_num)
+{
+  const int            key_length = file_header().key_length;
+  LinearHashBucketPage page(frame->data(), key_length);
+  frame->mark_dirty();
+  RC rc = mtr.logger().bucket_remove(
+      frame, index, span<const char>(page.item_at(index), static_cast<size_t>(item_num) * key_length), item_num);
+  if (OB_SUCC(rc)) {
+    page.remove_items(index, item_num);
+  }
+  return rc;
+}
+
+RC LinearHashHandler::fill_bucket(LinearHashMiniTransaction &mtr, vector<Frame *> &frames, const vector<char> &items)
+{
+  const LinearHashFileHeader &header = file_header();
+
+  const int total_num = static_cast<int>(items.size()) / header.key_length;
+  int       filled    = 0;
+  for (size_t i = 0; filled < total_num; i++) {
+    if (i == frames.size()) {
+      Frame *frame = nullptr;
+      RC     rc    = append_overflow_page(mtr, frames.back(), frame);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+      frames.push_back(frame);
+    }
+
+    const int item_num = LinearHashBucketPage(frames[i]->data(), header.key_length).item_num();
+    const int fill_num = min(header.bucket_capacity - item_num, total_num - filled);
+    if (fill_num <= 0) {
+      continue;
+    }
+
+    RC rc = insert_items(mtr, frames[i], item_num, items.data() + filled * header.key_length, fill_num);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    filled += fill_num;
+  }
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::split_bucket(LinearHashMiniTransaction &mtr)
+{
+  LatchMemo &latch_memo = mtr.latch_memo();
+
+  const LinearHashFileHeader old_header = file_header();
+  LinearHashFileHeader       new_header = old_header;
+
+  const int32_t round_bucket_num = old_header.round_bucket_num();
+  const int32_t split_bucket     = old_header.next_split;
+  const int32_t new_bucket       = round_bucket_num + split_bucket;
+  const int     directory_index  = new_bucket / LinearHashDirectoryPage::SLOT_NUM;
+
+  RC rc = RC::SUCCESS;
+  if (directory_index >= old_header.directory_page_num) {
+    Frame *directory_frame = nullptr;
+    rc                     = latch_memo.allocate_page(directory_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate directory page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    LinearHashDirectoryPage(directory_frame->data()).init_empty();
+    directory_frame->mark_dirty();
+    rc = mtr.logger().directory_init_empty(directory_frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    new_header.directory_pages[directory_index] = directory_frame->page_num();
+    new_header.directory_page_num               = directory_index + 1;
+  }
+
+  Frame *new_frame = nullptr;
+  rc               = allocate_bucket_page(mtr, new_frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 收集旧桶中的页面，按照下一轮的哈希范围把键值对分成留下的和搬走的两部分
+  vector<Frame *> old_frames;
+  Frame          *frame = nullptr;
+  rc                    = get_bucket_frame(latch_memo, old_header, split_bucket, frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int    key_length = old_header.key_length;
+  vector<char> staying_items;
+  vector<char> moving_items;
+  while (true) {
+    old_frames.push_back(frame);
+
+    LinearHashBucketPage page(frame->data(), key_length);
+    for (int i = 0; i < page.item_num(); i++) {
+      const char *item   = page.item_at(i);
+      const bool  moving = hash(item) % static_cast<uint32_t>(round_bucket_num * 2) == static_cast<uint32_t>(new_bucket);
+      vector<char> &items = moving ? moving_items : staying_items;
+      items.insert(items.end(), item, item + key_length);
+    }
+
+    PageNum next_page = page.next_page();
+    if (next_page == BP_INVALID_PAGE_NUM) {
+      break;
+    }
+    rc = latch_memo.get_page(next_page, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page_num=%d, rc=%s", next_page, strrc(rc));
+      return rc;
+    }
+  }
+
+  auto set_directory_page = [&](int32_t bucket, PageNum page_num) {
+    Frame *directory_frame = nullptr;
+    RC     rc              = latch_memo.get_page(
+        new_header.directory_pages[bucket / LinearHashDirectoryPage::SLOT_NUM], directory_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get directory page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    LinearHashDirectoryPage directory_page(directory_frame->data());
+    const int               slot         = bucket % LinearHashDirectoryPage::SLOT_NUM;
+    PageNum                 old_page_num = directory_page.page_at(slot);
+    directory_page.set_page(slot, page_num);
+    directory_frame->mark_dirty();
+    return mtr.logger().directory_set_page(directory_frame, slot, page_num, old_page_num);
+  };
+
+  if (staying_items.empty() && !moving_items.empty()) {
+    // 所有的数据都要搬走，直接把整个链表交给新桶，不用逐个复制
+    rc = set_directory_page(new_bucket, old_frames.front()->page_num());
+    if (OB_SUCC(rc)) {
+      rc = set_directory_page(split_bucket, new_frame->page_num());
+    }
+  } else {
+    rc = set_directory_page(new_bucket, new_frame->page_num());
+    if (OB_SUCC(rc) && !moving_items.empty()) {
+      for (Frame *old_frame : old_frames) {
+        const int item_num = LinearHashBucketPage(old_frame->data(), key_length).item_num();
+        if (item_num > 0) {
+          rc = remove_items(mtr, old_frame, 0, item_num);
+          if (OB_FAIL(rc)) {
+            return rc;
+          }
+        }
+      }
+
+      rc = fill_bucket(mtr, old_frames, staying_items);
+      if (OB_SUCC(rc)) {
+        vector<Frame *> new_frames{new_frame};
+        rc = fill_bucket(mtr, new_frames, moving_items);
+      }
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to split bucket. bucket=%d, rc=%s", split_bucket, strrc(rc));
+    return rc;
+  }
+
+  new_header.next_split++;
+  if (new_header.next_split == round_bucket_num) {
+    new_header.level++;
+    new_header.next_split = 0;
+  }
+
+  memcpy(header_frame_->data(), &new_header, sizeof(new_header));
+  header_frame_->mark_dirty();
+  rc = mtr.logger().update_header(header_frame_, new_header, old_header);
+  LOG_DEBUG("split bucket %d into %d. header=%s", split_bucket, new_bucket, new_header.to_string().c_str());
+  return rc;
+}
+
+RC LinearHashHandler::insert_entry(const char *user_key, const RID *rid)
+{
+  RC                        rc = RC::SUCCESS;
+  LinearHashMiniTransaction mtr(*this, &rc);
+  LatchMemo                &latch_memo = mtr.latch_memo();
+  latch_memo.xlatch(&lock_);
+
+  const LinearHashFileHeader &header = file_header();
+
+  vector<char> item(header.key_length);
+  make_key(user_key, *rid, item.data());
+
+  Frame *frame = nullptr;
+  rc           = get_bucket_frame(latch_memo, header, bucket_of(hash(item.data())), frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 检查整个桶中有没有重复的键值，同时找到第一个还有空位的页面
+  Frame *target_frame = nullptr;
+  while (true) {
+    LinearHashBucketPage page(frame->data(), header.key_length);
+    for (int i = 0; i < page.item_num(); i++) {
+      if (same_key(page.item_at(i), item.data())) {
+        rc = RC::RECORD_DUPLICATE_KEY;
+        return rc;
+      }
+    }
+    if (target_frame == nullptr && page.item_num() < header.bucket_capacity) {
+      target_frame = frame;
+    }
+
+    PageNum next_page = page.next_page();
+    if (next_page == BP_INVALID_PAGE_NUM) {
+      break;
+    }
+    rc = latch_memo.get_page(next_page, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page_num=%d, rc=%s", next_page, strrc(rc));
+      return rc;
+    }
+  }
+
+  bool overflow = false;
+  if (target_frame == nullptr) {
+    rc = append_overflow_page(mtr, frame, target_frame);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    overflow = true;
+  }
+
+  const int item_num = LinearHashBucketPage(target_frame->data(), header.key_length).item_num();
+  rc                 = insert_items(mtr, target_frame, item_num, item.data(), 1);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 有桶放满了才分裂，这样数据量不变时桶数也不会增加
+  if (overflow && header.bucket_num() < max_bucket_num()) {
+    rc = split_bucket(mtr);
+  }
+  return rc;
+}
+
+RC LinearHashHandler::delete_entry(const char *user_key, const RID *rid)
+{
+  RC                        rc = RC::SUCCESS;
+  LinearHashMiniTransaction mtr(*this, &rc);
+  LatchMemo                &latch_memo = mtr.latch_memo();
+  latch_memo.xlatch(&lock_);
+
+  const LinearHashFileHeader &header = file_header();
+
+  vector<char> item(header.key_length);
+  make_key(user_key, *rid, item.data());
+
+  Frame *frame = nullptr;
+  rc           = get_bucket_frame(latch_memo, header, bucket_of(hash(item.data())), frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int attr_length = attr_comparator_.attr_length();
+  while (true) {
+    LinearHashBucketPage page(frame->data(), header.key_length);
+    for (int i = 0; i < page.item_num(); i++) {
+      const char *page_item = page.item_at(i);
+      if (attr_comparator_(page_item, item.data()) == 0 &&
+          RID::compare(reinterpret_cast<const RID *>(page_item + attr_length), rid) == 0) {
+        rc = remove_items(mtr, frame, i, 1);
+        return rc;
+      }
+    }
+
+    PageNum next_page = page.next_page();
+    if (next_page == BP_INVALID_PAGE_NUM) {
+      break;
+    }
+    rc = latch_memo.get_page(next_page, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page_num=%d, rc=%s", next_page, strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = RC::RECORD_NOT_EXIST;
+  return rc;
+}
+
+RC LinearHashHandler::get_items(const char *user_key, vector<char> &items)
+{
+  LatchMemo latch_memo(disk_buffer_pool_);
+  latch_memo.slatch(&lock_);
+
+  const LinearHashFileHeader &header = file_header();
+
+  vector<char> key(header.key_length);
+  make_key(user_key, RID(0, 0), key.data());
+
+  Frame *frame = nullptr;
+  RC     rc    = get_bucket_frame(latch_memo, header, bucket_of(hash(key.data())), frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  while (true) {
+    LinearHashBucketPage page(frame->data(), header.key_length);
+    for (int i = 0; i < page.item_num(); i++) {
+      const char *item = page.item_at(i);
+      if (attr_comparator_(item, key.data()) == 0) {
+        items.insert(items.end(), item, item + header.key_length);
+      }
+    }
+
+    PageNum next_page = page.next_page();
+    if (next_page == BP_INVALID_PAGE_NUM) {
+      break;
+    }
+    rc = latch_memo.get_page(next_page, frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page_num=%d, rc=%s", next_page, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::get_entry(const char *user_key, vector<RID> &rids)
+{
+  vector<char> items;
+
+  RC rc = get_items(user_key, items);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  const int key_length  = file_header().key_length;
+  const int attr_length = attr_comparator_.attr_length();
+  for (size_t offset = 0; offset < items.size(); offset += key_length) {
+    RID rid;
+    memcpy(&rid, items.data() + offset + attr_length, sizeof(rid));
+    rids.push_back(rid);
+  }
+  return RC::SUCCESS;
+}
+
+RC LinearHashHandler::scan(const function<RC(const char *item)> &visitor)
+{
+  LatchMemo latch_memo(disk_buffer_pool_);
+  latch_memo.slatch(&lock_);
+
+  const LinearHashFileHeader &header = file_header();
+
+  RC rc = RC::SUCCESS;
+  for (int32_t bucket = 0; OB_SUCC(rc) && bucket < header.bucket_num(); bucket++) {
+    // 每个桶访问完就释放页面，避免同时 pin 住太多页面
+    const int memo_point = latch_memo.memo_point();
+
+    Frame *frame = nullptr;
+    rc           = get_bucket_frame(latch_memo, header, bucket, frame);
+    while (OB_SUCC(rc)) {
+      LinearHashBucketPage page(frame->data(), header.key_length);
+      for (int i = 0; OB_SUCC(rc) && i < page.item_num(); i++) {
+        rc = visitor(page.item_at(i));
+      }
+
+      PageNum next_page = page.next_page();
+      if (OB_FAIL(rc) || next_page == BP_INVALID_PAGE_NUM) {
+        break;
+      }
+      rc = latch_memo.get_page(next_page, frame);
+    }
+
+    latch_memo.release_from(memo_point);
+  }
+  return rc;
+}
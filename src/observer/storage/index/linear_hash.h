@@ -0,0 +1,235 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/functional.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/latch_memo.h"
+
+class LinearHashMiniTransaction;
+
+/**
+ * @brief 线性哈希表
+ * @defgroup LinearHash
+ * @details 磁盘上的线性哈希表，用作哈希索引。桶的个数每次增加一个：某个桶需要溢出页面时，分裂 next_split 指向的桶，
+ * 把其中的一部分数据按照新的哈希范围搬到新桶里。桶由一个主页面和若干个溢出页面串成的链表组成，桶号到主页面的映射
+ * 记录在目录页面中。所有的页面都由缓冲池管理，修改页面时记录日志，可以回滚和重做，参考 LinearHashLogger。
+ */
+
+/**
+ * @brief 线性哈希表的文件头
+ * @ingroup LinearHash
+ * @details 存放在文件的第一个页面中，打开文件后一直 pin 在内存里。
+ * 第 b 个桶的主页面记录在第 b / LinearHashDirectoryPage::SLOT_NUM 个目录页面的对应位置上
+ */
+struct LinearHashFileHeader
+{
+  static constexpr int MAX_DIRECTORY_PAGES = 64;
+
+  bool     unique;
+  int32_t  key_length;  ///< attr length + sizeof(RID)
+  int32_t  attr_num;    ///< 索引列数量
+  int32_t  attr_length[MAX_INDEX_FIELD_SIZE];
+  int32_t  attr_offset[MAX_INDEX_FIELD_SIZE];  ///< 键值在record中的offset
+  AttrType attr_type[MAX_INDEX_FIELD_SIZE];
+  int32_t  bucket_capacity;     ///< 每个页面最多存放的键值对数
+  int32_t  initial_bucket_num;  ///< 初始的桶数
+  int32_t  level;               ///< 已经完成的分裂轮数，每一轮之后桶数翻倍
+  int32_t  next_split;          ///< 本轮下一个要分裂的桶
+  int32_t  directory_page_num;  ///< 目录页面的个数
+  PageNum  directory_pages[MAX_DIRECTORY_PAGES];
+
+  int32_t attr_length_sum() const { return key_length - static_cast<int32_t>(sizeof(RID)); }
+
+  /// 本轮开始时的桶数
+  int32_t round_bucket_num() const { return initial_bucket_num << level; }
+  int32_t bucket_num() const { return round_bucket_num() + next_split; }
+
+  string to_string() const;
+};
+
+/**
+ * @brief 桶页面
+ * @ingroup LinearHash
+ * @code
+ * | item number | next page | key0, rid0 | key1, rid1 | ... |
+ * @endcode
+ * 键值对不排序，删除时后面的键值对向前移动
+ */
+class LinearHashBucketPage
+{
+public:
+  static constexpr int HEADER_SIZE = 8;
+
+  LinearHashBucketPage(char *data, int item_size) : data_(data), item_size_(item_size) {}
+
+  static int capacity(int item_size) { return (BP_PAGE_DATA_SIZE - HEADER_SIZE) / item_size; }
+
+  void init_empty();
+
+  int     item_num() const;
+  PageNum next_page() const;
+  void    set_next_page(PageNum page_num);
+
+  char *item_at(int index) { return data_ + HEADER_SIZE + index * item_size_; }
+
+  void insert_items(int index, const char *items, int num);
+  void remove_items(int index, int num);
+
+private:
+  void set_item_num(int num);
+
+private:
+  char *data_      = nullptr;
+  int   item_size_ = 0;
+};
+
+/**
+ * @brief 目录页面，按照桶号依次存放每个桶的主页面编号
+ * @ingroup LinearHash
+ */
+class LinearHashDirectoryPage
+{
+public:
+  static constexpr int SLOT_NUM = BP_PAGE_DATA_SIZE / static_cast<int>(sizeof(PageNum));
+
+  explicit LinearHashDirectoryPage(char *data) : data_(data) {}
+
+  void    init_empty();
+  PageNum page_at(int slot) const;
+  void    set_page(int slot, PageNum page_num);
+
+private:
+  char *data_ = nullptr;
+};
+
+/**
+ * @brief 线性哈希表
+ * @ingroup LinearHash
+ * @details 键值与B+树一样是索引字段拼接起来再加上RID。只能做等值查找。
+ * 哈希值与 AttrComparator 的比较结果保持一致：字符串只取第一个'\0'之前的部分，浮点数的 -0 与 +0 相同。
+ * 但是浮点数比较时允许 EPSILON 的误差，哈希做不到，只有二进制表示相同的浮点数才能查找到。
+ * 删除数据后不会合并桶，空出来的位置留给之后插入的数据。
+ * 修改操作之间用一个读写锁互斥，查找操作可以并发执行。因为修改和查找不会同时访问页面，页面只需要 pin 住，不再加页面锁，
+ * 这样分裂时也不用担心与插入重复加锁同一个桶。
+ */
+class LinearHashHandler
+{
+public:
+  LinearHashHandler() = default;
+  ~LinearHashHandler();
+
+  /**
+   * @brief 创建一个线性哈希表
+   * @param bucket_capacity 每个页面最多存放的键值对数，小于0时放满页面。用于测试
+   * @param initial_bucket_num 初始的桶数
+   */
+  RC create(bool unique, LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name,
+      const vector<const FieldMeta *> &field_metas, int bucket_capacity = -1,
+      int initial_bucket_num = DEFAULT_INITIAL_BUCKET_NUM);
+  RC create(bool unique, LogHandler &log_handler, DiskBufferPool &buffer_pool,
+      const vector<const FieldMeta *> &field_metas, int bucket_capacity = -1,
+      int initial_bucket_num = DEFAULT_INITIAL_BUCKET_NUM);
+
+  RC open(LogHandler &log_handler, BufferPoolManager &bpm, const char *file_name);
+  RC open(LogHandler &log_handler, DiskBufferPool &buffer_pool);
+
+  RC close();
+  RC sync();
+
+  /**
+   * @brief 插入一个键值对
+   * @param user_key 记录的格式，索引字段在 attr_offset 处
+   * @return 唯一索引中字段的值已经存在，或者同样的键值对已经存在时返回 RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 删除一个键值对
+   * @return 不存在时返回 RECORD_NOT_EXIST
+   */
+  RC delete_entry(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 查找索引字段的值与 user_key 相同的所有数据
+   * @param user_key 记录的格式
+   * @param[out] items 追加找到的键值对，每个键值对的长度是 key_length
+   */
+  RC get_items(const char *user_key, vector<char> &items);
+
+  /// 与 get_items 相同，只返回RID
+  RC get_entry(const char *user_key, vector<RID> &rids);
+
+  /**
+   * @brief 依次访问所有的键值对，没有顺序
+   * @details 访问期间不允许修改。visitor 返回失败时停止访问
+   */
+  RC scan(const function<RC(const char *item)> &visitor);
+
+  /// @brief 从记录中取出索引字段，加上RID组成键值对
+  void make_key(const char *user_key, const RID &rid, char *key) const;
+
+  const LinearHashFileHeader &file_header() const
+  {
+    return *reinterpret_cast<const LinearHashFileHeader *>(header_frame_->data());
+  }
+  const AttrComparator &attr_comparator() const { return attr_comparator_; }
+
+  DiskBufferPool &buffer_pool() const { return *disk_buffer_pool_; }
+  LogHandler     &log_handler() const { return *log_handler_; }
+  Frame          *header_frame() const { return header_frame_; }
+
+  /// 目录页面放满时的桶数，之后不再分裂，只增加溢出页面
+  static constexpr int32_t max_bucket_num()
+  {
+    return LinearHashFileHeader::MAX_DIRECTORY_PAGES * LinearHashDirectoryPage::SLOT_NUM;
+  }
+
+  static constexpr int DEFAULT_INITIAL_BUCKET_NUM = 4;
+
+private:
+  /// 键值对中索引字段部分的哈希值
+  uint32_t hash(const char *key) const;
+
+  /// 按照当前的桶数，哈希值对应的桶
+  int32_t bucket_of(uint32_t hash_value) const;
+
+  /// 找到桶的主页面
+  RC get_bucket_frame(LatchMemo &latch_memo, const LinearHashFileHeader &header, int32_t bucket, Frame *&frame);
+
+  /// 分配一个空的桶页面
+  RC allocate_bucket_page(LinearHashMiniTransaction &mtr, Frame *&frame);
+
+  /// 分配一个溢出页面，挂在 last_frame 之后
+  RC append_overflow_page(LinearHashMiniTransaction &mtr, Frame *last_frame, Frame *&frame);
+
+  RC insert_items(LinearHashMiniTransaction &mtr, Frame *frame, int index, const char *items, int item_num);
+  RC remove_items(LinearHashMiniTransaction &mtr, Frame *frame, int index, int item_num);
+
+  /// 把键值对依次放进 frames 中的页面，页面不够时增加溢出页面
+  RC fill_bucket(LinearHashMiniTransaction &mtr, vector<Frame *> &frames, const vector<char> &items);
+
+  /// 分裂 next_split 指向的桶
+  RC split_bucket(LinearHashMiniTransaction &mtr);
+
+  /// 唯一索引比较索引字段，否则比较整个键值对
+  bool same_key(const char *item1, const char *item2) const;
+
+private:
+  LogHandler         *log_handler_      = nullptr;
+  DiskBufferPool     *disk_buffer_pool_ = nullptr;
+  Frame              *header_frame_     = nullptr;  ///< 文件头页面，一直 pin 在内存中
+  AttrComparator      attr_comparator_;
+  common::SharedMutex lock_;  ///< 修改时加写锁，查找时加读锁
+};
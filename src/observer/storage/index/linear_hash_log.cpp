@@ -0,0 +1,453 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/linear_hash_log.h"
+#include "common/lang/serializer.h"
+#include "common/lang/sstream.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/frame.h"
+#include "storage/clog/log_entry.h"
+#include "storage/clog/log_handler.h"
+#include "storage/index/linear_hash.h"
+
+using namespace common;
+
+string LinearHashLogOperation::to_string() const
+{
+  stringstream ss;
+  ss << std::to_string(index()) << ":";
+  switch (type_) {
+    case Type::UPDATE_HEADER: ss << "UPDATE_HEADER"; break;
+    case Type::DIRECTORY_INIT_EMPTY: ss << "DIRECTORY_INIT_EMPTY"; break;
+    case Type::DIRECTORY_SET_PAGE: ss << "DIRECTORY_SET_PAGE"; break;
+    case Type::BUCKET_INIT_EMPTY: ss << "BUCKET_INIT_EMPTY"; break;
+    case Type::BUCKET_SET_NEXT_PAGE: ss << "BUCKET_SET_NEXT_PAGE"; break;
+    case Type::BUCKET_INSERT: ss << "BUCKET_INSERT"; break;
+    case Type::BUCKET_REMOVE: ss << "BUCKET_REMOVE"; break;
+    default: ss << "INVALID"; break;
+  }
+  return ss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashLogEntry
+LinearHashLogEntry::LinearHashLogEntry(LinearHashLogOperation operation, Frame *frame)
+    : operation_(operation), frame_(frame), page_num_(frame->page_num())
+{}
+
+static int write_bytes(Serializer &buffer, const vector<char> &bytes)
+{
+  int ret = buffer.write_int32(static_cast<int32_t>(bytes.size()));
+  if (ret == 0 && !bytes.empty()) {
+    ret = buffer.write(bytes.data(), static_cast<int>(bytes.size()));
+  }
+  return ret;
+}
+
+static int read_bytes(Deserializer &buffer, vector<char> &bytes)
+{
+  int32_t size = 0;
+  int     ret  = buffer.read_int32(size);
+  if (ret != 0 || size < 0 || size > buffer.remain()) {
+    return -1;
+  }
+  bytes.resize(size);
+  return size == 0 ? 0 : buffer.read(bytes.data(), size);
+}
+
+RC LinearHashLogEntry::serialize(Serializer &buffer) const
+{
+  int ret = buffer.write_int32(operation_.index());
+  if (ret == 0) {
+    ret = buffer.write_int32(page_num_);
+  }
+
+  switch (operation_.type()) {
+    case LinearHashLogOperation::Type::UPDATE_HEADER: {
+      if (ret == 0) {
+        ret = write_bytes(buffer, data);
+      }
+      if (ret == 0) {
+        ret = write_bytes(buffer, old_data);
+      }
+    } break;
+    case LinearHashLogOperation::Type::DIRECTORY_SET_PAGE:
+    case LinearHashLogOperation::Type::BUCKET_SET_NEXT_PAGE: {
+      for (int32_t value : {slot, new_page, old_page}) {
+        if (ret == 0) {
+          ret = buffer.write_int32(value);
+        }
+      }
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_INSERT:
+    case LinearHashLogOperation::Type::BUCKET_REMOVE: {
+      if (ret == 0) {
+        ret = buffer.write_int32(slot);
+      }
+      if (ret == 0) {
+        ret = buffer.write_int32(item_num);
+      }
+      if (ret == 0) {
+        ret = write_bytes(buffer, data);
+      }
+    } break;
+    default: break;
+  }
+  return ret == 0 ? RC::SUCCESS : RC::INTERNAL;
+}
+
+RC LinearHashLogEntry::deserialize(Deserializer &buffer, LinearHashLogEntry &entry)
+{
+  int32_t type = -1;
+  int     ret  = buffer.read_int32(type);
+  if (ret != 0 || type < 0 || type >= static_cast<int32_t>(LinearHashLogOperation::Type::MAX_TYPE)) {
+    return RC::INVALID_ARGUMENT;
+  }
+  entry.operation_ = LinearHashLogOperation(type);
+  entry.frame_     = nullptr;
+
+  ret = buffer.read_int32(entry.page_num_);
+  switch (entry.operation_.type()) {
+    case LinearHashLogOperation::Type::UPDATE_HEADER: {
+      if (ret == 0) {
+        ret = read_bytes(buffer, entry.data);
+      }
+      if (ret == 0) {
+        ret = read_bytes(buffer, entry.old_data);
+      }
+    } break;
+    case LinearHashLogOperation::Type::DIRECTORY_SET_PAGE:
+    case LinearHashLogOperation::Type::BUCKET_SET_NEXT_PAGE: {
+      for (int32_t *value : {&entry.slot, &entry.new_page, &entry.old_page}) {
+        if (ret == 0) {
+          ret = buffer.read_int32(*value);
+        }
+      }
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_INSERT:
+    case LinearHashLogOperation::Type::BUCKET_REMOVE: {
+      if (ret == 0) {
+        ret = buffer.read_int32(entry.slot);
+      }
+      if (ret == 0) {
+        ret = buffer.read_int32(entry.item_num);
+      }
+      if (ret == 0) {
+        ret = read_bytes(buffer, entry.data);
+      }
+      if (ret == 0 && (entry.item_num <= 0 || entry.data.size() % entry.item_num != 0)) {
+        ret = -1;
+      }
+    } break;
+    default: break;
+  }
+  return ret == 0 ? RC::SUCCESS : RC::INVALID_ARGUMENT;
+}
+
+RC LinearHashLogEntry::redo()
+{
+  char *page_data = frame_->data();
+  switch (operation_.type()) {
+    case LinearHashLogOperation::Type::UPDATE_HEADER: {
+      memcpy(page_data, data.data(), data.size());
+    } break;
+    case LinearHashLogOperation::Type::DIRECTORY_INIT_EMPTY: {
+      LinearHashDirectoryPage(page_data).init_empty();
+    } break;
+    case LinearHashLogOperation::Type::DIRECTORY_SET_PAGE: {
+      LinearHashDirectoryPage(page_data).set_page(slot, new_page);
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_INIT_EMPTY: {
+      LinearHashBucketPage(page_data, 0).init_empty();
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_SET_NEXT_PAGE: {
+      LinearHashBucketPage(page_data, 0).set_next_page(new_page);
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_INSERT: {
+      LinearHashBucketPage(page_data, static_cast<int>(data.size()) / item_num).insert_items(slot, data.data(), item_num);
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_REMOVE: {
+      LinearHashBucketPage(page_data, static_cast<int>(data.size()) / item_num).remove_items(slot, item_num);
+    } break;
+    default: {
+      LOG_ERROR("unknown linear hash log operation. operation=%s", operation_.to_string().c_str());
+      return RC::INTERNAL;
+    }
+  }
+  frame_->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogEntry::rollback()
+{
+  char *page_data = frame_->data();
+  switch (operation_.type()) {
+    case LinearHashLogOperation::Type::UPDATE_HEADER: {
+      memcpy(page_data, old_data.data(), old_data.size());
+    } break;
+    case LinearHashLogOperation::Type::DIRECTORY_SET_PAGE: {
+      LinearHashDirectoryPage(page_data).set_page(slot, old_page);
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_SET_NEXT_PAGE: {
+      LinearHashBucketPage(page_data, 0).set_next_page(old_page);
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_INSERT: {
+      LinearHashBucketPage(page_data, static_cast<int>(data.size()) / item_num).remove_items(slot, item_num);
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_REMOVE: {
+      LinearHashBucketPage(page_data, static_cast<int>(data.size()) / item_num).insert_items(slot, data.data(), item_num);
+    } break;
+    default: {
+      // 新分配的页面不需要回滚，没有地方引用它们
+    } break;
+  }
+  frame_->mark_dirty();
+  return RC::SUCCESS;
+}
+
+string LinearHashLogEntry::to_string() const
+{
+  stringstream ss;
+  ss << "operation=" << operation_.to_string() << ", page_num=" << page_num_;
+  switch (operation_.type()) {
+    case LinearHashLogOperation::Type::UPDATE_HEADER: {
+      if (data.size() >= sizeof(LinearHashFileHeader)) {
+        ss << ", header=" << reinterpret_cast<const LinearHashFileHeader *>(data.data())->to_string();
+      }
+    } break;
+    case LinearHashLogOperation::Type::DIRECTORY_SET_PAGE:
+    case LinearHashLogOperation::Type::BUCKET_SET_NEXT_PAGE: {
+      ss << ", slot=" << slot << ", new_page=" << new_page << ", old_page=" << old_page;
+    } break;
+    case LinearHashLogOperation::Type::BUCKET_INSERT:
+    case LinearHashLogOperation::Type::BUCKET_REMOVE: {
+      ss << ", index=" << slot << ", item_num=" << item_num;
+    } break;
+    default: break;
+  }
+  return ss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashLogger
+LinearHashLogger::LinearHashLogger(LogHandler &log_handler, int32_t buffer_pool_id)
+    : log_handler_(log_handler), buffer_pool_id_(buffer_pool_id)
+{}
+
+LinearHashLogger::~LinearHashLogger() { commit(); }
+
+RC LinearHashLogger::update_header(
+    Frame *frame, const LinearHashFileHeader &header, const LinearHashFileHeader &old_header)
+{
+  LinearHashLogEntry entry(LinearHashLogOperation::Type::UPDATE_HEADER, frame);
+  entry.data.assign(reinterpret_cast<const char *>(&header), reinterpret_cast<const char *>(&header + 1));
+  entry.old_data.assign(reinterpret_cast<const char *>(&old_header), reinterpret_cast<const char *>(&old_header + 1));
+  return append_log_entry(std::move(entry));
+}
+
+RC LinearHashLogger::directory_init_empty(Frame *frame)
+{
+  return append_log_entry(LinearHashLogEntry(LinearHashLogOperation::Type::DIRECTORY_INIT_EMPTY, frame));
+}
+
+RC LinearHashLogger::directory_set_page(Frame *frame, int slot, PageNum page_num, PageNum old_page_num)
+{
+  LinearHashLogEntry entry(LinearHashLogOperation::Type::DIRECTORY_SET_PAGE, frame);
+  entry.slot     = slot;
+  entry.new_page = page_num;
+  entry.old_page = old_page_num;
+  return append_log_entry(std::move(entry));
+}
+
+RC LinearHashLogger::bucket_init_empty(Frame *frame)
+{
+  return append_log_entry(LinearHashLogEntry(LinearHashLogOperation::Type::BUCKET_INIT_EMPTY, frame));
+}
+
+RC LinearHashLogger::bucket_set_next_page(Frame *frame, PageNum page_num, PageNum old_page_num)
+{
+  LinearHashLogEntry entry(LinearHashLogOperation::Type::BUCKET_SET_NEXT_PAGE, frame);
+  entry.new_page = page_num;
+  entry.old_page = old_page_num;
+  return append_log_entry(std::move(entry));
+}
+
+RC LinearHashLogger::bucket_insert(Frame *frame, int index, span<const char> items, int item_num)
+{
+  LinearHashLogEntry entry(LinearHashLogOperation::Type::BUCKET_INSERT, frame);
+  entry.slot     = index;
+  entry.item_num = item_num;
+  entry.data.assign(items.begin(), items.end());
+  return append_log_entry(std::move(entry));
+}
+
+RC LinearHashLogger::bucket_remove(Frame *frame, int index, span<const char> items, int item_num)
+{
+  LinearHashLogEntry entry(LinearHashLogOperation::Type::BUCKET_REMOVE, frame);
+  entry.slot     = index;
+  entry.item_num = item_num;
+  entry.data.assign(items.begin(), items.end());
+  return append_log_entry(std::move(entry));
+}
+
+RC LinearHashLogger::append_log_entry(LinearHashLogEntry entry)
+{
+  entries_.push_back(std::move(entry));
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::commit()
+{
+  if (entries_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  Serializer buffer;
+  buffer.write_int32(buffer_pool_id_);
+  for (const LinearHashLogEntry &entry : entries_) {
+    RC rc = entry.serialize(buffer);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to serialize linear hash log entry. entry=%s, rc=%s", entry.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+
+  LSN lsn = 0;
+  RC  rc  = log_handler_.append(lsn, LogModule::Id::HASH_INDEX, std::move(buffer.data()));
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to append log entry. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  for (LinearHashLogEntry &entry : entries_) {
+    entry.frame()->set_lsn(lsn);
+  }
+  entries_.clear();
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::rollback()
+{
+  for (auto iter = entries_.rbegin(), itend = entries_.rend(); iter != itend; ++iter) {
+    iter->rollback();
+  }
+  entries_.clear();
+  return RC::SUCCESS;
+}
+
+RC LinearHashLogger::redo(BufferPoolManager &bpm, const LogEntry &entry)
+{
+  ASSERT(entry.module().id() == LogModule::Id::HASH_INDEX, "invalid log entry: %s", entry.to_string().c_str());
+
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  if (buffer.read_int32(buffer_pool_id) != 0) {
+    LOG_ERROR("failed to read buffer pool id");
+    return RC::IOERR_READ;
+  }
+
+  DiskBufferPool *buffer_pool = nullptr;
+  RC              rc          = bpm.get_buffer_pool(buffer_pool_id, buffer_pool);
+  if (OB_FAIL(rc) || buffer_pool == nullptr) {
+    LOG_WARN("failed to get buffer pool. rc=%s, buffer_pool_id=%d", strrc(rc), buffer_pool_id);
+    return rc;
+  }
+
+  // 一条日志中可能多次修改同一个页面，所有的修改都重做完以后再设置页面的LSN
+  vector<Frame *> frames;
+  while (OB_SUCC(rc) && buffer.remain() > 0) {
+    LinearHashLogEntry log_entry;
+    rc = LinearHashLogEntry::deserialize(buffer, log_entry);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to deserialize linear hash log entry. lsn=%ld, rc=%s", entry.lsn(), strrc(rc));
+      break;
+    }
+
+    Frame *frame = nullptr;
+    rc           = buffer_pool->get_this_page(log_entry.page_num(), &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get page. page_num=%d, rc=%s", log_entry.page_num(), strrc(rc));
+      break;
+    }
+
+    if (frame->lsn() >= entry.lsn()) {
+      LOG_TRACE("no need to redo. frame=%s, redo lsn=%ld", frame->to_string().c_str(), entry.lsn());
+      frame->unpin();
+      continue;
+    }
+
+    frames.push_back(frame);
+    log_entry.set_frame(frame);
+    rc = log_entry.redo();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to redo linear hash log entry. entry=%s, rc=%s", log_entry.to_string().c_str(), strrc(rc));
+    }
+  }
+
+  for (Frame *frame : frames) {
+    if (OB_SUCC(rc)) {
+      frame->set_lsn(entry.lsn());
+    }
+    frame->unpin();
+  }
+  return rc;
+}
+
+string LinearHashLogger::log_entry_to_string(const LogEntry &entry)
+{
+  stringstream ss;
+  Deserializer buffer(entry.data(), entry.payload_size());
+  int32_t      buffer_pool_id = -1;
+  if (buffer.read_int32(buffer_pool_id) != 0) {
+    return ss.str();
+  }
+
+  ss << "buffer_pool_id:" << buffer_pool_id;
+  while (buffer.remain() > 0) {
+    LinearHashLogEntry log_entry;
+    if (OB_FAIL(LinearHashLogEntry::deserialize(buffer, log_entry))) {
+      break;
+    }
+    ss << "," << log_entry.to_string();
+  }
+  return ss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashMiniTransaction
+LinearHashMiniTransaction::LinearHashMiniTransaction(LinearHashHandler &handler, RC *operation_result /* = nullptr */)
+    : operation_result_(operation_result),
+      latch_memo_(&handler.buffer_pool()),
+      logger_(handler.log_handler(), handler.buffer_pool().id())
+{}
+
+LinearHashMiniTransaction::~LinearHashMiniTransaction()
+{
+  if (nullptr == operation_result_) {
+    return;
+  }
+
+  if (OB_SUCC(*operation_result_)) {
+    commit();
+  } else {
+    rollback();
+  }
+}
+
+RC LinearHashMiniTransaction::commit() { return logger_.commit(); }
+
+RC LinearHashMiniTransaction::rollback() { return logger_.rollback(); }
+
+///////////////////////////////////////////////////////////////////////////////
+// class LinearHashLogReplayer
+LinearHashLogReplayer::LinearHashLogReplayer(BufferPoolManager &bpm) : buffer_pool_manager_(bpm) {}
+
+RC LinearHashLogReplayer::replay(const LogEntry &entry) { return LinearHashLogger::redo(buffer_pool_manager_, entry); }
@@ -0,0 +1,189 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/types.h"
+#include "common/rc.h"
+#include "common/lang/span.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/clog/log_replayer.h"
+#include "storage/index/latch_memo.h"
+
+struct LinearHashFileHeader;
+class LogEntry;
+class LogHandler;
+class LinearHashHandler;
+class Frame;
+class BufferPoolManager;
+
+namespace common {
+class Serializer;
+class Deserializer;
+}  // namespace common
+
+/**
+ * @brief 线性哈希表日志操作类型
+ * @ingroup CLog
+ */
+class LinearHashLogOperation
+{
+public:
+  enum class Type
+  {
+    UPDATE_HEADER,         /// 修改文件头，比如分裂之后的桶数、增加目录页面
+    DIRECTORY_INIT_EMPTY,  /// 初始化目录页面
+    DIRECTORY_SET_PAGE,    /// 设置目录中某个桶的主页面
+    BUCKET_INIT_EMPTY,     /// 初始化桶页面
+    BUCKET_SET_NEXT_PAGE,  /// 设置桶页面的溢出页面
+    BUCKET_INSERT,         /// 在桶页面中插入一些键值对
+    BUCKET_REMOVE,         /// 在桶页面中删除一些键值对
+
+    MAX_TYPE,
+  };
+
+public:
+  LinearHashLogOperation(Type type) : type_(type) {}
+  explicit LinearHashLogOperation(int type) : type_(static_cast<Type>(type)) {}
+
+  Type type() const { return type_; }
+  int  index() const { return static_cast<int>(type_); }
+
+  string to_string() const;
+
+private:
+  Type type_;
+};
+
+/**
+ * @brief 线性哈希表对一个页面的一次修改
+ * @ingroup CLog
+ * @details 每种操作用到的字段不同：
+ * 目录和溢出页面的操作使用 slot/new_page/old_page，桶中插入删除使用 slot(位置)/item_num/data，
+ * 修改文件头使用 data/old_data 保存修改前后的整个文件头
+ */
+class LinearHashLogEntry
+{
+public:
+  LinearHashLogEntry() = default;
+  LinearHashLogEntry(LinearHashLogOperation operation, Frame *frame);
+
+  LinearHashLogOperation operation() const { return operation_; }
+  Frame                 *frame() const { return frame_; }
+  void                   set_frame(Frame *frame) { frame_ = frame; }
+  PageNum                page_num() const { return page_num_; }
+
+  RC serialize(common::Serializer &buffer) const;
+  static RC deserialize(common::Deserializer &buffer, LinearHashLogEntry &entry);
+
+  /// @brief 在 frame 上重做这次修改
+  RC redo();
+  /// @brief 在 frame 上撤销这次修改
+  RC rollback();
+
+  string to_string() const;
+
+public:
+  int32_t      slot     = -1;
+  int32_t      item_num = 0;
+  PageNum      new_page = BP_INVALID_PAGE_NUM;
+  PageNum      old_page = BP_INVALID_PAGE_NUM;
+  vector<char> data;
+  vector<char> old_data;
+
+private:
+  LinearHashLogOperation operation_ = LinearHashLogOperation::Type::MAX_TYPE;
+  Frame                 *frame_     = nullptr;
+  PageNum                page_num_  = BP_INVALID_PAGE_NUM;
+};
+
+/**
+ * @brief 线性哈希表的日志记录辅助类
+ * @ingroup CLog
+ * @details 与 BplusTreeLogger 一样，一次插入或删除涉及的所有页面修改先记在内存里，操作成功后合并成一条日志写入，
+ * 失败时按照相反的顺序撤销。重做时只根据日志修改页面，不需要打开哈希表
+ */
+class LinearHashLogger final
+{
+public:
+  LinearHashLogger(LogHandler &log_handler, int32_t buffer_pool_id);
+  ~LinearHashLogger();
+
+  RC update_header(Frame *frame, const LinearHashFileHeader &header, const LinearHashFileHeader &old_header);
+  RC directory_init_empty(Frame *frame);
+  RC directory_set_page(Frame *frame, int slot, PageNum page_num, PageNum old_page_num);
+  RC bucket_init_empty(Frame *frame);
+  RC bucket_set_next_page(Frame *frame, PageNum page_num, PageNum old_page_num);
+  RC bucket_insert(Frame *frame, int index, span<const char> items, int item_num);
+  RC bucket_remove(Frame *frame, int index, span<const char> items, int item_num);
+
+  RC commit();
+  RC rollback();
+
+  /**
+   * @brief 重做日志。通常在系统启动时，会把所有日志重做一遍
+   */
+  static RC redo(BufferPoolManager &bpm, const LogEntry &entry);
+
+  static string log_entry_to_string(const LogEntry &entry);
+
+private:
+  RC append_log_entry(LinearHashLogEntry entry);
+
+private:
+  LogHandler &log_handler_;
+  int32_t     buffer_pool_id_ = -1;
+
+  vector<LinearHashLogEntry> entries_;
+};
+
+/**
+ * @brief 线性哈希表使用的事务辅助类
+ * @ingroup LinearHash
+ * @details 与 BplusTreeMiniTransaction 相同，保证一次操作中所有页面的修改一起成功或一起失败
+ */
+class LinearHashMiniTransaction final
+{
+public:
+  /**
+   * @param operation_result 操作结果。不为nullptr时，结束时根据结果自动提交或回滚
+   */
+  LinearHashMiniTransaction(LinearHashHandler &handler, RC *operation_result = nullptr);
+  ~LinearHashMiniTransaction();
+
+  LatchMemo        &latch_memo() { return latch_memo_; }
+  LinearHashLogger &logger() { return logger_; }
+
+  RC commit();
+  RC rollback();
+
+private:
+  RC              *operation_result_ = nullptr;
+  LatchMemo        latch_memo_;
+  LinearHashLogger logger_;
+};
+
+/**
+ * @brief 线性哈希表日志重做器
+ * @ingroup CLog
+ */
+class LinearHashLogReplayer final : public LogReplayer
+{
+public:
+  LinearHashLogReplayer(BufferPoolManager &bpm);
+  virtual ~LinearHashLogReplayer() = default;
+
+  /// @copydoc LogReplayer::replay
+  virtual RC replay(const LogEntry &entry) override;
+
+private:
+  BufferPoolManager &buffer_pool_manager_;
+};
@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by Meiyi & Longda on 2021/4/13.
 //
 #include "storage/record/record_manager.h"
+#include "common/lang/algorithm.h"
 #include "common/lang/defer.h"
 #include "common/log/log.h"
 #include "common/types.h"
@@ -98,7 +99,8 @@ RC RecordPageIterator::next(Record &record)
 
 RecordPageHandler::~RecordPageHandler() { cleanup(); }
 
-RC RecordPageHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler, PageNum page_num, ReadWriteMode mode)
+RC RecordPageHandler::init(
+    DiskBufferPool &buffer_pool, LogHandler &log_handler, PageNum page_num, ReadWriteMode mode, ScanRing *scan_ring)
 {
   if (disk_buffer_pool_ != nullptr) {
     if (frame_->page_num() == page_num) {
@@ -110,7 +112,7 @@ RC RecordPageHandler::init(DiskBufferPool &buffer_pool, LogHandler &log_handler,
   }
 
   RC ret = RC::SUCCESS;
-  if ((ret = buffer_pool.get_this_page(page_num, &frame_)) != RC::SUCCESS) {
+  if ((ret = buffer_pool.get_this_page(page_num, &frame_, scan_ring)) != RC::SUCCESS) {
     LOG_ERROR("Failed to get page handle from disk buffer pool. ret=%d:%s", ret, strrc(ret));
     return ret;
   }
@@ -204,6 +206,7 @@ RC RecordPageHandler::init_empty_page(
     }
   }
 
+  frame_->mark_dirty();
   rc = log_handler_.init_new_page(frame_, page_num, span((const char *)column_index, column_num * sizeof(int)));
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to init empty page: write log failed. page_num:record_size %d:%d. rc=%s", 
@@ -244,6 +247,7 @@ RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, LogHandler &l
   // column_index[i] store the end offset of column `i` the start offset of column `i+1`
   int *column_index = reinterpret_cast<int *>(frame_->data() + page_header_->col_idx_offset);
   memcpy(column_index, col_idx_data, column_num * sizeof(int));
+  frame_->mark_dirty();
 
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to init empty page: write log failed. page_num:record_size %d:%d. rc=%s", 
@@ -285,6 +289,9 @@ RC RowRecordPageHandler::insert_record(const char *data, RID *rid)
   bitmap.set_bit(index);
   page_header_->record_num++;
 
+  // 先标记脏页再写日志，页面在脏页链表中的位置不会晚于这条日志
+  frame_->mark_dirty();
+
   RC rc = log_handler_.insert_record(frame_, RID(get_page_num(), index), data);
   if (OB_FAIL(rc)) {
     LOG_ERROR("Failed to insert record. page_num %d:%d. rc=%s", disk_buffer_pool_->file_desc(), frame_->page_num(), strrc(rc));
@@ -296,8 +303,6 @@ RC RowRecordPageHandler::insert_record(const char *data, RID *rid)
   // printf("data:%s len:%d\n", data, page_header_->record_real_size);
   memcpy(record_data, data, page_header_->record_real_size);
 
-  frame_->mark_dirty();
-
   if (rid) {
     rid->page_num = get_page_num();
     rid->slot_num = index;
@@ -375,6 +380,7 @@ RC RowRecordPageHandler::update_record(const RID &rid, const char *data)
       memcpy(record_data, data, page_header_->record_real_size);
     }
 
+    frame_->mark_dirty();
     RC rc = log_handler_.update_record(frame_, rid, data);
     if (OB_FAIL(rc)) {
       LOG_ERROR("Failed to update record. page_num %d:%d. rc=%s", 
@@ -382,7 +388,6 @@ RC RowRecordPageHandler::update_record(const RID &rid, const char *data)
       // return rc; // ignore errors
     }
     bitmap.set_bit(rid.slot_num);
-    frame_->mark_dirty();
     return RC::SUCCESS;
   } else {
     LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid.slot_num, frame_->page_num());
@@ -507,6 +512,7 @@ void RecordFileHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
     free_pages_.clear();
+    all_visible_pages_.clear();
     disk_buffer_pool_ = nullptr;
     log_handler_      = nullptr;
     table_meta_       = nullptr;
@@ -607,6 +613,7 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
   }
 
   // 找到空闲位置
+  clear_all_visible(current_page_num);
   return record_page_handler->insert_record(data, rid);
 }
 
@@ -622,6 +629,7 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
     return ret;
   }
 
+  clear_all_visible(rid.page_num);
   return record_page_handler->recover_insert_record(data, rid);
 }
 
@@ -637,6 +645,7 @@ RC RecordFileHandler::delete_record(const RID *rid)
     return rc;
   }
 
+  clear_all_visible(rid->page_num);
   rc = record_page_handler->delete_record(rid);
   // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
   // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放record manager锁
@@ -675,6 +684,36 @@ RC RecordFileHandler::get_record(const RID &rid, Record &record)
   return rc;
 }
 
+RC RecordFileHandler::get_records(span<const RID> rids, int record_size, vector<char> &data)
+{
+  data.resize(rids.size() * record_size);
+  if (rids.empty()) {
+    return RC::SUCCESS;
+  }
+
+  const PageNum                 page_num = rids.front().page_num;
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to init record page handler.page number=%d", page_num);
+    return rc;
+  }
+
+  Record inplace_record;
+  for (size_t i = 0; i < rids.size(); i++) {
+    ASSERT(rids[i].page_num == page_num, "records are not in the same page. rid=%s, page num=%d",
+        rids[i].to_string().c_str(), page_num);
+    rc = page_handler->get_record(rids[i], inplace_record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record from record page handle. rid=%s, rc=%s", rids[i].to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    memcpy(data.data() + i * record_size, inplace_record.data(), record_size);
+  }
+  return rc;
+}
+
 RC RecordFileHandler::update_record(const char *data, RID &rid)
 {
   unique_ptr<RecordPageHandler> record_page_handler(RecordPageHandler::create(storage_format_));
@@ -684,6 +723,7 @@ RC RecordFileHandler::update_record(const char *data, RID &rid)
     return rc;
   }
 
+  clear_all_visible(rid.page_num);
   rc = record_page_handler->update_record(rid, data);
 
   record_page_handler->cleanup();
@@ -721,17 +761,74 @@ RC RecordFileHandler::visit_record(const RID &rid, function<bool(Record &)> upda
 
   bool updated = updater(record);
   if (updated) {
+    clear_all_visible(rid.page_num);
     rc = page_handler->update_record(rid, record.data());
   }
   return rc;
 }
 
+bool RecordFileHandler::is_all_visible(PageNum page_num) const
+{
+  all_visible_lock_.lock_shared();
+  bool all_visible = all_visible_pages_.count(page_num) > 0;
+  all_visible_lock_.unlock_shared();
+  return all_visible;
+}
+
+RC RecordFileHandler::mark_all_visible_if(
+    PageNum page_num, const function<bool(const Record &)> &checker, bool &all_visible)
+{
+  all_visible = false;
+
+  unique_ptr<RecordPageHandler> page_handler(RecordPageHandler::create(storage_format_));
+
+  RC rc = page_handler->init(*disk_buffer_pool_, *log_handler_, page_num, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to init record page handler.page number=%d", page_num);
+    return rc;
+  }
+
+  // 其它线程可能已经标记过了
+  if (is_all_visible(page_num)) {
+    all_visible = true;
+    return rc;
+  }
+
+  RecordPageIterator iterator;
+  iterator.init(page_handler.get());
+  Record record;
+  while (iterator.has_next()) {
+    rc = iterator.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record from page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    if (!checker(record)) {
+      return RC::SUCCESS;
+    }
+  }
+
+  // 仍然持有页面的读锁，这期间页面上的记录不会被修改
+  all_visible_lock_.lock();
+  all_visible_pages_.insert(page_num);
+  all_visible_lock_.unlock();
+  all_visible = true;
+  return RC::SUCCESS;
+}
+
+void RecordFileHandler::clear_all_visible(PageNum page_num)
+{
+  all_visible_lock_.lock();
+  all_visible_pages_.erase(page_num);
+  all_visible_lock_.unlock();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
 
 RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler,
-    ReadWriteMode mode, ConditionFilter *condition_filter)
+    ReadWriteMode mode, ConditionFilter *condition_filter, PageNum start_page /* = 1 */, PageNum end_page /* = -1 */)
 {
   close_scan();
 
@@ -741,7 +838,8 @@ RC RecordFileScanner::open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *
   log_handler_      = &log_handler;
   rw_mode_          = mode;
 
-  RC rc = bp_iterator_.init(buffer_pool, 1);
+  scan_ring_.clear();
+  RC rc = bp_iterator_.init(buffer_pool, max(start_page, 1), end_page);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -780,7 +878,7 @@ RC RecordFileScanner::fetch_next_record()
   while (bp_iterator_.has_next()) {
     PageNum page_num = bp_iterator_.next();
     record_page_handler_->cleanup();
-    rc = record_page_handler_->init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_);
+    rc = record_page_handler_->init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_, &scan_ring_);
     if (OB_FAIL(rc)) {
       LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
       return rc;
@@ -906,6 +1004,7 @@ RC ChunkFileScanner::open_scan_chunk(
   log_handler_      = &log_handler;
   rw_mode_          = mode;
 
+  scan_ring_.clear();
   RC rc = bp_iterator_.init(buffer_pool, 1);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
@@ -927,7 +1026,7 @@ RC ChunkFileScanner::next_chunk(Chunk &chunk)
   while (bp_iterator_.has_next()) {
     PageNum page_num = bp_iterator_.next();
     record_page_handler_->cleanup();
-    rc = record_page_handler_->init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_);
+    rc = record_page_handler_->init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_, &scan_ring_);
     if (OB_FAIL(rc)) {
       LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
       return rc;
@@ -15,7 +15,9 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/lang/bitmap.h"
+#include "common/lang/span.h"
 #include "common/lang/sstream.h"
+#include "common/lang/unordered_set.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/chunk.h"
 #include "storage/record/record.h"
@@ -135,8 +137,10 @@ public:
    * @param buffer_pool 关联某个文件时，都通过buffer pool来做读写文件
    * @param page_num    当前处理哪个页面
    * @param mode        是否只读。在访问页面时，需要对页面加锁
+   * @param scan_ring   顺序扫描时使用的页帧环，避免扫描把其它页面淘汰出去
    */
-  RC init(DiskBufferPool &buffer_pool, LogHandler &log_handler, PageNum page_num, ReadWriteMode mode);
+  RC init(DiskBufferPool &buffer_pool, LogHandler &log_handler, PageNum page_num, ReadWriteMode mode,
+      ScanRing *scan_ring = nullptr);
 
   /**
    * @brief 数据库恢复时，与普通的运行场景有所不同，不做任何并发操作，也不需要加锁
@@ -404,9 +408,40 @@ public:
 
   RC get_record(const RID &rid, Record &record);
 
+  /**
+   * @brief 读取同一个页面上的多条记录，只访问一次页面
+   * @details 用于按照 RID 排好序以后逐页读取记录，避免反复访问同一个页面
+   * @param rids 都在同一个页面上的记录
+   * @param[out] data 依次存放每条记录的数据，每条记录的大小是 record_size
+   */
+  RC get_records(span<const RID> rids, int record_size, vector<char> &data);
+
+  /// 数据文件的页面数，用来估算表中记录的数量
+  int32_t page_count() const { return disk_buffer_pool_->page_count(); }
+
   RC visit_record(const RID &rid, function<bool(Record &)> updater);
 
+  /**
+   * @brief 页面是否被标记为所有记录都可见
+   * @details 标记只保存在内存中，页面上的记录有任何修改都会清除标记。只扫描索引的查询用它跳过读取记录
+   */
+  bool is_all_visible(PageNum page_num) const;
+
+  /**
+   * @brief 检查页面上的每一条记录，都满足条件时把页面标记为所有记录都可见
+   * @details 检查和标记时一直持有页面的读锁，修改记录需要页面的写锁，所以不会漏掉并发的修改
+   * @param checker 判断一条记录是否对所有事务都可见
+   * @param[out] all_visible 页面现在是否被标记为所有记录都可见
+   */
+  RC mark_all_visible_if(PageNum page_num, const function<bool(const Record &)> &checker, bool &all_visible);
+
 private:
+  /**
+   * @brief 页面上的记录被修改了，清除所有记录都可见的标记
+   * @note 调用时需要持有页面的写锁
+   */
+  void clear_all_visible(PageNum page_num);
+
   /**
    * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
    */
@@ -417,6 +452,8 @@ private:
   LogHandler            *log_handler_      = nullptr;  ///< 记录日志的处理器
   unordered_set<PageNum> free_pages_;                  ///< 没有填充满的页面集合
   common::Mutex          lock_;  ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
+  unordered_set<PageNum> all_visible_pages_;  ///< 所有记录都对所有事务可见的页面
+  mutable common::SharedMutex all_visible_lock_;  ///< 保护 all_visible_pages_，持有时不会再去拿页面锁
   StorageFormat          storage_format_;
   TableMeta             *table_meta_;
 };
@@ -440,9 +477,11 @@ public:
    * @param mode             当前是否只读操作。访问数据时，需要对页面加锁。比如
    *                         删除时也需要遍历找到数据，然后删除，这时就需要加写锁
    * @param condition_filter 做一些初步过滤操作
+   * @param start_page       从哪个页面开始遍历
+   * @param end_page         遍历到哪个页面为止(不包含)，小于0时遍历到文件末尾。多个扫描各自遍历一段页面，就可以并行扫描一个文件
    */
   RC open_scan(Table *table, DiskBufferPool &buffer_pool, Trx *trx, LogHandler &log_handler, ReadWriteMode mode,
-      ConditionFilter *condition_filter);
+      ConditionFilter *condition_filter, PageNum start_page = 1, PageNum end_page = -1);
 
   /**
    * @brief 关闭一个文件扫描，释放相应的资源
@@ -479,6 +518,7 @@ private:
   ReadWriteMode   rw_mode_ = ReadWriteMode::READ_WRITE;  ///< 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                    ///< 遍历buffer pool的所有页面
+  ScanRing           scan_ring_;                      ///< 扫描加载的页面使用的页帧环
   ConditionFilter   *condition_filter_    = nullptr;  ///< 过滤record
   RecordPageHandler *record_page_handler_ = nullptr;  ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;           ///< 遍历某个页面上的所有record
@@ -517,5 +557,6 @@ private:
   ReadWriteMode   rw_mode_ = ReadWriteMode::READ_WRITE;  ///< 遍历出来的数据，是否可能对它做修改
 
   BufferPoolIterator bp_iterator_;                    ///< 遍历buffer pool的所有页面
+  ScanRing           scan_ring_;                      ///< 扫描加载的页面使用的页帧环
   RecordPageHandler *record_page_handler_ = nullptr;  ///< 处理文件某页面的记录
 };
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/lang/span.h"
 #include "common/lang/algorithm.h"
+#include "common/lang/chrono.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
 #include "common/rc.h"
@@ -28,6 +29,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/condition_filter.h"
 #include "storage/common/meta_util.h"
 #include "storage/index/bplus_tree_index.h"
+#include "storage/index/hash_index.h"
 #include "storage/index/index.h"
 #include "storage/record/record_manager.h"
 #include "storage/table/table.h"
@@ -173,10 +175,17 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
       }
     }
 
-    BplusTreeIndex *index      = new BplusTreeIndex();
-    string          index_file = table_index_file(base_dir, name(), index_meta->name());
-
-    rc = index->open(this, index_file.c_str(), *index_meta, field_metas);
+    Index  *index      = nullptr;
+    string  index_file = table_index_file(base_dir, name(), index_meta->name());
+    if (index_meta->type() == IndexType::HASH) {
+      HashIndex *hash_index = new HashIndex();
+      rc                    = hash_index->open(this, index_file.c_str(), *index_meta, field_metas);
+      index                 = hash_index;
+    } else {
+      BplusTreeIndex *bplus_tree_index = new BplusTreeIndex();
+      rc    = bplus_tree_index->open(this, index_file.c_str(), *index_meta, field_metas);
+      index = bplus_tree_index;
+    }
     if (rc != RC::SUCCESS) {
       delete index;
       LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%s",
@@ -213,6 +222,8 @@ RC Table::insert_record(Record &record)
       LOG_PANIC("Failed to rollback record data when insert index entries failed. table name=%s, rc=%d:%s",
                 name(), rc2, strrc(rc2));
     }
+  } else {
+    data_version_++;
   }
   return rc;
 }
@@ -254,12 +265,16 @@ RC Table::update_record(Record &record, const char *data)
     return rc;
   }
 
+  data_version_++;
   return rc;
 }
 
 RC Table::visit_record(const RID &rid, function<bool(Record &)> visitor)
 {
-  return record_handler_->visit_record(rid, visitor);
+  // 事务通过这个接口标记删除、提交和回滚，都会改变记录的可见性
+  RC rc = record_handler_->visit_record(rid, visitor);
+  data_version_++;
+  return rc;
 }
 
 RC Table::get_record(const RID &rid, Record &record)
@@ -382,9 +397,10 @@ RC Table::init_record_handler(const char *base_dir)
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode)
+RC Table::get_record_scanner(
+    RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode, PageNum start_page /* = 1 */, PageNum end_page /* = -1 */)
 {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, db_->log_handler(), mode, nullptr);
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, db_->log_handler(), mode, nullptr, start_page, end_page);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
@@ -400,8 +416,8 @@ RC Table::get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode m
   return rc;
 }
 
-RC Table::create_index(
-    Trx *trx, const std::vector<const FieldMeta *> &field_metas, const char *index_name, const bool unique)
+RC Table::create_index(Trx *trx, const std::vector<const FieldMeta *> &field_metas, const char *index_name,
+    const bool unique, IndexType index_type /* = IndexType::BPLUS_TREE */)
 {
   if (common::is_blank(index_name) || field_metas.empty()) {
     LOG_INFO("Invalid input arguments, table name is %s, index_name is blank or attribute_name is blank", name());
@@ -410,7 +426,7 @@ RC Table::create_index(
 
   IndexMeta new_index_meta;
 
-  RC rc = new_index_meta.init(index_name, field_metas, unique);
+  RC rc = new_index_meta.init(index_name, field_metas, unique, index_type);
   if (rc != RC::SUCCESS) {
     std::string field_names = field_metas[0]->name();
     for (size_t i = 0; i < field_metas.size(); i++) {
@@ -423,43 +439,91 @@ RC Table::create_index(
   }
 
   // 创建索引相关数据
-  BplusTreeIndex *index      = new BplusTreeIndex();
-  string          index_file = table_index_file(base_dir_.c_str(), name(), index_name);
-  
-  rc = index->create(this, index_file.c_str(), new_index_meta, field_metas, unique);
+  Index          *index            = nullptr;
+  BplusTreeIndex *bplus_tree_index = nullptr;
+  string          index_file       = table_index_file(base_dir_.c_str(), name(), index_name);
+  if (index_type == IndexType::HASH) {
+    HashIndex *hash_index = new HashIndex();
+    rc                    = hash_index->create(this, index_file.c_str(), new_index_meta, field_metas, unique);
+    index                 = hash_index;
+  } else {
+    bplus_tree_index = new BplusTreeIndex();
+    rc               = bplus_tree_index->create(this, index_file.c_str(), new_index_meta, field_metas, unique);
+    index            = bplus_tree_index;
+  }
   if (rc != RC::SUCCESS) {
     delete index;
-    LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
+    LOG_ERROR("Failed to create index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
-  RecordFileScanner scanner;
-  rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", 
-             name(), index_name, strrc(rc));
-    return rc;
-  }
+  // 遍历当前的所有数据，插入这个索引。哈希索引没有批量构建，只能逐条插入
+  const BplusTreeBulkLoadOptions &bulk_load_options = db_->bulk_load_options();
+  const bool                      bulk_load         = bulk_load_options.enable && bplus_tree_index != nullptr;
+  const auto                      begin_time        = chrono::steady_clock::now();
+  int64_t                         row_count         = 0;
+  int                             thread_num        = 1;
+  if (bulk_load) {
+    // 批量构建：把数据页面分成几段，每段由一个线程扫描并排序键值，归并之后从下往上写B+树的页面
+    const PageNum page_count = data_buffer_pool_->page_count();
+    thread_num               = clamp(bulk_load_options.scan_thread_num(), 1, max(page_count - 1, 1));
+
+    vector<unique_ptr<RecordFileScanner>> scanners;
+    vector<RecordFileScanner *>           scanner_ptrs;
+    for (int i = 0; i < thread_num; i++) {
+      const PageNum start_page = 1 + static_cast<PageNum>(static_cast<int64_t>(page_count - 1) * i / thread_num);
+      const PageNum end_page   = 1 + static_cast<PageNum>(static_cast<int64_t>(page_count - 1) * (i + 1) / thread_num);
+      scanners.push_back(make_unique<RecordFileScanner>());
+      scanner_ptrs.push_back(scanners.back().get());
+      rc = get_record_scanner(*scanners.back(), trx, ReadWriteMode::READ_ONLY, start_page, end_page);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s",
+                 name(), index_name, strrc(rc));
+        return rc;
+      }
+    }
 
-  Record record;
-  while (OB_SUCC(rc = scanner.next(record))) {
-    rc = index->insert_entry(record.data(), &record.rid());
+    rc = bplus_tree_index->bulk_load(scanner_ptrs, bulk_load_options, row_count);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to bulk load index while creating index. table=%s, index=%s, rc=%s",
+               name(), index_name, strrc(rc));
+      return rc;
+    }
+  } else {
+    RecordFileScanner scanner;
+    rc = get_record_scanner(scanner, trx, ReadWriteMode::READ_ONLY);
     if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create scanner while creating index. table=%s, index=%s, rc=%s", 
+               name(), index_name, strrc(rc));
+      return rc;
+    }
+
+    Record record;
+    while (OB_SUCC(rc = scanner.next(record))) {
+      rc = index->insert_entry(record.data(), &record.rid());
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
+                 name(), index_name, strrc(rc));
+        return rc;
+      }
+      row_count++;
+    }
+    if (RC::RECORD_EOF == rc) {
+      rc = RC::SUCCESS;
+    } else {
       LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
                name(), index_name, strrc(rc));
       return rc;
     }
+    scanner.close_scan();
   }
-  if (RC::RECORD_EOF == rc) {
-    rc = RC::SUCCESS;
-  } else {
-    LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
-             name(), index_name, strrc(rc));
-    return rc;
-  }
-  scanner.close_scan();
-  LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
+
+  const int64_t elapsed_us =
+      chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin_time).count();
+  LOG_INFO("inserted all records into new index. table=%s, index=%s, bulk load=%d, threads=%d, rows=%ld, "
+           "elapsed=%ldms, throughput=%ld rows/sec",
+           name(), index_name, bulk_load, thread_num, row_count, elapsed_us / 1000,
+           row_count * 1000000 / max(elapsed_us, static_cast<int64_t>(1)));
 
   indexes_.push_back(index);
 
@@ -526,6 +590,9 @@ RC Table::delete_record(const Record &record)
            name(), index->index_meta().name(), record.rid().to_string().c_str(), strrc(rc));
   }
   rc = record_handler_->delete_record(&record.rid());
+  if (OB_SUCC(rc)) {
+    data_version_++;
+  }
   return rc;
 }
 
@@ -650,7 +717,7 @@ RC Table::drop(const char *dir)
       // 删除索引文件
       const int index_num = table_meta_.index_num();
       for (int i = 0; i < index_num; i++) {
-        ((BplusTreeIndex *)indexes_[i])->close();
+        indexes_[i]->close();
         const IndexMeta *index_meta = table_meta_.index(i);
         if (index_meta != nullptr) {
           std::string index_file = ::table_index_file(dir, name(), index_meta->name());
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/table/table_meta.h"
 #include "common/types.h"
+#include "common/lang/atomic.h"
 #include "common/lang/span.h"
 #include "common/lang/functional.h"
 
@@ -84,10 +85,16 @@ public:
   RC recover_insert_record(Record &record);
 
   // TODO refactor
-  RC create_index(
-      Trx *trx, const std::vector<const FieldMeta *> &field_metas, const char *index_name, const bool unique);
+  RC create_index(Trx *trx, const std::vector<const FieldMeta *> &field_metas, const char *index_name,
+      const bool unique, IndexType index_type = IndexType::BPLUS_TREE);
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode);
+  /**
+   * @brief 打开一个遍历表中记录的扫描器
+   * @param start_page 从哪个数据页面开始遍历
+   * @param end_page 遍历到哪个数据页面为止(不包含)，小于0时遍历到最后
+   */
+  RC get_record_scanner(
+      RecordFileScanner &scanner, Trx *trx, ReadWriteMode mode, PageNum start_page = 1, PageNum end_page = -1);
 
   RC get_chunk_scanner(ChunkFileScanner &scanner, Trx *trx, ReadWriteMode mode);
 
@@ -110,6 +117,13 @@ public:
 
   const TableMeta &table_meta() const;
 
+  /**
+   * @brief 表数据的版本
+   * @details 每次修改记录（包括事务提交、回滚时修改记录的事务字段）之后都会增加，用于判断查询缓存是否失效。
+   * 版本只在内存中维护，重启之后从0开始。
+   */
+  int64_t data_version() const { return data_version_.load(); }
+
   RC sync();
 
   RC drop(const char *dir);
@@ -134,4 +148,5 @@ private:
   DiskBufferPool    *data_buffer_pool_ = nullptr;  /// 数据文件关联的buffer pool
   RecordFileHandler *record_handler_   = nullptr;  /// 记录操作
   vector<Index *>    indexes_;
+  atomic<int64_t>    data_version_{0};  /// 表数据的版本，修改完数据之后再增加
 };
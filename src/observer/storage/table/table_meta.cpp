@@ -32,7 +32,8 @@ TableMeta::TableMeta(const TableMeta &other)
       fields_(other.fields_),
       indexes_(other.indexes_),
       storage_format_(other.storage_format_),
-      record_size_(other.record_size_)
+      record_size_(other.record_size_),
+      version_(other.version_)
 {}
 
 void TableMeta::swap(TableMeta &other) noexcept
@@ -41,6 +42,7 @@ void TableMeta::swap(TableMeta &other) noexcept
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
   std::swap(record_size_, other.record_size_);
+  std::swap(version_, other.version_);
 }
 
 RC TableMeta::init(int32_t table_id, const char *name, const std::vector<FieldMeta> *trx_fields,
@@ -107,6 +109,7 @@ RC TableMeta::init(int32_t table_id, const char *name, const std::vector<FieldMe
 RC TableMeta::add_index(const IndexMeta &index)
 {
   indexes_.push_back(index);
+  version_++;
   return RC::SUCCESS;
 }
 
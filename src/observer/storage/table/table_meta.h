@@ -65,6 +65,9 @@ public:
 
   int record_size() const;
 
+  /// @brief 元数据版本号，每次修改元数据（比如创建索引）都会递增，用于判断缓存的执行计划是否失效
+  int64_t version() const { return version_; }
+
 public:
   int  serialize(std::ostream &os) const override;
   int  deserialize(std::istream &is) override;
@@ -81,4 +84,6 @@ protected:
   StorageFormat          storage_format_;
 
   int record_size_ = 0;
+
+  int64_t version_ = 0;  ///< 元数据版本号，不持久化
 };
@@ -45,6 +45,30 @@ const vector<FieldMeta> *MvccTrxKit::trx_fields() const { return &fields_; }
 
 int32_t MvccTrxKit::next_trx_id() { return ++current_trx_id_; }
 
+int32_t MvccTrxKit::start_trx()
+{
+  lock_.lock();
+  int32_t trx_id = next_trx_id();
+  active_trx_ids_.insert(trx_id);
+  lock_.unlock();
+  return trx_id;
+}
+
+void MvccTrxKit::end_trx(int32_t trx_id)
+{
+  lock_.lock();
+  active_trx_ids_.erase(trx_id);
+  lock_.unlock();
+}
+
+int32_t MvccTrxKit::min_active_trx_id()
+{
+  lock_.lock();
+  int32_t trx_id = active_trx_ids_.empty() ? max_trx_id() : *active_trx_ids_.begin();
+  lock_.unlock();
+  return trx_id;
+}
+
 int32_t MvccTrxKit::max_trx_id() const { return numeric_limits<int32_t>::max(); }
 
 Trx *MvccTrxKit::create_trx(LogHandler &log_handler)
@@ -123,7 +147,12 @@ MvccTrx::MvccTrx(MvccTrxKit &kit, LogHandler &log_handler, int32_t trx_id)
   recovering_ = true;
 }
 
-MvccTrx::~MvccTrx() {}
+MvccTrx::~MvccTrx()
+{
+  if (started_ && !recovering_) {
+    trx_kit_.end_trx(trx_id_);
+  }
+}
 
 RC MvccTrx::insert_record(Table *table, Record &record)
 {
@@ -286,6 +315,37 @@ RC MvccTrx::visit_record(Table *table, Record &record, ReadWriteMode mode)
   return rc;
 }
 
+bool MvccTrx::is_page_all_visible(Table *table, PageNum page_num)
+{
+  if (!started_) {
+    return false;
+  }
+
+  RecordFileHandler *record_handler = table->record_handler();
+  if (record_handler->is_all_visible(page_num)) {
+    return true;
+  }
+
+  Field begin_field;
+  Field end_field;
+  trx_fields(table, begin_field, end_field);
+
+  const int32_t min_active_trx_id = trx_kit_.min_active_trx_id();
+  const int32_t max_trx_id        = trx_kit_.max_trx_id();
+  auto checker = [&begin_field, &end_field, min_active_trx_id, max_trx_id](const Record &record) -> bool {
+    int32_t begin_xid = begin_field.get_int(record);
+    return begin_xid > 0 && begin_xid < min_active_trx_id && end_field.get_int(record) == max_trx_id;
+  };
+
+  bool all_visible = false;
+  RC   rc          = record_handler->mark_all_visible_if(page_num, checker, all_visible);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to check page visibility. table=%s, page num=%d, rc=%s", table->name(), page_num, strrc(rc));
+    return false;
+  }
+  return all_visible;
+}
+
 /**
  * @brief 获取指定表上的事务使用的字段
  *
@@ -309,7 +369,7 @@ RC MvccTrx::start_if_need()
 {
   if (!started_) {
     ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
-    trx_id_ = trx_kit_.next_trx_id();
+    trx_id_ = trx_kit_.start_trx();
     LOG_DEBUG("current thread change to new trx with %d", trx_id_);
     started_ = true;
   }
@@ -385,6 +445,7 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
   }
 
   operations_.clear();
+  trx_kit_.end_trx(trx_id_);
 
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
   return rc;
@@ -460,6 +521,7 @@ RC MvccTrx::rollback()
   }
 
   operations_.clear();
+  trx_kit_.end_trx(trx_id_);
 
   if (!recovering_) {
     rc = log_handler_.rollback(trx_id_);
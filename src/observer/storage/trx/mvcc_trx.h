@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/set.h"
 #include "common/lang/vector.h"
 #include "storage/trx/trx.h"
 #include "storage/trx/mvcc_trx_log.h"
@@ -47,6 +48,21 @@ public:
 public:
   int32_t next_trx_id();
 
+  /**
+   * @brief 为开始的事务分配事务号，并记录为活跃事务
+   * @details 分配和记录在同一个临界区中，min_active_trx_id 不会漏掉刚拿到事务号的事务
+   */
+  int32_t start_trx();
+
+  /// 事务已经提交或回滚，不再是活跃事务
+  void end_trx(int32_t trx_id);
+
+  /**
+   * @brief 最小的活跃事务号，没有活跃事务时返回 max_trx_id
+   * @details 提交号比它小的数据对所有活跃事务和以后开始的事务都可见
+   */
+  int32_t min_active_trx_id();
+
 public:
   int32_t max_trx_id() const;
 
@@ -57,6 +73,7 @@ private:
 
   common::Mutex lock_;
   vector<Trx *> trxes_;
+  set<int32_t>  active_trx_ids_;  ///< 已经开始但还没有结束的事务号，也由 lock_ 保护
 };
 
 /**
@@ -92,6 +109,13 @@ public:
    */
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
 
+  /**
+   * @brief 页面上所有的记录是否都对当前事务可见
+   * @details 页面没有标记时检查一遍页面上的记录，所有记录都已经提交、没有删除，并且提交号小于最小的活跃事务号时，
+   * 这些记录对现在以及以后的所有事务都可见，就给页面加上标记，后面的查询不需要再检查
+   */
+  bool is_page_all_visible(Table *table, PageNum page_num) override;
+
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
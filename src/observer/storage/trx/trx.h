@@ -148,6 +148,12 @@ public:
   virtual RC visit_record(Table *table, Record &record, ReadWriteMode mode) = 0;
   virtual RC update_record(Table* table, Record& record, const char *data) = 0;
 
+  /**
+   * @brief 不读取记录，判断一个页面上的所有记录是否都对当前事务可见
+   * @details 用于只扫描索引的查询。返回 false 时并不表示记录不可见，需要读取记录再用 visit_record 判断
+   */
+  virtual bool is_page_all_visible(Table *table, PageNum page_num) = 0;
+
   virtual RC start_if_need() = 0;
   virtual RC commit()        = 0;
   virtual RC rollback()      = 0;
@@ -48,6 +48,7 @@ public:
   RC delete_record(Table *table, Record &record) override;
   RC visit_record(Table *table, Record &record, ReadWriteMode mode) override;
   RC update_record(Table *table, Record &record, const char *data) override;
+  bool is_page_all_visible(Table *table, PageNum page_num) override { return true; }
   RC start_if_need() override;
   RC commit() override;
   RC rollback() override;
@@ -20,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer/buffer_pool_log.h"
 #include "storage/record/record_log.h"
 #include "storage/index/bplus_tree_log_entry.h"
+#include "storage/index/linear_hash_log.h"
 #include "storage/trx/mvcc_trx_log.h"
 #include "common/lang/serializer.h"
 
@@ -56,6 +57,9 @@ public:
       case LogModule::Id::BPLUS_TREE: {
         ss << BplusTreeLogger::log_entry_to_string(entry);
       } break;
+      case LogModule::Id::HASH_INDEX: {
+        ss << LinearHashLogger::log_entry_to_string(entry);
+      } break;
 
       case LogModule::Id::TRANSACTION: {
         auto *header = reinterpret_cast<const MvccTrxLogHeader *>(entry.data());
@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "gtest/gtest.h"
+#include "common/lang/chrono.h"
+#include "common/lang/thread.h"
+#include "common/queue/blocking_queue.h"
+
+using namespace common;
+
+TEST(BlockingQueue, test)
+{
+  BlockingQueue<int> queue(chrono::milliseconds(10));
+  EXPECT_EQ(0, queue.size());
+
+  int ret = queue.push(1);
+  EXPECT_EQ(0, ret);
+  EXPECT_EQ(1, queue.size());
+
+  int value;
+  ret = queue.pop(value);
+  EXPECT_EQ(0, ret);
+  EXPECT_EQ(1, value);
+  EXPECT_EQ(0, queue.size());
+
+  // 队列为空时，等待超时之后返回失败
+  auto begin = chrono::steady_clock::now();
+  ret        = queue.pop(value);
+  EXPECT_EQ(-1, ret);
+  EXPECT_GE(chrono::steady_clock::now() - begin, chrono::milliseconds(10));
+}
+
+TEST(BlockingQueue, wait_push)
+{
+  BlockingQueue<int> queue(chrono::seconds(10));
+
+  thread producer([&queue]() {
+    this_thread::sleep_for(chrono::milliseconds(10));
+    queue.push(2);
+  });
+
+  int value = 0;
+  int ret   = queue.pop(value);
+  EXPECT_EQ(0, ret);
+  EXPECT_EQ(2, value);
+  producer.join();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
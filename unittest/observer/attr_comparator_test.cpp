@@ -0,0 +1,120 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+
+/// 使用 Value 和 DataType 比较，B+树比较器的结果需要和它一致
+static int compare_by_value(AttrType type, int length, const char *v1, const char *v2)
+{
+  Value left;
+  left.set_type(type);
+  left.set_data(v1, length);
+  Value right;
+  right.set_type(type);
+  right.set_data(v2, length);
+  return DataType::type_instance(type)->compare(left, right);
+}
+
+static int sign(int value) { return (value > 0) - (value < 0); }
+
+TEST(AttrComparator, ints)
+{
+  AttrType type   = AttrType::INTS;
+  int      length = sizeof(int);
+
+  AttrComparator comparator;
+  comparator.init(1, &type, &length);
+
+  const vector<int> values{INT32_MIN, -100, -1, 0, 1, 100, INT32_MAX};
+  for (int v1 : values) {
+    for (int v2 : values) {
+      const char *k1 = reinterpret_cast<const char *>(&v1);
+      const char *k2 = reinterpret_cast<const char *>(&v2);
+      ASSERT_EQ(sign(compare_by_value(type, length, k1, k2)), comparator(k1, k2)) << v1 << " vs " << v2;
+    }
+  }
+}
+
+TEST(AttrComparator, floats)
+{
+  AttrType type   = AttrType::FLOATS;
+  int      length = sizeof(float);
+
+  AttrComparator comparator;
+  comparator.init(1, &type, &length);
+
+  // 差值小于 EPSILON 时认为相等
+  const vector<float> values{-1e10f, -1.5f, -1e-7f, 0.0f, 1e-7f, 0.5f, 0.5000001f, 1e10f};
+  for (float v1 : values) {
+    for (float v2 : values) {
+      const char *k1 = reinterpret_cast<const char *>(&v1);
+      const char *k2 = reinterpret_cast<const char *>(&v2);
+      ASSERT_EQ(sign(compare_by_value(type, length, k1, k2)), comparator(k1, k2)) << v1 << " vs " << v2;
+    }
+  }
+}
+
+TEST(AttrComparator, chars)
+{
+  AttrType type   = AttrType::CHARS;
+  int      length = 8;
+
+  AttrComparator comparator;
+  comparator.init(1, &type, &length);
+
+  // 字段中 '\0' 之后的内容不参与比较，写满字段的字符串没有 '\0'
+  const vector<string> values{
+      "", "a", "ab", string("abc\0zz", 6), string("abc\0yy", 6), "abcdefgh", "b", "zzzzzzzz"};
+  for (const string &s1 : values) {
+    for (const string &s2 : values) {
+      char k1[8] = {0};
+      char k2[8] = {0};
+      memcpy(k1, s1.data(), min(s1.size(), sizeof(k1)));
+      memcpy(k2, s2.data(), min(s2.size(), sizeof(k2)));
+      ASSERT_EQ(sign(compare_by_value(type, length, k1, k2)), comparator(k1, k2)) << s1 << " vs " << s2;
+    }
+  }
+}
+
+TEST(AttrComparator, multiple_attrs)
+{
+  AttrType types[]   = {AttrType::CHARS, AttrType::INTS, AttrType::DATES};
+  int      lengths[] = {4, sizeof(int), sizeof(int)};
+
+  AttrComparator comparator;
+  comparator.init(3, types, lengths);
+  ASSERT_EQ(12, comparator.attr_length());
+
+  auto make_key = [](const char *s, int i, int d) {
+    string key(12, '\0');
+    memcpy(key.data(), s, strnlen(s, 4));
+    memcpy(key.data() + 4, &i, sizeof(i));
+    memcpy(key.data() + 8, &d, sizeof(d));
+    return key;
+  };
+
+  // 按照属性的顺序逐个比较
+  const vector<string> keys{make_key("a", 5, 1), make_key("a", 5, 2), make_key("a", 6, 0), make_key("b", -1, 0)};
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      int expected = (i > j) - (i < j);
+      ASSERT_EQ(expected, comparator(keys[i].data(), keys[j].data())) << i << " vs " << j;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -125,6 +125,58 @@ TEST(test_frame_manager, test_frame_manager_simple_lru)
   frame_manager.cleanup();
 }
 
+TEST(test_frame_manager, test_frame_manager_shard)
+{
+  const int      shard_num = 4;
+  BPFrameManager frame_manager("Test");
+  ASSERT_EQ(RC::SUCCESS, frame_manager.init(2, shard_num));
+  ASSERT_EQ(shard_num, frame_manager.shard_num());
+  ASSERT_EQ(2 * DEFAULT_ITEM_NUM_PER_POOL, static_cast<int>(frame_manager.total_frame_num()));
+
+  // 页号模分区数相同的页面在同一个分区中
+  const int          buffer_pool_id = 0;
+  std::list<Frame *> used_list;
+  for (PageNum page_num = 0; true; page_num += shard_num) {
+    Frame *frame = frame_manager.alloc(buffer_pool_id, page_num);
+    if (frame == nullptr) {
+      break;
+    }
+    used_list.push_back(frame);
+  }
+  ASSERT_EQ(2 * DEFAULT_ITEM_NUM_PER_POOL / shard_num, static_cast<int>(used_list.size()));
+
+  // 其它分区不受影响
+  Frame *other = frame_manager.alloc(buffer_pool_id, 1);
+  ASSERT_NE(nullptr, other);
+  ASSERT_EQ(other, frame_manager.get(buffer_pool_id, 1));
+  other->unpin();
+
+  // 只能淘汰同一个分区中没有pin住的页面
+  const PageNum new_page_num = static_cast<PageNum>(used_list.size() * shard_num);
+  auto          purger       = [](Frame *) { return RC::SUCCESS; };
+  ASSERT_EQ(0, frame_manager.purge_frames(buffer_pool_id, new_page_num, 1, purger));
+
+  Frame *victim = used_list.front();
+  used_list.pop_front();
+  victim->unpin();
+  ASSERT_EQ(1, frame_manager.purge_frames(buffer_pool_id, new_page_num, 1, purger));
+  ASSERT_EQ(nullptr, frame_manager.get(buffer_pool_id, 0));
+  ASSERT_EQ(other, frame_manager.get(buffer_pool_id, 1));
+  other->unpin();
+
+  Frame *frame = frame_manager.alloc(buffer_pool_id, new_page_num);
+  ASSERT_NE(nullptr, frame);
+  used_list.push_back(frame);
+  used_list.push_back(other);
+  ASSERT_EQ(used_list.size(), frame_manager.frame_num());
+
+  for (Frame *frame : used_list) {
+    ASSERT_EQ(RC::SUCCESS, frame_manager.free(buffer_pool_id, frame->page_num(), frame));
+  }
+  ASSERT_EQ(0, static_cast<int>(frame_manager.frame_num()));
+  ASSERT_EQ(RC::SUCCESS, frame_manager.cleanup());
+}
+
 int main(int argc, char **argv)
 {
 
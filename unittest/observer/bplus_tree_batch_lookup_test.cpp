@@ -0,0 +1,148 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+
+using namespace std;
+using namespace common;
+
+static const filesystem::path test_directory = "bplus_tree_batch_lookup_test_dir";
+
+/// 每个键值重复的次数
+static int duplicate_num(int value) { return value % 3 + 1; }
+
+class BplusTreeBatchLookupTest : public testing::TestWithParam<BplusTreeNodeFormat>
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(test_directory);
+    filesystem::create_directory(test_directory);
+    ASSERT_EQ(RC::SUCCESS, bpm_.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+    FieldMeta field_meta("key", AttrType::INTS, 0 /*attr_offset*/, sizeof(int), true /*visible*/, 0 /*field_id*/);
+    RC        rc = handler_.create(false /*unique*/,
+        log_handler_,
+        bpm_,
+        (test_directory / "batch_lookup.btree").c_str(),
+        {&field_meta},
+        -1,
+        -1,
+        GetParam());
+    ASSERT_EQ(RC::SUCCESS, rc);
+  }
+
+  void TearDown() override
+  {
+    handler_.close();
+    filesystem::remove_all(test_directory);
+  }
+
+  /// 插入 [0, max_value) 之间的偶数，每个键值重复 duplicate_num 次
+  void insert_even_values(int max_value)
+  {
+    for (int value = 0; value < max_value; value += 2) {
+      for (int i = 0; i < duplicate_num(value); i++) {
+        RID rid(value, i);
+        ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+      }
+    }
+  }
+
+  static vector<const char *> key_pointers(const vector<int> &values)
+  {
+    vector<const char *> keys;
+    for (const int &value : values) {
+      keys.push_back(reinterpret_cast<const char *>(&value));
+    }
+    return keys;
+  }
+
+protected:
+  BufferPoolManager bpm_;
+  VacuousLogHandler log_handler_;
+  BplusTreeHandler  handler_;
+};
+
+TEST_P(BplusTreeBatchLookupTest, same_as_get_entry)
+{
+  const int max_value = 20000;
+  insert_even_values(max_value);
+
+  // 包含不存在的键值、重复的键值，以及超出范围的键值
+  vector<int> values{-5, 0, 0, 1, 2};
+  for (int value = 3; value < max_value - 10; value += 7) {
+    values.push_back(value);
+  }
+  for (int value = max_value - 10; value < max_value + 10; value++) {
+    values.push_back(value);
+  }
+
+  vector<RID> rids;
+  vector<int> offsets;
+  ASSERT_EQ(RC::SUCCESS, handler_.get_entries(key_pointers(values), rids, &offsets));
+  ASSERT_EQ(values.size() + 1, offsets.size());
+  ASSERT_EQ(static_cast<int>(rids.size()), offsets.back());
+
+  for (size_t i = 0; i < values.size(); i++) {
+    list<RID> expected;
+    ASSERT_EQ(RC::SUCCESS, handler_.get_entry(reinterpret_cast<const char *>(&values[i]), sizeof(int), expected));
+
+    vector<RID> actual(rids.begin() + offsets[i], rids.begin() + offsets[i + 1]);
+    ASSERT_EQ(vector<RID>(expected.begin(), expected.end()), actual) << "value=" << values[i];
+
+    const bool exists = values[i] >= 0 && values[i] < max_value && values[i] % 2 == 0;
+    ASSERT_EQ(exists ? duplicate_num(values[i]) : 0, static_cast<int>(actual.size())) << "value=" << values[i];
+  }
+
+  // 不需要 offsets 时只追加结果
+  vector<RID> appended{RID(-1, -1)};
+  ASSERT_EQ(RC::SUCCESS, handler_.get_entries(key_pointers(values), appended, nullptr));
+  ASSERT_EQ(rids.size() + 1, appended.size());
+  ASSERT_TRUE(equal(rids.begin(), rids.end(), appended.begin() + 1));
+}
+
+TEST_P(BplusTreeBatchLookupTest, unsorted_keys)
+{
+  insert_even_values(100);
+
+  const vector<int> values{4, 2};
+  vector<RID>       rids;
+  ASSERT_EQ(RC::INVALID_ARGUMENT, handler_.get_entries(key_pointers(values), rids, nullptr));
+  ASSERT_TRUE(rids.empty());
+}
+
+TEST_P(BplusTreeBatchLookupTest, empty_tree)
+{
+  const vector<int> values{1, 2, 3};
+  vector<RID>       rids;
+  vector<int>       offsets;
+  ASSERT_EQ(RC::SUCCESS, handler_.get_entries(key_pointers(values), rids, &offsets));
+  ASSERT_TRUE(rids.empty());
+  ASSERT_EQ(vector<int>({0, 0, 0, 0}), offsets);
+
+  ASSERT_EQ(RC::SUCCESS, handler_.get_entries({}, rids, &offsets));
+  ASSERT_EQ(vector<int>({0}), offsets);
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeFormats, BplusTreeBatchLookupTest,
+    testing::Values(BplusTreeNodeFormat::PLAIN, BplusTreeNodeFormat::COMPRESSED));
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
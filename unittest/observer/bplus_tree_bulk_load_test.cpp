@@ -0,0 +1,292 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_load.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/integrated_log_replayer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+
+using namespace std;
+using namespace common;
+
+static vector<int> shuffled_keys(int key_num)
+{
+  vector<int> keys(key_num);
+  for (int i = 0; i < key_num; i++) {
+    keys[i] = i;
+  }
+  shuffle(keys.begin(), keys.end(), mt19937(random_device()()));
+  return keys;
+}
+
+/// 把键值加入排序器，RID 与键值相同
+static void add_keys(BplusTreeHandler &tree_handler, BplusTreeKeySorter &sorter, const vector<int> &keys)
+{
+  vector<char> key(tree_handler.file_header().key_length);
+  for (int k : keys) {
+    tree_handler.make_key(reinterpret_cast<const char *>(&k), RID(k, k), key.data());
+    ASSERT_EQ(RC::SUCCESS, sorter.add(key.data()));
+  }
+  ASSERT_EQ(RC::SUCCESS, sorter.finish());
+}
+
+static void check_all_values(BplusTreeHandler &tree_handler, int key_num)
+{
+  BplusTreeScanner scanner(tree_handler);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+
+  RC  rc    = RC::SUCCESS;
+  RID rid;
+  int count = 0;
+  while (OB_SUCC(rc = scanner.next_entry(rid))) {
+    ASSERT_EQ(count, rid.page_num);
+    ASSERT_EQ(count, rid.slot_num);
+    count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(key_num, count);
+  scanner.close();
+}
+
+TEST(BplusTreeKeySorter, external_sort)
+{
+  filesystem::path test_directory = "bplus_tree_bulk_load_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  AttrType       type   = AttrType::INTS;
+  int            length = sizeof(int);
+  AttrComparator comparator;
+  comparator.init(1, &type, &length);
+
+  const int key_length = sizeof(int) + sizeof(RID);
+  for (int64_t memory_limit : {64 * 1024 * 1024, 4 * 1024}) {
+    const filesystem::path sort_file = test_directory / "keys.sort";
+    BplusTreeKeySorter     sorter(comparator, key_length, memory_limit, sort_file.c_str());
+
+    // 每个键值出现两次，按照RID区分
+    const int   key_num = 10000;
+    vector<int> keys    = shuffled_keys(key_num);
+    for (int k : keys) {
+      for (int slot : {1, 0}) {
+        char key[key_length];
+        RID  rid(k, slot);
+        memcpy(key, &k, sizeof(k));
+        memcpy(key + sizeof(k), &rid, sizeof(rid));
+        ASSERT_EQ(RC::SUCCESS, sorter.add(key));
+      }
+    }
+    ASSERT_EQ(RC::SUCCESS, sorter.finish());
+    ASSERT_EQ(2 * key_num, sorter.key_count());
+    if (memory_limit < 64 * 1024) {
+      ASSERT_GT(sorter.run_count(), 1);
+    } else {
+      ASSERT_EQ(0, sorter.run_count());
+    }
+    // 临时文件打开后就删除了
+    ASSERT_FALSE(filesystem::exists(sort_file));
+
+    const char *key = nullptr;
+    for (int i = 0; i < 2 * key_num; i++) {
+      ASSERT_EQ(RC::SUCCESS, sorter.next(key));
+      ASSERT_EQ(i / 2, *reinterpret_cast<const int *>(key));
+      ASSERT_EQ(i % 2, reinterpret_cast<const RID *>(key + sizeof(int))->slot_num);
+    }
+    ASSERT_EQ(RC::RECORD_EOF, sorter.next(key));
+  }
+}
+
+TEST(BplusTreeBulkLoad, build)
+{
+  filesystem::path test_directory = "bplus_tree_bulk_load_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  // 键值个数与节点的最大元素个数，-1 表示按照页面大小计算
+  FieldMeta                    field("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  vector<const FieldMeta *>    field_metas{&field};
+  const vector<pair<int, int>> sizes{{1, 100}, {10, 5}, {1000, 5}, {10000, -1}};
+
+  for (size_t i = 0; i < sizes.size(); i++) {
+    const auto [key_num, order] = sizes[i];
+    const filesystem::path bp_file = test_directory / ("tree" + to_string(i) + ".bp");
+
+    VacuousLogHandler log_handler;
+    BufferPoolManager bpm;
+    ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+    BplusTreeHandler tree_handler;
+    ASSERT_EQ(RC::SUCCESS, tree_handler.create(false, log_handler, bpm, bp_file.c_str(), field_metas, order, order));
+
+    BplusTreeKeySorter sorter(tree_handler.key_comparator().attr_comparator(),
+        tree_handler.file_header().key_length, 16 * 1024, (bp_file.string() + ".sort").c_str());
+    add_keys(tree_handler, sorter, shuffled_keys(key_num));
+    ASSERT_EQ(RC::SUCCESS, tree_handler.bulk_load(sorter, 70));
+
+    ASSERT_FALSE(tree_handler.is_empty());
+    ASSERT_TRUE(tree_handler.validate_tree());
+    check_all_values(tree_handler, key_num);
+
+    // 批量构建出来的树可以继续正常地插入和删除
+    for (int k = 0; k < key_num; k += 2) {
+      RID rid(k, k);
+      ASSERT_EQ(RC::SUCCESS, tree_handler.delete_entry(reinterpret_cast<const char *>(&k), &rid));
+    }
+    for (int k = 0; k < key_num; k += 2) {
+      RID rid(k, k);
+      ASSERT_EQ(RC::SUCCESS, tree_handler.insert_entry(reinterpret_cast<const char *>(&k), &rid));
+    }
+    ASSERT_TRUE(tree_handler.validate_tree());
+    check_all_values(tree_handler, key_num);
+  }
+}
+
+TEST(BplusTreeBulkLoad, unique)
+{
+  filesystem::path test_directory = "bplus_tree_bulk_load_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+  const filesystem::path bp_file = test_directory / "unique.bp";
+
+  FieldMeta                 field("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  BplusTreeHandler tree_handler;
+  ASSERT_EQ(RC::SUCCESS, tree_handler.create(true, log_handler, bpm, bp_file.c_str(), field_metas, 5, 5));
+
+  BplusTreeKeySorter sorter(tree_handler.key_comparator().attr_comparator(),
+      tree_handler.file_header().key_length, 1024 * 1024, (bp_file.string() + ".sort").c_str());
+  vector<int> keys = shuffled_keys(100);
+  keys.push_back(50);
+  add_keys(tree_handler, sorter, keys);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, tree_handler.bulk_load(sorter, 100));
+  ASSERT_TRUE(tree_handler.is_empty());
+}
+
+TEST(BplusTreeBulkLoad, merge)
+{
+  filesystem::path test_directory = "bplus_tree_bulk_load_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+  const filesystem::path bp_file = test_directory / "merge.bp";
+
+  FieldMeta                 field("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+
+  VacuousLogHandler log_handler;
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  BplusTreeHandler tree_handler;
+  ASSERT_EQ(RC::SUCCESS, tree_handler.create(true, log_handler, bpm, bp_file.c_str(), field_metas, 5, 5));
+
+  // 模拟并行构建：键值交错地分给几个排序器，有的写临时文件，有的只在内存中排序，还有一个是空的
+  const int                              key_num = 1000;
+  const vector<int64_t>                  memory_limits{4 * 1024, 1024 * 1024, 1024 * 1024, 8 * 1024};
+  vector<int>                            keys = shuffled_keys(key_num);
+  vector<unique_ptr<BplusTreeKeySorter>> sorters;
+  vector<BplusTreeKeyReader *>           readers;
+  for (size_t i = 0; i < memory_limits.size(); i++) {
+    sorters.push_back(make_unique<BplusTreeKeySorter>(tree_handler.key_comparator().attr_comparator(),
+        tree_handler.file_header().key_length, memory_limits[i], (bp_file.string() + ".sort." + to_string(i)).c_str()));
+    readers.push_back(sorters.back().get());
+
+    vector<int> partition_keys;
+    for (int k = static_cast<int>(i); k < key_num && i + 1 < memory_limits.size(); k += memory_limits.size() - 1) {
+      partition_keys.push_back(keys[k]);
+    }
+    add_keys(tree_handler, *sorters.back(), partition_keys);
+  }
+  ASSERT_GT(sorters[0]->run_count(), 1);
+  ASSERT_EQ(0, sorters.back()->key_count());
+
+  BplusTreeKeyMerger merger(tree_handler.key_comparator().attr_comparator(), readers);
+  ASSERT_EQ(key_num, merger.key_count());
+  ASSERT_EQ(RC::SUCCESS, tree_handler.bulk_load(merger, 100));
+  ASSERT_TRUE(tree_handler.validate_tree());
+  check_all_values(tree_handler, key_num);
+}
+
+TEST(BplusTreeBulkLoad, recover)
+{
+  filesystem::path test_directory = "bplus_tree_bulk_load_test_dir";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const filesystem::path bp_file       = test_directory / "tree.bp";
+  const filesystem::path bp_file_copy  = test_directory / "tree_copy.bp";
+  const filesystem::path log_directory = test_directory / "clog";
+
+  FieldMeta                 field("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+  const int                 key_num = 1000;
+
+  // 1. 批量构建B+树，然后复制一份文件，就像是构建完成后立即重启
+  auto bpm         = make_unique<BufferPoolManager>();
+  auto log_handler = make_unique<DiskLogHandler>();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, log_handler->init(log_directory.c_str()));
+  IntegratedLogReplayer log_replayer(*bpm);
+  ASSERT_EQ(RC::SUCCESS, log_handler->replay(log_replayer, 0));
+  ASSERT_EQ(RC::SUCCESS, log_handler->start());
+
+  auto tree_handler = make_unique<BplusTreeHandler>();
+  ASSERT_EQ(RC::SUCCESS, tree_handler->create(false, *log_handler, *bpm, bp_file.c_str(), field_metas, 5, 5));
+
+  {
+    BplusTreeKeySorter sorter(tree_handler->key_comparator().attr_comparator(),
+        tree_handler->file_header().key_length, 16 * 1024, (bp_file.string() + ".sort").c_str());
+    add_keys(*tree_handler, sorter, shuffled_keys(key_num));
+    ASSERT_EQ(RC::SUCCESS, tree_handler->bulk_load(sorter, 100));
+  }
+  ASSERT_TRUE(filesystem::copy_file(bp_file, bp_file_copy));
+
+  ASSERT_EQ(RC::SUCCESS, log_handler->stop());
+  ASSERT_EQ(RC::SUCCESS, log_handler->await_termination());
+  tree_handler.reset();
+  bpm.reset();
+  log_handler.reset();
+
+  // 2. 使用复制的文件重放日志，B+树是完整的
+  auto bpm2         = make_unique<BufferPoolManager>();
+  auto log_handler2 = make_unique<DiskLogHandler>();
+  ASSERT_EQ(RC::SUCCESS, bpm2->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *buffer_pool2 = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm2->open_file(*log_handler2, bp_file_copy.c_str(), buffer_pool2));
+  ASSERT_EQ(RC::SUCCESS, log_handler2->init(log_directory.c_str()));
+  IntegratedLogReplayer log_replayer2(*bpm2);
+  ASSERT_EQ(RC::SUCCESS, log_handler2->replay(log_replayer2, 0));
+
+  auto tree_handler2 = make_unique<BplusTreeHandler>();
+  ASSERT_EQ(RC::SUCCESS, tree_handler2->open(*log_handler2, *buffer_pool2));
+  ASSERT_TRUE(tree_handler2->validate_tree());
+  check_all_values(*tree_handler2, key_num);
+
+  tree_handler2.reset();
+  bpm2.reset();
+  log_handler2.reset();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,322 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_bulk_load.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+
+using namespace std;
+using namespace common;
+
+static const filesystem::path test_directory = "bplus_tree_compression_test_dir";
+
+/// 字符串键值的长度，前面是相同的前缀，后面补0
+static constexpr int CHARS_LENGTH = 32;
+
+static string make_chars(int value)
+{
+  char buffer[CHARS_LENGTH + 1];
+  snprintf(buffer, sizeof(buffer), "customer_%08d", value);
+  return string(buffer, CHARS_LENGTH);
+}
+
+static vector<int> shuffled_values(int value_num, uint32_t seed)
+{
+  vector<int> values(value_num);
+  for (int i = 0; i < value_num; i++) {
+    values[i] = i;
+  }
+  shuffle(values.begin(), values.end(), mt19937(seed));
+  return values;
+}
+
+class BplusTreeCompressionTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(test_directory);
+    filesystem::create_directory(test_directory);
+    ASSERT_EQ(RC::SUCCESS, bpm_.init(make_unique<VacuousDoubleWriteBuffer>()));
+  }
+
+  void TearDown() override { filesystem::remove_all(test_directory); }
+
+  unique_ptr<BplusTreeHandler> create_tree(const char *name, const vector<const FieldMeta *> &field_metas,
+      BplusTreeNodeFormat node_format, bool unique = false)
+  {
+    auto handler = make_unique<BplusTreeHandler>();
+    RC   rc      = handler->create(
+        unique, log_handler_, bpm_, (test_directory / name).c_str(), field_metas, -1, -1, node_format);
+    EXPECT_EQ(RC::SUCCESS, rc);
+    return handler;
+  }
+
+  /// 扫描整棵树，返回所有的RID
+  static vector<RID> scan_all(BplusTreeHandler &handler)
+  {
+    vector<RID>      rids;
+    BplusTreeScanner scanner(handler);
+    EXPECT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+    RID rid;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      rids.push_back(rid);
+    }
+    return rids;
+  }
+
+protected:
+  VacuousLogHandler log_handler_;
+  BufferPoolManager bpm_;
+};
+
+TEST_F(BplusTreeCompressionTest, insert_and_delete_chars)
+{
+  FieldMeta                 field("name", AttrType::CHARS, 0, CHARS_LENGTH, true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+
+  auto plain_tree      = create_tree("plain.bp", field_metas, BplusTreeNodeFormat::PLAIN);
+  auto compressed_tree = create_tree("compressed.bp", field_metas, BplusTreeNodeFormat::COMPRESSED);
+  ASSERT_TRUE(compressed_tree->file_header().compressed());
+
+  const int   value_num = 20000;
+  vector<int> values    = shuffled_values(value_num, 1);
+  for (int i = 0; i < value_num; i++) {
+    const string key = make_chars(values[i]);
+    const RID    rid(values[i], 0);
+    ASSERT_EQ(RC::SUCCESS, plain_tree->insert_entry(key.data(), &rid));
+    ASSERT_EQ(RC::SUCCESS, compressed_tree->insert_entry(key.data(), &rid));
+    if (i % 5000 == 0) {
+      ASSERT_TRUE(compressed_tree->validate_tree());
+    }
+  }
+  ASSERT_TRUE(compressed_tree->validate_tree());
+
+  // 键值的前缀相同，末尾的RID中也有很多0，压缩之后一个页面能放下更多的键值
+  EXPECT_LT(compressed_tree->buffer_pool().page_count() * 4, plain_tree->buffer_pool().page_count() * 3);
+
+  vector<RID> rids = scan_all(*compressed_tree);
+  ASSERT_EQ(value_num, static_cast<int>(rids.size()));
+  for (int i = 0; i < value_num; i++) {
+    ASSERT_EQ(i, rids[i].page_num);
+  }
+
+  for (int value : {0, 1, value_num / 2, value_num - 1}) {
+    const string key = make_chars(value);
+    list<RID>    found_rids;
+    ASSERT_EQ(RC::SUCCESS, compressed_tree->get_entry(key.data(), CHARS_LENGTH, found_rids));
+    ASSERT_EQ(1, static_cast<int>(found_rids.size()));
+    ASSERT_EQ(value, found_rids.front().page_num);
+  }
+
+  values = shuffled_values(value_num, 2);
+  for (int i = 0; i < value_num; i++) {
+    const string key = make_chars(values[i]);
+    const RID    rid(values[i], 0);
+    ASSERT_EQ(RC::SUCCESS, compressed_tree->delete_entry(key.data(), &rid));
+    if (i % 5000 == 0) {
+      ASSERT_TRUE(compressed_tree->validate_tree());
+    }
+  }
+  ASSERT_TRUE(compressed_tree->is_empty());
+}
+
+TEST_F(BplusTreeCompressionTest, mixed_prefixes)
+{
+  // 不同前缀的键值交替插入和删除，页面经常需要重新编码，父节点的键值也会变长
+  FieldMeta                 field("name", AttrType::CHARS, 0, CHARS_LENGTH, true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+  auto tree = create_tree("mixed.bp", field_metas, BplusTreeNodeFormat::COMPRESSED, true /*unique*/);
+
+  mt19937     random(3);
+  set<string> keys;
+  while (keys.size() < 15000) {
+    string key(CHARS_LENGTH, '\0');
+    if (random() % 4 == 0) {
+      const int length = 1 + random() % CHARS_LENGTH;
+      for (int i = 0; i < length; i++) {
+        key[i] = 'a' + random() % 26;
+      }
+    } else {
+      key = make_chars(random() % 1000000);
+    }
+    keys.insert(key);
+  }
+
+  vector<string> shuffled_keys(keys.begin(), keys.end());
+  shuffle(shuffled_keys.begin(), shuffled_keys.end(), random);
+  for (size_t i = 0; i < shuffled_keys.size(); i++) {
+    const RID rid(static_cast<PageNum>(i), 0);
+    ASSERT_EQ(RC::SUCCESS, tree->insert_entry(shuffled_keys[i].data(), &rid));
+  }
+  ASSERT_TRUE(tree->validate_tree());
+
+  const RID duplicate_rid(-1, 0);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, tree->insert_entry(shuffled_keys[0].data(), &duplicate_rid));
+
+  // 删除一半之后再插入回来
+  const size_t half = shuffled_keys.size() / 2;
+  for (size_t i = 0; i < half; i++) {
+    const RID rid(static_cast<PageNum>(i), 0);
+    ASSERT_EQ(RC::SUCCESS, tree->delete_entry(shuffled_keys[i].data(), &rid));
+  }
+  ASSERT_TRUE(tree->validate_tree());
+  for (size_t i = 0; i < half; i++) {
+    const RID rid(static_cast<PageNum>(i), 0);
+    ASSERT_EQ(RC::SUCCESS, tree->insert_entry(shuffled_keys[i].data(), &rid));
+  }
+  ASSERT_TRUE(tree->validate_tree());
+  ASSERT_EQ(keys.size(), scan_all(*tree).size());
+
+  for (size_t i = 0; i < shuffled_keys.size(); i++) {
+    const RID rid(static_cast<PageNum>(i), 0);
+    ASSERT_EQ(RC::SUCCESS, tree->delete_entry(shuffled_keys[i].data(), &rid));
+  }
+  ASSERT_TRUE(tree->is_empty());
+}
+
+TEST_F(BplusTreeCompressionTest, long_keys)
+{
+  // 键值很长时一个页面只能放下几十个键值，能压缩的键值和不能压缩的键值混在一起，
+  // 删除时重新分配节点可能让父节点的键值变长，父节点放不下就需要分裂
+  const int                 length = 240;
+  FieldMeta                 field("name", AttrType::CHARS, 0, length, true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+  auto tree = create_tree("long.bp", field_metas, BplusTreeNodeFormat::COMPRESSED);
+
+  mt19937        random(6);
+  vector<string> keys;
+  for (int i = 0; i < 20000; i++) {
+    string key(length, '\0');
+    if (i % 50 == 0) {
+      for (int j = 0; j < length; j++) {
+        key[j] = 'a' + random() % 26;
+      }
+    } else {
+      snprintf(key.data(), length, "customer_%08d", i);
+    }
+    keys.push_back(key);
+  }
+
+  vector<int> order = shuffled_values(static_cast<int>(keys.size()), 7);
+  for (int i : order) {
+    const RID rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, tree->insert_entry(keys[i].data(), &rid));
+  }
+  ASSERT_TRUE(tree->validate_tree());
+
+  order = shuffled_values(static_cast<int>(keys.size()), 8);
+  for (size_t n = 0; n < order.size(); n++) {
+    const int i = order[n];
+    const RID rid(i, 0);
+    ASSERT_EQ(RC::SUCCESS, tree->delete_entry(keys[i].data(), &rid));
+    if (n % 2000 == 0) {
+      ASSERT_TRUE(tree->validate_tree());
+    }
+  }
+  ASSERT_TRUE(tree->is_empty());
+}
+
+TEST_F(BplusTreeCompressionTest, composite_keys)
+{
+  // 多个字段组成的键值，同一个键值对应多个RID
+  FieldMeta                 name_field("name", AttrType::CHARS, 0, 8, true, 0);
+  FieldMeta                 id_field("id", AttrType::INTS, 8, sizeof(int), true, 1);
+  vector<const FieldMeta *> field_metas{&name_field, &id_field};
+  auto tree = create_tree("composite.bp", field_metas, BplusTreeNodeFormat::COMPRESSED);
+
+  auto make_user_key = [](int value) {
+    string user_key(8 + sizeof(int), '\0');
+    snprintf(user_key.data(), 8, "k%d", value % 10);
+    memcpy(user_key.data() + 8, &value, sizeof(value));
+    return user_key;
+  };
+
+  const int   value_num = 3000;
+  const int   rid_num   = 3;
+  vector<int> values    = shuffled_values(value_num, 4);
+  for (int value : values) {
+    for (int slot = 0; slot < rid_num; slot++) {
+      const RID rid(value, slot);
+      ASSERT_EQ(RC::SUCCESS, tree->insert_entry(make_user_key(value).data(), &rid));
+    }
+  }
+  ASSERT_TRUE(tree->validate_tree());
+
+  list<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, tree->get_entry(make_user_key(1234).data(), 8 + sizeof(int), rids));
+  ASSERT_EQ(rid_num, static_cast<int>(rids.size()));
+
+  for (int value : values) {
+    for (int slot = 0; slot < rid_num; slot++) {
+      const RID rid(value, slot);
+      ASSERT_EQ(RC::SUCCESS, tree->delete_entry(make_user_key(value).data(), &rid));
+    }
+  }
+  ASSERT_TRUE(tree->is_empty());
+}
+
+TEST_F(BplusTreeCompressionTest, bulk_load)
+{
+  FieldMeta                 field("name", AttrType::CHARS, 0, CHARS_LENGTH, true, 0);
+  vector<const FieldMeta *> field_metas{&field};
+
+  for (int value_num : {1, 100, 30000}) {
+    auto tree = create_tree(("bulk" + to_string(value_num) + ".bp").c_str(),
+        field_metas, BplusTreeNodeFormat::COMPRESSED);
+
+    BplusTreeKeySorter sorter(tree->key_comparator().attr_comparator(),
+        tree->file_header().key_length,
+        64 * 1024 * 1024,
+        (test_directory / "keys.sort").c_str());
+    vector<char> key(tree->file_header().key_length);
+    for (int value : shuffled_values(value_num, 5)) {
+      tree->make_key(make_chars(value).data(), RID(value, 0), key.data());
+      ASSERT_EQ(RC::SUCCESS, sorter.add(key.data()));
+    }
+    ASSERT_EQ(RC::SUCCESS, sorter.finish());
+    ASSERT_EQ(RC::SUCCESS, tree->bulk_load(sorter, 90));
+    ASSERT_TRUE(tree->validate_tree());
+
+    vector<RID> rids = scan_all(*tree);
+    ASSERT_EQ(value_num, static_cast<int>(rids.size()));
+    for (int i = 0; i < value_num; i++) {
+      ASSERT_EQ(i, rids[i].page_num);
+    }
+
+    // 批量构建之后还可以正常地插入和删除
+    for (int value = value_num; value < value_num + 1000; value++) {
+      const RID rid(value, 0);
+      ASSERT_EQ(RC::SUCCESS, tree->insert_entry(make_chars(value).data(), &rid));
+    }
+    for (int value = 0; value < value_num; value += 2) {
+      const RID rid(value, 0);
+      ASSERT_EQ(RC::SUCCESS, tree->delete_entry(make_chars(value).data(), &rid));
+    }
+    ASSERT_TRUE(tree->validate_tree());
+    ASSERT_EQ(value_num / 2 + 1000, static_cast<int>(scan_all(*tree).size()));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  filesystem::path log_filename = filesystem::path(argv[0]).filename();
+  LoggerFactory::init_default(log_filename.string() + ".log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
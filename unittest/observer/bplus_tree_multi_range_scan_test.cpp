@@ -0,0 +1,227 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+
+using namespace std;
+using namespace common;
+
+static const filesystem::path test_directory = "bplus_tree_multi_range_scan_test_dir";
+
+/// 每个键值重复的次数
+static int duplicate_num(int value) { return value % 3 + 1; }
+
+/// 用整数描述的范围，没有边界时对应的指针为空
+struct IntRange
+{
+  const int *left;
+  bool       left_inclusive;
+  const int *right;
+  bool       right_inclusive;
+
+  bool contains(int value) const
+  {
+    if (left != nullptr && (value < *left || (value == *left && !left_inclusive))) {
+      return false;
+    }
+    if (right != nullptr && (value > *right || (value == *right && !right_inclusive))) {
+      return false;
+    }
+    return true;
+  }
+};
+
+class BplusTreeMultiRangeScanTest : public testing::TestWithParam<BplusTreeNodeFormat>
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(test_directory);
+    filesystem::create_directory(test_directory);
+    ASSERT_EQ(RC::SUCCESS, bpm_.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+    FieldMeta field_meta("key", AttrType::INTS, 0 /*attr_offset*/, sizeof(int), true /*visible*/, 0 /*field_id*/);
+    RC        rc = handler_.create(false /*unique*/,
+        log_handler_,
+        bpm_,
+        (test_directory / "multi_range_scan.btree").c_str(),
+        {&field_meta},
+        -1,
+        -1,
+        GetParam());
+    ASSERT_EQ(RC::SUCCESS, rc);
+  }
+
+  void TearDown() override
+  {
+    handler_.close();
+    filesystem::remove_all(test_directory);
+  }
+
+  /// 插入 [0, max_value) 之间的偶数，每个键值重复 duplicate_num 次
+  void insert_even_values(int max_value)
+  {
+    max_value_ = max_value;
+    for (int value = 0; value < max_value; value += 2) {
+      for (int i = 0; i < duplicate_num(value); i++) {
+        RID rid(value, i);
+        ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+      }
+    }
+  }
+
+  RC scan(const vector<IntRange> &ranges, vector<RID> &rids)
+  {
+    vector<BplusTreeScanRange> tree_ranges;
+    for (const IntRange &range : ranges) {
+      tree_ranges.push_back(BplusTreeScanRange{reinterpret_cast<const char *>(range.left),
+          range.left_inclusive,
+          reinterpret_cast<const char *>(range.right),
+          range.right_inclusive});
+    }
+
+    BplusTreeScanner scanner(handler_);
+    RC               rc = scanner.open(tree_ranges);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    RID rid;
+    while (OB_SUCC(rc = scanner.next_entry(rid))) {
+      rids.push_back(rid);
+    }
+    return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+  }
+
+  /// 按照插入的数据计算出范围内的所有记录
+  vector<RID> expected_rids(const vector<IntRange> &ranges) const
+  {
+    vector<RID> rids;
+    for (const IntRange &range : ranges) {
+      for (int value = 0; value < max_value_; value += 2) {
+        for (int i = 0; range.contains(value) && i < duplicate_num(value); i++) {
+          rids.emplace_back(value, i);
+        }
+      }
+    }
+    return rids;
+  }
+
+protected:
+  BufferPoolManager bpm_;
+  VacuousLogHandler log_handler_;
+  BplusTreeHandler  handler_;
+  int               max_value_ = 0;
+};
+
+TEST_P(BplusTreeMultiRangeScanTest, same_as_expected)
+{
+  const int max_value = 20000;
+  insert_even_values(max_value);
+
+  // 各种边界的组合：相邻的点、同一个叶子节点中的范围、跨越多个叶子节点的范围，以及首尾没有边界的范围
+  vector<int> bounds;
+  for (int value = 1; value < max_value + 100; value += 13) {
+    bounds.push_back(value);
+  }
+  bounds.insert(bounds.begin() + 10, {140, 141, 142, 142});
+  sort(bounds.begin(), bounds.end());
+
+  vector<IntRange> ranges;
+  ranges.push_back(IntRange{nullptr, true, &bounds[0], false});
+  for (size_t i = 1; i + 1 < bounds.size(); i += 2) {
+    const bool inclusive = i % 4 == 1;
+    if (bounds[i] == bounds[i + 1] && !inclusive) {
+      continue;
+    }
+    ranges.push_back(IntRange{&bounds[i], inclusive, &bounds[i + 1], inclusive});
+  }
+  const int far_left = max_value * 2;
+  ranges.push_back(IntRange{&far_left, true, nullptr, true});
+
+  vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, scan(ranges, rids));
+  ASSERT_EQ(expected_rids(ranges), rids);
+
+  // 只有一个没有边界的范围就是扫描整棵树
+  rids.clear();
+  ASSERT_EQ(RC::SUCCESS, scan({IntRange{nullptr, true, nullptr, true}}, rids));
+  ASSERT_EQ(expected_rids({IntRange{nullptr, true, nullptr, true}}), rids);
+}
+
+TEST_P(BplusTreeMultiRangeScanTest, point_ranges)
+{
+  const int max_value = 5000;
+  insert_even_values(max_value);
+
+  // IN 列表对应的点，包括不存在的键值和超出范围的键值
+  vector<int> points{-3, 0, 1, 2, 100, 101, 102, 2000, 4998, 4999, 6000};
+  vector<IntRange> ranges;
+  for (const int &point : points) {
+    ranges.push_back(IntRange{&point, true, &point, true});
+  }
+
+  vector<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, scan(ranges, rids));
+  ASSERT_EQ(expected_rids(ranges), rids);
+}
+
+TEST_P(BplusTreeMultiRangeScanTest, invalid_ranges)
+{
+  insert_even_values(100);
+
+  const vector<int> values{2, 4, 6, 8};
+  vector<RID>       rids;
+
+  // 左边界大于右边界
+  ASSERT_EQ(RC::INVALID_ARGUMENT, scan({IntRange{&values[1], true, &values[0], true}}, rids));
+  // 范围重叠
+  ASSERT_EQ(RC::INVALID_ARGUMENT,
+      scan({IntRange{&values[0], true, &values[2], true}, IntRange{&values[1], true, &values[3], true}}, rids));
+  // 没有排序
+  ASSERT_EQ(RC::INVALID_ARGUMENT,
+      scan({IntRange{&values[2], true, &values[3], true}, IntRange{&values[0], true, &values[1], true}}, rids));
+  // 中间的范围没有边界
+  ASSERT_EQ(RC::INVALID_ARGUMENT,
+      scan({IntRange{&values[0], true, nullptr, true}, IntRange{&values[2], true, &values[3], true}}, rids));
+  ASSERT_TRUE(rids.empty());
+
+  // 相邻但是不重叠的范围
+  ASSERT_EQ(RC::SUCCESS,
+      scan({IntRange{&values[0], true, &values[1], false}, IntRange{&values[1], true, &values[2], true}}, rids));
+  ASSERT_EQ(vector<RID>({RID(2, 0), RID(2, 1), RID(2, 2), RID(4, 0), RID(4, 1), RID(6, 0)}), rids);
+}
+
+TEST_P(BplusTreeMultiRangeScanTest, empty_tree)
+{
+  const vector<int> values{1, 2, 3};
+  vector<RID>       rids;
+  ASSERT_EQ(RC::SUCCESS,
+      scan({IntRange{nullptr, true, &values[0], true}, IntRange{&values[1], true, &values[2], true}}, rids));
+  ASSERT_TRUE(rids.empty());
+
+  ASSERT_EQ(RC::SUCCESS, scan({}, rids));
+  ASSERT_TRUE(rids.empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeFormats, BplusTreeMultiRangeScanTest,
+    testing::Values(BplusTreeNodeFormat::PLAIN, BplusTreeNodeFormat::COMPRESSED));
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,9 @@ See the Mulan PSL v2 for more details. */
 #include <filesystem>
 
 #include "gtest/gtest.h"
+#include "common/lang/chrono.h"
+#include "common/lang/limits.h"
+#include "common/lang/thread.h"
 #include "common/log/log.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/clog/vacuous_log_handler.h"
@@ -132,6 +135,188 @@ TEST(BufferPool, create)
   ASSERT_EQ(buffer_pool->id(), buffer_pool2->id());
 }
 
+TEST(DiskBufferPool, scan_ring)
+{
+  filesystem::path test_directory("buffer_pool");
+  filesystem::path bp_file = test_directory / "scan_ring.bp";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const int         ring_size = 4;
+  BufferPoolManager bpm(BufferPoolOptions{.scan_ring_size = ring_size});
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+  VacuousLogHandler log_handler;
+  DiskBufferPool   *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+
+  const int page_num = 50;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+
+  // 重新打开文件，内存中只剩下文件头页面
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+  BPFrameManager &frame_manager = bpm.get_frame_manager();
+  ASSERT_EQ(1, static_cast<int>(frame_manager.frame_num()));
+
+  // 扫描之前就在内存中的页面，不会被扫描淘汰
+  const PageNum hot_page = 10;
+  Frame        *frame    = nullptr;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(hot_page, &frame));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+
+  ScanRing scan_ring;
+  for (PageNum i = 1; i <= page_num; i++) {
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(i, &frame, &scan_ring));
+    ASSERT_EQ(i, frame->page_num());
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+    ASSERT_LE(static_cast<int>(scan_ring.size()), ring_size);
+    ASSERT_LE(static_cast<int>(frame_manager.frame_num()), ring_size + 2);
+  }
+
+  frame = frame_manager.get(buffer_pool->id(), hot_page);
+  ASSERT_NE(nullptr, frame);
+  frame->unpin();
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+}
+
+TEST(DiskBufferPool, read_ahead)
+{
+  filesystem::path test_directory("buffer_pool");
+  filesystem::path bp_file = test_directory / "read_ahead.bp";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const int         ring_size        = 8;
+  const int         read_ahead_pages = 4;
+  BufferPoolManager bpm(BufferPoolOptions{.scan_ring_size = ring_size, .read_ahead_pages = read_ahead_pages});
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+  VacuousLogHandler log_handler;
+  DiskBufferPool   *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+
+  const int page_num = 50;
+  for (int i = 0; i < page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    PageNum this_page = frame->page_num();
+    memcpy(frame->data(), &this_page, sizeof(this_page));
+    frame->mark_dirty();
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+  BPFrameManager &frame_manager = bpm.get_frame_manager();
+
+  ScanRing scan_ring;
+  for (PageNum i = 1; i <= page_num; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(i, &frame, &scan_ring));
+    ASSERT_EQ(i, frame->page_num());
+    ASSERT_EQ(i, *reinterpret_cast<PageNum *>(frame->data()));
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+    ASSERT_LE(static_cast<int>(scan_ring.size()), ring_size);
+
+    // 连续访问两个页面之后开始预读，等待后面的一个页面加载完成，后面访问它时一定是命中的
+    if (i == 2) {
+      Frame *prefetched_frame = nullptr;
+      for (int retry = 0; retry < 1000 && prefetched_frame == nullptr; retry++) {
+        prefetched_frame = frame_manager.get(buffer_pool->id(), i + read_ahead_pages);
+        if (prefetched_frame == nullptr) {
+          this_thread::sleep_for(chrono::milliseconds(1));
+        }
+      }
+      ASSERT_NE(nullptr, prefetched_frame);
+      prefetched_frame->wait_loaded();
+      prefetched_frame->unpin();
+    }
+  }
+
+  ASSERT_GT(buffer_pool->read_ahead_pages(), 0);
+  ASSERT_GT(buffer_pool->read_ahead_hits(), 0);
+  ASSERT_LE(buffer_pool->read_ahead_hits(), buffer_pool->read_ahead_pages());
+  ASSERT_LE(static_cast<int>(frame_manager.frame_num()), ring_size + read_ahead_pages + 2);
+
+  // B+树按照兄弟指针预读单个页面，关闭文件时会等待预读任务完成
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(1, &frame));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  buffer_pool->read_ahead_page(1);
+  buffer_pool->read_ahead_page(page_num + 1);
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+}
+
+TEST(DiskBufferPool, dirty_page_list)
+{
+  filesystem::path test_directory("buffer_pool");
+  filesystem::path bp_file = test_directory / "dirty_page_list.bp";
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  BufferPoolManager bpm(BufferPoolOptions{.frame_shard_num = 1});
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(bp_file.c_str()));
+
+  LSN             current_lsn   = 0;
+  BPFrameManager &frame_manager = bpm.get_frame_manager();
+  frame_manager.set_lsn_provider([&current_lsn]() { return current_lsn; });
+
+  VacuousLogHandler log_handler;
+  DiskBufferPool   *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, bp_file.c_str(), buffer_pool));
+  ASSERT_EQ(0, frame_manager.min_recovery_lsn());
+
+  // 第i个页面在LSN为 i*10 时变脏，文件头页面和第一个页面一起变脏
+  const int page_num = 10;
+  for (int i = 1; i <= page_num; i++) {
+    current_lsn  = i * 10;
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->allocate_page(&frame));
+    frame->mark_dirty();
+    ASSERT_EQ(current_lsn + 1, frame->recovery_lsn());
+    ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+  }
+  ASSERT_EQ(11, frame_manager.min_recovery_lsn());
+  ASSERT_EQ(page_num + 1, static_cast<int>(frame_manager.dirty_frame_num()));
+
+  // 再次修改不会改变页面在脏页链表中的位置
+  Frame *frame = nullptr;
+  current_lsn  = 1000;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->get_this_page(2, &frame));
+  frame->mark_dirty();
+  ASSERT_EQ(21, frame->recovery_lsn());
+  ASSERT_EQ(RC::SUCCESS, buffer_pool->unpin_page(frame));
+
+  // 刷新最早的两个页面
+  ASSERT_EQ(2, bpm.flush_oldest_pages(0, 2, numeric_limits<LSN>::max()));
+  ASSERT_EQ(21, frame_manager.min_recovery_lsn());
+  ASSERT_EQ(page_num - 1, static_cast<int>(frame_manager.dirty_frame_num()));
+
+  // 只刷新 recovery lsn 不大于51的页面
+  ASSERT_EQ(4, bpm.flush_oldest_pages(0, 100, 51));
+  ASSERT_EQ(61, frame_manager.min_recovery_lsn());
+
+  frame = frame_manager.get(buffer_pool->id(), 3);
+  ASSERT_NE(nullptr, frame);
+  ASSERT_FALSE(frame->dirty());
+  ASSERT_EQ(0, frame->recovery_lsn());
+  frame->unpin();
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(bp_file.c_str()));
+  ASSERT_EQ(0, frame_manager.min_recovery_lsn());
+  ASSERT_EQ(0, static_cast<int>(frame_manager.dirty_frame_num()));
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -180,6 +180,56 @@ TEST(DiskLogHandler, multi_thread)
   ASSERT_EQ(RC::SUCCESS, handler.await_termination());
 }
 
+TEST(DiskLogHandler, group_commit)
+{
+  const char *directory = "test_log_handler_group_commit";
+  filesystem::remove_all(directory);
+
+  LogHandlerOptions options;
+  options.group_commit_window_us = 1000;
+  DiskLogHandler  handler(options);
+  TestLogReplayer replayer;
+  ASSERT_EQ(RC::SUCCESS, handler.init(directory));
+  ASSERT_EQ(RC::SUCCESS, handler.replay(replayer, 0));
+  ASSERT_EQ(RC::SUCCESS, handler.start());
+
+  // 每个线程模拟事务提交：写一条日志，等待它落盘
+  const int      thread_num = 16;
+  const int      times      = 100;
+  vector<thread> threads;
+  for (int i = 0; i < thread_num; i++) {
+    threads.emplace_back([&handler]() {
+      for (int j = 0; j < times; j++) {
+        LSN          lsn = 0;
+        vector<char> data(10);
+        ASSERT_EQ(RC::SUCCESS, handler.append(lsn, LogModule::Id::BUFFER_POOL, std::move(data)));
+        ASSERT_EQ(RC::SUCCESS, handler.wait_lsn(lsn));
+        ASSERT_GE(handler.current_flushed_lsn(), lsn);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  // 多个事务共用一次fsync
+  ASSERT_EQ(thread_num * times, handler.current_flushed_lsn());
+  ASSERT_LT(handler.flush_group_count(), thread_num * times);
+
+  ASSERT_EQ(RC::SUCCESS, handler.stop());
+  ASSERT_EQ(RC::SUCCESS, handler.await_termination());
+
+  int  count             = 0;
+  auto log_entry_counter = [&count](LogEntry &) -> RC {
+    count++;
+    return RC::SUCCESS;
+  };
+  ASSERT_EQ(RC::SUCCESS, handler.iterate(log_entry_counter, 0));
+  ASSERT_EQ(thread_num * times, count);
+
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
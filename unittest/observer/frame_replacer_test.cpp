@@ -0,0 +1,235 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "gtest/gtest.h"
+#include "storage/buffer/frame_replacer.h"
+
+using namespace std;
+
+/**
+ * @brief 模拟一个页帧个数固定的缓冲池，用来测试淘汰策略
+ */
+class FramePool
+{
+public:
+  FramePool(FrameReplacer &replacer, int capacity) : replacer_(replacer), frames_(capacity) {}
+
+  /**
+   * @brief 访问一个页面，不在内存中就淘汰一个页面之后加载
+   * @return 是否命中
+   */
+  bool access(PageNum page_num)
+  {
+    for (Frame &frame : frames_) {
+      if (frame.page_num() == page_num) {
+        replacer_.access(&frame);
+        return true;
+      }
+    }
+
+    Frame *free_frame = nullptr;
+    for (Frame &frame : frames_) {
+      if (frame.page_num() == -1) {
+        free_frame = &frame;
+        break;
+      }
+    }
+
+    if (free_frame == nullptr) {
+      free_frame = replacer_.victim([](Frame *frame) { return frame->pin_count() == 0; });
+      EXPECT_NE(nullptr, free_frame);
+      replacer_.evict(free_frame);
+      replacer_.remove(free_frame);
+    }
+
+    free_frame->set_buffer_pool_id(0);
+    free_frame->set_page_num(page_num);
+    replacer_.insert(free_frame);
+    return false;
+  }
+
+  bool contains(PageNum page_num) const
+  {
+    for (const Frame &frame : frames_) {
+      if (frame.page_num() == page_num) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Frame *find(PageNum page_num)
+  {
+    for (Frame &frame : frames_) {
+      if (frame.page_num() == page_num) {
+        return &frame;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  FrameReplacer &replacer_;
+  vector<Frame>  frames_;
+};
+
+/**
+ * @brief 反复访问一些热页面，然后做一次全表扫描，再检查热页面是否还在内存中
+ */
+int hot_pages_after_scan(FrameReplacer &replacer, int capacity)
+{
+  FramePool pool(replacer, capacity);
+
+  const int hot_page_num = capacity / 2;
+  for (int round = 0; round < 4; round++) {
+    for (PageNum page_num = 0; page_num < hot_page_num; page_num++) {
+      pool.access(page_num);
+    }
+  }
+
+  for (PageNum page_num = 1000; page_num < 1000 + capacity * 10; page_num++) {
+    pool.access(page_num);
+  }
+
+  int hot_num = 0;
+  for (PageNum page_num = 0; page_num < hot_page_num; page_num++) {
+    if (pool.contains(page_num)) {
+      hot_num++;
+    }
+  }
+  return hot_num;
+}
+
+TEST(FrameReplacer, type_from_string)
+{
+  FrameReplacerType type = FrameReplacerType::LRU;
+  ASSERT_EQ(RC::SUCCESS, frame_replacer_type_from_string("LRU-K", type));
+  ASSERT_EQ(FrameReplacerType::LRU_K, type);
+  ASSERT_EQ(RC::SUCCESS, frame_replacer_type_from_string("clock_pro", type));
+  ASSERT_EQ(FrameReplacerType::CLOCK_PRO, type);
+  ASSERT_STREQ("clock-pro", frame_replacer_type_name(type));
+  ASSERT_NE(RC::SUCCESS, frame_replacer_type_from_string("arc", type));
+  ASSERT_EQ(FrameReplacerType::CLOCK_PRO, type);
+}
+
+TEST(FrameReplacer, lru)
+{
+  LruFrameReplacer replacer;
+  FramePool        pool(replacer, 3);
+  pool.access(1);
+  pool.access(2);
+  pool.access(3);
+  pool.access(1);
+
+  // 2 是最久没有访问的
+  pool.access(4);
+  ASSERT_FALSE(pool.contains(2));
+  ASSERT_TRUE(pool.contains(1));
+
+  // 被pin住的页面不会淘汰
+  Frame *frame = pool.find(3);
+  frame->pin();
+  ASSERT_EQ(pool.find(1), replacer.victim([](Frame *frame) { return frame->pin_count() == 0; }));
+  frame->unpin();
+  ASSERT_EQ(3, static_cast<int>(replacer.size()));
+
+  // 全表扫描会把热页面都淘汰出去
+  LruFrameReplacer scan_replacer;
+  ASSERT_EQ(0, hot_pages_after_scan(scan_replacer, 16));
+}
+
+TEST(FrameReplacer, lru_k)
+{
+  LruKFrameReplacer replacer(2);
+  FramePool         pool(replacer, 3);
+  pool.access(1);
+  pool.access(1);
+  pool.access(2);
+  pool.access(2);
+  pool.access(3);
+
+  // 3 只访问了一次，倒数第2次访问时间是无穷远
+  pool.access(4);
+  ASSERT_FALSE(pool.contains(3));
+
+  // 4 也只访问了一次
+  pool.access(5);
+  ASSERT_FALSE(pool.contains(4));
+  ASSERT_TRUE(pool.contains(1));
+  ASSERT_TRUE(pool.contains(2));
+
+  // 5 访问两次之后，1 的倒数第2次访问最早
+  pool.access(5);
+  pool.access(6);
+  ASSERT_FALSE(pool.contains(1));
+
+  LruKFrameReplacer scan_replacer(2);
+  ASSERT_EQ(8, hot_pages_after_scan(scan_replacer, 16));
+}
+
+TEST(FrameReplacer, clock_pro)
+{
+  ClockProFrameReplacer replacer(4);
+  FramePool             pool(replacer, 4);
+  for (PageNum page_num = 1; page_num <= 4; page_num++) {
+    ASSERT_FALSE(pool.access(page_num));
+  }
+  ASSERT_EQ(4, replacer.cold_count());
+  ASSERT_EQ(0, replacer.hot_count());
+
+  // 淘汰最早加载的冷页面，它还在测试期内，会保留它的记录
+  ASSERT_FALSE(pool.access(5));
+  ASSERT_FALSE(pool.contains(1));
+  ASSERT_EQ(1, replacer.test_count());
+  ASSERT_EQ(4, static_cast<int>(replacer.size()));
+
+  // 测试期内再次加载，直接变成热页面
+  ASSERT_FALSE(pool.access(1));
+  ASSERT_FALSE(pool.contains(2));
+  ASSERT_TRUE(pool.contains(1));
+  ASSERT_EQ(1, replacer.hot_count());
+  ASSERT_EQ(3, replacer.cold_count());
+  ASSERT_EQ(1, replacer.test_count());
+
+  // 热页面不会先于冷页面淘汰
+  ASSERT_FALSE(pool.access(6));
+  ASSERT_FALSE(pool.access(7));
+  ASSERT_TRUE(pool.contains(1));
+
+  // 冷页面的内存是自适应调整的，刚开始的时候可能会淘汰少量的热页面
+  ClockProFrameReplacer scan_replacer(16);
+  ASSERT_GE(hot_pages_after_scan(scan_replacer, 16), 8 * 3 / 4);
+}
+
+TEST(FrameReplacer, all_pinned)
+{
+  for (FrameReplacerType type : {FrameReplacerType::LRU, FrameReplacerType::LRU_K, FrameReplacerType::CLOCK_PRO}) {
+    unique_ptr<FrameReplacer> replacer = FrameReplacer::create(type, 4, 2);
+    FramePool                 pool(*replacer, 4);
+    for (PageNum page_num = 1; page_num <= 4; page_num++) {
+      pool.access(page_num);
+      pool.access(page_num);
+      pool.find(page_num)->pin();
+    }
+
+    ASSERT_EQ(nullptr, replacer->victim([](Frame *frame) { return frame->pin_count() == 0; }))
+        << frame_replacer_type_name(type);
+
+    pool.find(3)->unpin();
+    ASSERT_EQ(pool.find(3), replacer->victim([](Frame *frame) { return frame->pin_count() == 0; }))
+        << frame_replacer_type_name(type);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <map>
+#include <memory>
+
+#include "sql/operator/hash_join_physical_operator.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 按照名字从tuple中取值，与FieldExpr相同，但是不需要真实的表
+ */
+class NamedCellExpr : public Expression
+{
+public:
+  NamedCellExpr(const char *table_name, const char *field_name) : spec_(table_name, field_name) {}
+
+  RC get_value(const Tuple &tuple, Value &value) const override { return tuple.find_cell(spec_, value); }
+
+  ExprType type() const override { return ExprType::FIELD; }
+  AttrType value_type() const override { return AttrType::INTS; }
+
+private:
+  TupleCellSpec spec_;
+};
+
+/**
+ * @brief 输出固定数据的算子，每行两列：id 和 v
+ */
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  RowsPhysicalOperator(const char *table_name, vector<pair<int, int>> rows) : rows_(std::move(rows))
+  {
+    tuple_.set_names({TupleCellSpec(table_name, "id"), TupleCellSpec(table_name, "v")});
+  }
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::STRING_LIST; }
+
+  RC open(Trx *) override
+  {
+    index_ = -1;
+    return RC::SUCCESS;
+  }
+
+  RC next() override
+  {
+    if (++index_ >= static_cast<int>(rows_.size())) {
+      return RC::RECORD_EOF;
+    }
+    tuple_.set_cells({Value(rows_[index_].first), Value(rows_[index_].second)});
+    return RC::SUCCESS;
+  }
+
+  RC close() override { return RC::SUCCESS; }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  vector<pair<int, int>> rows_;
+  int                    index_ = -1;
+  ValueListTuple         tuple_;
+};
+
+/// 返回 (左边v, 右边v) -> 出现次数
+static map<pair<int, int>, int> run_join(
+    const vector<pair<int, int>> &left_rows, const vector<pair<int, int>> &right_rows, int64_t memory_limit, bool &spilled)
+{
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  left_keys.emplace_back(new NamedCellExpr("t1", "id"));
+  right_keys.emplace_back(new NamedCellExpr("t2", "id"));
+
+  HashJoinPhysicalOperator join(std::move(left_keys), std::move(right_keys), memory_limit);
+  join.add_child(make_unique<RowsPhysicalOperator>("t1", left_rows));
+  join.add_child(make_unique<RowsPhysicalOperator>("t2", right_rows));
+
+  map<pair<int, int>, int> result;
+  EXPECT_EQ(RC::SUCCESS, join.open(nullptr));
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = join.next())) {
+    Tuple *tuple = join.current_tuple();
+    EXPECT_EQ(4, tuple->cell_num());
+
+    Value left_id, left_v, right_id, right_v;
+    EXPECT_EQ(RC::SUCCESS, tuple->cell_at(0, left_id));
+    EXPECT_EQ(RC::SUCCESS, tuple->cell_at(1, left_v));
+    EXPECT_EQ(RC::SUCCESS, tuple->cell_at(2, right_id));
+    EXPECT_EQ(RC::SUCCESS, tuple->cell_at(3, right_v));
+    EXPECT_EQ(left_id.get_int(), right_id.get_int());
+    result[{left_v.get_int(), right_v.get_int()}]++;
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  spilled = join.spilled();
+  EXPECT_EQ(RC::SUCCESS, join.close());
+  return result;
+}
+
+static map<pair<int, int>, int> nested_loop_join(
+    const vector<pair<int, int>> &left_rows, const vector<pair<int, int>> &right_rows)
+{
+  map<pair<int, int>, int> result;
+  for (auto &left : left_rows) {
+    for (auto &right : right_rows) {
+      if (left.first == right.first) {
+        result[{left.second, right.second}]++;
+      }
+    }
+  }
+  return result;
+}
+
+TEST(HashJoinPhysicalOperator, in_memory)
+{
+  vector<pair<int, int>> left_rows  = {{1, 100}, {2, 200}, {3, 300}, {3, 301}};
+  vector<pair<int, int>> right_rows = {{1, 10}, {1, 11}, {3, 30}, {4, 40}};
+
+  bool spilled = true;
+  auto result  = run_join(left_rows, right_rows, 64 * 1024 * 1024, spilled);
+  ASSERT_FALSE(spilled);
+  ASSERT_EQ(nested_loop_join(left_rows, right_rows), result);
+  ASSERT_EQ(4, result.size());
+}
+
+TEST(HashJoinPhysicalOperator, empty_side)
+{
+  vector<pair<int, int>> rows = {{1, 100}, {2, 200}};
+
+  bool spilled = true;
+  ASSERT_TRUE(run_join(rows, {}, 64 * 1024 * 1024, spilled).empty());
+  ASSERT_TRUE(run_join({}, rows, 64 * 1024 * 1024, spilled).empty());
+  ASSERT_TRUE(run_join({}, rows, 1, spilled).empty());
+  ASSERT_TRUE(spilled);
+}
+
+TEST(HashJoinPhysicalOperator, spill)
+{
+  vector<pair<int, int>> left_rows;
+  vector<pair<int, int>> right_rows;
+  for (int i = 0; i < 2000; i++) {
+    left_rows.emplace_back(i % 500, i);
+    right_rows.emplace_back(i % 700, i);
+  }
+
+  bool spilled = false;
+  auto result  = run_join(left_rows, right_rows, 4096, spilled);
+  ASSERT_TRUE(spilled);
+  ASSERT_EQ(nested_loop_join(left_rows, right_rows), result);
+
+  auto in_memory_result = run_join(left_rows, right_rows, 64 * 1024 * 1024, spilled);
+  ASSERT_FALSE(spilled);
+  ASSERT_EQ(result, in_memory_result);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
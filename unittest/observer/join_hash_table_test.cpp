@@ -0,0 +1,141 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "sql/expr/join_hash_table.h"
+
+using namespace std;
+
+static void make_int_chunk(Chunk &chunk, const vector<int> &values)
+{
+  auto column = make_unique<Column>(AttrType::INTS, sizeof(int));
+  for (int value : values) {
+    column->append_one(reinterpret_cast<char *>(&value));
+  }
+  chunk.add_column(std::move(column), 0);
+}
+
+/// 探测 probe_keys 中每一行，返回所有匹配的 build 端行号
+static vector<vector<int>> probe_all(const JoinHashTable &hash_table, Chunk &probe_keys)
+{
+  vector<uint64_t> hashes;
+  vector<int>      matches;
+  JoinHashTable::hash_chunk(probe_keys, hashes);
+  hash_table.probe(probe_keys, hashes, matches);
+
+  vector<vector<int>> result(matches.size());
+  for (size_t row = 0; row < matches.size(); row++) {
+    for (int match = matches[row]; match != JoinHashTable::NO_MATCH;
+         match     = hash_table.next_match(match, probe_keys, static_cast<int>(row))) {
+      result[row].push_back(match);
+    }
+  }
+  return result;
+}
+
+TEST(JoinHashTableTest, int_keys_with_duplicates)
+{
+  JoinHashTable hash_table;
+
+  // build 端分两批写入，key 为 i % 100，每个 key 出现 10 次
+  for (int batch = 0; batch < 2; batch++) {
+    vector<int> keys;
+    vector<int> payloads;
+    for (int i = batch * 500; i < (batch + 1) * 500; i++) {
+      keys.push_back(i % 100);
+      payloads.push_back(i);
+    }
+    Chunk keys_chunk;
+    Chunk payload_chunk;
+    make_int_chunk(keys_chunk, keys);
+    make_int_chunk(payload_chunk, payloads);
+    ASSERT_EQ(RC::SUCCESS, hash_table.add_chunk(keys_chunk, payload_chunk));
+  }
+  hash_table.build();
+  ASSERT_EQ(1000, hash_table.rows());
+
+  Chunk probe_keys;
+  make_int_chunk(probe_keys, {0, 42, 99, 100, -1});
+  vector<vector<int>> result = probe_all(hash_table, probe_keys);
+  ASSERT_EQ(5, static_cast<int>(result.size()));
+  EXPECT_EQ(10, static_cast<int>(result[0].size()));
+  EXPECT_EQ(10, static_cast<int>(result[1].size()));
+  EXPECT_EQ(10, static_cast<int>(result[2].size()));
+  EXPECT_TRUE(result[3].empty());
+  EXPECT_TRUE(result[4].empty());
+
+  // 匹配行按照写入顺序输出，payload 可以通过行号取回
+  Column payload(AttrType::INTS, sizeof(int));
+  ASSERT_EQ(RC::SUCCESS, hash_table.gather(0, result[1], payload));
+  ASSERT_EQ(10, payload.count());
+  for (int i = 0; i < payload.count(); i++) {
+    EXPECT_EQ(42 + i * 100, payload.get_value(i).get_int());
+  }
+}
+
+TEST(JoinHashTableTest, composite_char_keys)
+{
+  const int char_len = 8;
+
+  auto make_keys = [char_len](Chunk &chunk, const vector<pair<string, int>> &keys) {
+    auto str_column = make_unique<Column>(AttrType::CHARS, char_len);
+    auto int_column = make_unique<Column>(AttrType::INTS, sizeof(int));
+    for (const auto &[str, num] : keys) {
+      char buf[char_len];
+      memset(buf, 0, sizeof(buf));
+      memcpy(buf, str.c_str(), min(str.size(), sizeof(buf)));
+      str_column->append_one(buf);
+      int value = num;
+      int_column->append_one(reinterpret_cast<char *>(&value));
+    }
+    chunk.add_column(std::move(str_column), 0);
+    chunk.add_column(std::move(int_column), 1);
+  };
+
+  JoinHashTable hash_table;
+  Chunk         build_keys;
+  Chunk         build_payload;
+  make_keys(build_keys, {{"a", 1}, {"a", 2}, {"bb", 1}, {"a", 1}});
+  make_int_chunk(build_payload, {0, 1, 2, 3});
+  ASSERT_EQ(RC::SUCCESS, hash_table.add_chunk(build_keys, build_payload));
+  hash_table.build();
+
+  Chunk probe_keys;
+  make_keys(probe_keys, {{"a", 1}, {"bb", 1}, {"bb", 2}, {"c", 1}});
+  vector<vector<int>> result = probe_all(hash_table, probe_keys);
+  ASSERT_EQ(4, static_cast<int>(result.size()));
+  EXPECT_EQ((vector<int>{0, 3}), result[0]);
+  EXPECT_EQ((vector<int>{2}), result[1]);
+  EXPECT_TRUE(result[2].empty());
+  EXPECT_TRUE(result[3].empty());
+}
+
+TEST(JoinHashTableTest, empty_build_side)
+{
+  JoinHashTable hash_table;
+  hash_table.build();
+  ASSERT_EQ(0, hash_table.rows());
+
+  Chunk probe_keys;
+  make_int_chunk(probe_keys, {1, 2, 3});
+  vector<vector<int>> result = probe_all(hash_table, probe_keys);
+  for (const vector<int> &matches : result) {
+    EXPECT_TRUE(matches.empty());
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
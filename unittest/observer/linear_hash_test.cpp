@@ -0,0 +1,266 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+#include "storage/buffer/buffer_pool_log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/buffer/double_write_buffer.h"
+#include "storage/clog/disk_log_handler.h"
+#include "storage/clog/log_entry.h"
+#include "storage/clog/vacuous_log_handler.h"
+#include "storage/field/field_meta.h"
+#include "storage/index/linear_hash.h"
+#include "storage/index/linear_hash_log.h"
+
+using namespace std;
+using namespace common;
+
+static const filesystem::path test_directory = "linear_hash_test_dir";
+
+/// 每个键值重复的次数
+static int duplicate_num(int value) { return value % 3 + 1; }
+
+class LinearHashTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filesystem::remove_all(test_directory);
+    filesystem::create_directory(test_directory);
+    ASSERT_EQ(RC::SUCCESS, bpm_.init(make_unique<VacuousDoubleWriteBuffer>()));
+  }
+
+  void TearDown() override
+  {
+    handler_.close();
+    filesystem::remove_all(test_directory);
+  }
+
+  /// 每个页面只放8个键值对，插入不多的数据就会分裂
+  void create(bool unique)
+  {
+    ASSERT_EQ(RC::SUCCESS,
+        handler_.create(unique,
+            log_handler_,
+            bpm_,
+            (test_directory / "test.hash").c_str(),
+            {&field_meta_},
+            8 /*bucket_capacity*/,
+            2 /*initial_bucket_num*/));
+  }
+
+  /// 插入 [0, max_value) 之间的数，每个键值重复 duplicate_num 次
+  static void insert_values(LinearHashHandler &handler, int max_value)
+  {
+    for (int value = 0; value < max_value; value++) {
+      for (int i = 0; i < duplicate_num(value); i++) {
+        RID rid(value, i);
+        ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+      }
+    }
+  }
+
+  static vector<RID> get_rids(LinearHashHandler &handler, int value)
+  {
+    vector<RID> rids;
+    EXPECT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&value), rids));
+    sort(rids.begin(), rids.end(), [](const RID &a, const RID &b) { return RID::compare(&a, &b) < 0; });
+    return rids;
+  }
+
+  static vector<RID> expected_rids(int value)
+  {
+    vector<RID> rids;
+    for (int i = 0; i < duplicate_num(value); i++) {
+      rids.emplace_back(value, i);
+    }
+    return rids;
+  }
+
+protected:
+  FieldMeta         field_meta_{"key", AttrType::INTS, 0 /*attr_offset*/, sizeof(int), true /*visible*/, 0 /*field_id*/};
+  BufferPoolManager bpm_;
+  VacuousLogHandler log_handler_;
+  LinearHashHandler handler_;
+};
+
+TEST_F(LinearHashTest, insert_and_get)
+{
+  create(false /*unique*/);
+
+  const int max_value = 3000;
+  insert_values(handler_, max_value);
+  ASSERT_GT(handler_.file_header().bucket_num(), 2);
+
+  for (int value = -10; value < max_value + 10; value++) {
+    const vector<RID> rids = get_rids(handler_, value);
+    if (value < 0 || value >= max_value) {
+      ASSERT_TRUE(rids.empty()) << "value=" << value;
+    } else {
+      ASSERT_EQ(expected_rids(value), rids) << "value=" << value;
+    }
+  }
+
+  // 同样的键值对不能重复插入
+  int value = 7;
+  RID rid(value, 0);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler_.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+
+  int item_count = 0;
+  ASSERT_EQ(RC::SUCCESS, handler_.scan([&item_count](const char *) {
+    item_count++;
+    return RC::SUCCESS;
+  }));
+  int expected_count = 0;
+  for (int value = 0; value < max_value; value++) {
+    expected_count += duplicate_num(value);
+  }
+  ASSERT_EQ(expected_count, item_count);
+}
+
+TEST_F(LinearHashTest, unique)
+{
+  create(true /*unique*/);
+
+  for (int value = 0; value < 1000; value++) {
+    RID rid(value, 0);
+    ASSERT_EQ(RC::SUCCESS, handler_.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  for (int value = 0; value < 1000; value += 7) {
+    RID rid(value, 1);
+    ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler_.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  for (int value = 0; value < 1000; value++) {
+    ASSERT_EQ(vector<RID>{RID(value, 0)}, get_rids(handler_, value)) << "value=" << value;
+  }
+}
+
+TEST_F(LinearHashTest, delete_entry)
+{
+  create(false /*unique*/);
+
+  const int max_value = 2000;
+  insert_values(handler_, max_value);
+
+  for (int value = 0; value < max_value; value += 2) {
+    for (int i = 0; i < duplicate_num(value); i++) {
+      RID rid(value, i);
+      ASSERT_EQ(RC::SUCCESS, handler_.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+    }
+  }
+
+  int value = 0;
+  RID rid(value, 0);
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, handler_.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+
+  for (int value = 0; value < max_value; value++) {
+    const vector<RID> rids = get_rids(handler_, value);
+    if (value % 2 == 0) {
+      ASSERT_TRUE(rids.empty()) << "value=" << value;
+    } else {
+      ASSERT_EQ(expected_rids(value), rids) << "value=" << value;
+    }
+  }
+
+  // 删除后空出来的位置可以再次使用
+  insert_values(handler_, 10);
+  ASSERT_EQ(expected_rids(4), get_rids(handler_, 4));
+}
+
+/// 分发缓冲池和哈希索引的日志
+class LinearHashTestLogReplayer : public LogReplayer
+{
+public:
+  LinearHashTestLogReplayer(BufferPoolManager &bpm) : buffer_pool_log_replayer_(bpm), hash_log_replayer_(bpm) {}
+
+  RC replay(const LogEntry &entry) override
+  {
+    switch (entry.module().id()) {
+      case LogModule::Id::BUFFER_POOL: return buffer_pool_log_replayer_.replay(entry);
+      case LogModule::Id::HASH_INDEX: return hash_log_replayer_.replay(entry);
+      default: return RC::INVALID_ARGUMENT;
+    }
+  }
+
+private:
+  BufferPoolLogReplayer buffer_pool_log_replayer_;
+  LinearHashLogReplayer hash_log_replayer_;
+};
+
+TEST_F(LinearHashTest, redo)
+{
+  // 只有日志落盘、数据页面没有落盘时，重做日志之后可以查到所有的数据
+  const filesystem::path clog_path   = test_directory / "clog";
+  const filesystem::path file_name   = test_directory / "redo.hash";
+  const filesystem::path backup_name = test_directory / "redo.hash.backup";
+  const int              max_value   = 2000;
+
+  {
+    BufferPoolManager bpm;
+    ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+    DiskLogHandler            log_handler;
+    LinearHashTestLogReplayer log_replayer(bpm);
+    ASSERT_EQ(RC::SUCCESS, log_handler.init(clog_path.c_str()));
+    ASSERT_EQ(RC::SUCCESS, log_handler.replay(log_replayer, 0));
+    ASSERT_EQ(RC::SUCCESS, log_handler.start());
+
+    LinearHashHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.create(false, log_handler, bpm, file_name.c_str(), {&field_meta_}, 8, 2));
+    filesystem::copy_file(file_name, backup_name);
+
+    insert_values(handler, max_value);
+    for (int value = 0; value < max_value; value += 5) {
+      RID rid(value, 0);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+    }
+
+    ASSERT_EQ(RC::SUCCESS, log_handler.stop());
+    ASSERT_EQ(RC::SUCCESS, log_handler.await_termination());
+    ASSERT_EQ(RC::SUCCESS, handler.close());
+  }
+
+  filesystem::remove(file_name);
+  filesystem::copy_file(backup_name, file_name);
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+
+  DiskLogHandler  log_handler;
+  DiskBufferPool *buffer_pool = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, file_name.c_str(), buffer_pool));
+
+  LinearHashTestLogReplayer log_replayer(bpm);
+  ASSERT_EQ(RC::SUCCESS, log_handler.init(clog_path.c_str()));
+  ASSERT_EQ(RC::SUCCESS, log_handler.replay(log_replayer, 0));
+  ASSERT_EQ(RC::SUCCESS, log_handler.start());
+
+  LinearHashHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.open(log_handler, *buffer_pool));
+  ASSERT_GT(handler.file_header().bucket_num(), 2);
+  for (int value = 0; value < max_value; value++) {
+    vector<RID> expected = expected_rids(value);
+    if (value % 5 == 0) {
+      expected.erase(expected.begin());
+    }
+    ASSERT_EQ(expected, get_rids(handler, value)) << "value=" << value;
+  }
+
+  ASSERT_EQ(RC::SUCCESS, log_handler.stop());
+  ASSERT_EQ(RC::SUCCESS, log_handler.await_termination());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
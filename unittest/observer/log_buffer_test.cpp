@@ -40,8 +40,11 @@ TEST(LogEntryBuffer, test_append)
   ASSERT_GT(buffer.bytes(), 0);
   ASSERT_GT(buffer.entry_number(), 0);
 
+  // 文件大小刚好可以放下 (start_lsn, end_lsn] 的日志和一个结束标记
   LogFileWriter writer;
-  ASSERT_EQ(RC::SUCCESS, writer.open("test_log_entry_buffer.log", end_lsn));
+  int64_t       max_size = (end_lsn - start_lsn) * (LogHeader::SIZE + 10) + LogHeader::SIZE;
+  filesystem::remove("test_log_entry_buffer.log");
+  ASSERT_EQ(RC::SUCCESS, writer.open("test_log_entry_buffer.log", max_size));
   int count = 0;
   ASSERT_EQ(RC::SUCCESS, buffer.flush(writer, count));
   ASSERT_EQ(count, 1);
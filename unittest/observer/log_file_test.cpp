@@ -30,17 +30,20 @@ using namespace common;
 TEST(LogFileWriter, basic)
 {
   const char *filename = "test_log_file_writer.log";
+  filesystem::remove(filename);
 
   // test LogFileWriter open, close, valid
+  // 文件大小刚好可以放下 end_lsn 条日志和一个结束标记
   LogFileWriter writer;
-  LSN           end_lsn = 1000 - 1;
-  ASSERT_EQ(RC::SUCCESS, writer.open(filename, end_lsn));
+  LSN           end_lsn  = 1000 - 1;
+  int64_t       max_size = end_lsn * (LogHeader::SIZE + 10) + LogHeader::SIZE;
+  ASSERT_EQ(RC::SUCCESS, writer.open(filename, max_size));
   ASSERT_TRUE(writer.valid());
   ASSERT_FALSE(writer.full());
   ASSERT_EQ(RC::SUCCESS, writer.close());
 
   // test LogFileWriter write
-  ASSERT_EQ(RC::SUCCESS, writer.open(filename, end_lsn));
+  ASSERT_EQ(RC::SUCCESS, writer.open(filename, max_size));
 
   LogEntry entry;
 
@@ -66,11 +69,13 @@ TEST(LogFileWriter, basic)
   ASSERT_EQ(entry.init(end_lsn - 100, LogModule::Id::BUFFER_POOL, std::move(data)), RC::SUCCESS);
   ASSERT_NE(RC::SUCCESS, writer.write(entry));
 
+  // 重新打开文件时，会接着最后一条日志写
   data.resize(10);
   writer.close();
-  ASSERT_EQ(RC::SUCCESS, writer.open(filename, end_lsn));
+  ASSERT_EQ(RC::SUCCESS, writer.open(filename, max_size));
+  ASSERT_EQ(end_lsn, writer.last_lsn());
   ASSERT_EQ(entry.init(end_lsn + 1, LogModule::Id::BUFFER_POOL, std::move(data)), RC::SUCCESS);
-  ASSERT_NE(RC::SUCCESS, writer.write(entry));
+  ASSERT_EQ(RC::LOG_FILE_FULL, writer.write(entry));
   ASSERT_TRUE(writer.full());
 
   filesystem::remove(filename);
@@ -83,8 +88,9 @@ TEST(LogFileReader, basic)
   filesystem::remove(log_file);
 
   LogFileWriter writer;
-  LSN           end_lsn = 1000 - 1;
-  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, end_lsn));
+  LSN           end_lsn  = 1000 - 1;
+  int64_t       max_size = 1024 * 1024;
+  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, max_size));
   ASSERT_TRUE(writer.valid());
 
   LogEntry entry;
@@ -131,8 +137,9 @@ TEST(LogFileReadWrite, test_read_write)
   filesystem::remove(log_file);
 
   LogFileWriter writer;
-  LSN           end_lsn = 1000 - 1;
-  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, end_lsn));
+  LSN           end_lsn  = 1000 - 1;
+  int64_t       max_size = 1024 * 1024;
+  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, max_size));
   ASSERT_TRUE(writer.valid());
 
   LogEntry entry;
@@ -162,7 +169,8 @@ TEST(LogFileReadWrite, test_read_write)
   writer.close();
   reader.close();
 
-  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, end_lsn));
+  ASSERT_EQ(RC::SUCCESS, writer.open(log_file, max_size));
+  ASSERT_EQ(one_lsn, writer.last_lsn());
 
   for (LSN i = one_lsn + 1; i <= end_lsn; i++) {
     vector<char> data(10);
@@ -202,11 +210,11 @@ TEST(LogFileManager, get_lsn_from_filename)
 
 TEST(LogFileManager, init_not_exists)
 {
-  const char *directory                 = "not_exists/not_exists2";
-  int         max_entry_number_per_file = 1000;
+  const char *directory    = "not_exists/not_exists2";
+  int64_t     segment_size = 1000;
 
   LogFileManager manager;
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
   ASSERT_TRUE(filesystem::is_directory(directory));
 
   vector<string> files;
@@ -218,13 +226,13 @@ TEST(LogFileManager, init_not_exists)
 
 TEST(LogFileManager, init_empty_directory)
 {
-  const char *directory                 = "empty_directory";
-  int         max_entry_number_per_file = 1000;
+  const char *directory    = "empty_directory";
+  int64_t     segment_size = 1000;
 
   ASSERT_TRUE(filesystem::create_directory(directory));
 
   LogFileManager manager;
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
   ASSERT_TRUE(filesystem::is_directory(directory));
 
   vector<string> files;
@@ -236,8 +244,8 @@ TEST(LogFileManager, init_empty_directory)
 
 TEST(LogFileManager, init_with_files)
 {
-  const char *directory                 = "init_with_files";
-  int         max_entry_number_per_file = 1000;
+  const char *directory    = "init_with_files";
+  int64_t     segment_size = 1000;
 
   filesystem::remove_all(directory);
 
@@ -255,7 +263,7 @@ TEST(LogFileManager, init_with_files)
   }
 
   LogFileManager manager;
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
   ASSERT_TRUE(filesystem::is_directory(directory));
 
   vector<string> result_files;
@@ -286,11 +294,53 @@ TEST(LogFileManager, init_with_files)
   ASSERT_EQ(RC::SUCCESS, manager.list_files(result_files, 3010));
   ASSERT_EQ(1, result_files.size());
 
+  // 最后一个文件中的日志没有上限
   ASSERT_EQ(RC::SUCCESS, manager.list_files(result_files, 4000));
-  ASSERT_EQ(0, result_files.size());
+  ASSERT_EQ(1, result_files.size());
 
   ASSERT_EQ(RC::SUCCESS, manager.list_files(result_files, 5000));
-  ASSERT_EQ(0, result_files.size());
+  ASSERT_EQ(1, result_files.size());
+
+  ASSERT_TRUE(filesystem::remove_all(directory));
+}
+
+TEST(LogFileManager, remove_files_before)
+{
+  const char *directory    = "remove_files_before";
+  int64_t     segment_size = 1000;
+
+  filesystem::remove_all(directory);
+  ASSERT_TRUE(filesystem::create_directory(directory));
+
+  LSN lsns[] = {1000, 2000, 3000};
+  for (LSN lsn : lsns) {
+    filesystem::path filename =
+        filesystem::path(directory) / (string(LogFileManager::file_prefix_) + to_string(lsn) + LogFileManager::file_suffix_);
+    ofstream ofs(filename);
+    ofs.close();
+  }
+
+  LogFileManager manager;
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
+
+  // 文件中还有需要保留的日志
+  int removed_count = 0;
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files_before(1999, removed_count));
+  ASSERT_EQ(0, removed_count);
+
+  vector<string> result_files;
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files_before(2500, removed_count));
+  ASSERT_EQ(1, removed_count);
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(result_files, 0));
+  ASSERT_EQ(2, result_files.size());
+  ASSERT_FALSE(filesystem::exists(filesystem::path(directory) / (string(LogFileManager::file_prefix_) + "1000" +
+                                                                  LogFileManager::file_suffix_)));
+
+  // 最后一个文件不会删除
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files_before(10000, removed_count));
+  ASSERT_EQ(1, removed_count);
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(result_files, 0));
+  ASSERT_EQ(1, result_files.size());
 
   ASSERT_TRUE(filesystem::remove_all(directory));
 }
@@ -298,13 +348,13 @@ TEST(LogFileManager, init_with_files)
 TEST(LogFileManager, last_file)
 {
   // create an empty directory and try to open last file
-  const char *directory                 = "last_file";
-  int         max_entry_number_per_file = 1000;
+  const char *directory    = "last_file";
+  int64_t     segment_size = 1000;
 
   filesystem::remove_all(directory);
 
   LogFileManager manager;
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
   ASSERT_TRUE(filesystem::is_directory(directory));
 
   LogFileWriter writer;
@@ -332,7 +382,7 @@ TEST(LogFileManager, last_file)
     ofs.close();
   }
 
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
   ASSERT_TRUE(filesystem::is_directory(directory));
 
   ASSERT_EQ(RC::SUCCESS, manager.last_file(writer));
@@ -345,13 +395,13 @@ TEST(LogFileManager, last_file)
 TEST(LogFileManager, next_file)
 {
   // create an empty directory and try to open next file
-  const char *directory                 = "next_file";
-  int         max_entry_number_per_file = 1000;
+  const char *directory    = "next_file";
+  int64_t     segment_size = 1000;
 
   filesystem::remove_all(directory);
 
   LogFileManager manager;
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size));
   ASSERT_TRUE(filesystem::is_directory(directory));
 
   LogFileWriter writer;
@@ -365,31 +415,106 @@ TEST(LogFileManager, next_file)
 
   ASSERT_TRUE(filesystem::remove_all(directory));
 
-  // create a directory with some files and try to open next file
-  ASSERT_TRUE(filesystem::create_directory(directory));
-  LSN            lsns[] = {1000, 2000, 3000};
-  vector<string> files;
-  for (LSN lsn : lsns) {
-    stringstream filename_ss;
-    string       filename = string(LogFileManager::file_prefix_) + to_string(lsn) + LogFileManager::file_suffix_;
-    files.push_back(filename);
-    filename_ss << directory << "/" << filename;
-    ofstream ofs(filename_ss.str());
-    ofs.close();
-  }
+  // 写满一个文件之后，下一个文件的LSN紧跟着最后一条日志
+  filesystem::remove_all(directory);
+  LogFileManager manager2;
+  ASSERT_EQ(RC::SUCCESS, manager2.init(directory, segment_size));
+  ASSERT_EQ(RC::SUCCESS, manager2.last_file(writer));
 
-  ASSERT_EQ(RC::SUCCESS, manager.init(directory, max_entry_number_per_file));
-  ASSERT_TRUE(filesystem::is_directory(directory));
+  RC       rc = RC::SUCCESS;
+  LogEntry entry;
+  for (lsn = 1; OB_SUCC(rc); lsn++) {
+    ASSERT_EQ(RC::SUCCESS, entry.init(lsn, LogModule::Id::BUFFER_POOL, vector<char>(10)));
+    rc = writer.write(entry);
+  }
+  ASSERT_EQ(RC::LOG_FILE_FULL, rc);
+  const LSN last_lsn = writer.last_lsn();
+  ASSERT_GT(last_lsn, 0);
 
-  ASSERT_EQ(RC::SUCCESS, manager.next_file(writer));
+  ASSERT_EQ(RC::SUCCESS, manager2.next_file(writer));
   ASSERT_TRUE(writer.valid());
   ASSERT_EQ(RC::SUCCESS, LogFileManager::get_lsn_from_filename(filesystem::path(writer.filename()).filename(), lsn));
-  ASSERT_EQ(4000, lsn);
+  ASSERT_EQ(last_lsn + 1, lsn);
 
   writer.close();
   filesystem::remove_all(directory);
 }
 
+TEST(LogFileManager, recycle)
+{
+  const char *directory    = "recycle";
+  int64_t     segment_size = 1000;
+
+  filesystem::remove_all(directory);
+
+  LogFileManager manager;
+  ASSERT_EQ(RC::SUCCESS, manager.init(directory, segment_size, 1 /*max_recycled_file_num*/));
+
+  // 写满3个日志文件
+  LogFileWriter writer;
+  ASSERT_EQ(RC::SUCCESS, manager.last_file(writer));
+  ASSERT_EQ(segment_size, static_cast<int64_t>(filesystem::file_size(writer.filename())));
+
+  LSN      lsn = 1;
+  LogEntry entry;
+  for (int i = 0; i < 3; lsn++) {
+    ASSERT_EQ(RC::SUCCESS, entry.init(lsn, LogModule::Id::BUFFER_POOL, vector<char>(10)));
+    RC rc = writer.write(entry);
+    if (rc == RC::LOG_FILE_FULL) {
+      ASSERT_EQ(RC::SUCCESS, writer.sync());
+      ASSERT_EQ(RC::SUCCESS, manager.next_file(writer));
+      ASSERT_EQ(RC::SUCCESS, writer.write(entry));
+      i++;
+    } else {
+      ASSERT_EQ(RC::SUCCESS, rc);
+    }
+  }
+  ASSERT_EQ(RC::SUCCESS, writer.sync());
+
+  vector<string> files;
+  ASSERT_EQ(RC::SUCCESS, manager.list_files(files, 0));
+  ASSERT_EQ(4, files.size());
+
+  // 第一个文件回收，其它的删除
+  int removed_count = 0;
+  ASSERT_EQ(RC::SUCCESS, manager.remove_files_before(lsn, removed_count));
+  ASSERT_EQ(3, removed_count);
+  ASSERT_EQ(1, manager.recycled_file_num());
+  ASSERT_FALSE(filesystem::exists(files[0]));
+  ASSERT_FALSE(filesystem::exists(files[1]));
+
+  // 重启之后也能找到回收的文件
+  LogFileManager manager2;
+  ASSERT_EQ(RC::SUCCESS, manager2.init(directory, segment_size, 1 /*max_recycled_file_num*/));
+  ASSERT_EQ(1, manager2.recycled_file_num());
+
+  // 复用回收的文件，里面旧的日志不会被读到
+  ASSERT_EQ(RC::SUCCESS, manager2.last_file(writer));
+  ASSERT_EQ(lsn - 1, writer.last_lsn());
+  ASSERT_EQ(RC::SUCCESS, manager2.next_file(writer));
+  ASSERT_EQ(0, manager2.recycled_file_num());
+  ASSERT_EQ(0, writer.last_lsn());
+  ASSERT_EQ(RC::SUCCESS, entry.init(lsn, LogModule::Id::BUFFER_POOL, vector<char>(10)));
+  ASSERT_EQ(RC::SUCCESS, writer.write(entry));
+  ASSERT_EQ(RC::SUCCESS, writer.sync());
+  writer.close();
+
+  LogFileReader reader;
+  ASSERT_EQ(RC::SUCCESS, manager2.list_files(files, lsn));
+  ASSERT_EQ(1, files.size());
+  ASSERT_EQ(RC::SUCCESS, reader.open(files[0].c_str()));
+  int count = 0;
+  ASSERT_EQ(RC::SUCCESS, reader.iterate([&count](LogEntry &) {
+    count++;
+    return RC::SUCCESS;
+  }));
+  ASSERT_EQ(1, count);
+  ASSERT_EQ(lsn, reader.last_lsn());
+  reader.close();
+
+  filesystem::remove_all(directory);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
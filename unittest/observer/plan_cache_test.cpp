@@ -0,0 +1,146 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "gtest/gtest.h"
+#include "sql/expr/expression.h"
+#include "sql/plan_cache/parameterized_sql.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "storage/db/db.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+
+TEST(ParameterizedSqlTest, replace_literals)
+{
+  ParameterizedSql sql;
+  ASSERT_EQ(RC::SUCCESS,
+      ParameterizedSql::parameterize(
+          "select * from t where id = 1 and name = 'abc' and d = '2020-01-02' and f = -1.5;", sql));
+  EXPECT_TRUE(sql.is_select());
+  EXPECT_EQ("select * from t where id = ?ints and name = ?chars and d = ?dates and f = ?floats;", sql.key());
+
+  const vector<SqlLiteral> &literals = sql.literals();
+  ASSERT_EQ(4, static_cast<int>(literals.size()));
+  EXPECT_EQ(1, literals[0].value.get_int());
+  EXPECT_EQ("1", literals[0].text);
+  EXPECT_EQ("abc", literals[1].value.get_string());
+  EXPECT_EQ("'abc'", literals[1].text);
+  EXPECT_EQ(AttrType::DATES, literals[2].value.attr_type());
+  EXPECT_FLOAT_EQ(-1.5, literals[3].value.get_float());
+
+  // 不同的常量得到相同的key
+  ParameterizedSql other;
+  ASSERT_EQ(RC::SUCCESS,
+      ParameterizedSql::parameterize(
+          "select * from t where id = 20 and name = \"x y\" and d = '2021-12-31' and f = 3.0;", other));
+  EXPECT_EQ(sql.key(), other.key());
+  EXPECT_EQ("x y", other.literals()[1].value.get_string());
+}
+
+TEST(ParameterizedSqlTest, not_select)
+{
+  ParameterizedSql sql;
+  ASSERT_EQ(RC::SUCCESS, ParameterizedSql::parameterize("insert into t values(1, 'a');", sql));
+  EXPECT_FALSE(sql.is_select());
+  EXPECT_EQ("insert into t values(?ints, ?chars);", sql.key());
+
+  ASSERT_NE(RC::SUCCESS, ParameterizedSql::parameterize("select * from t where d = '2021-02-31';", sql));
+}
+
+TEST(PlanCacheTest, get_put_release)
+{
+  PlanCache cache(2 /*capacity*/, 2 /*max_idle_plans*/);
+  Db        db;
+
+  ParameterizedSql sql;
+  ASSERT_EQ(RC::SUCCESS, ParameterizedSql::parameterize("select * from t where id = 1 and id < 10", sql));
+
+  shared_ptr<PlanCacheEntry> entry;
+  unique_ptr<CachedPlan>     plan;
+  ASSERT_EQ(RC::NOTFOUND, cache.get(sql.key(), sql.literals(), &db, entry, plan));
+
+  // 第一个常量是参数，第二个常量要求原文相同
+  ValueExpr param(Value(1));
+  auto      new_entry = make_shared<PlanCacheEntry>();
+  new_entry->key      = sql.key();
+  new_entry->db       = &db;
+  new_entry->param_literals.push_back(0);
+  new_entry->fixed_literals.emplace_back(1, "10");
+
+  plan = make_unique<CachedPlan>();
+  plan->params.push_back(&param);
+  cache.put(new_entry, entry);
+  ASSERT_EQ(new_entry, entry);
+  cache.release(entry, std::move(plan), true /*reusable*/);
+
+  ParameterizedSql next_sql;
+  ASSERT_EQ(RC::SUCCESS, ParameterizedSql::parameterize("select * from t where id = 5 and id < 10", next_sql));
+  ASSERT_EQ(sql.key(), next_sql.key());
+  ASSERT_EQ(RC::SUCCESS, cache.get(next_sql.key(), next_sql.literals(), &db, entry, plan));
+  EXPECT_EQ(5, param.get_value().get_int());
+  EXPECT_EQ(1, cache.hit_count());
+
+  // 唯一的计划正在使用中
+  ParameterizedSql same_sql;
+  ASSERT_EQ(RC::SUCCESS, ParameterizedSql::parameterize("select * from t where id = 6 and id < 10", same_sql));
+  shared_ptr<PlanCacheEntry> other_entry;
+  unique_ptr<CachedPlan>     other_plan;
+  ASSERT_EQ(RC::NOTFOUND, cache.get(same_sql.key(), same_sql.literals(), &db, other_entry, other_plan));
+
+  // 执行出错的计划不会被复用
+  cache.release(entry, std::move(plan), false /*reusable*/);
+  ASSERT_EQ(RC::NOTFOUND, cache.get(same_sql.key(), same_sql.literals(), &db, other_entry, other_plan));
+
+  plan = make_unique<CachedPlan>();
+  plan->params.push_back(&param);
+  cache.release(entry, std::move(plan), true /*reusable*/);
+  ASSERT_EQ(RC::SUCCESS, cache.get(same_sql.key(), same_sql.literals(), &db, entry, plan));
+  EXPECT_EQ(6, param.get_value().get_int());
+  cache.release(entry, std::move(plan), true /*reusable*/);
+
+  // 不能参数化的常量不同
+  ParameterizedSql fixed_sql;
+  ASSERT_EQ(RC::SUCCESS, ParameterizedSql::parameterize("select * from t where id = 6 and id < 11", fixed_sql));
+  ASSERT_EQ(RC::NOTFOUND, cache.get(fixed_sql.key(), fixed_sql.literals(), &db, other_entry, other_plan));
+
+  // 其它的数据库
+  Db other_db;
+  ASSERT_EQ(RC::NOTFOUND, cache.get(same_sql.key(), same_sql.literals(), &other_db, other_entry, other_plan));
+  EXPECT_EQ(0, static_cast<int>(cache.count()));
+}
+
+TEST(PlanCacheTest, evict)
+{
+  PlanCache cache(2 /*capacity*/, 2 /*max_idle_plans*/);
+  Db        db;
+
+  for (const char *key : {"a", "b", "c"}) {
+    auto new_entry = make_shared<PlanCacheEntry>();
+    new_entry->key = key;
+    new_entry->db  = &db;
+
+    shared_ptr<PlanCacheEntry> entry;
+    cache.put(new_entry, entry);
+    cache.release(entry, make_unique<CachedPlan>(), true /*reusable*/);
+  }
+  ASSERT_EQ(2, static_cast<int>(cache.count()));
+
+  shared_ptr<PlanCacheEntry> entry;
+  unique_ptr<CachedPlan>     plan;
+  EXPECT_EQ(RC::NOTFOUND, cache.get("a", {}, &db, entry, plan));
+  EXPECT_EQ(RC::SUCCESS, cache.get("c", {}, &db, entry, plan));
+  cache.release(entry, std::move(plan), true /*reusable*/);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
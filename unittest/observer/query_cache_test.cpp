@@ -0,0 +1,136 @@
+/* Copyright (c) 2024 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "gtest/gtest.h"
+#include "sql/query_cache/query_cache.h"
+#include "storage/db/db.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+
+namespace {
+
+shared_ptr<QueryResult> make_result(int rows)
+{
+  auto result = make_shared<QueryResult>();
+  result->schema().append_cell("id");
+  result->schema().append_cell("name");
+
+  ValueListTuple tuple;
+  for (int i = 0; i < rows; i++) {
+    tuple.set_cells({Value(i), Value(to_string(i).c_str())});
+    EXPECT_EQ(RC::SUCCESS, result->append_row(tuple));
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(QueryResultTest, append_and_read)
+{
+  auto           result = make_shared<QueryResult>();
+  ValueListTuple tuple;
+
+  Value boolean_value;
+  boolean_value.set_boolean(true);
+  Value date_value;
+  date_value.set_date(20240102);
+  tuple.set_cells({Value(-1), Value(1.5f), Value("abc"), Value(""), boolean_value, date_value});
+  ASSERT_EQ(RC::SUCCESS, result->append_row(tuple));
+  tuple.set_cells({Value(2)});
+  ASSERT_EQ(RC::SUCCESS, result->append_row(tuple));
+  EXPECT_EQ(2, result->row_count());
+
+  size_t        offset = 0;
+  vector<Value> cells;
+  ASSERT_EQ(RC::SUCCESS, result->read_row(offset, cells));
+  ASSERT_EQ(6, static_cast<int>(cells.size()));
+  EXPECT_EQ(-1, cells[0].get_int());
+  EXPECT_FLOAT_EQ(1.5f, cells[1].get_float());
+  EXPECT_EQ("abc", cells[2].get_string());
+  EXPECT_EQ(AttrType::CHARS, cells[3].attr_type());
+  EXPECT_EQ("", cells[3].get_string());
+  EXPECT_TRUE(cells[4].get_boolean());
+  EXPECT_EQ(AttrType::DATES, cells[5].attr_type());
+  EXPECT_EQ(date_value.to_string(), cells[5].to_string());
+
+  ASSERT_EQ(RC::SUCCESS, result->read_row(offset, cells));
+  ASSERT_EQ(1, static_cast<int>(cells.size()));
+  EXPECT_EQ(2, cells[0].get_int());
+  EXPECT_EQ(RC::RECORD_EOF, result->read_row(offset, cells));
+}
+
+TEST(QueryCacheTest, get_put)
+{
+  QueryCache cache(1024 * 1024 /*capacity*/, 1024 /*max_result_size*/);
+  Db         db;
+
+  shared_ptr<const QueryResult> result;
+  ASSERT_EQ(RC::NOTFOUND, cache.get("select * from t", &db, result));
+
+  auto entry    = QueryCache::make_entry("select * from t", &db, {});
+  entry->result = make_result(3);
+  ASSERT_TRUE(cache.put(entry));
+  ASSERT_EQ(RC::SUCCESS, cache.get("select * from t", &db, result));
+  EXPECT_EQ(3, result->row_count());
+  EXPECT_EQ(2, result->schema().cell_num());
+  EXPECT_EQ(1, cache.hit_count());
+
+  // 其它的数据库
+  Db other_db;
+  ASSERT_EQ(RC::NOTFOUND, cache.get("select * from t", &other_db, result));
+  EXPECT_EQ(0, static_cast<int>(cache.count()));
+  EXPECT_EQ(0, static_cast<int>(cache.memory_size()));
+
+  // 太大的结果不缓存
+  auto big_entry    = QueryCache::make_entry("select * from big", &db, {});
+  big_entry->result = make_result(1000);
+  ASSERT_FALSE(cache.put(big_entry));
+  ASSERT_EQ(RC::NOTFOUND, cache.get("select * from big", &db, result));
+}
+
+TEST(QueryCacheTest, evict)
+{
+  Db     db;
+  auto   result     = make_result(10);
+  size_t entry_size = 0;
+  {
+    auto entry    = QueryCache::make_entry("a", &db, {});
+    entry->result = result;
+    entry_size    = entry->memory_size();
+  }
+
+  QueryCache cache(entry_size * 2 /*capacity*/, 1024 /*max_result_size*/);
+  for (const char *key : {"a", "b", "c"}) {
+    auto entry    = QueryCache::make_entry(key, &db, {});
+    entry->result = result;
+    ASSERT_TRUE(cache.put(entry));
+  }
+  ASSERT_EQ(2, static_cast<int>(cache.count()));
+  EXPECT_EQ(entry_size * 2, cache.memory_size());
+
+  shared_ptr<const QueryResult> cached;
+  EXPECT_EQ(RC::NOTFOUND, cache.get("a", &db, cached));
+  EXPECT_EQ(RC::SUCCESS, cache.get("b", &db, cached));
+
+  // 重复放入相同的key，替换旧的结果
+  auto entry    = QueryCache::make_entry("b", &db, {});
+  entry->result = make_result(1);
+  ASSERT_TRUE(cache.put(entry));
+  EXPECT_EQ(2, static_cast<int>(cache.count()));
+  ASSERT_EQ(RC::SUCCESS, cache.get("b", &db, cached));
+  EXPECT_EQ(1, cached->row_count());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
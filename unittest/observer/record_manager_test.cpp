@@ -204,6 +204,142 @@ TEST(RecordFileScanner, test_record_file_iterator)
   delete bpm;
 }
 
+TEST(RecordFileHandler, all_visible_pages)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager_all_visible.bp";
+  filesystem::remove(record_manager_file);
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, record_manager_file, bp));
+
+  RecordFileHandler file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, nullptr));
+
+  // 第一个字节为1表示记录对所有事务可见
+  char             record_data[20] = {1};
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; i++) {
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+    rids.push_back(rid);
+  }
+  const PageNum first_page = rids.front().page_num;
+  const PageNum last_page  = rids.back().page_num;
+  ASSERT_NE(first_page, last_page);
+
+  auto checker = [](const Record &record) { return record.data()[0] == 1; };
+  bool all_visible = false;
+  ASSERT_FALSE(file_handler.is_all_visible(first_page));
+  ASSERT_EQ(RC::SUCCESS, file_handler.mark_all_visible_if(first_page, checker, all_visible));
+  ASSERT_TRUE(all_visible);
+  ASSERT_TRUE(file_handler.is_all_visible(first_page));
+
+  // 有一条记录不满足条件就不标记
+  ASSERT_EQ(RC::SUCCESS, file_handler.visit_record(rids.back(), [](Record &record) {
+    record.data()[0] = 0;
+    return true;
+  }));
+  ASSERT_EQ(RC::SUCCESS, file_handler.mark_all_visible_if(last_page, checker, all_visible));
+  ASSERT_FALSE(all_visible);
+  ASSERT_FALSE(file_handler.is_all_visible(last_page));
+
+  // 任何修改都会清除标记
+  ASSERT_EQ(RC::SUCCESS, file_handler.visit_record(rids.front(), [](Record &) { return false; }));
+  ASSERT_TRUE(file_handler.is_all_visible(first_page));
+  ASSERT_EQ(RC::SUCCESS, file_handler.visit_record(rids.front(), [](Record &) { return true; }));
+  ASSERT_FALSE(file_handler.is_all_visible(first_page));
+
+  ASSERT_EQ(RC::SUCCESS, file_handler.mark_all_visible_if(first_page, checker, all_visible));
+  ASSERT_TRUE(all_visible);
+  ASSERT_EQ(RC::SUCCESS, file_handler.update_record(record_data, rids[1]));
+  ASSERT_FALSE(file_handler.is_all_visible(first_page));
+
+  ASSERT_EQ(RC::SUCCESS, file_handler.mark_all_visible_if(first_page, checker, all_visible));
+  ASSERT_TRUE(all_visible);
+  ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&rids[2]));
+  ASSERT_FALSE(file_handler.is_all_visible(first_page));
+
+  // 插入的记录不管放到哪个页面，都会清除那个页面的标记
+  ASSERT_EQ(RC::SUCCESS, file_handler.visit_record(rids.back(), [](Record &record) {
+    record.data()[0] = 1;
+    return true;
+  }));
+  for (const RID &inserted_rid : rids) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.mark_all_visible_if(inserted_rid.page_num, checker, all_visible));
+    ASSERT_TRUE(all_visible);
+  }
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(record_data, sizeof(record_data), &rid));
+  ASSERT_FALSE(file_handler.is_all_visible(rid.page_num));
+
+  file_handler.close();
+  bpm.close_file(record_manager_file);
+}
+
+TEST(RecordFileHandler, get_records_in_page)
+{
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager_get_records.bp";
+  filesystem::remove(record_manager_file);
+
+  BufferPoolManager bpm;
+  ASSERT_EQ(RC::SUCCESS, bpm.init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(log_handler, record_manager_file, bp));
+
+  RecordFileHandler file_handler(StorageFormat::ROW_FORMAT);
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, nullptr));
+
+  const int        record_size = sizeof(int) * 4;
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; i++) {
+    int record_data[4] = {i, i + 1, i + 2, i + 3};
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record(reinterpret_cast<char *>(record_data), record_size, &rid));
+    rids.push_back(rid);
+  }
+  ASSERT_GT(file_handler.page_count(), 2);
+
+  // 每个页面隔一条记录读取一条，与逐条读取的结果相同
+  size_t begin = 0;
+  while (begin < rids.size()) {
+    size_t end = begin;
+    while (end < rids.size() && rids[end].page_num == rids[begin].page_num) {
+      end++;
+    }
+
+    std::vector<RID> page_rids;
+    for (size_t i = begin; i < end; i += 2) {
+      page_rids.push_back(rids[i]);
+    }
+
+    std::vector<char> data;
+    ASSERT_EQ(RC::SUCCESS, file_handler.get_records(page_rids, record_size, data));
+    ASSERT_EQ(page_rids.size() * record_size, data.size());
+    for (size_t i = 0; i < page_rids.size(); i++) {
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, file_handler.get_record(page_rids[i], record));
+      ASSERT_EQ(0, memcmp(record.data(), data.data() + i * record_size, record_size));
+    }
+    begin = end;
+  }
+
+  // 已经删除的记录读取失败
+  ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&rids[1]));
+  std::vector<char> data;
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, file_handler.get_records(std::vector<RID>{rids[0], rids[1]}, record_size, data));
+
+  file_handler.close();
+  bpm.close_file(record_manager_file);
+}
+
 TEST(RecordManager, durability)
 {
   /*